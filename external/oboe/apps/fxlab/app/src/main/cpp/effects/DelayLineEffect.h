@@ -40,8 +40,24 @@ public:
 
 
     void operator () (typename std::iterator_traits<iter_type>::reference x) {
+        tick(x, mMod() * kDepth + kTap);
+    }
+    // Block form: an unmodulated line (depth 0, e.g. echo) skips the control
+    // signal, which is then a call through std::function per sample for nothing
+    void operator () (iter_type begin, iter_type end) {
+        if (kDepth == 0) {
+            for (; begin != end; ++begin) {
+                tick(*begin, static_cast<float>(kTap));
+            }
+        } else {
+            for (; begin != end; ++begin) {
+                operator()(*begin);
+            }
+        }
+    }
+private:
+    void tick(typename std::iterator_traits<iter_type>::reference x, float variableDelay) {
         auto delayInput = x + kFeedBack * delayLine[kTap];
-        auto variableDelay = mMod() * kDepth + kTap;
         int index = static_cast<int>(variableDelay);
         auto fracComp = 1 - (variableDelay - index);
         //linear
@@ -54,12 +70,7 @@ public:
         delayLine.push(delayInput);
         x = interpolated * kFeedForward + kBlend * delayInput;
     }
-    void operator () (iter_type begin, iter_type end) {
-        for (; begin != end; ++begin) {
-            operator()(*begin);
-        }
-    }
-private:
+
     // Weights
     const float kBlend;
     const float kFeedForward;
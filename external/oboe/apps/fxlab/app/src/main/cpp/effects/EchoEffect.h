@@ -23,9 +23,9 @@
 template <class iter_type>
 class EchoEffect: public DelayLineEffect<iter_type> {
 public:
-    EchoEffect(float feedback, float delay_ms):
+    EchoEffect(float feedback, float delay_ms, int sampleRate = SAMPLE_RATE):
         DelayLineEffect<iter_type> {1, 0, feedback,
-            static_cast<int>(delay_ms * SAMPLE_RATE / 1000),
+            static_cast<int>(delay_ms * sampleRate / 1000),
             0,
             std::function<float()>{[](){return 0.0;}}}
     {}
@@ -22,8 +22,8 @@ template<class iter_type>
 class FlangerEffect : public DelayLineEffect<iter_type> {
 public:
     // feedback should be 0.7071
-    FlangerEffect(float depth_ms, float frequency, float feedback):
-        DelayLineEffect<iter_type>(feedback, feedback, feedback, 0, depth_ms * SAMPLE_RATE / 1000,
-                SineWave {frequency, 1, SAMPLE_RATE})  { }
+    FlangerEffect(float depth_ms, float frequency, float feedback, int sampleRate = SAMPLE_RATE):
+        DelayLineEffect<iter_type>(feedback, feedback, feedback, 0, depth_ms * sampleRate / 1000,
+                SineWave {frequency, 1, sampleRate})  { }
 };
 #endif //ANDROID_FXLAB_FLANGEREFFECT_H
@@ -22,13 +22,13 @@
 
 class TremoloEffect {
 public:
-    TremoloEffect(float frequency, float height):
+    TremoloEffect(float frequency, float height, int sampleRate = SAMPLE_RATE):
         kCenter(1 - height),
-        kSignal {SineWave{frequency, height, SAMPLE_RATE}} { }
+        mSignal {frequency, height, sampleRate} { }
 
     template <class numeric_type>
     void operator () (numeric_type &x) {
-        x  = x * (kSignal() + kCenter);
+        x  = x * (mSignal() + kCenter);
     }
     template <class iter_type>
     void  operator () (iter_type begin, iter_type end) {
@@ -38,6 +38,6 @@ public:
     }
 private:
     const float kCenter;
-    std::function<float()> kSignal;
+    SineWave mSignal;
 };
 #endif //ANDROID_FXLAB_TREMOLOEFFECT_H
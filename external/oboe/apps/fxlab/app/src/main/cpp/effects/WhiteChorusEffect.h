@@ -22,11 +22,13 @@
 template <class iter_type>
 class WhiteChorusEffect : public DelayLineEffect<iter_type> {
 public:
-    WhiteChorusEffect(float depth_ms, float delay_ms, float noise_pass):
+    // Instances with different seeds wander independently (e.g. left and right)
+    WhiteChorusEffect(float depth_ms, float delay_ms, float noise_pass,
+                      int sampleRate = SAMPLE_RATE, uint32_t seed = 1):
         DelayLineEffect<iter_type> {0.7071, 1, -0.7071f,
-            static_cast<int>(delay_ms * SAMPLE_RATE / 1000),
-            static_cast<int>(depth_ms * SAMPLE_RATE / 1000),
-            std::function<float()>{WhiteNoise{static_cast<int>(4800 * noise_pass)}}}
+            static_cast<int>(delay_ms * sampleRate / 1000),
+            static_cast<int>(depth_ms * sampleRate / 1000),
+            std::function<float()>{WhiteNoise{static_cast<int>(sampleRate / 10 * noise_pass), seed}}}
     {}
 };
 #endif //ANDROID_FXLAB_WHITECHORUSEFFECT_H
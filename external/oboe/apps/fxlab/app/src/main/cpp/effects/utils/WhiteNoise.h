@@ -15,16 +15,24 @@
  */
 #ifndef ANDROID_FXLAB_WHITENOISE_H
 #define ANDROID_FXLAB_WHITENOISE_H
+
+#include <cstdint>
+
+// Band-limited noise: a new random target every kScale samples, linearly
+// interpolated in between. Each instance has its own generator state, so it
+// is safe on an audio thread (no rand(), no shared statics).
 class WhiteNoise  {
     const int kScale;
+    uint32_t mSeed;
+    int counter = 0;
+    float r_0 = 0, r_1 = 0;
 public:
-    WhiteNoise(int scale): kScale(scale)  {}
+    WhiteNoise(int scale, uint32_t seed = 1): kScale(scale > 0 ? scale : 1), mSeed(seed)  {}
     float operator() () {
-        static int counter = 0;
-        static float r_0, r_1 = 0;
         if (counter == 0) {
             r_0 = r_1;
-            r_1 = (static_cast <float> (rand()) / static_cast <float> (RAND_MAX)) * 2 - 1;
+            mSeed = mSeed * 1664525u + 1013904223u;
+            r_1 = static_cast<float>(mSeed >> 8) * (2.0f / 16777216.0f) - 1;
         }
         float ret = r_0 + counter * (r_1 - r_0) / kScale;
         if (++counter == kScale) counter = 0;
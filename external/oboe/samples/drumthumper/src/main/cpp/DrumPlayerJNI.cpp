@@ -66,6 +66,16 @@ JNIEXPORT void JNICALL Java_com_plausiblesoftware_drumthumper_DrumPlayer_teardow
     sDTPlayer.teardownAudioStream();
 }
 
+/**
+ * Native (JNI) implementation of DrumPlayer.setResampleCacheDirNative()
+ */
+JNIEXPORT void JNICALL Java_com_plausiblesoftware_drumthumper_DrumPlayer_setResampleCacheDirNative(
+        JNIEnv* env, jobject, jstring cacheDir) {
+    const char* path = env->GetStringUTFChars(cacheDir, nullptr);
+    sDTPlayer.setResampleCacheDir(path);
+    env->ReleaseStringUTFChars(cacheDir, path);
+}
+
 /**
  * Native (JNI) implementation of DrumPlayer.allocSampleDataNative()
  */
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include "ResampleCache.h"
+
+namespace iolib {
+
+namespace {
+
+constexpr char kMagic[4] = {'I', 'O', 'R', 'S'};
+
+struct CacheFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t sourceHash;
+    int32_t  numSourceSamples;
+    int32_t  channelCount;
+    int32_t  sourceRate;
+    int32_t  targetRate;
+    int32_t  quality;
+    int32_t  numSamples;        // resampled samples following the header
+};
+// The samples follow the header directly and are read in place
+static_assert(sizeof(CacheFileHeader) % sizeof(float) == 0, "samples must stay aligned");
+
+CacheFileHeader makeHeader(const ResampleCache::Key &key, int32_t numSamples) {
+    CacheFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = ResampleCache::kVersion;
+    header.sourceHash = key.sourceHash;
+    header.numSourceSamples = key.numSourceSamples;
+    header.channelCount = key.channelCount;
+    header.sourceRate = key.sourceRate;
+    header.targetRate = key.targetRate;
+    header.quality = key.quality;
+    header.numSamples = numSamples;
+    return header;
+}
+
+inline uint64_t mix(uint64_t h, uint64_t word) {
+    h = (h ^ word) * 0xff51afd7ed558ccdULL;
+    return h ^ (h >> 32);
+}
+
+} // namespace
+
+ResampleCache::ResampleCache(const char *directory) : mDirectory(directory) {
+    if (!mDirectory.empty() && mDirectory.back() != '/') {
+        mDirectory += '/';
+    }
+}
+
+uint64_t ResampleCache::hashSamples(const float *data, int32_t numSamples) {
+    // Four independent lanes keep the multiplies pipelined; the hash runs at memory speed
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    const size_t numBytes = static_cast<size_t>(numSamples) * sizeof(float);
+    uint64_t lanes[4] = {0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL,
+                         0x165667b19e3779f9ULL, 0x27d4eb2f165667c5ULL};
+    size_t offset = 0;
+    for (; offset + 32 <= numBytes; offset += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word;
+            std::memcpy(&word, bytes + offset + lane * 8, 8);
+            lanes[lane] = mix(lanes[lane], word);
+        }
+    }
+    uint64_t hash = mix(lanes[0], numBytes);
+    for (int lane = 1; lane < 4; lane++) {
+        hash = mix(hash, lanes[lane]);
+    }
+    for (; offset < numBytes; offset += 4) {
+        uint32_t word;
+        std::memcpy(&word, bytes + offset, 4);
+        hash = mix(hash, word);
+    }
+    return mix(hash, 0);
+}
+
+std::string ResampleCache::getPath(const Key &key) const {
+    char name[64];
+    snprintf(name, sizeof(name), "%016" PRIx64 "-%d-%d.resampled",
+             key.sourceHash, key.sourceRate, key.targetRate);
+    return mDirectory + name;
+}
+
+std::unique_ptr<parselib::MappedFile> ResampleCache::load(const Key &key, const float **data,
+                                                          int32_t *numSamples) const {
+    std::unique_ptr<parselib::MappedFile> file(new parselib::MappedFile(getPath(key).c_str()));
+    if (!file->isValid() || file->getSize() < (int32_t)sizeof(CacheFileHeader)) {
+        return nullptr;
+    }
+
+    CacheFileHeader header;
+    std::memcpy(&header, file->getData(), sizeof(header));
+    const CacheFileHeader expected = makeHeader(key, header.numSamples);
+    if (std::memcmp(&header, &expected, sizeof(header)) != 0 || header.numSamples < 0 ||
+            (int64_t)file->getSize() !=
+            (int64_t)sizeof(header) + (int64_t)header.numSamples * (int64_t)sizeof(float)) {
+        return nullptr;
+    }
+
+    *data = reinterpret_cast<const float *>(file->getData() + sizeof(header));
+    *numSamples = header.numSamples;
+    return file;
+}
+
+bool ResampleCache::store(const Key &key, const float *data, int32_t numSamples) const {
+    const std::string path = getPath(key);
+    const std::string tempPath = path + ".tmp" + std::to_string(getpid());
+
+    FILE *file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const CacheFileHeader header = makeHeader(key, numSamples);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(data, sizeof(float), numSamples, file) == (size_t)numSamples;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace iolib
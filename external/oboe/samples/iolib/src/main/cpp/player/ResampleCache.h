@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _PLAYER_RESAMPLECACHE_H_
+#define _PLAYER_RESAMPLECACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <stream/MappedFile.h>
+
+namespace iolib {
+
+/**
+ * Persists the float data produced by SampleBuffer::resampleData() so the next launch on
+ * the same device maps it instead of converting again.
+ *
+ * Entries are keyed by a hash of the source samples and the conversion parameters. Each
+ * file holds a header (magic, format version, the full key) followed by the samples; an
+ * entry whose header does not match the requested key exactly, including one written by
+ * another format version, is treated as a miss and overwritten by the next store().
+ */
+class ResampleCache {
+public:
+    // Bump whenever the file layout or the resampler output changes
+    static constexpr uint32_t kVersion = 1;
+
+    struct Key {
+        uint64_t sourceHash;        // hashSamples() of the source data
+        int32_t  numSourceSamples;
+        int32_t  channelCount;
+        int32_t  sourceRate;
+        int32_t  targetRate;
+        int32_t  quality;           // MultiChannelResampler::Quality
+    };
+
+    /**
+     * @param directory an existing, writable directory (e.g. the app's cache dir)
+     */
+    explicit ResampleCache(const char *directory);
+
+    /**
+     * A fast non-cryptographic 64-bit hash of the sample data, for use as Key::sourceHash
+     */
+    static uint64_t hashSamples(const float *data, int32_t numSamples);
+
+    /**
+     * Maps the entry for key, read-only.
+     * @return the mapping, or nullptr on a miss. On success *data points at the cached
+     * samples inside the mapping and *numSamples holds their count.
+     */
+    std::unique_ptr<parselib::MappedFile> load(const Key &key, const float **data,
+                                               int32_t *numSamples) const;
+
+    /**
+     * Writes (or replaces) the entry for key. The file is written under a temporary name
+     * and renamed into place, so a crash mid-write never leaves a truncated entry.
+     */
+    bool store(const Key &key, const float *data, int32_t numSamples) const;
+
+    std::string getPath(const Key &key) const;
+
+private:
+    std::string mDirectory;
+};
+
+} // namespace iolib
+
+#endif // _PLAYER_RESAMPLECACHE_H_
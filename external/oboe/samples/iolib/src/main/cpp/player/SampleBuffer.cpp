@@ -14,9 +14,15 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "SampleBuffer.h"
+#include "ResampleCache.h"
 
 // Resampler Includes
+#include <resampler/IntegerRatio.h>
 #include <resampler/MultiChannelResampler.h>
 
 #include "wav/WavStreamReader.h"
@@ -26,6 +32,8 @@ using namespace RESAMPLER_OUTER_NAMESPACE::resampler;
 namespace iolib {
 
 void SampleBuffer::loadSampleData(parselib::WavStreamReader* reader) {
+    unloadSampleData();
+
     mAudioProperties.channelCount = reader->getNumChannels();
     mAudioProperties.sampleRate = reader->getSampleRate();
 
@@ -38,81 +46,189 @@ void SampleBuffer::loadSampleData(parselib::WavStreamReader* reader) {
 }
 
 void SampleBuffer::unloadSampleData() {
-    if (mSampleData != nullptr) {
+    if (mMappedData) {
+        mMappedData.reset();
+    } else if (mSampleData != nullptr) {
         delete[] mSampleData;
-        mSampleData = nullptr;
     }
+    mSampleData = nullptr;
     mNumSamples = 0;
 }
 
-class ResampleBlock {
-public:
-    int32_t mSampleRate;
-    float*  mBuffer;
-    int32_t mNumSamples;
+namespace {
+
+constexpr MultiChannelResampler::Quality kQuality = MultiChannelResampler::Quality::Medium;
+
+// Input frames per parallel task, rounded down to whole resampler periods
+constexpr int32_t kChunkFrames = 64 * 1024;
+
+// Filter length of the highest quality; history needed before a chunk
+constexpr int32_t kMaxTaps = 32;
+
+struct ResampleJob {
+    SampleBuffer*   buffer;
+    const float*    input;
+    int32_t         numInputFrames;
+    int32_t         channelCount;
+    int32_t         inputRate;
+    int32_t         outputRate;
+    // The resampler repeats its phase every periodIn input and periodOut output frames
+    int32_t         periodIn;
+    int32_t         periodOut;
+    float*          output;
+    int32_t         numOutputFrames;
+    ResampleCache::Key key;
+};
+
+struct ResampleChunk {
+    const ResampleJob* job;
+    int32_t startFrame;
+    int32_t numFrames;
 };
 
-void resampleData(const ResampleBlock& input, ResampleBlock* output, int numChannels) {
-    // Calculate output buffer size
-    double temp =
-            ((double)input.mNumSamples * (double)output->mSampleRate) / (double)input.mSampleRate;
-
-    // round up
-    int32_t numOutFramesAllocated = (int32_t)(temp + 0.5);
-    // We iterate thousands of times through the loop. Roundoff error could accumulate
-    // so add a few more frames for padding
-    numOutFramesAllocated += 8;
-
-    MultiChannelResampler *resampler = MultiChannelResampler::make(
-            numChannels, // channel count
-            input.mSampleRate, // input sampleRate
-            output->mSampleRate, // output sampleRate
-            MultiChannelResampler::Quality::Medium); // conversion quality
-
-    float *inputBuffer = input.mBuffer;;     // multi-channel buffer to be consumed
-    float *outputBuffer = new float[numOutFramesAllocated];    // multi-channel buffer to be filled
-    output->mBuffer = outputBuffer;
-
-    int numOutputSamples = 0;
-    int inputSamplesLeft = input.mNumSamples;
-    while ((inputSamplesLeft > 0) && (numOutputSamples < numOutFramesAllocated)) {
-        if(resampler->isWriteNeeded()) {
-            resampler->writeNextFrame(inputBuffer);
-            inputBuffer += numChannels;
-            inputSamplesLeft -= numChannels;
+/*
+ * Converts one chunk of a job into its slot in the job's output.
+ *
+ * The resampler's state is a function of its integer phase and its last numTaps
+ * input frames. Chunks start on a period boundary, where the phase matches that of a
+ * serial conversion, and the filter history is primed by running whole periods of the
+ * preceding input (their output is discarded), so chunk seams are bit exact.
+ */
+void resampleChunk(const ResampleChunk& chunk) {
+    const ResampleJob& job = *chunk.job;
+    std::unique_ptr<MultiChannelResampler> resampler(MultiChannelResampler::make(
+            job.channelCount, job.inputRate, job.outputRate, kQuality));
+
+    const int32_t warmupPeriods = (kMaxTaps + job.periodIn - 1) / job.periodIn;
+    int32_t inFrame = std::max(0, chunk.startFrame - warmupPeriods * job.periodIn);
+    int64_t outFrame = (int64_t)inFrame / job.periodIn * job.periodOut;
+    const int64_t firstOutFrame = (int64_t)chunk.startFrame / job.periodIn * job.periodOut;
+    const int32_t endFrame = chunk.startFrame + chunk.numFrames;
+
+    std::vector<float> discard(job.channelCount);
+    while (true) {
+        if (resampler->isWriteNeeded()) {
+            if (inFrame == endFrame) {
+                break;
+            }
+            resampler->writeNextFrame(job.input + (size_t)inFrame * job.channelCount);
+            inFrame++;
         } else {
-            resampler->readNextFrame(outputBuffer);
-            outputBuffer += numChannels;
-            numOutputSamples += numChannels;
+            float* frame = outFrame >= firstOutFrame
+                    ? job.output + (size_t)outFrame * job.channelCount
+                    : discard.data();
+            resampler->readNextFrame(frame);
+            outFrame++;
         }
     }
-    output->mNumSamples = numOutputSamples;
-
-    delete resampler;
 }
 
-void SampleBuffer::resampleData(int sampleRate) {
-    if (mAudioProperties.sampleRate == sampleRate) {
-        // nothing to do
-        return;
+// Runs task(0) .. task(numTasks - 1) on up to one thread per core, the caller included
+template <typename Task>
+void runParallel(size_t numTasks, const Task& task) {
+    std::atomic<size_t> nextTask(0);
+    auto worker = [&]() {
+        for (size_t index; (index = nextTask.fetch_add(1)) < numTasks;) {
+            task(index);
+        }
+    };
+
+    const size_t numThreads = std::min<size_t>(
+            numTasks, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (size_t thread = 1; thread < numThreads; thread++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
     }
+}
 
-    ResampleBlock inputBlock;
-    inputBlock.mBuffer = mSampleData;
-    inputBlock.mNumSamples = mNumSamples;
-    inputBlock.mSampleRate = mAudioProperties.sampleRate;
+} // namespace
 
-    ResampleBlock outputBlock;
-    outputBlock.mSampleRate = sampleRate;
-    iolib::resampleData(inputBlock, &outputBlock, mAudioProperties.channelCount);
+void SampleBuffer::resampleData(int sampleRate, const ResampleCache* cache) {
+    resampleAll({this}, sampleRate, cache);
+}
+
+void SampleBuffer::resampleAll(const std::vector<SampleBuffer*>& buffers, int sampleRate,
+                               const ResampleCache* cache) {
+    std::vector<ResampleJob> jobs;
+    jobs.reserve(buffers.size()); // chunks point into jobs
+
+    for (SampleBuffer* buffer : buffers) {
+        const AudioProperties& properties = buffer->mAudioProperties;
+        if (properties.sampleRate == sampleRate || buffer->mSampleData == nullptr ||
+                properties.channelCount <= 0) {
+            // nothing to do
+            continue;
+        }
+
+        ResampleJob job = {};
+        job.buffer = buffer;
+        job.input = buffer->mSampleData;
+        job.channelCount = properties.channelCount;
+        job.numInputFrames = buffer->mNumSamples / properties.channelCount;
+        job.inputRate = properties.sampleRate;
+        job.outputRate = sampleRate;
+
+        if (cache != nullptr) {
+            job.key.sourceHash = ResampleCache::hashSamples(job.input, buffer->mNumSamples);
+            job.key.numSourceSamples = buffer->mNumSamples;
+            job.key.channelCount = job.channelCount;
+            job.key.sourceRate = job.inputRate;
+            job.key.targetRate = sampleRate;
+            job.key.quality = (int32_t)kQuality;
+
+            const float* cachedData;
+            int32_t numCachedSamples;
+            std::unique_ptr<parselib::MappedFile> mapping =
+                    cache->load(job.key, &cachedData, &numCachedSamples);
+            if (mapping) {
+                buffer->unloadSampleData();
+                // The mapping is read-only; SampleSources only ever read it
+                buffer->mSampleData = const_cast<float*>(cachedData);
+                buffer->mNumSamples = numCachedSamples;
+                buffer->mMappedData = std::move(mapping);
+                buffer->mAudioProperties.sampleRate = sampleRate;
+                continue;
+            }
+        }
+
+        IntegerRatio ratio(job.inputRate, job.outputRate);
+        ratio.reduce();
+        job.periodIn = ratio.getNumerator();
+        job.periodOut = ratio.getDenominator();
+        // Every input frame is consumed: the output ends where the next write would be
+        job.numOutputFrames = (int32_t)(((int64_t)job.numInputFrames * job.periodOut
+                + job.periodIn - 1) / job.periodIn);
+        job.output = new float[(size_t)job.numOutputFrames * job.channelCount];
+        jobs.push_back(job);
+    }
+
+    std::vector<ResampleChunk> chunks;
+    for (const ResampleJob& job : jobs) {
+        const int32_t chunkFrames =
+                std::max(job.periodIn, kChunkFrames / job.periodIn * job.periodIn);
+        for (int32_t start = 0; start < job.numInputFrames; start += chunkFrames) {
+            chunks.push_back({&job, start, std::min(chunkFrames, job.numInputFrames - start)});
+        }
+    }
+    runParallel(chunks.size(), [&chunks](size_t index) { resampleChunk(chunks[index]); });
 
-    // delete previous samples
-    delete[] mSampleData;
+    for (const ResampleJob& job : jobs) {
+        SampleBuffer* buffer = job.buffer;
+        const int32_t numSamples = job.numOutputFrames * job.channelCount;
+        if (cache != nullptr) {
+            cache->store(job.key, job.output, numSamples);
+        }
 
-    // install the resampled data
-    mSampleData = outputBlock.mBuffer;
-    mNumSamples = outputBlock.mNumSamples;
-    mAudioProperties.sampleRate = outputBlock.mSampleRate;
+        // install the resampled data
+        buffer->unloadSampleData();
+        buffer->mSampleData = job.output;
+        buffer->mNumSamples = numSamples;
+        buffer->mAudioProperties.sampleRate = sampleRate;
+    }
 }
 
 } // namespace iolib
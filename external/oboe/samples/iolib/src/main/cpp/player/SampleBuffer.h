@@ -17,10 +17,16 @@
 #ifndef _PLAYER_SAMPLEBUFFER_
 #define _PLAYER_SAMPLEBUFFER_
 
+#include <memory>
+#include <vector>
+
+#include <stream/MappedFile.h>
 #include <wav/WavStreamReader.h>
 
 namespace iolib {
 
+class ResampleCache;
+
 /*
  * Defines the relevant properties of the audio data being sourced.
  */
@@ -31,14 +37,27 @@ struct AudioProperties {
 
 class SampleBuffer {
 public:
-    SampleBuffer() : mNumSamples(0) {};
+    SampleBuffer() : mSampleData(nullptr), mNumSamples(0) {};
     ~SampleBuffer() { unloadSampleData(); }
 
     // Data load/unload
     void loadSampleData(parselib::WavStreamReader* reader);
     void unloadSampleData();
 
-    void resampleData(int sampleRate);
+    /**
+     * Converts the sample data to sampleRate. Long buffers are split into chunks that are
+     * converted in parallel; the result is identical to converting serially.
+     * If cache is given, a previously stored conversion of the same data is mapped
+     * instead, and a fresh conversion is stored for next time.
+     */
+    void resampleData(int sampleRate, const ResampleCache* cache = nullptr);
+
+    /**
+     * resampleData() for a whole set of buffers at once: the chunks of every buffer
+     * share one pool of worker threads, so small buffers convert side by side.
+     */
+    static void resampleAll(const std::vector<SampleBuffer*>& buffers, int sampleRate,
+                            const ResampleCache* cache = nullptr);
 
     virtual AudioProperties getProperties() const { return mAudioProperties; }
 
@@ -50,6 +69,9 @@ protected:
 
     float*  mSampleData;
     int32_t mNumSamples;
+
+    // Set when mSampleData points into a (read-only) ResampleCache entry
+    std::unique_ptr<parselib::MappedFile> mMappedData;
 };
 
 }
@@ -116,6 +116,8 @@ bool SimpleMultiPlayer::openStream() {
 }
 
 bool SimpleMultiPlayer::startStream() {
+    resamplePendingBuffers();
+
     int tryCount = 0;
     while (tryCount < 3) {
         bool wasOpenSuccessful = true;
@@ -161,13 +163,31 @@ void SimpleMultiPlayer::teardownAudioStream() {
 }
 
 void SimpleMultiPlayer::addSampleSource(SampleSource* source, SampleBuffer* buffer) {
-    buffer->resampleData(mSampleRate);
+    if (mAudioStream && mAudioStream->getState() == StreamState::Started) {
+        buffer->resampleData(mSampleRate, mResampleCache.get());
+    } else {
+        mPendingBuffers.push_back(buffer);
+    }
 
     mSampleBuffers.push_back(buffer);
     mSampleSources.push_back(source);
     mNumSampleBuffers++;
 }
 
+void SimpleMultiPlayer::resamplePendingBuffers() {
+    if (mPendingBuffers.empty()) {
+        return;
+    }
+    // One-shots are mostly a single chunk each, so convert the whole kit together to
+    // spread it across the worker threads
+    SampleBuffer::resampleAll(mPendingBuffers, mSampleRate, mResampleCache.get());
+    mPendingBuffers.clear();
+}
+
+void SimpleMultiPlayer::setResampleCacheDir(const char* cacheDir) {
+    mResampleCache.reset(new ResampleCache(cacheDir));
+}
+
 void SimpleMultiPlayer::unloadSampleData() {
     __android_log_print(ANDROID_LOG_INFO, TAG, "unloadSampleData()");
     resetAll();
@@ -179,6 +199,7 @@ void SimpleMultiPlayer::unloadSampleData() {
 
     mSampleBuffers.clear();
     mSampleSources.clear();
+    mPendingBuffers.clear();
 
     mNumSampleBuffers = 0;
 }
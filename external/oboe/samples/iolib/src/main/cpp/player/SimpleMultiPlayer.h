@@ -22,6 +22,7 @@
 #include <oboe/Oboe.h>
 
 #include "OneShotSampleSource.h"
+#include "ResampleCache.h"
 #include "SampleBuffer.h"
 
 namespace iolib {
@@ -47,8 +48,18 @@ public:
      * Transfers ownership of those objects so that they can be deleted/unloaded.
      * The indexes associated with each source channel is the order in which they
      * are added.
+     * Buffers added before startStream() are converted to the device rate there, all in
+     * one SampleBuffer::resampleAll() batch; once the stream is started, each buffer is
+     * converted as it is added.
      */
     void addSampleSource(SampleSource* source, SampleBuffer* buffer);
+
+    /**
+     * Keeps sample data resampled to the device rate in cacheDir, so that sources added
+     * on a later run with the same data and device rate load without converting.
+     * Call before addSampleSource().
+     */
+    void setResampleCacheDir(const char* cacheDir);
     /**
      * Deallocates and deletes all added source/buffer (see addSampleSource()).
      */
@@ -106,11 +117,17 @@ private:
     int32_t mNumSampleBuffers;
     std::vector<SampleBuffer*>  mSampleBuffers;
     std::vector<SampleSource*>  mSampleSources;
+    // Added but not yet converted to mSampleRate
+    std::vector<SampleBuffer*>  mPendingBuffers;
+
+    std::unique_ptr<ResampleCache> mResampleCache;
 
     bool    mOutputReset;
 
     std::shared_ptr<MyDataCallback> mDataCallback;
     std::shared_ptr<MyErrorCallback> mErrorCallback;
+
+    void resamplePendingBuffers();
 };
 
 }
@@ -56,6 +56,17 @@ public:
      * Sets the read position of the stream to the 0 or positive position.
      */
     virtual void setPos(int32_t pos) = 0;
+
+    /**
+     * For streams backed by memory: returns a pointer to the bytes at the read position
+     * and sets numBytesAvailable to how many can be read from it, so callers can decode
+     * in place instead of copying through read(). DOES NOT advance the read position.
+     * Returns: nullptr (the default) if the stream has no such buffer.
+     */
+    virtual const unsigned char *peekDirect(int32_t *numBytesAvailable) {
+        *numBytesAvailable = 0;
+        return nullptr;
+    }
 };
 
 } // namespace parselib
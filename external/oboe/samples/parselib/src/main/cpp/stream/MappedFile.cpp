@@ -0,0 +1,51 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.h"
+
+namespace parselib {
+
+MappedFile::MappedFile(const char *path) : mData(nullptr), mSize(0) {
+    int fh = ::open(path, O_RDONLY);
+    if (fh < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (::fstat(fh, &info) == 0 && info.st_size > 0 && info.st_size <= INT32_MAX) {
+        void *data = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fh, 0);
+        if (data != MAP_FAILED) {
+            // Samples are decoded front to back: let the kernel read ahead
+            ::madvise(data, info.st_size, MADV_SEQUENTIAL);
+            mData = static_cast<unsigned char *>(data);
+            mSize = static_cast<int32_t>(info.st_size);
+        }
+    }
+    ::close(fh); // the mapping keeps the file alive
+}
+
+MappedFile::~MappedFile() {
+    if (mData != nullptr) {
+        ::munmap(mData, mSize);
+    }
+}
+
+} // namespace parselib
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IO_STREAM_MAPPEDFILE_H_
+#define _IO_STREAM_MAPPEDFILE_H_
+
+#include <cstdint>
+
+namespace parselib {
+
+/**
+ * Maps a file read-only for its lifetime. Wrap it in a MemInputStream to parse it:
+ * WavStreamReader then converts samples straight out of the page cache with no
+ * intermediate copy.
+ *
+ *     MappedFile file(path);
+ *     MemInputStream stream(file.getData(), file.getSize());
+ *
+ * Files over 2 GB are not mapped (MemInputStream positions are 32-bit).
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const char *path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isValid() const { return mData != nullptr; }
+
+    unsigned char *getData() const { return mData; }
+
+    int32_t getSize() const { return mSize; }
+
+private:
+    unsigned char *mData;
+    int32_t mSize;
+};
+
+} // namespace parselib
+
+#endif // _IO_STREAM_MAPPEDFILE_H_
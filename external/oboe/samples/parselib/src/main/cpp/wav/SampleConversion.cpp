@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+
+#include "SampleConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARSELIB_HAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PARSELIB_HAVE_NEON 1
+#endif
+
+namespace parselib {
+
+// Every integer format is scaled as if left-justified in 32 bits, so one
+// power-of-two factor covers them and the conversion stays exact
+static constexpr float kInverseScale32 = 1.0f / (float) 0x80000000;
+static constexpr float kInverseScale16 = 1.0f / (float) 0x8000;
+
+static inline int32_t loadPCM24(const uint8_t *p) {
+    return (int32_t) (((uint32_t) p[0] << 8) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 24));
+}
+
+static inline int32_t loadPCM32(const uint8_t *p) {
+    int32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline int16_t loadPCM16(const uint8_t *p) {
+    int16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void convertPCM8ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    // PCM8 is unsigned, so we need to make it signed before scaling/converting
+    static constexpr float kSampleFullScale = (float) 0x80;
+    static constexpr float kInverseScale = 1.0f / kSampleFullScale;
+    for (int32_t i = 0; i < numSamples; i++) {
+        dst[i] = ((float) src[i] - kSampleFullScale) * kInverseScale;
+    }
+}
+
+void convertPCM16ToFloatScalar(const uint8_t *src, float *dst, int32_t numSamples) {
+    for (int32_t i = 0; i < numSamples; i++) {
+        dst[i] = (float) loadPCM16(src + 2 * i) * kInverseScale16;
+    }
+}
+
+void convertPCM24ToFloatScalar(const uint8_t *src, float *dst, int32_t numSamples) {
+    for (int32_t i = 0; i < numSamples; i++) {
+        dst[i] = (float) loadPCM24(src + 3 * i) * kInverseScale32;
+    }
+}
+
+void convertPCM32ToFloatScalar(const uint8_t *src, float *dst, int32_t numSamples) {
+    for (int32_t i = 0; i < numSamples; i++) {
+        dst[i] = (float) loadPCM32(src + 4 * i) * kInverseScale32;
+    }
+}
+
+void convertFloat32ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    // Turns out that WAV Float32 is just Android floats
+    memcpy(dst, src, numSamples * sizeof(float));
+}
+
+#if PARSELIB_HAVE_SSE2
+
+void convertPCM16ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    const __m128 scale = _mm_set1_ps(kInverseScale32);
+    const __m128i zero = _mm_setzero_si128();
+    int32_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m128i pcm = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i));
+        // Interleaving zeros below each sample left-justifies it in 32 bits
+        const __m128i lo = _mm_unpacklo_epi16(zero, pcm);
+        const __m128i hi = _mm_unpackhi_epi16(zero, pcm);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    convertPCM16ToFloatScalar(src + 2 * i, dst + i, numSamples - i);
+}
+
+void convertPCM24ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    const __m128 scale = _mm_set1_ps(kInverseScale32);
+    int32_t i = 0;
+    // Each step converts 4 samples (12 bytes) but loads 16, so stop while
+    // the whole load is still inside the source
+    for (; i + 6 <= numSamples; i += 4) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * i));
+        // Gather samples 0..3 (byte offsets 0, 3, 6, 9) into the low three
+        // bytes of each lane, then shift up so the sign lands in bit 31
+        const __m128i s01 = _mm_unpacklo_epi32(bytes, _mm_srli_si128(bytes, 3));
+        const __m128i s23 = _mm_unpacklo_epi32(_mm_srli_si128(bytes, 6),
+                                               _mm_srli_si128(bytes, 9));
+        const __m128i samples = _mm_slli_epi32(_mm_unpacklo_epi64(s01, s23), 8);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), scale));
+    }
+    convertPCM24ToFloatScalar(src + 3 * i, dst + i, numSamples - i);
+}
+
+void convertPCM32ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    const __m128 scale = _mm_set1_ps(kInverseScale32);
+    int32_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * i + 16));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(a), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), scale));
+    }
+    convertPCM32ToFloatScalar(src + 4 * i, dst + i, numSamples - i);
+}
+
+#elif PARSELIB_HAVE_NEON
+
+void convertPCM16ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    int32_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        // Byte loads have no alignment requirement
+        const int16x8_t pcm = vreinterpretq_s16_u8(vld1q_u8(src + 2 * i));
+        // Fixed-point convert with 15 fraction bits == multiply by 2^-15
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(pcm)), 15));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(pcm)), 15));
+    }
+    convertPCM16ToFloatScalar(src + 2 * i, dst + i, numSamples - i);
+}
+
+void convertPCM24ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    int32_t i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        // De-interleave 16 samples into low, middle and high bytes
+        const uint8x16x3_t b = vld3q_u8(src + 3 * i);
+        // Rebuild each sample as bytes [0, lo, mid, hi]: left-justified
+        const uint8x16x2_t zeroLo = vzipq_u8(zero, b.val[0]);
+        const uint8x16x2_t midHi = vzipq_u8(b.val[1], b.val[2]);
+        const uint16x8x2_t first = vzipq_u16(vreinterpretq_u16_u8(zeroLo.val[0]),
+                                             vreinterpretq_u16_u8(midHi.val[0]));
+        const uint16x8x2_t second = vzipq_u16(vreinterpretq_u16_u8(zeroLo.val[1]),
+                                              vreinterpretq_u16_u8(midHi.val[1]));
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vreinterpretq_s32_u16(first.val[0]), 31));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vreinterpretq_s32_u16(first.val[1]), 31));
+        vst1q_f32(dst + i + 8, vcvtq_n_f32_s32(vreinterpretq_s32_u16(second.val[0]), 31));
+        vst1q_f32(dst + i + 12, vcvtq_n_f32_s32(vreinterpretq_s32_u16(second.val[1]), 31));
+    }
+    convertPCM24ToFloatScalar(src + 3 * i, dst + i, numSamples - i);
+}
+
+void convertPCM32ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    int32_t i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const int32x4_t a = vreinterpretq_s32_u8(vld1q_u8(src + 4 * i));
+        const int32x4_t b = vreinterpretq_s32_u8(vld1q_u8(src + 4 * i + 16));
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(a, 31));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(b, 31));
+    }
+    convertPCM32ToFloatScalar(src + 4 * i, dst + i, numSamples - i);
+}
+
+#else
+
+void convertPCM16ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    convertPCM16ToFloatScalar(src, dst, numSamples);
+}
+
+void convertPCM24ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    convertPCM24ToFloatScalar(src, dst, numSamples);
+}
+
+void convertPCM32ToFloat(const uint8_t *src, float *dst, int32_t numSamples) {
+    convertPCM32ToFloatScalar(src, dst, numSamples);
+}
+
+#endif
+
+} // namespace parselib
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IO_WAV_SAMPLECONVERSION_H_
+#define _IO_WAV_SAMPLECONVERSION_H_
+
+#include <cstdint>
+
+namespace parselib {
+
+/**
+ * Each function converts numSamples interleaved samples from packed
+ * little-endian WAV data to floats in [-1, 1). The source may have any
+ * alignment (data chunks in a memory-mapped file rarely start on a vector
+ * boundary). Uses SSE2 on x86 and NEON on ARM, with a scalar tail.
+ */
+void convertPCM8ToFloat(const uint8_t *src, float *dst, int32_t numSamples);
+void convertPCM16ToFloat(const uint8_t *src, float *dst, int32_t numSamples);
+void convertPCM24ToFloat(const uint8_t *src, float *dst, int32_t numSamples);
+void convertPCM32ToFloat(const uint8_t *src, float *dst, int32_t numSamples);
+void convertFloat32ToFloat(const uint8_t *src, float *dst, int32_t numSamples);
+
+/**
+ * Plain per-sample versions: the reference the SIMD paths must match
+ * bit-for-bit, and the baseline for benchmarks.
+ */
+void convertPCM16ToFloatScalar(const uint8_t *src, float *dst, int32_t numSamples);
+void convertPCM24ToFloatScalar(const uint8_t *src, float *dst, int32_t numSamples);
+void convertPCM32ToFloatScalar(const uint8_t *src, float *dst, int32_t numSamples);
+
+} // namespace parselib
+
+#endif // _IO_WAV_SAMPLECONVERSION_H_
@@ -13,13 +13,17 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#ifdef __ANDROID__
 #include <android/log.h>
+#endif
 
 #include "stream/InputStream.h"
 
 #include "WavFmtChunkHeader.h"
 
+#ifdef __ANDROID__
 static const char *TAG = "WavFmtChunkHeader";
+#endif
 
 namespace parselib {
 
@@ -16,11 +16,18 @@
 #include <algorithm>
 #include <string.h>
 
+#ifdef __ANDROID__
 #include <android/log.h>
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, TAG, __VA_ARGS__)
+#else
+// Host builds (tests, benchmarks) have no logcat
+#define LOGI(...) ((void) TAG)
+#endif
 
 #include "stream/InputStream.h"
 
 #include "AudioEncoding.h"
+#include "SampleConversion.h"
 #include "WavRIFFChunkHeader.h"
 #include "WavFmtChunkHeader.h"
 #include "WavChunkHeader.h"
@@ -28,7 +35,8 @@
 
 static const char *TAG = "WavStreamReader";
 
-static constexpr int kConversionBufferFrames = 16;
+// Staging buffer for streams that have to be copied out of (e.g. files)
+static constexpr int kConversionBufferBytes = 4096;
 
 namespace parselib {
 
@@ -114,201 +122,91 @@ void WavStreamReader::positionToAudio() {
     }
 }
 
-/**
- * Read and convert samples in PCM8 format to float
- */
-int WavStreamReader::getDataFloat_PCM8(float *buff, int numFrames) {
+int WavStreamReader::readAndConvert(float *buff, int numFrames, int bytesPerFrame,
+                                    SampleConverter convert) {
     int numChannels = mFmtChunk->mNumChannels;
-
-    int buffOffset = 0;
-    int totalFramesRead = 0;
-
-    static constexpr int kSampleSize = sizeof(u_int8_t);
-    static constexpr float kSampleFullScale = (float)0x80;
-    static constexpr float kInverseScale = 1.0f / kSampleFullScale;
-
-    u_int8_t readBuff[kConversionBufferFrames * numChannels];
-    int framesLeft = numFrames;
-    while (framesLeft > 0) {
-        int framesThisRead = std::min(framesLeft, kConversionBufferFrames);
-        //__android_log_print(ANDROID_LOG_INFO, TAG, "read(%d)", framesThisRead);
-        int numFramesRead =
-                mStream->read(readBuff, framesThisRead *  kSampleSize * numChannels) /
-                (kSampleSize * numChannels);
-        totalFramesRead += numFramesRead;
-
-        // Convert & Scale
-        for (int offset = 0; offset < numFramesRead * numChannels; offset++) {
-            // PCM8 is unsigned, so we need to make it signed before scaling/converting
-            buff[buffOffset++] = ((float) readBuff[offset] - kSampleFullScale)
-                    * kInverseScale;
-        }
-
-        if (numFramesRead < framesThisRead) {
-            break; // none left
-        }
-
-        framesLeft -= framesThisRead;
+    int framesPerRead = kConversionBufferBytes / bytesPerFrame;
+    if (framesPerRead == 0) {
+        return 0;
     }
 
-    return totalFramesRead;
-}
-
-/**
- * Read and convert samples in PCM16 format to float
- */
-int WavStreamReader::getDataFloat_PCM16(float *buff, int numFrames) {
-    int numChannels = mFmtChunk->mNumChannels;
-
-    int buffOffset = 0;
+    uint8_t readBuff[kConversionBufferBytes];
     int totalFramesRead = 0;
-
-    static constexpr int kSampleSize = sizeof(int16_t);
-    static constexpr float kSampleFullScale = (float) 0x8000;
-    static constexpr float kInverseScale = 1.0f / kSampleFullScale;
-
-    int16_t readBuff[kConversionBufferFrames * numChannels];
-    int framesLeft = numFrames;
-    while (framesLeft > 0) {
-        int framesThisRead = std::min(framesLeft, kConversionBufferFrames);
-        //__android_log_print(ANDROID_LOG_INFO, TAG, "read(%d)", framesThisRead);
-        int numFramesRead =
-                mStream->read(readBuff, framesThisRead * kSampleSize * numChannels) /
-                (kSampleSize * numChannels);
-        totalFramesRead += numFramesRead;
-
-        // Convert & Scale
-        for (int offset = 0; offset < numFramesRead * numChannels; offset++) {
-            buff[buffOffset++] = (float) readBuff[offset] * kInverseScale;
-        }
-
-        if (numFramesRead < framesThisRead) {
+    while (totalFramesRead < numFrames) {
+        int framesThisRead = std::min(numFrames - totalFramesRead, framesPerRead);
+        int numFramesRead = mStream->read(readBuff, framesThisRead * bytesPerFrame) / bytesPerFrame;
+        if (numFramesRead <= 0) {
             break; // none left
         }
-
-        framesLeft -= framesThisRead;
-    }
-
-    return totalFramesRead;
-}
-
-/**
- * Read and convert samples in PCM24 format to float
- */
-int WavStreamReader::getDataFloat_PCM24(float *buff, int numFrames) {
-    int numChannels = mFmtChunk->mNumChannels;
-    int numSamples = numFrames * numChannels;
-
-    static constexpr float kSampleFullScale = (float) 0x80000000;
-    static constexpr float kInverseScale = 1.0f / kSampleFullScale;
-
-    uint8_t buffer[3];
-    for(int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++) {
-        if (mStream->read(buffer, 3) < 3) {
-            break; // no more data
-        }
-        int32_t sample = (buffer[0] << 8) | (buffer[1] << 16) | (buffer[2] << 24);
-        buff[sampleIndex] = (float)sample * kInverseScale;
-    }
-
-    return numFrames;
-}
-
-/**
- * Read and convert samples in Float32 format to float
- */
-int WavStreamReader::getDataFloat_Float32(float *buff, int numFrames) {
-    // Turns out that WAV Float32 is just Android floats
-    int numChannels = mFmtChunk->mNumChannels;
-
-    return mStream->read(buff, numFrames * sizeof(float) * numChannels) /
-           (sizeof(float) * numChannels);
-}
-
-/**
- * Read and convert samples in PCM32 format to float
- */
-int WavStreamReader::getDataFloat_PCM32(float *buff, int numFrames) {
-    int numChannels = mFmtChunk->mNumChannels;
-
-    int buffOffset = 0;
-    int totalFramesRead = 0;
-
-    static constexpr int kSampleSize = sizeof(int32_t);
-    static constexpr float kSampleFullScale = (float) 0x80000000;
-    static constexpr float kInverseScale = 1.0f / kSampleFullScale;
-
-    int32_t readBuff[kConversionBufferFrames * numChannels];
-    int framesLeft = numFrames;
-    while (framesLeft > 0) {
-        int framesThisRead = std::min(framesLeft, kConversionBufferFrames);
-        //__android_log_print(ANDROID_LOG_INFO, TAG, "read(%d)", framesThisRead);
-        int numFramesRead =
-                mStream->read(readBuff, framesThisRead *  kSampleSize* numChannels) /
-                    (kSampleSize * numChannels);
+        convert(readBuff, buff + totalFramesRead * numChannels, numFramesRead * numChannels);
         totalFramesRead += numFramesRead;
-
-        // convert & Scale
-        for (int offset = 0; offset < numFramesRead * numChannels; offset++) {
-            buff[buffOffset++] = (float) readBuff[offset] * kInverseScale;
-        }
-
-        if (numFramesRead < framesThisRead) {
-            break; // none left
-        }
-
-        framesLeft -= framesThisRead;
     }
 
     return totalFramesRead;
 }
 
 int WavStreamReader::getDataFloat(float *buff, int numFrames) {
-    // __android_log_print(ANDROID_LOG_INFO, TAG, "getData(%d)", numFrames);
+    // LOGI("getData(%d)", numFrames);
 
     if (mDataChunk == nullptr || mFmtChunk == nullptr) {
         return ERR_INVALID_STATE;
     }
 
-    int numFramesRead = 0;
+    SampleConverter convert = nullptr;
     switch (mFmtChunk->mSampleSize) {
         case 8:
-            numFramesRead = getDataFloat_PCM8(buff, numFrames);
+            convert = convertPCM8ToFloat;
             break;
 
         case 16:
-            numFramesRead = getDataFloat_PCM16(buff, numFrames);
+            convert = convertPCM16ToFloat;
             break;
 
         case 24:
             if (mFmtChunk->mEncodingId == WavFmtChunkHeader::ENCODING_PCM) {
-                numFramesRead = getDataFloat_PCM24(buff, numFrames);
-            } else {
-                __android_log_print(ANDROID_LOG_INFO, TAG, "invalid encoding:%d mSampleSize:%d",
-                                    mFmtChunk->mEncodingId, mFmtChunk->mSampleSize);
+                convert = convertPCM24ToFloat;
             }
             break;
 
         case 32:
             if (mFmtChunk->mEncodingId == WavFmtChunkHeader::ENCODING_PCM) {
-                numFramesRead = getDataFloat_PCM32(buff, numFrames);
+                convert = convertPCM32ToFloat;
             } else if (mFmtChunk->mEncodingId == WavFmtChunkHeader::ENCODING_IEEE_FLOAT) {
-                numFramesRead = getDataFloat_Float32(buff, numFrames);
-            } else {
-                __android_log_print(ANDROID_LOG_INFO, TAG, "invalid encoding:%d mSampleSize:%d",
-                                    mFmtChunk->mEncodingId, mFmtChunk->mSampleSize);
+                convert = convertFloat32ToFloat;
             }
             break;
 
         default:
-            __android_log_print(ANDROID_LOG_INFO, TAG, "invalid encoding:%d mSampleSize:%d",
+            LOGI("invalid encoding:%d mSampleSize:%d",
                     mFmtChunk->mEncodingId, mFmtChunk->mSampleSize);
             return ERR_INVALID_FORMAT;
     }
 
+    int numChannels = getNumChannels();
+    int numFramesRead = 0;
+    if (convert == nullptr) {
+        LOGI("invalid encoding:%d mSampleSize:%d",
+                mFmtChunk->mEncodingId, mFmtChunk->mSampleSize);
+    } else {
+        int bytesPerFrame = (mFmtChunk->mSampleSize / 8) * numChannels;
+
+        // Never run past the data chunk into whatever chunk follows it
+        long bytesLeft = mAudioDataStartPos + mDataChunk->mChunkSize - mStream->getPos();
+        int framesToRead = (int) std::min<long>(numFrames, std::max(0L, bytesLeft) / bytesPerFrame);
+
+        int32_t numBytesDirect = 0;
+        const unsigned char *direct = mStream->peekDirect(&numBytesDirect);
+        if (direct != nullptr) {
+            numFramesRead = std::min(framesToRead, numBytesDirect / bytesPerFrame);
+            convert(direct, buff, numFramesRead * numChannels);
+            mStream->advance(numFramesRead * bytesPerFrame);
+        } else {
+            numFramesRead = readAndConvert(buff, framesToRead, bytesPerFrame, convert);
+        }
+    }
+
     // Zero out any unread frames
     if (numFramesRead < numFrames) {
-        int numChannels = getNumChannels();
         memset(buff + (numFramesRead * numChannels), 0,
                 (numFrames - numFramesRead) * sizeof(buff[0]) * numChannels);
     }
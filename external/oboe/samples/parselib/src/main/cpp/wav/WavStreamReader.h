@@ -17,6 +17,8 @@
 #define _IO_WAV_WAVSTREAMREADER_H_
 
 #include <map>
+#include <memory>
+#include <stdint.h>
 
 #include "AudioEncoding.h"
 #include "WavRIFFChunkHeader.h"
@@ -55,6 +57,12 @@ public:
     static constexpr int ERR_INVALID_FORMAT    = -1;
     static constexpr int ERR_INVALID_STATE    = -2;
 
+    /**
+     * Reads up to numFrames interleaved frames, converted to float, and zeroes any frames
+     * past the end of the data chunk. Returns the number of frames actually read.
+     * When the stream is memory-backed (a MemInputStream, e.g. over a MappedFile) samples
+     * are converted straight from the stream's buffer into buff, with no intermediate copy.
+     */
     int getDataFloat(float *buff, int numFrames);
 
     // int getData16(short *buff, int numFramees);
@@ -71,17 +79,12 @@ protected:
     std::map<RiffID, std::shared_ptr<WavChunkHeader>> mChunkMap;
 
 private:
+    typedef void (*SampleConverter)(const uint8_t *src, float *dst, int32_t numSamples);
+
     /*
-     * Individual Format Readers/Converters
+     * Copying path for streams that cannot be read in place (e.g. FileInputStream)
      */
-    int getDataFloat_PCM8(float *buff, int numFrames);
-
-    int getDataFloat_PCM16(float *buff, int numFrames);
-
-    int getDataFloat_PCM24(float *buff, int numFrames);
-
-    int getDataFloat_Float32(float *buff, int numFrames);
-    int getDataFloat_PCM32(float *buff, int numFrames);
+    int readAndConvert(float *buff, int numFrames, int bytesPerFrame, SampleConverter convert);
 };
 
 } // namespace parselib
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "FlowGraphNode.h"
+#include "LookAheadLimiter.h"
+
+using namespace FLOWGRAPH_OUTER_NAMESPACE::flowgraph;
+
+LookAheadLimiter::LookAheadLimiter(int32_t channelCount, int32_t sampleRate,
+                                   float lookAheadSeconds, float releaseSeconds)
+        : FlowGraphFilter(channelCount)
+        , mChannelCount(channelCount)
+        , mLookAheadFrames(std::max(1, static_cast<int32_t>(
+                std::lround(lookAheadSeconds * static_cast<float>(sampleRate)))))
+        , mReleaseCoefficient(static_cast<float>(std::exp(
+                -1.0 / std::max(1.0, static_cast<double>(releaseSeconds) * sampleRate))))
+        , mHistory(static_cast<size_t>(mLookAheadFrames + kBlockFrames) * channelCount)
+        , mGains(kBlockFrames)
+        , mDequeFrames(mLookAheadFrames + 1)
+        , mDequeGains(mLookAheadFrames + 1)
+        , mBox(mLookAheadFrames) {
+    reset();
+}
+
+void LookAheadLimiter::setThreshold(float threshold) {
+    mThreshold.store(std::max(threshold, 1.0e-6f), std::memory_order_relaxed);
+}
+
+void LookAheadLimiter::reset() {
+    FlowGraphFilter::reset();
+    std::fill(mHistory.begin(), mHistory.end(), 0.0f);
+    mDequeHead = 0;
+    mDequeSize = 0;
+    mFrame = 0;
+    mReleased = 1.0f;
+    std::fill(mBox.begin(), mBox.end(), 1.0f);
+    mBoxIndex = 0;
+    mBoxSum = mLookAheadFrames;
+    mCurrentGain = 1.0f;
+}
+
+int32_t LookAheadLimiter::onProcess(int32_t numFrames) {
+    process(input.getBuffer(), output.getBuffer(), numFrames);
+    return numFrames;
+}
+
+void LookAheadLimiter::process(const float *inputBuffer, float *outputBuffer,
+                               int32_t numFrames) {
+    for (int32_t offset = 0; offset < numFrames; offset += kBlockFrames) {
+        const int32_t n = std::min(kBlockFrames, numFrames - offset);
+        processBlock(inputBuffer + static_cast<size_t>(offset) * mChannelCount,
+                     outputBuffer + static_cast<size_t>(offset) * mChannelCount, n);
+    }
+}
+
+bool LookAheadLimiter::isIdle() const {
+    return mReleased == 1.0f && mBoxSum == mLookAheadFrames && mDequeSize == 1 &&
+           mDequeGains[mDequeHead] == 1.0f;
+}
+
+float LookAheadLimiter::followEnvelope(float requiredGain) {
+    const int32_t capacity = mLookAheadFrames + 1;
+    auto wrap = [capacity](int32_t index) {
+        return index >= capacity ? index - capacity : index;
+    };
+
+    // Sliding minimum: retire the gain that has left the window, drop queued
+    // gains that can no longer be the minimum, then queue this one
+    if (mDequeSize > 0 && mDequeFrames[mDequeHead] <= mFrame - capacity) {
+        mDequeHead = wrap(mDequeHead + 1);
+        mDequeSize--;
+    }
+    while (mDequeSize > 0 && mDequeGains[wrap(mDequeHead + mDequeSize - 1)] >= requiredGain) {
+        mDequeSize--;
+    }
+    const int32_t tail = wrap(mDequeHead + mDequeSize);
+    mDequeFrames[tail] = mFrame;
+    mDequeGains[tail] = requiredGain;
+    mDequeSize++;
+    mFrame++;
+    const float held = mDequeGains[mDequeHead];
+
+    // Instant attack, exponential release
+    mReleased = held < mReleased ? held : held + (mReleased - held) * mReleaseCoefficient;
+
+    // Moving average over the look-ahead turns the attack into a ramp
+    mBoxSum += static_cast<double>(mReleased) - mBox[mBoxIndex];
+    mBox[mBoxIndex] = mReleased;
+    if (++mBoxIndex == mLookAheadFrames) {
+        mBoxIndex = 0;
+        double sum = 0.0;
+        for (float gain : mBox) {
+            sum += gain;
+        }
+        mBoxSum = sum;
+    }
+    return static_cast<float>(mBoxSum / mLookAheadFrames);
+}
+
+void LookAheadLimiter::processBlock(const float *inputBuffer, float *outputBuffer,
+                                    int32_t numFrames) {
+    const int32_t channels = mChannelCount;
+    const size_t delaySamples = static_cast<size_t>(mLookAheadFrames) * channels;
+    float *history = mHistory.data();
+    float *incoming = history + delaySamples;
+    float *gains = mGains.data();
+    std::memcpy(incoming, inputBuffer,
+                static_cast<size_t>(numFrames) * channels * sizeof(float));
+
+    // Peak of each frame across channels
+    if (channels == 2) {
+        for (int32_t i = 0; i < numFrames; i++) {
+            gains[i] = std::max(std::fabs(incoming[2 * i]), std::fabs(incoming[2 * i + 1]));
+        }
+    } else {
+        for (int32_t i = 0; i < numFrames; i++) {
+            float peak = std::fabs(incoming[i * channels]);
+            for (int32_t c = 1; c < channels; c++) {
+                peak = std::max(peak, std::fabs(incoming[i * channels + c]));
+            }
+            gains[i] = peak;
+        }
+    }
+
+    // Required gain: threshold / peak above the threshold, else 1. NaN
+    // peaks fail the comparison and ask for no reduction.
+    const float threshold = mThreshold.load(std::memory_order_relaxed);
+    for (int32_t i = 0; i < numFrames; i++) {
+        gains[i] = threshold / std::max(threshold, gains[i]);
+    }
+
+    float lowest = 1.0f;
+    for (int32_t i = 0; i < numFrames; i++) {
+        lowest = std::min(lowest, gains[i]);
+    }
+    if (lowest == 1.0f && isIdle()) {
+        // Nothing to limit and nothing releasing: the envelope would stay at
+        // exactly 1, so only its frame count moves on
+        mDequeFrames[mDequeHead] = mFrame + numFrames - 1;
+        mFrame += numFrames;
+        mBoxIndex = (mBoxIndex + numFrames) % mLookAheadFrames;
+        mCurrentGain = 1.0f;
+        std::memcpy(outputBuffer, history,
+                    static_cast<size_t>(numFrames) * channels * sizeof(float));
+        std::memmove(history, history + static_cast<size_t>(numFrames) * channels,
+                     delaySamples * sizeof(float));
+        return;
+    }
+
+    for (int32_t i = 0; i < numFrames; i++) {
+        gains[i] = followEnvelope(gains[i]);
+    }
+    mCurrentGain = gains[numFrames - 1];
+
+    // Delayed frames out, scaled
+    if (channels == 2) {
+        for (int32_t i = 0; i < numFrames; i++) {
+            outputBuffer[2 * i] = history[2 * i] * gains[i];
+            outputBuffer[2 * i + 1] = history[2 * i + 1] * gains[i];
+        }
+    } else {
+        for (int32_t i = 0; i < numFrames; i++) {
+            for (int32_t c = 0; c < channels; c++) {
+                outputBuffer[i * channels + c] = history[i * channels + c] * gains[i];
+            }
+        }
+    }
+
+    // Keep the newest L frames for the next block
+    std::memmove(history, history + static_cast<size_t>(numFrames) * channels,
+                 delaySamples * sizeof(float));
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOWGRAPH_LOOK_AHEAD_LIMITER_H
+#define FLOWGRAPH_LOOK_AHEAD_LIMITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "FlowGraphNode.h"
+
+namespace FLOWGRAPH_OUTER_NAMESPACE::flowgraph {
+
+/**
+ * Brick-wall peak limiter with a fixed look-ahead, for the end of a mix bus.
+ *
+ * Unlike Limiter, which soft-clips each sample on its own, this one turns the whole frame
+ * down (all channels by the same gain, so the stereo image holds) before a peak arrives:
+ *
+ *  1. The signal is delayed by the look-ahead, L frames.
+ *  2. Each frame's required gain is threshold / peak (or 1). A sliding-window minimum over
+ *     the last L + 1 frames, kept in a monotonic deque, holds the lowest gain any frame
+ *     still in the delay line needs.
+ *  3. That held gain is taken at once when it drops and released exponentially.
+ *  4. A moving average over L frames smooths the attack into a ramp.
+ *
+ * Every frame in the averaging window holds a gain no higher than the one the delayed
+ * frame needs, so the output never exceeds the threshold, while gain changes stay smooth.
+ * The cost is a latency of exactly getLatencyFrames() frames.
+ *
+ * The per-frame peak and required-gain passes and the gain multiply run as plain loops
+ * over blocks of up to kBlockFrames frames, which the compiler vectorises; only the
+ * envelope follower is serial, and a block that needs no limiting while the envelope is at
+ * rest skips it and is just delayed. Nothing allocates after construction.
+ *
+ * process() may also be called directly, without ports, on interleaved buffers.
+ */
+class LookAheadLimiter : public FlowGraphFilter {
+public:
+    static constexpr int32_t kBlockFrames = 256;
+    static constexpr float kDefaultThreshold = 0.891251f; // -1 dBFS
+    static constexpr float kDefaultLookAheadSeconds = 0.002f;
+    static constexpr float kDefaultReleaseSeconds = 0.08f;
+
+    LookAheadLimiter(int32_t channelCount, int32_t sampleRate,
+                     float lookAheadSeconds = kDefaultLookAheadSeconds,
+                     float releaseSeconds = kDefaultReleaseSeconds);
+
+    virtual ~LookAheadLimiter() = default;
+
+    int32_t onProcess(int32_t numFrames) override;
+
+    /**
+     * Limit numFrames interleaved frames. input and output may be the same buffer.
+     */
+    void process(const float *input, float *output, int32_t numFrames);
+
+    /**
+     * Linear peak ceiling. This may be safely called by another thread.
+     */
+    void setThreshold(float threshold);
+
+    float getThreshold() const {
+        return mThreshold.load(std::memory_order_relaxed);
+    }
+
+    int32_t getLatencyFrames() const {
+        return mLookAheadFrames;
+    }
+
+    /**
+     * Gain applied to the most recent output frame: 1 when not limiting.
+     */
+    float getCurrentGain() const {
+        return mCurrentGain;
+    }
+
+    /**
+     * Clear the delay line and the envelope.
+     */
+    void reset() override;
+
+    const char *getName() override {
+        return "LookAheadLimiter";
+    }
+
+private:
+    void processBlock(const float *input, float *output, int32_t numFrames);
+    float followEnvelope(float requiredGain);
+    // True when the envelope is at rest at unity gain
+    bool isIdle() const;
+
+    const int32_t mChannelCount;
+    const int32_t mLookAheadFrames;
+    const float mReleaseCoefficient;
+    std::atomic<float> mThreshold{kDefaultThreshold};
+
+    // The last L input frames followed by the current block, interleaved
+    std::vector<float> mHistory;
+    // Per-frame scratch: peak, then gain
+    std::vector<float> mGains;
+
+    // Sliding minimum over L + 1 frames: ring of (frame, gain), gains increasing
+    std::vector<int64_t> mDequeFrames;
+    std::vector<float> mDequeGains;
+    int32_t mDequeHead = 0;
+    int32_t mDequeSize = 0;
+    int64_t mFrame = 0;
+
+    float mReleased = 1.0f;
+
+    // Moving average over L frames; the sum is rebuilt once per lap of the ring
+    std::vector<float> mBox;
+    int32_t mBoxIndex = 0;
+    double mBoxSum = 0.0;
+
+    float mCurrentGain = 1.0f;
+};
+
+} /* namespace FLOWGRAPH_OUTER_NAMESPACE::flowgraph */
+
+#endif //FLOWGRAPH_LOOK_AHEAD_LIMITER_H
@@ -51,8 +51,7 @@ void PolyphaseResampler::readFrame(float *frame) {
         }
     }
 
-    // Advance and wrap through coefficients.
-    mCoefficientCursor = (mCoefficientCursor + mNumTaps) % mCoefficients.size();
+    advanceCoefficientCursor();
 
     // Copy accumulator to output.
     for (int channel = 0; channel < getChannelCount(); channel++) {
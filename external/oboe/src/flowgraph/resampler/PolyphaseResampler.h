@@ -44,6 +44,15 @@ public:
 
 protected:
 
+    // Advance and wrap through coefficients, one row of mNumTaps per output frame.
+    // The table holds a whole number of rows, so the cursor wraps exactly to zero.
+    void advanceCoefficientCursor() {
+        mCoefficientCursor += mNumTaps;
+        if (mCoefficientCursor >= static_cast<int32_t>(mCoefficients.size())) {
+            mCoefficientCursor = 0;
+        }
+    }
+
     int32_t                mCoefficientCursor = 0;
 
 };
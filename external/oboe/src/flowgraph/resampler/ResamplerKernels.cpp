@@ -0,0 +1,356 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResamplerKernels.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define RESAMPLER_HAVE_SSE2 1
+#if defined(__GNUC__)
+#define RESAMPLER_HAVE_AVX2 1
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_HAVE_NEON 1
+#endif
+
+using namespace RESAMPLER_OUTER_NAMESPACE::resampler;
+
+namespace {
+
+using FirFn = float (*)(const float *, const float *, int32_t);
+using FirStereoFn = void (*)(const float *, const float *, int32_t, float *);
+using Fir2Fn = void (*)(const float *, const float *, const float *, int32_t, float *, float *);
+
+#if RESAMPLER_HAVE_SSE2
+
+inline float horizontalSum(__m128 v) {
+    const __m128 swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128 pairs = _mm_add_ps(v, swapped);
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(swapped, pairs)));
+}
+
+// {L0, R0, L1, R1} -> out[0] = L0 + L1, out[1] = R0 + R1
+inline void storeStereoSum(__m128 v, float *out) {
+    const __m128 folded = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    _mm_storel_pi(reinterpret_cast<__m64 *>(out), folded);
+}
+
+float firMonoSse2(const float *x, const float *c, int32_t numTaps) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int32_t i = 0;
+    for (; i + 8 <= numTaps; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(c + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(c + i + 4)));
+    }
+    if (i < numTaps) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(c + i)));
+    }
+    return horizontalSum(_mm_add_ps(acc0, acc1));
+}
+
+void firStereoSse2(const float *x, const float *c, int32_t numTaps, float *out) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        // Each coefficient weights one interleaved frame: {c0, c0, c1, c1}, {c2, c2, c3, c3}
+        const __m128 coefficients = _mm_loadu_ps(c + i);
+        const float *frames = x + 2 * i;
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(frames),
+                                           _mm_unpacklo_ps(coefficients, coefficients)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(frames + 4),
+                                           _mm_unpackhi_ps(coefficients, coefficients)));
+    }
+    storeStereoSum(_mm_add_ps(acc0, acc1), out);
+}
+
+void firMono2Sse2(const float *x, const float *c1, const float *c2, int32_t numTaps,
+                  float *out1, float *out2) {
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        const __m128 samples = _mm_loadu_ps(x + i);
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(samples, _mm_loadu_ps(c1 + i)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(samples, _mm_loadu_ps(c2 + i)));
+    }
+    out1[0] = horizontalSum(acc1);
+    out2[0] = horizontalSum(acc2);
+}
+
+void firStereo2Sse2(const float *x, const float *c1, const float *c2, int32_t numTaps,
+                    float *out1, float *out2) {
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        const __m128 frames0 = _mm_loadu_ps(x + 2 * i);
+        const __m128 frames1 = _mm_loadu_ps(x + 2 * i + 4);
+        const __m128 coefficients1 = _mm_loadu_ps(c1 + i);
+        const __m128 coefficients2 = _mm_loadu_ps(c2 + i);
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(frames0, _mm_unpacklo_ps(coefficients1, coefficients1)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(frames1, _mm_unpackhi_ps(coefficients1, coefficients1)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(frames0, _mm_unpacklo_ps(coefficients2, coefficients2)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(frames1, _mm_unpackhi_ps(coefficients2, coefficients2)));
+    }
+    storeStereoSum(acc1, out1);
+    storeStereoSum(acc2, out2);
+}
+#endif
+
+#if RESAMPLER_HAVE_AVX2
+#define RESAMPLER_AVX2 __attribute__((target("avx2")))
+
+RESAMPLER_AVX2 inline __m128 foldHalves(__m256 v) {
+    return _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+}
+
+// Four coefficients spread over four interleaved stereo frames: {c0, c0, c1, c1, ..., c3, c3}
+RESAMPLER_AVX2 inline __m256 loadStereoCoefficients(const float *c) {
+    const __m256i duplicate = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    return _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_loadu_ps(c)), duplicate);
+}
+
+RESAMPLER_AVX2 float firMonoAvx2(const float *x, const float *c, int32_t numTaps) {
+    __m256 acc = _mm256_setzero_ps();
+    int32_t i = 0;
+    for (; i + 8 <= numTaps; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(c + i)));
+    }
+    __m128 sum = foldHalves(acc);
+    if (i < numTaps) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(c + i)));
+    }
+    return horizontalSum(sum);
+}
+
+RESAMPLER_AVX2 void firStereoAvx2(const float *x, const float *c, int32_t numTaps, float *out) {
+    __m256 acc = _mm256_setzero_ps();
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i),
+                                               loadStereoCoefficients(c + i)));
+    }
+    storeStereoSum(foldHalves(acc), out);
+}
+
+RESAMPLER_AVX2 void firMono2Avx2(const float *x, const float *c1, const float *c2,
+                                 int32_t numTaps, float *out1, float *out2) {
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    int32_t i = 0;
+    for (; i + 8 <= numTaps; i += 8) {
+        const __m256 samples = _mm256_loadu_ps(x + i);
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(samples, _mm256_loadu_ps(c1 + i)));
+        acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(samples, _mm256_loadu_ps(c2 + i)));
+    }
+    __m128 sum1 = foldHalves(acc1);
+    __m128 sum2 = foldHalves(acc2);
+    if (i < numTaps) {
+        const __m128 samples = _mm_loadu_ps(x + i);
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(samples, _mm_loadu_ps(c1 + i)));
+        sum2 = _mm_add_ps(sum2, _mm_mul_ps(samples, _mm_loadu_ps(c2 + i)));
+    }
+    out1[0] = horizontalSum(sum1);
+    out2[0] = horizontalSum(sum2);
+}
+
+RESAMPLER_AVX2 void firStereo2Avx2(const float *x, const float *c1, const float *c2,
+                                   int32_t numTaps, float *out1, float *out2) {
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        const __m256 frames = _mm256_loadu_ps(x + 2 * i);
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(frames, loadStereoCoefficients(c1 + i)));
+        acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(frames, loadStereoCoefficients(c2 + i)));
+    }
+    storeStereoSum(foldHalves(acc1), out1);
+    storeStereoSum(foldHalves(acc2), out2);
+}
+#endif
+
+#if RESAMPLER_HAVE_NEON
+
+inline float horizontalSum(float32x4_t v) {
+#if defined(__aarch64__)
+    return vaddvq_f32(v);
+#else
+    const float32x2_t pairs = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+#endif
+}
+
+float firMonoNeon(const float *x, const float *c, int32_t numTaps) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int32_t i = 0;
+    for (; i + 8 <= numTaps; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(x + i), vld1q_f32(c + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(x + i + 4), vld1q_f32(c + i + 4));
+    }
+    if (i < numTaps) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(x + i), vld1q_f32(c + i));
+    }
+    return horizontalSum(vaddq_f32(acc0, acc1));
+}
+
+void firStereoNeon(const float *x, const float *c, int32_t numTaps, float *out) {
+    float32x4_t left = vdupq_n_f32(0.0f);
+    float32x4_t right = vdupq_n_f32(0.0f);
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        // De-interleave four frames so each lane pairs with one coefficient
+        const float32x4x2_t frames = vld2q_f32(x + 2 * i);
+        const float32x4_t coefficients = vld1q_f32(c + i);
+        left = vmlaq_f32(left, frames.val[0], coefficients);
+        right = vmlaq_f32(right, frames.val[1], coefficients);
+    }
+    out[0] = horizontalSum(left);
+    out[1] = horizontalSum(right);
+}
+
+void firMono2Neon(const float *x, const float *c1, const float *c2, int32_t numTaps,
+                  float *out1, float *out2) {
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f);
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        const float32x4_t samples = vld1q_f32(x + i);
+        acc1 = vmlaq_f32(acc1, samples, vld1q_f32(c1 + i));
+        acc2 = vmlaq_f32(acc2, samples, vld1q_f32(c2 + i));
+    }
+    out1[0] = horizontalSum(acc1);
+    out2[0] = horizontalSum(acc2);
+}
+
+void firStereo2Neon(const float *x, const float *c1, const float *c2, int32_t numTaps,
+                    float *out1, float *out2) {
+    float32x4_t left1 = vdupq_n_f32(0.0f);
+    float32x4_t right1 = vdupq_n_f32(0.0f);
+    float32x4_t left2 = vdupq_n_f32(0.0f);
+    float32x4_t right2 = vdupq_n_f32(0.0f);
+    for (int32_t i = 0; i < numTaps; i += 4) {
+        const float32x4x2_t frames = vld2q_f32(x + 2 * i);
+        const float32x4_t coefficients1 = vld1q_f32(c1 + i);
+        const float32x4_t coefficients2 = vld1q_f32(c2 + i);
+        left1 = vmlaq_f32(left1, frames.val[0], coefficients1);
+        right1 = vmlaq_f32(right1, frames.val[1], coefficients1);
+        left2 = vmlaq_f32(left2, frames.val[0], coefficients2);
+        right2 = vmlaq_f32(right2, frames.val[1], coefficients2);
+    }
+    out1[0] = horizontalSum(left1);
+    out1[1] = horizontalSum(right1);
+    out2[0] = horizontalSum(left2);
+    out2[1] = horizontalSum(right2);
+}
+#endif
+
+struct Kernels {
+    FirFn mono;
+    FirStereoFn stereo;
+    Fir2Fn mono2;
+    Fir2Fn stereo2;
+    const char *name;
+};
+
+Kernels selectKernels() {
+#if RESAMPLER_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return {firMonoAvx2, firStereoAvx2, firMono2Avx2, firStereo2Avx2, "avx2"};
+    }
+#endif
+#if RESAMPLER_HAVE_SSE2
+    return {firMonoSse2, firStereoSse2, firMono2Sse2, firStereo2Sse2, "sse2"};
+#elif RESAMPLER_HAVE_NEON
+    return {firMonoNeon, firStereoNeon, firMono2Neon, firStereo2Neon, "neon"};
+#else
+    return {ResamplerKernels::firMonoScalar, ResamplerKernels::firStereoScalar,
+            ResamplerKernels::firMono2Scalar, ResamplerKernels::firStereo2Scalar, "scalar"};
+#endif
+}
+
+// The FIR set for this CPU, picked once for every resampler instance
+const Kernels kKernels = selectKernels();
+
+} // namespace
+
+float ResamplerKernels::firMono(const float *x, const float *c, int32_t numTaps) {
+    return kKernels.mono(x, c, numTaps);
+}
+
+void ResamplerKernels::firStereo(const float *x, const float *c, int32_t numTaps, float *out) {
+    kKernels.stereo(x, c, numTaps, out);
+}
+
+void ResamplerKernels::firMono2(const float *x, const float *c1, const float *c2,
+                                int32_t numTaps, float *out1, float *out2) {
+    kKernels.mono2(x, c1, c2, numTaps, out1, out2);
+}
+
+void ResamplerKernels::firStereo2(const float *x, const float *c1, const float *c2,
+                                  int32_t numTaps, float *out1, float *out2) {
+    kKernels.stereo2(x, c1, c2, numTaps, out1, out2);
+}
+
+float ResamplerKernels::firMonoScalar(const float *x, const float *c, int32_t numTaps) {
+    float sum = 0.0f;
+    for (int32_t i = 0; i < numTaps; i++) {
+        sum += x[i] * c[i];
+    }
+    return sum;
+}
+
+void ResamplerKernels::firStereoScalar(const float *x, const float *c, int32_t numTaps,
+                                       float *out) {
+    float left = 0.0f;
+    float right = 0.0f;
+    for (int32_t i = 0; i < numTaps; i++) {
+        left += x[2 * i] * c[i];
+        right += x[2 * i + 1] * c[i];
+    }
+    out[0] = left;
+    out[1] = right;
+}
+
+void ResamplerKernels::firMono2Scalar(const float *x, const float *c1, const float *c2,
+                                      int32_t numTaps, float *out1, float *out2) {
+    float sum1 = 0.0f;
+    float sum2 = 0.0f;
+    for (int32_t i = 0; i < numTaps; i++) {
+        sum1 += x[i] * c1[i];
+        sum2 += x[i] * c2[i];
+    }
+    out1[0] = sum1;
+    out2[0] = sum2;
+}
+
+void ResamplerKernels::firStereo2Scalar(const float *x, const float *c1, const float *c2,
+                                        int32_t numTaps, float *out1, float *out2) {
+    float left1 = 0.0f;
+    float right1 = 0.0f;
+    float left2 = 0.0f;
+    float right2 = 0.0f;
+    for (int32_t i = 0; i < numTaps; i++) {
+        left1 += x[2 * i] * c1[i];
+        right1 += x[2 * i + 1] * c1[i];
+        left2 += x[2 * i] * c2[i];
+        right2 += x[2 * i + 1] * c2[i];
+    }
+    out1[0] = left1;
+    out1[1] = right1;
+    out2[0] = left2;
+    out2[1] = right2;
+}
+
+const char *ResamplerKernels::name() {
+    return kKernels.name;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RESAMPLER_RESAMPLER_KERNELS_H
+#define RESAMPLER_RESAMPLER_KERNELS_H
+
+#include <cstdint>
+
+#include "ResamplerDefinitions.h"
+
+namespace RESAMPLER_OUTER_NAMESPACE::resampler {
+
+/**
+ * The inner loops of the resamplers' readFrame(): one or two rows of filter coefficients
+ * multiplied against the input history.
+ *
+ * x points at the newest frame of the history (mX at mCursor), mono or interleaved stereo.
+ * numTaps must be a multiple of 4, as the resamplers already require.
+ *
+ * The best kernel for the CPU is chosen once at load time. SIMD kernels sum in a different
+ * order from the scalar reference, so results differ from it by rounding only.
+ */
+class ResamplerKernels {
+public:
+    // Returns sum(x[i] * c[i])
+    static float firMono(const float *x, const float *c, int32_t numTaps);
+
+    // out[channel] = sum(x[2 * i + channel] * c[i])
+    static void firStereo(const float *x, const float *c, int32_t numTaps, float *out);
+
+    // Two coefficient rows over the same history, for sinc interpolation:
+    // out1 and out2 each receive one value per channel
+    static void firMono2(const float *x, const float *c1, const float *c2, int32_t numTaps,
+                         float *out1, float *out2);
+
+    static void firStereo2(const float *x, const float *c1, const float *c2, int32_t numTaps,
+                           float *out1, float *out2);
+
+    // Portable reference implementations, summing in tap order
+    static float firMonoScalar(const float *x, const float *c, int32_t numTaps);
+
+    static void firStereoScalar(const float *x, const float *c, int32_t numTaps, float *out);
+
+    static void firMono2Scalar(const float *x, const float *c1, const float *c2,
+                               int32_t numTaps, float *out1, float *out2);
+
+    static void firStereo2Scalar(const float *x, const float *c1, const float *c2,
+                                 int32_t numTaps, float *out1, float *out2);
+
+    // Name of the selected kernel set: "avx2", "sse2", "neon" or "scalar"
+    static const char *name();
+};
+
+} /* namespace RESAMPLER_OUTER_NAMESPACE::resampler */
+
+#endif //RESAMPLER_RESAMPLER_KERNELS_H
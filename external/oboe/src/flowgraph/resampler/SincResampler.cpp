@@ -17,6 +17,7 @@
 #include <algorithm>   // Do NOT delete. Needed for LLVM. See #1746
 #include <cassert>
 #include <math.h>
+#include "ResamplerKernels.h"
 #include "SincResampler.h"
 
 using namespace RESAMPLER_OUTER_NAMESPACE::resampler;
@@ -37,10 +38,6 @@ SincResampler::SincResampler(const MultiChannelResampler::Builder &builder)
 }
 
 void SincResampler::readFrame(float *frame) {
-    // Clear accumulator for mixing.
-    std::fill(mSingleFrame.begin(), mSingleFrame.end(), 0.0);
-    std::fill(mSingleFrame2.begin(), mSingleFrame2.end(), 0.0);
-
     // Determine indices into coefficients table.
     const double tablePhase = getIntegerPhase() * mPhaseScaler;
     const int indexLow = static_cast<int>(floor(tablePhase));
@@ -52,13 +49,22 @@ void SincResampler::readFrame(float *frame) {
                                              * static_cast<size_t>(getNumTaps())];
 
     float *xFrame = &mX[static_cast<size_t>(mCursor) * static_cast<size_t>(getChannelCount())];
-    for (int tap = 0; tap < mNumTaps; tap++) {
-        const float coefficientLow = *coefficientsLow++;
-        const float coefficientHigh = *coefficientsHigh++;
-        for (int channel = 0; channel < getChannelCount(); channel++) {
-            const float sample = *xFrame++;
-            mSingleFrame[channel] += sample * coefficientLow;
-            mSingleFrame2[channel] += sample * coefficientHigh;
+    if (getChannelCount() == 1) {
+        ResamplerKernels::firMono2(xFrame, coefficientsLow, coefficientsHigh, mNumTaps,
+                                   mSingleFrame.data(), mSingleFrame2.data());
+    } else {
+        // Clear accumulator for mixing.
+        std::fill(mSingleFrame.begin(), mSingleFrame.end(), 0.0);
+        std::fill(mSingleFrame2.begin(), mSingleFrame2.end(), 0.0);
+
+        for (int tap = 0; tap < mNumTaps; tap++) {
+            const float coefficientLow = *coefficientsLow++;
+            const float coefficientHigh = *coefficientsHigh++;
+            for (int channel = 0; channel < getChannelCount(); channel++) {
+                const float sample = *xFrame++;
+                mSingleFrame[channel] += sample * coefficientLow;
+                mSingleFrame2[channel] += sample * coefficientHigh;
+            }
         }
     }
 
@@ -18,6 +18,7 @@
 #include <cassert>
 #include <math.h>
 
+#include "ResamplerKernels.h"
 #include "SincResamplerStereo.h"
 
 using namespace RESAMPLER_OUTER_NAMESPACE::resampler;
@@ -48,10 +49,6 @@ void SincResamplerStereo::writeFrame(const float *frame) {
 
 // Multiply input times windowed sinc function.
 void SincResamplerStereo::readFrame(float *frame) {
-    // Clear accumulator for mixing.
-    std::fill(mSingleFrame.begin(), mSingleFrame.end(), 0.0);
-    std::fill(mSingleFrame2.begin(), mSingleFrame2.end(), 0.0);
-
     // Determine indices into coefficients table.
     double tablePhase = getIntegerPhase() * mPhaseScaler;
     int index1 = static_cast<int>(floor(tablePhase));
@@ -60,22 +57,14 @@ void SincResamplerStereo::readFrame(float *frame) {
     int index2 = (index1 + 1);
     float *coefficients2 = &mCoefficients[static_cast<size_t>(index2)
             * static_cast<size_t>(getNumTaps())];
-    float *xFrame = &mX[static_cast<size_t>(mCursor) * static_cast<size_t>(getChannelCount())];
-    for (int i = 0; i < mNumTaps; i++) {
-        float coefficient1 = *coefficients1++;
-        float coefficient2 = *coefficients2++;
-        for (int channel = 0; channel < getChannelCount(); channel++) {
-            float sample = *xFrame++;
-            mSingleFrame[channel] +=  sample * coefficient1;
-            mSingleFrame2[channel] += sample * coefficient2;
-        }
-    }
+    float *xFrame = &mX[static_cast<size_t>(mCursor) * STEREO];
+    float low[STEREO];
+    float high[STEREO];
+    ResamplerKernels::firStereo2(xFrame, coefficients1, coefficients2, mNumTaps, low, high);
 
     // Interpolate and copy to output.
     float fraction = tablePhase - index1;
-    for (int channel = 0; channel < getChannelCount(); channel++) {
-        float low = mSingleFrame[channel];
-        float high = mSingleFrame2[channel];
-        frame[channel] = low + (fraction * (high - low));
+    for (int channel = 0; channel < STEREO; channel++) {
+        frame[channel] = low[channel] + (fraction * (high[channel] - low[channel]));
     }
 }
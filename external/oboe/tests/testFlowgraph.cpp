@@ -25,6 +25,7 @@
 
 #include "flowgraph/ClipToRange.h"
 #include "flowgraph/Limiter.h"
+#include "flowgraph/LookAheadLimiter.h"
 #include "flowgraph/MonoToMultiConverter.h"
 #include "flowgraph/SourceFloat.h"
 #include "flowgraph/RampLinear.h"
@@ -267,3 +268,42 @@ TEST(test_flowgraph, module_limiter_nan) {
         EXPECT_NEAR(expected[i], output[i], tolerance);
     }
 }
+
+TEST(test_flowgraph, module_look_ahead_limiter) {
+    constexpr int kSampleRate = 1000; // 2 frames of look-ahead
+    constexpr int kNumFrames = 40;
+    constexpr float kThreshold = 0.5f;
+    float input[kNumFrames * 2];
+    float output[kNumFrames * 2];
+    for (int i = 0; i < kNumFrames; i++) {
+        input[2 * i] = (i == 10) ? 2.0f : 0.25f;
+        input[2 * i + 1] = -input[2 * i] * 0.5f;
+    }
+    SourceFloat sourceFloat{2};
+    LookAheadLimiter limiter{2, kSampleRate};
+    SinkFloat sinkFloat{2};
+    limiter.setThreshold(kThreshold);
+    const int latency = limiter.getLatencyFrames();
+    ASSERT_EQ(2, latency);
+
+    sourceFloat.setData(input, kNumFrames);
+    sourceFloat.output.connect(&limiter.input);
+    limiter.output.connect(&sinkFloat.input);
+
+    int32_t numRead = sinkFloat.read(output, kNumFrames);
+    ASSERT_EQ(kNumFrames, numRead);
+
+    for (int i = 0; i < numRead; i++) {
+        const float delayedLeft = i < latency ? 0.0f : input[2 * (i - latency)];
+        const float delayedRight = i < latency ? 0.0f : input[2 * (i - latency) + 1];
+        EXPECT_LE(fabsf(output[2 * i]), kThreshold); // never over the ceiling
+        EXPECT_LE(fabsf(output[2 * i + 1]), kThreshold);
+        // Both channels share one gain, which never boosts
+        EXPECT_NEAR(output[2 * i] * delayedRight, output[2 * i + 1] * delayedLeft, 1e-6f);
+        EXPECT_LE(fabsf(output[2 * i]), fabsf(delayedLeft));
+        if (i < 8) {
+            EXPECT_EQ(delayedLeft, output[2 * i]); // untouched before the peak
+        }
+    }
+    EXPECT_NEAR(kThreshold, output[2 * (10 + latency)], 1e-6f); // the peak lands on it
+}
@@ -25,6 +25,11 @@
 #include <oboe/Oboe.h>
 
 #include "flowgraph/resampler/MultiChannelResampler.h"
+#include "flowgraph/resampler/PolyphaseResamplerMono.h"
+#include "flowgraph/resampler/PolyphaseResamplerStereo.h"
+#include "flowgraph/resampler/ResamplerKernels.h"
+#include "flowgraph/resampler/SincResampler.h"
+#include "flowgraph/resampler/SincResamplerStereo.h"
 
 using namespace oboe::resampler;
 
@@ -223,3 +228,204 @@ TEST(test_resampler, resampler_48000_44100_best) {
 TEST(test_resampler, resampler_44100_11025_best) {
     checkResampler(44100, 11025, MultiChannelResampler::Quality::Best);
 }
+
+// Deterministic noise in [-1, 1)
+static void fillNoise(float *buffer, int32_t numSamples, uint32_t seed) {
+    for (int32_t i = 0; i < numSamples; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        buffer[i] = static_cast<int32_t>(seed) * (1.0f / 2147483648.0f);
+    }
+}
+
+// Rounding bound for a dot product summed in a different order
+static float dotTolerance(const float *x, int32_t xStride, const float *c, int32_t numTaps) {
+    float magnitude = 0.0f;
+    for (int32_t i = 0; i < numTaps; i++) {
+        magnitude += fabsf(x[i * xStride] * c[i]);
+    }
+    return magnitude * numTaps * 1.2e-7f;
+}
+
+TEST(test_resampler, kernels_match_scalar) {
+    printf("resampler kernels: %s\n", ResamplerKernels::name());
+    for (int32_t numTaps = 4; numTaps <= 64; numTaps += 4) {
+        // Odd offsets: the history and coefficient rows are not vector aligned
+        std::vector<float> x(2 * numTaps + 1);
+        std::vector<float> c1(numTaps + 1);
+        std::vector<float> c2(numTaps + 1);
+        fillNoise(x.data(), x.size(), numTaps);
+        fillNoise(c1.data(), c1.size(), numTaps + 100);
+        fillNoise(c2.data(), c2.size(), numTaps + 200);
+        const float *history = x.data() + 1;
+        const float *row1 = c1.data() + 1;
+        const float *row2 = c2.data() + 1;
+
+        const float mono = ResamplerKernels::firMono(history, row1, numTaps);
+        EXPECT_NEAR(ResamplerKernels::firMonoScalar(history, row1, numTaps), mono,
+                    dotTolerance(history, 1, row1, numTaps)) << "taps " << numTaps;
+
+        float stereo[2], stereoScalar[2];
+        ResamplerKernels::firStereo(history, row1, numTaps, stereo);
+        ResamplerKernels::firStereoScalar(history, row1, numTaps, stereoScalar);
+        for (int channel = 0; channel < 2; channel++) {
+            EXPECT_NEAR(stereoScalar[channel], stereo[channel],
+                        dotTolerance(history + channel, 2, row1, numTaps)) << "taps " << numTaps;
+        }
+
+        float mono1, mono2, mono1Scalar, mono2Scalar;
+        ResamplerKernels::firMono2(history, row1, row2, numTaps, &mono1, &mono2);
+        ResamplerKernels::firMono2Scalar(history, row1, row2, numTaps, &mono1Scalar, &mono2Scalar);
+        EXPECT_NEAR(mono1Scalar, mono1, dotTolerance(history, 1, row1, numTaps));
+        EXPECT_NEAR(mono2Scalar, mono2, dotTolerance(history, 1, row2, numTaps));
+
+        float low[2], high[2], lowScalar[2], highScalar[2];
+        ResamplerKernels::firStereo2(history, row1, row2, numTaps, low, high);
+        ResamplerKernels::firStereo2Scalar(history, row1, row2, numTaps, lowScalar, highScalar);
+        for (int channel = 0; channel < 2; channel++) {
+            EXPECT_NEAR(lowScalar[channel], low[channel],
+                        dotTolerance(history + channel, 2, row1, numTaps));
+            EXPECT_NEAR(highScalar[channel], high[channel],
+                        dotTolerance(history + channel, 2, row2, numTaps));
+        }
+    }
+}
+
+// The readFrame() loops as they were before the SIMD kernels, as references
+
+class ReferencePolyphaseMono : public PolyphaseResamplerMono {
+public:
+    using PolyphaseResamplerMono::PolyphaseResamplerMono;
+
+    void readFrame(float *frame) override {
+        float sum = 0.0;
+        const float *coefficients = &mCoefficients[mCoefficientCursor];
+        const float *xFrame = &mX[mCursor];
+        for (int i = 0; i < mNumTaps; i++) {
+            sum += *xFrame++ * *coefficients++;
+        }
+        mCoefficientCursor = (mCoefficientCursor + mNumTaps) % mCoefficients.size();
+        frame[0] = sum;
+    }
+};
+
+class ReferencePolyphaseStereo : public PolyphaseResamplerStereo {
+public:
+    using PolyphaseResamplerStereo::PolyphaseResamplerStereo;
+
+    void readFrame(float *frame) override {
+        float left = 0.0;
+        float right = 0.0;
+        const float *coefficients = &mCoefficients[mCoefficientCursor];
+        const float *xFrame = &mX[mCursor * 2];
+        for (int i = 0; i < mNumTaps; i++) {
+            const float coefficient = *coefficients++;
+            left += *xFrame++ * coefficient;
+            right += *xFrame++ * coefficient;
+        }
+        mCoefficientCursor = (mCoefficientCursor + mNumTaps) % mCoefficients.size();
+        frame[0] = left;
+        frame[1] = right;
+    }
+};
+
+template <typename SincBase>
+class ReferenceSinc : public SincBase {
+public:
+    using SincBase::SincBase;
+
+    void readFrame(float *frame) override {
+        const int channelCount = this->getChannelCount();
+        std::vector<float> low(channelCount, 0.0f);
+        std::vector<float> high(channelCount, 0.0f);
+        const double tablePhase = this->getIntegerPhase() * this->mPhaseScaler;
+        const int indexLow = static_cast<int>(floor(tablePhase));
+        const float *coefficientsLow = &this->mCoefficients[indexLow * this->mNumTaps];
+        const float *coefficientsHigh = &this->mCoefficients[(indexLow + 1) * this->mNumTaps];
+        const float *xFrame = &this->mX[this->mCursor * channelCount];
+        for (int tap = 0; tap < this->mNumTaps; tap++) {
+            const float coefficientLow = *coefficientsLow++;
+            const float coefficientHigh = *coefficientsHigh++;
+            for (int channel = 0; channel < channelCount; channel++) {
+                const float sample = *xFrame++;
+                low[channel] += sample * coefficientLow;
+                high[channel] += sample * coefficientHigh;
+            }
+        }
+        const float fraction = tablePhase - indexLow;
+        for (int channel = 0; channel < channelCount; channel++) {
+            frame[channel] = low[channel] + (fraction * (high[channel] - low[channel]));
+        }
+    }
+};
+
+// Runs the same noise through both resamplers; every output sample must agree to rounding
+static void checkAgainstReference(MultiChannelResampler *resampler,
+                                  MultiChannelResampler *reference, int channelCount) {
+    const int32_t kNumFrames = 4000;
+    std::vector<float> input(kNumFrames * channelCount);
+    fillNoise(input.data(), input.size(), 42);
+    std::vector<float> frame(channelCount);
+    std::vector<float> referenceFrame(channelCount);
+    float maxError = 0.0f;
+    int32_t numRead = 0;
+    for (int32_t i = 0; i < kNumFrames;) {
+        ASSERT_EQ(reference->isWriteNeeded(), resampler->isWriteNeeded());
+        if (resampler->isWriteNeeded()) {
+            resampler->writeNextFrame(&input[i * channelCount]);
+            reference->writeNextFrame(&input[i * channelCount]);
+            i++;
+        } else {
+            resampler->readNextFrame(frame.data());
+            reference->readNextFrame(referenceFrame.data());
+            for (int channel = 0; channel < channelCount; channel++) {
+                maxError = std::max(maxError, fabsf(frame[channel] - referenceFrame[channel]));
+            }
+            numRead++;
+        }
+    }
+    EXPECT_GT(numRead, 0);
+    // Full-scale noise through a unity-gain FIR of at most 32 taps
+    EXPECT_LT(maxError, 2.0e-5f);
+}
+
+static MultiChannelResampler::Builder makeBuilder(int channelCount, int32_t inputRate,
+                                                  int32_t outputRate, int32_t numTaps) {
+    MultiChannelResampler::Builder builder;
+    builder.setChannelCount(channelCount)
+            ->setInputRate(inputRate)
+            ->setOutputRate(outputRate)
+            ->setNumTaps(numTaps);
+    return builder;
+}
+
+TEST(test_resampler, kernels_match_reference_resamplers) {
+    const int32_t tapCounts[] = {4, 8, 16, 32}; // Low, Medium, High, Best
+    for (int32_t numTaps : tapCounts) {
+        SCOPED_TRACE(numTaps);
+        {
+            auto builder = makeBuilder(1, 44100, 48000, numTaps);
+            PolyphaseResamplerMono resampler(builder);
+            ReferencePolyphaseMono reference(builder);
+            checkAgainstReference(&resampler, &reference, 1);
+        }
+        {
+            auto builder = makeBuilder(2, 48000, 44100, numTaps);
+            PolyphaseResamplerStereo resampler(builder);
+            ReferencePolyphaseStereo reference(builder);
+            checkAgainstReference(&resampler, &reference, 2);
+        }
+        {
+            // An awkward ratio (44100 / 47999) that needs the interpolating sinc resampler
+            auto builder = makeBuilder(1, 44100, 47999, numTaps);
+            SincResampler resampler(builder);
+            ReferenceSinc<SincResampler> reference(builder);
+            checkAgainstReference(&resampler, &reference, 1);
+        }
+        {
+            auto builder = makeBuilder(2, 47999, 44100, numTaps);
+            SincResamplerStereo resampler(builder);
+            ReferenceSinc<SincResamplerStereo> reference(builder);
+            checkAgainstReference(&resampler, &reference, 2);
+        }
+    }
+}
@@ -0,0 +1,15 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Per-thread heap allocation counter for the host test runner
+ */
+
+#pragma once
+
+// While t_countAllocations is set, every operator new on that thread bumps
+// t_allocationCount, so the tests can assert that the audio path never
+// allocates. The counting operator new/delete live in AllocationCounter.cpp,
+// which only the host test runner links (ONGOMA_COUNT_ALLOCATIONS).
+extern thread_local bool t_countAllocations;
+extern thread_local int t_allocationCount;
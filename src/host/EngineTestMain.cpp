@@ -0,0 +1,16 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Host runner for the synth core tests (ctest entry point)
+ */
+
+#include "EngineTests.h"
+#include <cstdio>
+#include <string>
+
+int main() {
+    std::string result = runEngineTests();
+    std::fputs(result.c_str(), stdout);
+    return result.find("FAIL:") == std::string::npos ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Offline renderer: plays a note script through the synth core into a WAV
+ *
+ *   ongoma_render [--rate HZ] [--buffer FRAMES] [--channels 1|2] [--seconds S]
+ *                 [--samples MAP] [--pcm24] [--record COPY] [script] out.wav
+ *
+ * A script has one event per line, "<frame> on|off <midiNote> [pan]"; blank
+ * lines and lines starting with '#' are ignored. Notes without a pan are
+ * spread by pitch. Without a script a short built-in
+ * demo is rendered. --samples plays a SampleLibrary map instead of the
+ * wavetable voices. --pcm24 writes 24-bit PCM instead of float.
+ *
+ * --record also records the render through an OutputRecorder (FIFO and
+ * writer thread, as on the device) into COPY, then checks that COPY is
+ * byte-identical to out.wav.
+ */
+
+#include "OutputRecorder.h"
+#include "SampleLibrary.h"
+#include "StreamingSampler.h"
+#include "SynthCore.h"
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ScriptEvent {
+    int64_t frame;
+    bool on;
+    int midiNote;
+    bool hasPan;
+    float pan;
+};
+
+bool parseScript(const char *path, std::vector<ScriptEvent> &events) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "Cannot open script %s\n", path);
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        ScriptEvent event{};
+        std::string type;
+        if (!(fields >> event.frame >> type >> event.midiNote) ||
+            (type != "on" && type != "off")) {
+            std::fprintf(stderr, "%s:%d: expected \"<frame> on|off <note> [pan]\"\n",
+                         path, lineNumber);
+            return false;
+        }
+        event.on = type == "on";
+        event.hasPan = static_cast<bool>(fields >> event.pan);
+        events.push_back(event);
+    }
+    return true;
+}
+
+bool sameBytes(const char *pathA, const char *pathB) {
+    std::ifstream a(pathA, std::ios::binary);
+    std::ifstream b(pathB, std::ios::binary);
+    if (!a || !b) {
+        return false;
+    }
+    return std::vector<char>(std::istreambuf_iterator<char>(a), {}) ==
+           std::vector<char>(std::istreambuf_iterator<char>(b), {});
+}
+
+// A C major arpeggio into a held chord, released after two seconds
+std::vector<ScriptEvent> demoScript(int32_t sampleRate) {
+    const int notes[] = {48, 52, 55, 60, 64, 67, 72};
+    std::vector<ScriptEvent> events;
+    for (int i = 0; i < 7; i++) {
+        events.push_back({static_cast<int64_t>(i) * sampleRate / 8, true, notes[i], false, 0.0f});
+        events.push_back({2LL * sampleRate, false, notes[i], false, 0.0f});
+    }
+    return events;
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: ongoma_render [--rate HZ] [--buffer FRAMES] "
+                 "[--channels 1|2] [--seconds S] [--samples MAP] [--pcm24] "
+                 "[--record COPY] [script] out.wav\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int32_t sampleRate = SynthCore::SAMPLE_RATE;
+    int32_t bufferFrames = 192;
+    int channels = 2;
+    double seconds = 0.0;
+    const char *sampleMap = nullptr;
+    const char *recordPath = nullptr;
+    WavWriter::Format format = WavWriter::Format::FLOAT32;
+    std::vector<const char *> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            sampleRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--buffer") == 0 && i + 1 < argc) {
+            bufferFrames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--channels") == 0 && i + 1 < argc) {
+            channels = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sampleMap = argv[++i];
+        } else if (std::strcmp(argv[i], "--pcm24") == 0) {
+            format = WavWriter::Format::PCM24;
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || paths.size() > 2 || sampleRate <= 0 || bufferFrames <= 0 ||
+        channels < 1 || channels > SynthCore::MAX_CHANNELS) {
+        usage();
+        return 2;
+    }
+
+    std::vector<ScriptEvent> events;
+    if (paths.size() == 2) {
+        if (!parseScript(paths[0], events)) {
+            return 1;
+        }
+    } else {
+        events = demoScript(sampleRate);
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ScriptEvent &a, const ScriptEvent &b) {
+                         return a.frame < b.frame;
+                     });
+
+    // Default length: last event plus the full release tail
+    int64_t totalFrames = static_cast<int64_t>(seconds * sampleRate);
+    if (totalFrames <= 0) {
+        int64_t lastEvent = events.empty() ? 0 : events.back().frame;
+        totalFrames = lastEvent +
+                      static_cast<int64_t>((SynthCore::RELEASE_TIME + 0.5) * sampleRate);
+    }
+
+    SynthCore synth;
+    synth.setSampleRate(sampleRate);
+    synth.setChannelCount(channels);
+
+    SampleLibrary library;
+    std::unique_ptr<StreamingSampler> sampler;
+    if (sampleMap != nullptr) {
+        if (library.loadMap(sampleMap) == 0) {
+            std::fprintf(stderr, "No playable zones in %s\n", sampleMap);
+            return 1;
+        }
+        sampler = std::make_unique<StreamingSampler>(library);
+        synth.attachSampler(sampler.get());
+    }
+
+    WavWriter wav;
+    if (!wav.open(paths.back(), sampleRate, channels, format)) {
+        std::fprintf(stderr, "Cannot write %s\n", paths.back());
+        return 1;
+    }
+    OutputRecorder recorder;
+    if (recordPath != nullptr) {
+        if (!recorder.start(recordPath, sampleRate, channels, format)) {
+            std::fprintf(stderr, "Cannot write %s\n", recordPath);
+            return 1;
+        }
+        synth.attachRecorder(&recorder);
+    }
+
+    // Feed the queue one buffer ahead, as a UI thread would, so scripts of
+    // any length fit the bounded event queue
+    std::vector<float> buffer(static_cast<size_t>(bufferFrames) * channels);
+    size_t nextEvent = 0;
+    float peak = 0.0f;
+    for (int64_t frame = 0; frame < totalFrames; frame += bufferFrames) {
+        const int32_t n = static_cast<int32_t>(
+            std::min<int64_t>(bufferFrames, totalFrames - frame));
+        while (nextEvent < events.size() && events[nextEvent].frame < frame + n) {
+            const ScriptEvent &event = events[nextEvent];
+            bool posted;
+            if (!event.on) {
+                posted = synth.postNoteOff(event.midiNote, event.frame);
+            } else if (event.hasPan) {
+                posted = synth.postNoteOn(event.midiNote, event.frame, event.pan);
+            } else {
+                posted = synth.postNoteOn(event.midiNote, event.frame);
+            }
+            if (!posted) {
+                break; // queue full: render this buffer and retry
+            }
+            nextEvent++;
+        }
+        if (sampler) {
+            // Rendering outruns real time; let the tails catch up
+            sampler->waitForPrefetch();
+        }
+        if (recordPath != nullptr) {
+            recorder.waitForSpace(n);
+        }
+        synth.render(buffer.data(), n);
+        for (int32_t i = 0; i < n * channels; i++) {
+            peak = std::max(peak, std::abs(buffer[i]));
+        }
+        if (!wav.write(buffer.data(), n)) {
+            std::fprintf(stderr, "Write to %s failed\n", paths.back());
+            return 1;
+        }
+    }
+    if (!wav.close()) {
+        std::fprintf(stderr, "Write to %s failed\n", paths.back());
+        return 1;
+    }
+    if (recordPath != nullptr) {
+        synth.attachRecorder(nullptr);
+        if (!recorder.finish()) {
+            std::fprintf(stderr, "Recording to %s failed\n", recordPath);
+            return 1;
+        }
+        const bool same = sameBytes(paths.back(), recordPath);
+        std::printf("Recorded %lld frames to %s (%lld overrun): %s\n",
+                    static_cast<long long>(recorder.getFramesCaptured()), recordPath,
+                    static_cast<long long>(recorder.getOverrunFrames()),
+                    same ? "identical to the direct render" : "DIFFERS from the direct render");
+        if (!same) {
+            return 1;
+        }
+    }
+
+    std::printf("Rendered %lld frames @ %d Hz x %d ch (%zu events, peak %.3f) to %s\n",
+                static_cast<long long>(totalFrames), sampleRate, channels, events.size(),
+                peak, paths.back());
+
+    const EngineStats &stats = synth.getStats();
+    std::printf("%lld callbacks, max render %lld ns (%.1f%% of a buffer), "
+                "peak %lld voices, %lld steals, %lld stream underruns, %lld idle\n",
+                static_cast<long long>(stats.get(EngineStats::CALLBACKS)),
+                static_cast<long long>(stats.get(EngineStats::MAX_RENDER_NANOS)),
+                stats.get(EngineStats::MAX_LOAD_PERMILLE) / 10.0,
+                static_cast<long long>(stats.get(EngineStats::PEAK_VOICES)),
+                static_cast<long long>(stats.get(EngineStats::VOICE_STEALS)),
+                static_cast<long long>(stats.get(EngineStats::STREAM_UNDERRUNS)),
+                static_cast<long long>(stats.get(EngineStats::IDLE_CALLBACKS)));
+    return 0;
+}
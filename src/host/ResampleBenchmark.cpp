@@ -0,0 +1,162 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Instrument load benchmarks: converting a 44.1 kHz sample library to a
+ * 48 kHz device rate with iolib::SampleBuffer
+ *
+ * The library is ONGOMA_RESAMPLE_BENCH_BUFFERS stereo buffers (default 16)
+ * of 5 seconds each. Every case starts from freshly decoded buffers:
+ *
+ *   Serial:    one MultiChannelResampler per buffer on the calling thread,
+ *              as SampleBuffer::resampleData() did before
+ *   Parallel:  SampleBuffer::resampleAll(), chunks spread over all cores
+ *   Cached:    resampleAll() with a warm ResampleCache (hash + mmap)
+ */
+
+#include "WavTestFiles.h"
+
+#include "player/ResampleCache.h"
+#include "player/SampleBuffer.h"
+#include "resampler/MultiChannelResampler.h"
+#include "stream/MemInputStream.h"
+#include "wav/WavStreamReader.h"
+
+#include <benchmark/benchmark.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using RESAMPLER_OUTER_NAMESPACE::resampler::MultiChannelResampler;
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr int32_t kFrames = 5 * 44100;
+constexpr int kDeviceRate = 48000;
+
+class Library {
+public:
+    Library() {
+        const char *count = std::getenv("ONGOMA_RESAMPLE_BENCH_BUFFERS");
+        const int numBuffers = count != nullptr ? std::atoi(count) : 16;
+        for (int i = 0; i < numBuffers; i++) {
+            wavs.push_back(makeTestWav(WavTestEncoding::PCM_16, kChannels, kFrames, i + 1, 44100));
+        }
+        const char *tmp = std::getenv("TMPDIR");
+        cacheDir = std::string(tmp != nullptr ? tmp : "/tmp") + "/ongoma_resample_bench_XXXXXX";
+        if (mkdtemp(&cacheDir[0]) == nullptr) {
+            cacheDir.clear();
+        }
+    }
+
+    ~Library() {
+        if (DIR *entries = opendir(cacheDir.c_str())) {
+            while (dirent *entry = readdir(entries)) {
+                if (entry->d_name[0] != '.') {
+                    unlink((cacheDir + "/" + entry->d_name).c_str());
+                }
+            }
+            closedir(entries);
+            rmdir(cacheDir.c_str());
+        }
+    }
+
+    std::vector<std::unique_ptr<iolib::SampleBuffer>> load() const {
+        std::vector<std::unique_ptr<iolib::SampleBuffer>> buffers;
+        for (const std::vector<uint8_t> &wav : wavs) {
+            parselib::MemInputStream stream(const_cast<uint8_t *>(wav.data()),
+                                            static_cast<int32_t>(wav.size()));
+            parselib::WavStreamReader reader(&stream);
+            reader.parse();
+            buffers.push_back(std::make_unique<iolib::SampleBuffer>());
+            buffers.back()->loadSampleData(&reader);
+        }
+        return buffers;
+    }
+
+    int64_t sourceFrames() const { return static_cast<int64_t>(wavs.size()) * kFrames; }
+
+    std::string cacheDir;
+
+private:
+    std::vector<std::vector<uint8_t>> wavs;
+};
+
+const Library &library() {
+    static Library instance;
+    return instance;
+}
+
+// The pre-parallel conversion loop
+void resampleSerial(iolib::SampleBuffer &buffer) {
+    std::unique_ptr<MultiChannelResampler> resampler(MultiChannelResampler::make(
+        kChannels, buffer.getProperties().sampleRate, kDeviceRate,
+        MultiChannelResampler::Quality::Medium));
+    std::vector<float> out(static_cast<size_t>(kFrames) * kDeviceRate / 44100 * kChannels + 64);
+    const float *input = buffer.getSampleData();
+    float *output = out.data();
+    int32_t framesLeft = buffer.getNumSamples() / kChannels;
+    while (framesLeft > 0) {
+        if (resampler->isWriteNeeded()) {
+            resampler->writeNextFrame(input);
+            input += kChannels;
+            framesLeft--;
+        } else {
+            resampler->readNextFrame(output);
+            output += kChannels;
+        }
+    }
+    benchmark::DoNotOptimize(out.data());
+}
+
+enum class Mode { SERIAL, PARALLEL, CACHED };
+
+template <Mode MODE>
+void BM_ResampleLibrary(benchmark::State &state) {
+    const Library &lib = library();
+    iolib::ResampleCache cache(lib.cacheDir.c_str());
+    if (MODE == Mode::CACHED) {
+        auto warm = lib.load();
+        std::vector<iolib::SampleBuffer *> buffers;
+        for (auto &buffer : warm) buffers.push_back(buffer.get());
+        iolib::SampleBuffer::resampleAll(buffers, kDeviceRate, &cache);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto owned = lib.load();
+        std::vector<iolib::SampleBuffer *> buffers;
+        for (auto &buffer : owned) buffers.push_back(buffer.get());
+        state.ResumeTiming();
+
+        if (MODE == Mode::SERIAL) {
+            for (iolib::SampleBuffer *buffer : buffers) resampleSerial(*buffer);
+        } else {
+            iolib::SampleBuffer::resampleAll(buffers, kDeviceRate,
+                                             MODE == Mode::CACHED ? &cache : nullptr);
+        }
+        benchmark::DoNotOptimize(buffers.front()->getSampleData());
+
+        state.PauseTiming();
+        owned.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * lib.sourceFrames());
+}
+
+void libraryArgs(benchmark::internal::Benchmark *b) {
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_ResampleLibrary, Mode::SERIAL)->Apply(libraryArgs);
+BENCHMARK_TEMPLATE(BM_ResampleLibrary, Mode::PARALLEL)->Apply(libraryArgs);
+BENCHMARK_TEMPLATE(BM_ResampleLibrary, Mode::CACHED)->Apply(libraryArgs);
+
+BENCHMARK_MAIN();
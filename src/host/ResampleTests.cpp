@@ -0,0 +1,237 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * iolib load-time resampling tests (ctest entry point): chunked parallel
+ * conversion against a serial reference, and the on-disk ResampleCache.
+ * Prints "FAIL: reason" per failing check and a summary line.
+ */
+
+#include "WavTestFiles.h"
+
+#include "player/ResampleCache.h"
+#include "player/SampleBuffer.h"
+#include "resampler/MultiChannelResampler.h"
+#include "stream/MemInputStream.h"
+#include "wav/WavStreamReader.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using RESAMPLER_OUTER_NAMESPACE::resampler::MultiChannelResampler;
+
+namespace {
+
+std::unique_ptr<iolib::SampleBuffer> loadBuffer(int channels, int32_t frames, uint32_t rate,
+                                                uint32_t seed) {
+    std::vector<uint8_t> wav =
+        makeTestWav(WavTestEncoding::FLOAT_32, channels, frames, seed, rate);
+    parselib::MemInputStream stream(wav.data(), static_cast<int32_t>(wav.size()));
+    parselib::WavStreamReader reader(&stream);
+    reader.parse();
+    auto buffer = std::make_unique<iolib::SampleBuffer>();
+    buffer->loadSampleData(&reader);
+    return buffer;
+}
+
+// One resampler over the whole buffer, consuming every input frame
+std::vector<float> serialReference(iolib::SampleBuffer &buffer, int outputRate) {
+    const int channels = buffer.getProperties().channelCount;
+    std::unique_ptr<MultiChannelResampler> resampler(MultiChannelResampler::make(
+        channels, buffer.getProperties().sampleRate, outputRate,
+        MultiChannelResampler::Quality::Medium));
+    std::vector<float> out;
+    std::vector<float> frame(channels);
+    const float *input = buffer.getSampleData();
+    int32_t framesLeft = buffer.getNumSamples() / channels;
+    while (true) {
+        if (resampler->isWriteNeeded()) {
+            if (framesLeft == 0) break;
+            resampler->writeNextFrame(input);
+            input += channels;
+            framesLeft--;
+        } else {
+            resampler->readNextFrame(frame.data());
+            out.insert(out.end(), frame.begin(), frame.end());
+        }
+    }
+    return out;
+}
+
+bool sameData(iolib::SampleBuffer &buffer, const std::vector<float> &expected) {
+    return buffer.getNumSamples() == static_cast<int32_t>(expected.size()) &&
+           std::memcmp(buffer.getSampleData(), expected.data(),
+                       expected.size() * sizeof(float)) == 0;
+}
+
+} // namespace
+
+int main() {
+    std::string results;
+    int passed = 0;
+    int failed = 0;
+
+    auto check = [&](const std::string &name, bool condition) {
+        if (condition) {
+            passed++;
+        } else {
+            failed++;
+            results += "FAIL: " + name + "\n";
+        }
+    };
+
+    // --- Chunked conversion is bit exact against one serial pass ---
+    struct Case {
+        const char *name;
+        int channels;
+        int32_t frames;
+        uint32_t inRate;
+        int outRate;
+    };
+    const Case cases[] = {
+        {"mono 44100->48000", 1, 200003, 44100, 48000},
+        {"stereo 44100->48000", 2, 150001, 44100, 48000},
+        {"stereo 48000->44100", 2, 150001, 48000, 44100},
+        {"3ch 22050->48000", 3, 70001, 22050, 48000},
+        {"stereo 44100->47999 (sinc)", 2, 100001, 44100, 47999},
+        {"short stereo 44100->48000", 2, 5, 44100, 48000},
+    };
+    for (const Case &c : cases) {
+        auto reference = loadBuffer(c.channels, c.frames, c.inRate, 3);
+        const std::vector<float> expected = serialReference(*reference, c.outRate);
+        auto buffer = loadBuffer(c.channels, c.frames, c.inRate, 3);
+        buffer->resampleData(c.outRate);
+        check(std::string(c.name) + " matches serial conversion",
+              sameData(*buffer, expected) && buffer->getProperties().sampleRate == c.outRate);
+    }
+
+    {
+        std::vector<std::unique_ptr<iolib::SampleBuffer>> owned;
+        std::vector<iolib::SampleBuffer *> buffers;
+        std::vector<std::vector<float>> expected;
+        for (uint32_t seed = 1; seed <= 5; seed++) {
+            const int channels = 1 + seed % 2;
+            auto reference = loadBuffer(channels, 30000 * seed, 44100, seed);
+            expected.push_back(serialReference(*reference, 48000));
+            owned.push_back(loadBuffer(channels, 30000 * seed, 44100, seed));
+            buffers.push_back(owned.back().get());
+        }
+        owned.push_back(loadBuffer(2, 1000, 48000, 9)); // already at the device rate
+        buffers.push_back(owned.back().get());
+        const std::vector<float> untouched(owned.back()->getSampleData(),
+                                           owned.back()->getSampleData() + 2000);
+
+        iolib::SampleBuffer::resampleAll(buffers, 48000);
+        bool all = true;
+        for (size_t i = 0; i < expected.size(); i++) {
+            all = all && sameData(*buffers[i], expected[i]);
+        }
+        check("resampleAll converts every buffer", all);
+        check("resampleAll leaves matching rates alone", sameData(*buffers.back(), untouched));
+    }
+
+    // --- ResampleCache ---
+    const char *tmpEnv = std::getenv("TMPDIR");
+    std::string dirTemplate = std::string(tmpEnv != nullptr ? tmpEnv : "/tmp") +
+                              "/ongoma_resample_XXXXXX";
+    if (mkdtemp(&dirTemplate[0]) == nullptr) {
+        check("cache directory created", false);
+    } else {
+        const std::string dir = dirTemplate;
+        iolib::ResampleCache cache(dir.c_str());
+
+        auto reference = loadBuffer(2, 90001, 44100, 11);
+        const std::vector<float> expected = serialReference(*reference, 48000);
+
+        auto first = loadBuffer(2, 90001, 44100, 11);
+        iolib::ResampleCache::Key key = {};
+        key.sourceHash = iolib::ResampleCache::hashSamples(first->getSampleData(),
+                                                           first->getNumSamples());
+        key.numSourceSamples = first->getNumSamples();
+        key.channelCount = 2;
+        key.sourceRate = 44100;
+        key.targetRate = 48000;
+        key.quality = static_cast<int32_t>(MultiChannelResampler::Quality::Medium);
+        const std::string path = cache.getPath(key);
+
+        first->resampleData(48000, &cache);
+        struct stat info;
+        check("cache miss converts", sameData(*first, expected));
+        check("cache entry written",
+              stat(path.c_str(), &info) == 0 &&
+                  info.st_size > static_cast<off_t>(expected.size() * sizeof(float)));
+
+        // Mark the cached samples: a load that returns the mark came from the file
+        std::vector<uint8_t> file(info.st_size);
+        FILE *f = std::fopen(path.c_str(), "rb");
+        const bool readOk =
+            f != nullptr && std::fread(file.data(), 1, file.size(), f) == file.size();
+        if (f != nullptr) std::fclose(f);
+        const size_t headerBytes = file.size() - expected.size() * sizeof(float);
+        std::vector<uint8_t> marked = file;
+        const float mark = 0.125f;
+        std::memcpy(marked.data() + headerBytes, &mark, sizeof(mark));
+        writeTestFile(path.c_str(), marked);
+
+        auto second = loadBuffer(2, 90001, 44100, 11);
+        second->resampleData(48000, &cache);
+        check("cache hit maps stored data",
+              readOk && second->getNumSamples() == static_cast<int32_t>(expected.size()) &&
+                  second->getSampleData()[0] == mark &&
+                  std::memcmp(second->getSampleData() + 1, expected.data() + 1,
+                              (expected.size() - 1) * sizeof(float)) == 0 &&
+                  second->getProperties().sampleRate == 48000);
+        second->unloadSampleData();
+
+        // Another format version is a miss, and the entry is rewritten
+        std::vector<uint8_t> stale = marked;
+        stale[4] ^= 0xFF;
+        writeTestFile(path.c_str(), stale);
+        auto third = loadBuffer(2, 90001, 44100, 11);
+        third->resampleData(48000, &cache);
+        check("stale version is ignored", sameData(*third, expected));
+        auto fourth = loadBuffer(2, 90001, 44100, 11);
+        fourth->resampleData(48000, &cache);
+        check("stale entry is replaced", sameData(*fourth, expected));
+
+        // A truncated entry is a miss
+        writeTestFile(path.c_str(), std::vector<uint8_t>(file.begin(), file.end() - 4));
+        auto fifth = loadBuffer(2, 90001, 44100, 11);
+        fifth->resampleData(48000, &cache);
+        check("truncated entry is ignored", sameData(*fifth, expected));
+
+        // Different source data or device rate never hits
+        auto other = loadBuffer(2, 90001, 44100, 12);
+        const std::vector<float> otherExpected =
+            serialReference(*loadBuffer(2, 90001, 44100, 12), 48000);
+        other->resampleData(48000, &cache);
+        check("different source misses", sameData(*other, otherExpected));
+        auto otherRate = loadBuffer(2, 90001, 44100, 11);
+        otherRate->resampleData(96000, &cache);
+        check("different device rate misses",
+              sameData(*otherRate, serialReference(*loadBuffer(2, 90001, 44100, 11), 96000)));
+
+        if (DIR *entries = opendir(dir.c_str())) {
+            while (dirent *entry = readdir(entries)) {
+                if (entry->d_name[0] != '.') {
+                    unlink((dir + "/" + entry->d_name).c_str());
+                }
+            }
+            closedir(entries);
+        }
+        rmdir(dir.c_str());
+    }
+
+    results += "Tests: " + std::to_string(passed) + " passed, " + std::to_string(failed) +
+               " failed\n";
+    std::fputs(results.c_str(), stdout);
+    return failed == 0 ? 0 : 1;
+}
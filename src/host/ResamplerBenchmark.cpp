@@ -0,0 +1,122 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Resampler benchmarks: the flowgraph MultiChannelResampler at every
+ * quality level and channel count, and its FIR kernels on their own.
+ *
+ *   Resample:  44.1 -> 48 kHz (polyphase) and 44.1 -> 47.999 kHz (sinc),
+ *              reporting output frames per second
+ *   Fir:       one readFrame() dot product, dispatched kernel vs scalar
+ */
+
+#include "resampler/MultiChannelResampler.h"
+#include "resampler/ResamplerKernels.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+using RESAMPLER_OUTER_NAMESPACE::resampler::MultiChannelResampler;
+using RESAMPLER_OUTER_NAMESPACE::resampler::ResamplerKernels;
+
+namespace {
+
+constexpr int32_t kInputFrames = 4096;
+
+void fillNoise(std::vector<float> &buffer) {
+    uint32_t seed = 1;
+    for (float &sample : buffer) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = static_cast<int32_t>(seed) * (1.0f / 2147483648.0f);
+    }
+}
+
+// Args: quality, channel count, output rate
+void BM_Resample(benchmark::State &state) {
+    const auto quality = static_cast<MultiChannelResampler::Quality>(state.range(0));
+    const int channels = static_cast<int>(state.range(1));
+    const int32_t outputRate = static_cast<int32_t>(state.range(2));
+    std::unique_ptr<MultiChannelResampler> resampler(
+        MultiChannelResampler::make(channels, 44100, outputRate, quality));
+
+    std::vector<float> input(static_cast<size_t>(kInputFrames) * channels);
+    fillNoise(input);
+    std::vector<float> output(static_cast<size_t>(kInputFrames) * 2 * channels);
+    int64_t framesOut = 0;
+    for (auto _ : state) {
+        const float *in = input.data();
+        float *out = output.data();
+        for (int32_t framesLeft = kInputFrames; framesLeft > 0;) {
+            if (resampler->isWriteNeeded()) {
+                resampler->writeNextFrame(in);
+                in += channels;
+                framesLeft--;
+            } else {
+                resampler->readNextFrame(out);
+                out += channels;
+            }
+        }
+        framesOut += (out - output.data()) / channels;
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(framesOut);
+    state.SetLabel(ResamplerKernels::name());
+}
+
+void resampleArgs(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"quality", "channels", "rate"});
+    for (int64_t rate : {48000, 47999}) {
+        for (int64_t channels : {1, 2, 4}) {
+            for (int64_t quality = static_cast<int64_t>(MultiChannelResampler::Quality::Low);
+                 quality <= static_cast<int64_t>(MultiChannelResampler::Quality::Best); quality++) {
+                b->Args({quality, channels, rate});
+            }
+        }
+    }
+}
+
+// Args: taps, channel count (1 or 2)
+template <bool SCALAR>
+void BM_Fir(benchmark::State &state) {
+    const int32_t numTaps = static_cast<int32_t>(state.range(0));
+    const int channels = static_cast<int>(state.range(1));
+    std::vector<float> x(static_cast<size_t>(numTaps) * channels);
+    std::vector<float> c(numTaps);
+    fillNoise(x);
+    fillNoise(c);
+    float out[2];
+    for (auto _ : state) {
+        if (channels == 1) {
+            out[0] = SCALAR ? ResamplerKernels::firMonoScalar(x.data(), c.data(), numTaps)
+                            : ResamplerKernels::firMono(x.data(), c.data(), numTaps);
+        } else if (SCALAR) {
+            ResamplerKernels::firStereoScalar(x.data(), c.data(), numTaps, out);
+        } else {
+            ResamplerKernels::firStereo(x.data(), c.data(), numTaps, out);
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (!SCALAR) {
+        state.SetLabel(ResamplerKernels::name());
+    }
+}
+
+void firArgs(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"taps", "channels"});
+    for (int64_t channels : {1, 2}) {
+        for (int64_t taps : {4, 8, 16, 32}) {
+            b->Args({taps, channels});
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_Resample)->Apply(resampleArgs);
+BENCHMARK_TEMPLATE(BM_Fir, true)->Apply(firArgs);
+BENCHMARK_TEMPLATE(BM_Fir, false)->Apply(firArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,411 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Host benchmarks for the real-time render path (Google Benchmark)
+ *
+ * Every case reports per_frame, the time spent per output frame, so results
+ * compare across buffer sizes and sample rates. BM_EffectsBus measures the
+ * master bus with each fxlab effect on its own, BM_LookAheadLimiter the
+ * output limiter. BM_RenderWorkers renders a full chord single-threaded
+ * (workers:0) and across a VoiceWorkerPool, and reports max_voices: the
+ * polyphony that would fit in one buffer period at the measured cost per
+ * voice. BM_OscillatorKernel and BM_Render take a `filter` argument that
+ * turns on the per-voice low-pass, so its cost reads against the
+ * oscillator's; BM_Render's `vibrato` keeps every voice's pitch moving, which
+ * runs the modulation tick and the kernel's increment ramps. BM_PostEvents
+ * reports per_event, the cost of getting one note event from the UI thread
+ * to the audio thread, posted one call at a time or as a batch through an
+ * EventRing. BM_ConvolutionReverb reports the callback's cost (per_frame and
+ * the slowest call, max_call) and tail_cpu: the share of one core the tail
+ * thread needs to keep up in real time, by response length and partition.
+ * BM_IdleRender renders silence through an echo and a reverb, on the full
+ * path (idle:0) and the idle fast path (idle:1), and reports idle_cpu: the
+ * share of one core the callback would take in real time.
+ */
+
+#include "ConvolutionReverb.h"
+#include "EventRing.h"
+#include "SynthCore.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+
+void reportPerFrame(benchmark::State &state, int32_t framesPerIteration) {
+    const double frames = static_cast<double>(state.iterations()) * framesPerIteration;
+    state.SetItemsProcessed(static_cast<int64_t>(frames));
+    // Inverted rate: seconds per frame, printed with an SI prefix (e.g. 24n)
+    state.counters["per_frame"] = benchmark::Counter(
+        frames, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// Full SynthCore::render with `voices` notes held in sustain
+void BM_Render(benchmark::State &state) {
+    const int voices = static_cast<int>(state.range(0));
+    const int32_t bufferFrames = static_cast<int32_t>(state.range(1));
+    const int32_t sampleRate = static_cast<int32_t>(state.range(2));
+    const int channels = static_cast<int>(state.range(3));
+    const bool filter = state.range(4) != 0;
+    const bool vibrato = state.range(5) != 0;
+
+    SynthCore synth;
+    synth.setSampleRate(sampleRate);
+    synth.setChannelCount(channels);
+    synth.setFilter(filter, 1.0f, 0.5f);
+    synth.setVibrato(5.5f, vibrato ? 0.3f : 0.0f);
+    for (int v = 0; v < voices; v++) {
+        synth.postNoteOn(36 + v * 2, 0);
+    }
+    // Run past attack and decay so the loop measures steady-state sustain
+    std::vector<float> buffer(static_cast<size_t>(bufferFrames) * channels);
+    for (int64_t frame = 0; frame < sampleRate / 2; frame += bufferFrames) {
+        synth.render(buffer.data(), bufferFrames);
+    }
+
+    for (auto _ : state) {
+        synth.render(buffer.data(), bufferFrames);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["voices"] = synth.activeVoiceCount();
+    reportPerFrame(state, bufferFrames);
+}
+
+void renderArgs(benchmark::internal::Benchmark *b) {
+    for (int voices : {1, 8, 16, SynthCore::MAX_POLYPHONY}) {
+        b->Args({voices, 192, 48000, 1, 0, 0});
+    }
+    for (int buffer : {32, 64, 256, 1024}) {
+        b->Args({SynthCore::MAX_POLYPHONY, buffer, 48000, 1, 0, 0});
+    }
+    for (int rate : {44100, 96000}) {
+        b->Args({SynthCore::MAX_POLYPHONY, 192, rate, 1, 0, 0});
+    }
+    for (int voices : {8, SynthCore::MAX_POLYPHONY}) {
+        b->Args({voices, 192, 48000, 2, 0, 0});
+    }
+    for (int channels : {1, 2}) {
+        b->Args({SynthCore::MAX_POLYPHONY, 192, 48000, channels, 1, 0});
+    }
+    for (int filter : {0, 1}) {
+        b->Args({SynthCore::MAX_POLYPHONY, 192, 48000, 1, filter, 1});
+    }
+}
+BENCHMARK(BM_Render)
+    ->ArgNames({"voices", "buffer", "rate", "channels", "filter", "vibrato"})
+    ->Apply(renderArgs);
+
+// Oscillator kernel alone, dispatched (SIMD) against the scalar reference,
+// optionally through the voice filter with its coefficients ramping
+template <bool SCALAR>
+void BM_OscillatorKernel(benchmark::State &state) {
+    const int voices = static_cast<int>(state.range(0));
+    const bool filter = state.range(1) != 0;
+    constexpr int32_t bufferFrames = 192;
+
+    SynthCore synth;
+    const MipmappedWavetable &wavetable = synth.getWavetable();
+    std::vector<uint32_t> phase(voices), increment(voices), tableOffset(voices);
+    std::vector<float> level(voices, 0.5f), mul(voices, 1.0f), add(voices, 0.0f);
+    for (int v = 0; v < voices; v++) {
+        double frequency = SynthCore::midiNoteToFrequency(36 + v * 2);
+        increment[v] = OscillatorKernel::phaseIncrementFor(frequency, SynthCore::SAMPLE_RATE);
+        tableOffset[v] = wavetable.tableOffsetFor(frequency);
+    }
+    OscillatorKernel::Voices lanes{phase.data(), increment.data(), tableOffset.data(),
+                                   level.data(), mul.data(), add.data(), voices};
+    const VoiceFilter::Coefficients c = VoiceFilter::coefficients(-5.0f, 0.5f);
+    std::vector<float> s1(voices), s2(voices), g(voices, c.g), a1(voices, c.a1),
+        a2(voices, c.a2), gStep(voices, 1e-9f), a1Step(voices, -1e-9f), a2Step(voices, 1e-9f);
+    if (filter) {
+        lanes.filter = {s1.data(), s2.data(),    g.data(),      a1.data(),
+                        a2.data(), gStep.data(), a1Step.data(), a2Step.data()};
+    }
+    std::vector<float> output(bufferFrames);
+
+    for (auto _ : state) {
+        if (SCALAR) {
+            OscillatorKernel::renderScalar(wavetable.pairs(), lanes, 0.2f,
+                                           output.data(), bufferFrames);
+        } else {
+            OscillatorKernel::render(wavetable.pairs(), lanes, 0.2f,
+                                     output.data(), bufferFrames);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    if (!SCALAR) {
+        state.SetLabel(OscillatorKernel::name());
+    }
+    reportPerFrame(state, bufferFrames);
+}
+BENCHMARK_TEMPLATE(BM_OscillatorKernel, false)
+    ->ArgNames({"voices", "filter"})
+    ->ArgsProduct({{8, SynthCore::MAX_POLYPHONY}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_OscillatorKernel, true)
+    ->ArgNames({"voices", "filter"})
+    ->ArgsProduct({{8, SynthCore::MAX_POLYPHONY}, {0, 1}});
+
+// Effects bus with one effect on the master chain (-1: empty bus), stereo.
+// Together with the empty case this is the per-effect CPU cost.
+void BM_EffectsBus(benchmark::State &state) {
+    const int type = static_cast<int>(state.range(0));
+    const int32_t bufferFrames = static_cast<int32_t>(state.range(1));
+    const EffectSpec specs[] = {
+        EffectSpec::echo(0.5f, 250.0f),
+        EffectSpec::flanger(2.0f, 0.3f, 0.7071f),
+        EffectSpec::whiteChorus(5.0f, 10.0f, 0.5f),
+        EffectSpec::tremolo(5.0f, 0.5f),
+        EffectSpec::delayLine(0.5f, 0.5f, 0.3f, 40.0f),
+    };
+    static const char *const names[] = {"echo", "flanger", "white_chorus", "tremolo",
+                                        "delay_line"};
+
+    EffectsBus bus;
+    bus.setSampleRate(SynthCore::SAMPLE_RATE);
+    if (type >= 0) {
+        bus.setMasterChain({specs[type]});
+    }
+    std::vector<float> buffer(static_cast<size_t>(bufferFrames) * 2);
+    for (size_t i = 0; i < buffer.size(); i++) {
+        buffer[i] = 0.25f * std::sin(0.01f * static_cast<float>(i));
+    }
+    for (auto _ : state) {
+        bus.process(buffer.data(), bufferFrames, 2);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(type >= 0 ? names[type] : "empty");
+    reportPerFrame(state, bufferFrames);
+}
+
+void effectsArgs(benchmark::internal::Benchmark *b) {
+    for (int type = -1; type < static_cast<int>(EffectSpec::Type::COUNT); type++) {
+        b->Args({type, 192});
+    }
+    b->Args({static_cast<int>(EffectSpec::Type::FLANGER), 1024});
+}
+BENCHMARK(BM_EffectsBus)->ArgNames({"effect", "buffer"})->Apply(effectsArgs);
+
+// Output limiter alone on a signal that keeps it limiting
+void BM_LookAheadLimiter(benchmark::State &state) {
+    const int channels = static_cast<int>(state.range(0));
+    constexpr int32_t bufferFrames = 192;
+    oboe::flowgraph::LookAheadLimiter limiter(channels, SynthCore::SAMPLE_RATE);
+    std::vector<float> input(static_cast<size_t>(bufferFrames) * channels);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = 2.0f * std::sin(0.013f * static_cast<float>(i));
+    }
+    std::vector<float> output(input.size());
+    for (auto _ : state) {
+        limiter.process(input.data(), output.data(), bufferFrames);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    reportPerFrame(state, bufferFrames);
+}
+BENCHMARK(BM_LookAheadLimiter)->ArgName("channels")->Arg(1)->Arg(2);
+
+// Every voice sounding, rendered inline or across `workers` pool threads
+void BM_RenderWorkers(benchmark::State &state) {
+    const int workers = static_cast<int>(state.range(0));
+    const int32_t bufferFrames = static_cast<int32_t>(state.range(1));
+    constexpr int voices = SynthCore::MAX_POLYPHONY;
+
+    std::unique_ptr<VoiceWorkerPool> pool;
+    SynthCore synth;
+    synth.setChannelCount(2);
+    if (workers > 0) {
+        pool = std::make_unique<VoiceWorkerPool>(workers);
+        synth.attachWorkerPool(pool.get());
+    }
+    for (int v = 0; v < voices; v++) {
+        synth.postNoteOn(36 + v * 2, 0);
+    }
+    std::vector<float> buffer(2 * static_cast<size_t>(bufferFrames));
+    for (int64_t frame = 0; frame < SynthCore::SAMPLE_RATE / 2; frame += bufferFrames) {
+        synth.render(buffer.data(), bufferFrames);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        synth.render(buffer.data(), bufferFrames);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double period = static_cast<double>(bufferFrames) / SynthCore::SAMPLE_RATE;
+    const double perBuffer = seconds / static_cast<double>(state.iterations());
+    state.counters["max_voices"] = voices * period / perBuffer;
+    if (pool) {
+        const VoiceWorkerPool::Stats &stats = pool->getStats();
+        state.counters["worker_tasks"] = static_cast<double>(stats.workerTasks.load());
+        state.counters["late_tasks"] = static_cast<double>(stats.lateTasks.load());
+    }
+    reportPerFrame(state, bufferFrames);
+}
+BENCHMARK(BM_RenderWorkers)
+    ->ArgNames({"workers", "buffer"})
+    ->ArgsProduct({{0, 1, 3}, {192, 1024}})
+    ->UseRealTime();
+
+// Chords of note-ons then note-offs, posted one call per event (batched:0,
+// what the per-note JNI entry points do) or through the event ring. Each
+// time the queue is half full, an untimed render drains it.
+void BM_PostEvents(benchmark::State &state) {
+    const bool batched = state.range(0) != 0;
+    const int chord = static_cast<int>(state.range(1));
+    const int eventsPerChord = 2 * chord;
+    const int drainChords = static_cast<int>(SynthCore::EVENT_QUEUE_CAPACITY) / 2 / eventsPerChord;
+
+    // Events land one buffer after "now", so each drain takes the previous batch
+    constexpr int32_t drainFrames = 64;
+    SynthCore synth;
+    float buffer[SynthCore::MAX_CHANNELS * drainFrames];
+    synth.render(buffer, drainFrames);
+
+    std::vector<PackedNoteEvent> ring(static_cast<size_t>(eventsPerChord));
+    for (int i = 0; i < chord; i++) {
+        ring[i] = {PackedNoteEvent::NOTE_ON, static_cast<uint8_t>(48 + 4 * i), 0, 0, 0.0f, 0};
+        ring[chord + i] = {PackedNoteEvent::NOTE_OFF, static_cast<uint8_t>(48 + 4 * i), 0, 0,
+                           0.0f, 0};
+    }
+    EventRing events;
+    events.attach(ring.data(), ring.size() * sizeof(PackedNoteEvent));
+
+    int chords = 0;
+    for (auto _ : state) {
+        if (batched) {
+            events.submit(synth, eventsPerChord);
+        } else {
+            for (int i = 0; i < chord; i++) {
+                synth.postNoteOn(48 + 4 * i, synth.eventFrameNow());
+            }
+            for (int i = 0; i < chord; i++) {
+                synth.postNoteOff(48 + 4 * i, synth.eventFrameNow());
+            }
+        }
+        if (++chords == drainChords) {
+            state.PauseTiming();
+            synth.render(buffer, drainFrames);
+            chords = 0;
+            state.ResumeTiming();
+        }
+    }
+    const double posted = static_cast<double>(state.iterations()) * eventsPerChord;
+    state.SetItemsProcessed(static_cast<int64_t>(posted));
+    state.counters["per_event"] = benchmark::Counter(
+        posted, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["dropped"] =
+        static_cast<double>(synth.getStats().get(EngineStats::DROPPED_EVENTS));
+}
+BENCHMARK(BM_PostEvents)->ArgNames({"batched", "chord"})->ArgsProduct({{0, 1}, {1, 4}});
+
+// Stereo reverb over `ir_ms` of response in partitions of `partition`
+// frames, fed 192-frame buffers. The loop runs faster than real time, so
+// the tail thread falls behind; tail_cpu comes from its time per block.
+void BM_ConvolutionReverb(benchmark::State &state) {
+    const int32_t irFrames = static_cast<int32_t>(state.range(0) * SynthCore::SAMPLE_RATE / 1000);
+    const int32_t partition = static_cast<int32_t>(state.range(1));
+    constexpr int32_t BUFFER_FRAMES = 192;
+
+    ImpulseResponse impulse;
+    impulse.channels = 2;
+    impulse.sampleRate = SynthCore::SAMPLE_RATE;
+    impulse.samples.resize(2 * static_cast<size_t>(irFrames));
+    uint32_t noise = 1;
+    for (size_t i = 0; i < impulse.samples.size(); i++) {
+        noise = noise * 1664525u + 1013904223u;
+        const double decay = std::exp(-3.0 * static_cast<double>(i / 2) / irFrames);
+        impulse.samples[i] = static_cast<float>(decay * (noise / 4294967296.0 - 0.5));
+    }
+    ConvolutionReverb reverb(impulse, SynthCore::SAMPLE_RATE, 2, partition);
+
+    std::vector<float> buffer(2 * BUFFER_FRAMES);
+    for (int32_t i = 0; i < BUFFER_FRAMES; i++) {
+        buffer[2 * i] = buffer[2 * i + 1] = static_cast<float>(std::sin(i * 0.1));
+    }
+    int64_t slowest = 0;
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        reverb.process(buffer.data(), BUFFER_FRAMES);
+        slowest = std::max<int64_t>(
+            slowest, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count());
+        benchmark::DoNotOptimize(buffer.data());
+        // process() adds into the buffer; give every call the same input
+        std::fill(buffer.begin(), buffer.end(), 0.1f);
+    }
+    reportPerFrame(state, BUFFER_FRAMES);
+
+    const ConvolutionReverb::Stats &stats = reverb.getStats();
+    const double tailBlocks = static_cast<double>(stats.tailBlocks.load());
+    const double nanosPerBlock =
+        tailBlocks > 0 ? static_cast<double>(stats.tailNanos.load()) / tailBlocks : 0.0;
+    state.counters["max_call"] = benchmark::Counter(slowest * 1e-9);
+    state.counters["tail_cpu"] =
+        nanosPerBlock * 1e-9 * SynthCore::SAMPLE_RATE / reverb.getBlockFrames();
+    state.counters["partitions"] = reverb.getPartitionCount();
+}
+BENCHMARK(BM_ConvolutionReverb)
+    ->ArgNames({"ir_ms", "partition"})
+    ->ArgsProduct({{250, 1000, 3000, 8000}, {64, 128, 256, 512}})
+    ->UseRealTime();
+
+// Stereo silence after a note has died away, with an echo on the master bus
+// and a one-second reverb, so the full path has everything to run
+void BM_IdleRender(benchmark::State &state) {
+    const bool idle = state.range(0) != 0;
+    constexpr int32_t BUFFER_FRAMES = 192;
+
+    ImpulseResponse impulse;
+    impulse.channels = 2;
+    impulse.sampleRate = SynthCore::SAMPLE_RATE;
+    impulse.samples.assign(2 * static_cast<size_t>(SynthCore::SAMPLE_RATE), 0.0f);
+    impulse.samples[0] = impulse.samples[1] = 1.0f;
+    SynthCore::Patch patch;
+    patch.releaseTime = 0.01;
+    SynthCore synth(patch);
+    synth.setChannelCount(2);
+    synth.getEffectsBus().setMasterChain({EffectSpec::echo(0.5f, 250.0f)});
+    ConvolutionReverb reverb(impulse, SynthCore::SAMPLE_RATE, 2);
+    synth.attachReverb(&reverb);
+    synth.setIdleDetection(idle);
+
+    std::vector<float> buffer(2 * BUFFER_FRAMES);
+    synth.postNoteOn(60, 0);
+    synth.postNoteOff(60, SynthCore::SAMPLE_RATE / 10);
+    const int64_t settle = static_cast<int64_t>(
+        (SynthCore::IDLE_SETTLE_SECONDS + 1.0) * SynthCore::SAMPLE_RATE);
+    for (int64_t frame = 0; frame < settle; frame += BUFFER_FRAMES) {
+        synth.render(buffer.data(), BUFFER_FRAMES);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        synth.render(buffer.data(), BUFFER_FRAMES);
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    reportPerFrame(state, BUFFER_FRAMES);
+    const double played =
+        static_cast<double>(state.iterations()) * BUFFER_FRAMES / SynthCore::SAMPLE_RATE;
+    state.counters["idle_cpu"] = played > 0.0 ? elapsed / played : 0.0;
+    state.counters["is_idle"] = synth.isIdle() ? 1 : 0;
+    synth.attachReverb(nullptr);
+}
+BENCHMARK(BM_IdleRender)->ArgName("idle")->Arg(0)->Arg(1);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,206 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Instrument load benchmarks: decoding large WAV files to float with parselib
+ *
+ * Each Load case decodes a whole file of ONGOMA_WAV_BENCH_MB megabytes
+ * (default 256) in 64k-frame pieces, the way a sample loader fills its
+ * buffers, and reports bytes_per_second of WAV data:
+ *
+ *   Legacy:  the pre-SIMD loop (16 frames per virtual read(), one sample
+ *            converted at a time, PCM24 read 3 bytes per call)
+ *   File:    WavStreamReader over a FileInputStream (staged copy, SIMD)
+ *   Mapped:  WavStreamReader over a MappedFile (in place, SIMD), including
+ *            the cost of mapping and faulting in the file
+ *
+ * The file is generated once per encoding in TMPDIR and deleted on exit.
+ * The Convert cases time the converters alone on a cache-resident block.
+ */
+
+#include "WavTestFiles.h"
+
+#include "stream/FileInputStream.h"
+#include "stream/MappedFile.h"
+#include "stream/MemInputStream.h"
+#include "wav/SampleConversion.h"
+#include "wav/WavStreamReader.h"
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr int32_t kChunkFrames = 65536;
+
+// One generated file at a time: a few hundred MB per encoding adds up
+class BenchFile {
+public:
+    ~BenchFile() { remove(); }
+
+    const std::string &get(WavTestEncoding encoding) {
+        if (path.empty() || encoding != current) {
+            remove();
+            const char *tmp = std::getenv("TMPDIR");
+            const char *mb = std::getenv("ONGOMA_WAV_BENCH_MB");
+            const int64_t bytes = (mb != nullptr ? std::atoll(mb) : 256) << 20;
+            const int bytesPerFrame = kChannels * wavTestBits(encoding) / 8;
+            path = std::string(tmp != nullptr ? tmp : "/tmp") + "/ongoma_wav_bench.wav";
+            writeTestFile(path.c_str(), makeTestWav(encoding, kChannels, bytes / bytesPerFrame));
+            current = encoding;
+        }
+        return path;
+    }
+
+private:
+    std::string path;
+    WavTestEncoding current = WavTestEncoding::PCM_16;
+
+    void remove() {
+        if (!path.empty()) {
+            unlink(path.c_str());
+            path.clear();
+        }
+    }
+};
+
+BenchFile benchFile;
+
+// The WavStreamReader decode loop as it was before the zero-copy/SIMD path
+int legacyDecode(parselib::InputStream *stream, int bits, float *buff, int numFrames) {
+    static constexpr int kConversionBufferFrames = 16;
+    const int numSamples = numFrames * kChannels;
+    if (bits == 24) {
+        uint8_t buffer[3];
+        for (int i = 0; i < numSamples; i++) {
+            if (stream->read(buffer, 3) < 3) {
+                return i / kChannels;
+            }
+            int32_t sample = (buffer[0] << 8) | (buffer[1] << 16) | (buffer[2] << 24);
+            buff[i] = (float) sample * (1.0f / (float) 0x80000000);
+        }
+        return numFrames;
+    }
+    const int sampleSize = bits / 8;
+    uint8_t readBuff[kConversionBufferFrames * kChannels * 4];
+    int offset = 0;
+    int framesLeft = numFrames;
+    while (framesLeft > 0) {
+        int framesThisRead = std::min(framesLeft, kConversionBufferFrames);
+        int numRead = stream->read(readBuff, framesThisRead * sampleSize * kChannels) /
+                      (sampleSize * kChannels);
+        for (int s = 0; s < numRead * kChannels; s++) {
+            if (bits == 16) {
+                buff[offset++] = (float) reinterpret_cast<int16_t *>(readBuff)[s] *
+                                 (1.0f / (float) 0x8000);
+            } else {
+                buff[offset++] = (float) reinterpret_cast<int32_t *>(readBuff)[s] *
+                                 (1.0f / (float) 0x80000000);
+            }
+        }
+        if (numRead < framesThisRead) {
+            break;
+        }
+        framesLeft -= framesThisRead;
+    }
+    return numFrames - framesLeft;
+}
+
+enum class LoadPath { LEGACY, FILE, MAPPED };
+
+template <LoadPath PATH>
+void BM_Load(benchmark::State &state) {
+    const int bits = static_cast<int>(state.range(0));
+    const WavTestEncoding encoding = bits == 16   ? WavTestEncoding::PCM_16
+                                     : bits == 24 ? WavTestEncoding::PCM_24
+                                                  : WavTestEncoding::PCM_32;
+    const std::string &path = benchFile.get(encoding);
+    std::vector<float> buffer(static_cast<size_t>(kChunkFrames) * kChannels);
+    int64_t bytes = 0;
+
+    for (auto _ : state) {
+        int64_t frames = 0;
+        if (PATH == LoadPath::MAPPED) {
+            parselib::MappedFile file(path.c_str());
+            parselib::MemInputStream stream(file.getData(), file.getSize());
+            parselib::WavStreamReader reader(&stream);
+            reader.parse();
+            reader.positionToAudio();
+            while (int n = reader.getDataFloat(buffer.data(), kChunkFrames)) {
+                frames += n;
+                benchmark::DoNotOptimize(buffer.data());
+            }
+        } else {
+            const int fh = open(path.c_str(), O_RDONLY);
+            parselib::FileInputStream stream(fh);
+            parselib::WavStreamReader reader(&stream);
+            reader.parse();
+            reader.positionToAudio();
+            const int total = reader.getNumSampleFrames();
+            while (frames < total) {
+                const int want = static_cast<int>(std::min<int64_t>(kChunkFrames, total - frames));
+                const int n = PATH == LoadPath::LEGACY
+                                  ? legacyDecode(&stream, bits, buffer.data(), want)
+                                  : reader.getDataFloat(buffer.data(), want);
+                if (n <= 0) break;
+                frames += n;
+                benchmark::DoNotOptimize(buffer.data());
+            }
+            close(fh);
+        }
+        bytes += frames * kChannels * bits / 8;
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void loadArgs(benchmark::internal::Benchmark *b) {
+    b->ArgName("bits")->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+template <bool SCALAR>
+void BM_Convert(benchmark::State &state) {
+    const int bits = static_cast<int>(state.range(0));
+    constexpr int32_t kSamples = 1 << 16;
+    std::vector<uint8_t> src(kSamples * 4 + 16, 0x5A);
+    std::vector<float> dst(kSamples);
+    for (auto _ : state) {
+        const uint8_t *p = src.data() + 1; // WAV data is rarely aligned
+        if (bits == 16) {
+            (SCALAR ? parselib::convertPCM16ToFloatScalar : parselib::convertPCM16ToFloat)(
+                p, dst.data(), kSamples);
+        } else if (bits == 24) {
+            (SCALAR ? parselib::convertPCM24ToFloatScalar : parselib::convertPCM24ToFloat)(
+                p, dst.data(), kSamples);
+        } else {
+            (SCALAR ? parselib::convertPCM32ToFloatScalar : parselib::convertPCM32ToFloat)(
+                p, dst.data(), kSamples);
+        }
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kSamples);
+}
+
+} // namespace
+
+// Grouped by encoding so each large file is generated once
+#define LOAD_CASES(BITS)                                                    \
+    BENCHMARK_TEMPLATE(BM_Load, LoadPath::LEGACY)->Arg(BITS)->Apply(loadArgs); \
+    BENCHMARK_TEMPLATE(BM_Load, LoadPath::FILE)->Arg(BITS)->Apply(loadArgs);   \
+    BENCHMARK_TEMPLATE(BM_Load, LoadPath::MAPPED)->Arg(BITS)->Apply(loadArgs)
+
+LOAD_CASES(16);
+LOAD_CASES(24);
+LOAD_CASES(32);
+
+BENCHMARK_TEMPLATE(BM_Convert, true)->ArgName("bits")->Arg(16)->Arg(24)->Arg(32);
+BENCHMARK_TEMPLATE(BM_Convert, false)->ArgName("bits")->Arg(16)->Arg(24)->Arg(32);
+
+BENCHMARK_MAIN();
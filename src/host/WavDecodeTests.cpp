@@ -0,0 +1,173 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * parselib WAV decode tests (ctest entry point). Prints "FAIL: reason" per
+ * failing check and a summary line.
+ */
+
+#include "WavTestFiles.h"
+
+#include "stream/FileInputStream.h"
+#include "stream/MappedFile.h"
+#include "stream/MemInputStream.h"
+#include "wav/SampleConversion.h"
+#include "wav/WavStreamReader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *encodingName(WavTestEncoding encoding) {
+    switch (encoding) {
+        case WavTestEncoding::PCM_16: return "PCM16";
+        case WavTestEncoding::PCM_24: return "PCM24";
+        case WavTestEncoding::PCM_32: return "PCM32";
+        case WavTestEncoding::FLOAT_32: return "Float32";
+    }
+    return "?";
+}
+
+// What every decode path must produce, bit for bit
+std::vector<float> reference(const std::vector<uint8_t> &wav, WavTestEncoding encoding,
+                             int32_t numSamples) {
+    std::vector<float> out(numSamples);
+    const uint8_t *data = wav.data() + 44;
+    switch (encoding) {
+        case WavTestEncoding::PCM_16:
+            parselib::convertPCM16ToFloatScalar(data, out.data(), numSamples);
+            break;
+        case WavTestEncoding::PCM_24:
+            parselib::convertPCM24ToFloatScalar(data, out.data(), numSamples);
+            break;
+        case WavTestEncoding::PCM_32:
+            parselib::convertPCM32ToFloatScalar(data, out.data(), numSamples);
+            break;
+        case WavTestEncoding::FLOAT_32:
+            std::memcpy(out.data(), data, numSamples * sizeof(float));
+            break;
+    }
+    return out;
+}
+
+// Decodes in uneven pieces, asking for more frames than the file has, so
+// block tails, the data chunk bound and zero-filling are all exercised
+std::vector<float> decodeAll(parselib::InputStream *stream, int channels, int32_t frames,
+                             int *framesRead) {
+    parselib::WavStreamReader reader(stream);
+    reader.parse();
+    reader.positionToAudio();
+    std::vector<float> out((frames + 64) * channels, -2.0f);
+    *framesRead = 0;
+    for (int32_t offset = 0; offset < frames + 64; offset += 333) {
+        const int n = std::min(333, frames + 64 - offset);
+        *framesRead += reader.getDataFloat(out.data() + offset * channels, n);
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    std::string results;
+    int passed = 0;
+    int failed = 0;
+
+    auto check = [&](const std::string &name, bool condition) {
+        if (condition) {
+            passed++;
+        } else {
+            failed++;
+            results += "FAIL: " + name + "\n";
+        }
+    };
+
+    // --- Converters: SIMD matches scalar at every alignment and length ---
+    {
+        std::vector<uint8_t> bytes(4 * 100 + 16);
+        uint32_t state = 7;
+        for (auto &b : bytes) {
+            state = state * 1664525u + 1013904223u;
+            b = static_cast<uint8_t>(state >> 24);
+        }
+        bool same = true;
+        for (int align = 0; align < 4; align++) {
+            for (int32_t n = 0; n <= 100; n++) {
+                const uint8_t *src = bytes.data() + align;
+                std::vector<float> simd(n + 1, 9.0f), scalar(n + 1, 9.0f);
+                parselib::convertPCM16ToFloat(src, simd.data(), n);
+                parselib::convertPCM16ToFloatScalar(src, scalar.data(), n);
+                same = same && simd == scalar;
+                parselib::convertPCM24ToFloat(src, simd.data(), n);
+                parselib::convertPCM24ToFloatScalar(src, scalar.data(), n);
+                same = same && simd == scalar;
+                parselib::convertPCM32ToFloat(src, simd.data(), n);
+                parselib::convertPCM32ToFloatScalar(src, scalar.data(), n);
+                same = same && simd == scalar;
+            }
+        }
+        check("SIMD conversion matches scalar", same);
+
+        const uint8_t extremes[] = {0x00, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x80,
+                                    0xFF, 0xFF, 0x7F};
+        float out[3];
+        parselib::convertPCM16ToFloatScalar(extremes, out, 2);
+        check("PCM16 full scale", out[0] == -1.0f && out[1] == 32767.0f / 32768.0f);
+        parselib::convertPCM24ToFloatScalar(extremes + 4, out, 2);
+        check("PCM24 full scale", out[0] == -1.0f && out[1] == 8388607.0f / 8388608.0f);
+    }
+
+    // --- WavStreamReader: in-place and copying paths agree ---
+    const char *tmpEnv = std::getenv("TMPDIR");
+    const std::string path = std::string(tmpEnv != nullptr ? tmpEnv : "/tmp") +
+                             "/ongoma_wav_decode_test.wav";
+    for (WavTestEncoding encoding : {WavTestEncoding::PCM_16, WavTestEncoding::PCM_24,
+                                     WavTestEncoding::PCM_32, WavTestEncoding::FLOAT_32}) {
+        const int channels = 2;
+        const int32_t frames = 1001;
+        std::vector<uint8_t> wav = makeTestWav(encoding, channels, frames);
+        const std::vector<float> expected = reference(wav, encoding, frames * channels);
+        const std::string name = encodingName(encoding);
+
+        // Decodes everything from `stream` and compares it with the reference
+        auto decodesExactly = [&](parselib::InputStream *stream) {
+            int framesRead = 0;
+            const std::vector<float> decoded = decodeAll(stream, channels, frames, &framesRead);
+            return framesRead == frames &&
+                   std::equal(expected.begin(), expected.end(), decoded.begin()) &&
+                   std::all_of(decoded.begin() + frames * channels, decoded.end(),
+                               [](float v) { return v == 0.0f; });
+        };
+
+        parselib::MemInputStream memory(wav.data(), static_cast<int32_t>(wav.size()));
+        check(name + " decodes in place from memory", decodesExactly(&memory));
+
+        if (!writeTestFile(path.c_str(), wav)) {
+            check(name + " test file written", false);
+            continue;
+        }
+        const int fh = open(path.c_str(), O_RDONLY);
+        parselib::FileInputStream file(fh);
+        check(name + " decodes through a file stream", fh >= 0 && decodesExactly(&file));
+        close(fh);
+
+        parselib::MappedFile mapped(path.c_str());
+        parselib::MemInputStream mappedStream(mapped.getData(), mapped.getSize());
+        check(name + " decodes from a mapped file",
+              mapped.isValid() && decodesExactly(&mappedStream));
+    }
+    unlink(path.c_str());
+
+    results += "Tests: " + std::to_string(passed) + " passed, " + std::to_string(failed) +
+               " failed\n";
+    std::fputs(results.c_str(), stdout);
+    return failed == 0 ? 0 : 1;
+}
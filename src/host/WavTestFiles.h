@@ -0,0 +1,84 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Synthetic WAV files for the parselib decode tests and benchmarks
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// The encodings parselib::WavStreamReader decodes
+enum class WavTestEncoding { PCM_16, PCM_24, PCM_32, FLOAT_32 };
+
+inline int wavTestBits(WavTestEncoding encoding) {
+  return encoding == WavTestEncoding::PCM_16 ? 16
+         : encoding == WavTestEncoding::PCM_24 ? 24
+                                               : 32;
+}
+
+/*
+ * A complete WAV image with pseudo-random full-scale samples. A "LIST"
+ * chunk follows the data, as written by most editors, so readers that run
+ * past the data chunk decode garbage.
+ */
+inline std::vector<uint8_t> makeTestWav(WavTestEncoding encoding, int channels,
+                                        int64_t frames, uint32_t seed = 1,
+                                        uint32_t rate = 48000) {
+  const int bytesPerSample = wavTestBits(encoding) / 8;
+  const uint32_t dataBytes = static_cast<uint32_t>(frames * channels * bytesPerSample);
+  static const char kTrailer[] = "LIST\x04\x00\x00\x00INFO";
+  const uint32_t trailerBytes = sizeof(kTrailer) - 1;
+
+  std::vector<uint8_t> wav(44 + dataBytes + trailerBytes);
+  uint8_t *p = wav.data();
+  auto put = [&p](const void *bytes, size_t n) {
+    std::memcpy(p, bytes, n);
+    p += n;
+  };
+  auto put16 = [&put](uint16_t v) { put(&v, 2); };
+  auto put32 = [&put](uint32_t v) { put(&v, 4); };
+
+  put("RIFF", 4);
+  put32(36 + dataBytes + trailerBytes);
+  put("WAVEfmt ", 8);
+  put32(16);
+  put16(encoding == WavTestEncoding::FLOAT_32 ? 3 : 1);
+  put16(static_cast<uint16_t>(channels));
+  put32(rate);
+  put32(rate * channels * bytesPerSample);
+  put16(static_cast<uint16_t>(channels * bytesPerSample));
+  put16(static_cast<uint16_t>(wavTestBits(encoding)));
+  put("data", 4);
+  put32(dataBytes);
+
+  // xorshift32: cheap and covers the full range, including the extremes
+  uint32_t state = seed ? seed : 1;
+  for (uint32_t i = 0; i < dataBytes; i += bytesPerSample) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    if (encoding == WavTestEncoding::FLOAT_32) {
+      const float value = static_cast<float>(static_cast<int32_t>(state)) / 2147483648.0f;
+      std::memcpy(p + i, &value, 4);
+    } else {
+      std::memcpy(p + i, &state, bytesPerSample);
+    }
+  }
+  p += dataBytes;
+  put(kTrailer, trailerBytes);
+  return wav;
+}
+
+inline bool writeTestFile(const char *path, const std::vector<uint8_t> &bytes) {
+  FILE *file = std::fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+  return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,112 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Native render benchmarks — called from Kotlin via JNI
+ * Returns a human-readable report of ns/frame for each kernel.
+ */
+
+#include "SynthCore.h"
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <jni.h>
+
+namespace {
+
+constexpr int BENCH_VOICES = SynthCore::MAX_POLYPHONY;
+constexpr int BENCH_SAMPLE_RATE = SynthCore::SAMPLE_RATE;
+constexpr int32_t BENCH_BUFFER = 192;
+constexpr int BENCH_SECONDS = 2;
+
+// The pre-kernel inner loop: double phase, truncating lookup, branchy wrap
+void renderLegacy(double *phases, const double *increments, float envVol,
+                  float *output, int32_t numFrames) {
+    constexpr double twoPi = SynthCore::TWO_PI;
+    constexpr double scale = SynthCore::WAVE_TABLE_SIZE / twoPi;
+    for (int v = 0; v < BENCH_VOICES; v++) {
+        double phase = phases[v];
+        for (int32_t i = 0; i < numFrames; ++i) {
+            int idx = static_cast<int>(phase * scale) & SynthCore::WAVE_TABLE_MASK;
+            output[i] += SynthCore::waveTable[idx] * envVol;
+            phase += increments[v];
+            if (phase >= twoPi) {
+                phase -= twoPi;
+            }
+        }
+        phases[v] = phase;
+    }
+}
+
+template <typename Fn>
+double nanosPerFrame(Fn &&renderBuffer) {
+    const int buffers = BENCH_SECONDS * BENCH_SAMPLE_RATE / BENCH_BUFFER;
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < buffers; b++) {
+        renderBuffer();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           (static_cast<double>(buffers) * BENCH_BUFFER);
+}
+
+} // namespace
+
+static std::string runAllBenchmarks() {
+    std::ostringstream report;
+    SynthCore engine;
+    engine.initWaveTable();
+
+    std::vector<float> output(BENCH_BUFFER);
+    std::vector<double> legacyPhase(BENCH_VOICES), legacyIncrement(BENCH_VOICES);
+    std::vector<uint32_t> phase(BENCH_VOICES), increment(BENCH_VOICES),
+        tableOffset(BENCH_VOICES);
+    std::vector<float> level(BENCH_VOICES, 0.5f), mul(BENCH_VOICES, 1.0f),
+        add(BENCH_VOICES, 0.0f);
+
+    for (int v = 0; v < BENCH_VOICES; v++) {
+        double frequency = 440.0 * std::pow(2.0, (48 + v - 69) / 12.0);
+        legacyIncrement[v] = SynthCore::TWO_PI * frequency / BENCH_SAMPLE_RATE;
+        increment[v] = OscillatorKernel::phaseIncrementFor(frequency, BENCH_SAMPLE_RATE);
+        tableOffset[v] = engine.getWavetable().tableOffsetFor(frequency);
+    }
+    OscillatorKernel::Voices voices{phase.data(), increment.data(), tableOffset.data(),
+                                    level.data(), mul.data(), add.data(), BENCH_VOICES};
+    const float *pairs = engine.getWavetable().pairs();
+
+    double legacy = nanosPerFrame([&] {
+        renderLegacy(legacyPhase.data(), legacyIncrement.data(), 0.5f,
+                     output.data(), BENCH_BUFFER);
+    });
+    double scalar = nanosPerFrame([&] {
+        OscillatorKernel::renderScalar(pairs, voices, 0.2f,
+                                       output.data(), BENCH_BUFFER);
+    });
+    double simd = nanosPerFrame([&] {
+        OscillatorKernel::render(pairs, voices, 0.2f,
+                                 output.data(), BENCH_BUFFER);
+    });
+
+    char line[128];
+    report << "Oscillator, " << BENCH_VOICES << " voices @ " << BENCH_SAMPLE_RATE
+           << " Hz, " << BENCH_BUFFER << "-frame buffers\n";
+    std::snprintf(line, sizeof(line), "  legacy loop    %8.1f ns/frame\n", legacy);
+    report << line;
+    std::snprintf(line, sizeof(line), "  kernel scalar  %8.1f ns/frame (%.2fx)\n",
+                  scalar, legacy / scalar);
+    report << line;
+    std::snprintf(line, sizeof(line), "  kernel %-7s %8.1f ns/frame (%.2fx)\n",
+                  OscillatorKernel::name(), simd, legacy / simd);
+    report << line;
+    return report.str();
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_ongoma_AudioEngine_nativeRunBenchmarks(JNIEnv *env, jobject) {
+    std::string result = runAllBenchmarks();
+    return env->NewStringUTF(result.c_str());
+}
@@ -0,0 +1,320 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Partitioned FFT convolution reverb with a background tail thread
+ */
+
+#include "ConvolutionReverb.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "stream/MappedFile.h"
+#include "stream/MemInputStream.h"
+#include "wav/WavStreamReader.h"
+
+namespace {
+
+// A parked worker rechecks this often, so a wake-up the notify raced past
+// costs at most this long; the head partitions give it several blocks
+constexpr auto PARK_TIMEOUT = std::chrono::milliseconds(1);
+
+// Decodes straight from the mapped file; tells a WAV without a data chunk
+// apart before parselib would read through the missing header
+class ImpulseReader final : public parselib::WavStreamReader {
+public:
+    using WavStreamReader::WavStreamReader;
+    bool hasAudio() const { return mFmtChunk != nullptr && mDataChunk != nullptr; }
+};
+
+// sum += x * h, bin by bin, over one channel's split-complex spectra
+void multiplyAdd(float *sum, const float *x, const float *h, int bins) {
+    float *sumRe = sum;
+    float *sumIm = sum + bins;
+    const float *xIm = x + bins;
+    const float *hIm = h + bins;
+    for (int k = 0; k < bins; k++) {
+        sumRe[k] += x[k] * h[k] - xIm[k] * hIm[k];
+        sumIm[k] += x[k] * hIm[k] + xIm[k] * h[k];
+    }
+}
+
+int32_t powerOfTwoAtLeast(int32_t n) {
+    int32_t power = 1;
+    while (power < n) {
+        power <<= 1;
+    }
+    return power;
+}
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+bool ImpulseResponse::load(const std::string &path) {
+    samples.clear();
+    channels = 0;
+    sampleRate = 0;
+
+    parselib::MappedFile file(path.c_str());
+    if (!file.isValid()) {
+        return false;
+    }
+    parselib::MemInputStream stream(file.getData(), file.getSize());
+    ImpulseReader reader(&stream);
+    reader.parse();
+    if (!reader.hasAudio() || reader.getNumChannels() <= 0 ||
+        reader.getSampleEncoding() == parselib::AudioEncoding::INVALID ||
+        reader.getSampleRate() <= 0) {
+        return false;
+    }
+    const int32_t limit =
+        static_cast<int32_t>(ConvolutionReverb::MAX_SECONDS * reader.getSampleRate());
+    const int32_t frames = std::min(reader.getNumSampleFrames(), limit);
+    if (frames <= 0) {
+        return false;
+    }
+    samples.resize(static_cast<size_t>(frames) * reader.getNumChannels());
+    reader.positionToAudio();
+    reader.getDataFloat(samples.data(), frames);
+    channels = reader.getNumChannels();
+    sampleRate = reader.getSampleRate();
+    return true;
+}
+
+ConvolutionReverb::ConvolutionReverb(const ImpulseResponse &impulse, int32_t sampleRate,
+                                     int channelCount, int32_t requestedBlock,
+                                     int requestedHead)
+    : channels(std::clamp(channelCount, 1, MAX_CHANNELS)),
+      blockFrames(powerOfTwoAtLeast(std::max(requestedBlock, 16))),
+      headFft(2 * blockFrames) {
+    bins = headFft.getBins();
+    spectrumFloats = static_cast<size_t>(channels) * 2 * bins;
+
+    // The response at our rate, one plane per channel we play
+    const double step = impulse.sampleRate > 0 && sampleRate > 0
+                            ? static_cast<double>(impulse.sampleRate) / sampleRate
+                            : 1.0;
+    const int32_t sourceFrames = impulse.frames();
+    const int32_t frames = std::min(static_cast<int32_t>(sourceFrames / step),
+                                    static_cast<int32_t>(MAX_SECONDS * sampleRate));
+    partitions = std::max(1, (frames + blockFrames - 1) / blockFrames);
+    headPartitions = std::clamp(requestedHead, 1, std::min(partitions, RING_BLOCKS - 2));
+    tailPartitions = partitions - headPartitions;
+
+    std::vector<float> plane(static_cast<size_t>(partitions) * blockFrames, 0.0f);
+    std::vector<float> padded(2 * static_cast<size_t>(blockFrames));
+    response.assign(static_cast<size_t>(partitions) * spectrumFloats, 0.0f);
+    // The inverse FFT is unnormalised; take its scale out here, once
+    const float scale = 1.0f / static_cast<float>(2 * blockFrames);
+    for (int c = 0; c < channels; c++) {
+        const int source = impulse.channels > 1 ? std::min(c, impulse.channels - 1) : 0;
+        for (int32_t i = 0; i < frames; i++) {
+            const double position = i * step;
+            const int32_t at = static_cast<int32_t>(position);
+            const float frac = static_cast<float>(position - at);
+            const float a = impulse.samples[static_cast<size_t>(at) * impulse.channels + source];
+            const float b =
+                at + 1 < sourceFrames
+                    ? impulse.samples[static_cast<size_t>(at + 1) * impulse.channels + source]
+                    : 0.0f;
+            plane[i] = (a + (b - a) * frac) * scale;
+        }
+        for (int p = 0; p < partitions; p++) {
+            std::copy_n(plane.data() + static_cast<size_t>(p) * blockFrames, blockFrames,
+                        padded.data());
+            std::fill(padded.begin() + blockFrames, padded.end(), 0.0f);
+            float *spectrum = response.data() + p * spectrumFloats + c * 2 * bins;
+            headFft.forward(padded.data(), spectrum, spectrum + bins);
+        }
+        std::fill(plane.begin(), plane.end(), 0.0f);
+    }
+
+    const size_t blockSamples = static_cast<size_t>(channels) * blockFrames;
+    input.assign(blockSamples, 0.0f);
+    previous.assign(blockSamples, 0.0f);
+    wet.assign(blockSamples, 0.0f);
+    time.assign(2 * static_cast<size_t>(blockFrames), 0.0f);
+    headHistory.assign(static_cast<size_t>(headPartitions) * spectrumFloats, 0.0f);
+    sum.assign(spectrumFloats, 0.0f);
+    wetNow = wetTarget.load(std::memory_order_relaxed);
+
+    if (tailPartitions > 0) {
+        toTail.assign(RING_BLOCKS * spectrumFloats, 0.0f);
+        fromTail.assign(RING_BLOCKS * spectrumFloats, 0.0f);
+        tailHistory.assign(static_cast<size_t>(tailPartitions) * spectrumFloats, 0.0f);
+        tailSum.assign(spectrumFloats, 0.0f);
+        worker = std::thread(&ConvolutionReverb::workerLoop, this);
+    }
+}
+
+ConvolutionReverb::~ConvolutionReverb() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(parkLock);
+            running.store(false, std::memory_order_relaxed);
+        }
+        parkSignal.notify_all();
+        worker.join();
+    }
+}
+
+void ConvolutionReverb::process(float *output, int32_t numFrames) {
+    int32_t done = 0;
+    while (done < numFrames) {
+        const int32_t n = std::min(numFrames - done, blockFrames - filled);
+        for (int c = 0; c < channels; c++) {
+            float *in = input.data() + c * blockFrames + filled;
+            const float *out = wet.data() + c * blockFrames + filled;
+            float *frame = output + done * channels + c;
+            for (int32_t i = 0; i < n; i++) {
+                in[i] = frame[i * channels];
+                frame[i * channels] += out[i];
+            }
+        }
+        filled += n;
+        done += n;
+        if (filled == blockFrames) {
+            processBlock();
+            filled = 0;
+        }
+    }
+}
+
+// Audio thread: one full block of input in, the next block of reverb out
+void ConvolutionReverb::processBlock() {
+    const int64_t n = block++;
+    float *spectrum = headHistory.data() + (n % headPartitions) * spectrumFloats;
+    for (int c = 0; c < channels; c++) {
+        float *in = input.data() + c * blockFrames;
+        float *last = previous.data() + c * blockFrames;
+        std::copy_n(last, blockFrames, time.data());
+        std::copy_n(in, blockFrames, time.data() + blockFrames);
+        std::copy_n(in, blockFrames, last);
+        float *channel = spectrum + c * 2 * bins;
+        headFft.forward(time.data(), channel, channel + bins);
+    }
+
+    if (tailPartitions > 0) {
+        // Hand the spectrum on unless the worker is a whole ring behind
+        const int slot = static_cast<int>(n % RING_BLOCKS);
+        if (waitForTail.load(std::memory_order_relaxed)) {
+            while (n - blocksTaken.load(std::memory_order_acquire) >= RING_BLOCKS) {
+                std::this_thread::yield();
+            }
+        }
+        if (n - blocksTaken.load(std::memory_order_acquire) < RING_BLOCKS) {
+            std::copy_n(spectrum, spectrumFloats, toTail.data() + slot * spectrumFloats);
+            toTailSlots[slot].block.store(n, std::memory_order_release);
+        } else {
+            stats.droppedBlocks.store(stats.droppedBlocks.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_relaxed);
+        }
+        blocksSent.store(n + 1, std::memory_order_seq_cst);
+        if (parked.load(std::memory_order_seq_cst)) {
+            parkSignal.notify_one();
+        }
+    }
+
+    std::fill(sum.begin(), sum.end(), 0.0f);
+    for (int p = 0; p < headPartitions && p <= n; p++) {
+        const float *x = headHistory.data() + ((n - p) % headPartitions) * spectrumFloats;
+        const float *h = response.data() + p * spectrumFloats;
+        for (int c = 0; c < channels; c++) {
+            multiplyAdd(sum.data() + c * 2 * bins, x + c * 2 * bins, h + c * 2 * bins, bins);
+        }
+    }
+    if (tailPartitions > 0 && n >= headPartitions) {
+        const int slot = static_cast<int>(n % RING_BLOCKS);
+        if (waitForTail.load(std::memory_order_relaxed)) {
+            while (fromTailSlots[slot].block.load(std::memory_order_acquire) != n) {
+                std::this_thread::yield();
+            }
+        }
+        if (fromTailSlots[slot].block.load(std::memory_order_acquire) == n) {
+            const float *tail = fromTail.data() + slot * spectrumFloats;
+            for (size_t i = 0; i < spectrumFloats; i++) {
+                sum[i] += tail[i];
+            }
+        } else {
+            stats.lateTailBlocks.store(
+                stats.lateTailBlocks.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        }
+    }
+
+    // Overlap-save: the second half of the inverse is this block's output
+    const float from = wetNow;
+    const float to = wetTarget.load(std::memory_order_relaxed);
+    const float gainStep = (to - from) / static_cast<float>(blockFrames);
+    for (int c = 0; c < channels; c++) {
+        const float *channel = sum.data() + c * 2 * bins;
+        headFft.inverse(channel, channel + bins, time.data());
+        float *out = wet.data() + c * blockFrames;
+        const float *tail = time.data() + blockFrames;
+        for (int32_t i = 0; i < blockFrames; i++) {
+            out[i] = tail[i] * (from + gainStep * static_cast<float>(i + 1));
+        }
+    }
+    wetNow = to;
+    stats.blocks.store(n + 1, std::memory_order_relaxed);
+}
+
+void ConvolutionReverb::workerLoop() {
+    // A normal-priority thread: below the callback, which never waits for
+    // it, and ahead of background work such as the recorder's writer
+    int64_t next = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        if (next < blocksSent.load(std::memory_order_acquire)) {
+            const int slot = static_cast<int>(next % RING_BLOCKS);
+            float *spectrum = tailHistory.data() + (next % tailPartitions) * spectrumFloats;
+            if (toTailSlots[slot].block.load(std::memory_order_acquire) == next) {
+                std::copy_n(toTail.data() + slot * spectrumFloats, spectrumFloats, spectrum);
+            } else {
+                // Dropped while we were behind: silence in the delay line
+                std::fill_n(spectrum, spectrumFloats, 0.0f);
+            }
+            blocksTaken.store(next + 1, std::memory_order_release);
+            computeTail(next);
+            next++;
+            continue;
+        }
+
+        parked.store(true, std::memory_order_seq_cst);
+        if (next >= blocksSent.load(std::memory_order_seq_cst)) {
+            std::unique_lock<std::mutex> lock(parkLock);
+            parkSignal.wait_for(lock, PARK_TIMEOUT, [&] {
+                return next < blocksSent.load(std::memory_order_seq_cst) ||
+                       !running.load(std::memory_order_relaxed);
+            });
+        }
+        parked.store(false, std::memory_order_relaxed);
+    }
+}
+
+void ConvolutionReverb::computeTail(int64_t next) {
+    const int64_t start = nowNanos();
+    std::fill(tailSum.begin(), tailSum.end(), 0.0f);
+    // Spectrum of input block next - q meets response partition head + q
+    for (int q = 0; q < tailPartitions && q <= next; q++) {
+        const float *x = tailHistory.data() + ((next - q) % tailPartitions) * spectrumFloats;
+        const float *h = response.data() + (headPartitions + q) * spectrumFloats;
+        for (int c = 0; c < channels; c++) {
+            multiplyAdd(tailSum.data() + c * 2 * bins, x + c * 2 * bins, h + c * 2 * bins,
+                        bins);
+        }
+    }
+    const int64_t target = next + headPartitions;
+    const int slot = static_cast<int>(target % RING_BLOCKS);
+    std::copy(tailSum.begin(), tailSum.end(), fromTail.data() + slot * spectrumFloats);
+    fromTailSlots[slot].block.store(target, std::memory_order_release);
+
+    stats.tailBlocks.store(next + 1, std::memory_order_relaxed);
+    stats.tailNanos.store(stats.tailNanos.load(std::memory_order_relaxed) + nowNanos() - start,
+                          std::memory_order_relaxed);
+}
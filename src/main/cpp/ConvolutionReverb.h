@@ -0,0 +1,173 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Partitioned FFT convolution reverb with a background tail thread
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RealFft.h"
+
+// An impulse response as decoded from a WAV file: interleaved float frames
+struct ImpulseResponse {
+  std::vector<float> samples;
+  int channels = 0;
+  int32_t sampleRate = 0;
+
+  int32_t frames() const {
+    return channels > 0 ? static_cast<int32_t>(samples.size() / channels) : 0;
+  }
+
+  // Decodes any WAV parselib reads (8/16/24/32-bit PCM, float). Returns
+  // false, leaving this empty, if the file is missing or not a WAV.
+  bool load(const std::string &path);
+};
+
+/*
+ * Convolves the master output with an impulse response of up to
+ * MAX_SECONDS, uniformly partitioned into blocks of `blockFrames`
+ * (overlap-save with FFTs of twice that).
+ *
+ * The audio thread collects each block of input, transforms it once, and
+ * convolves it with the first `headPartitions` partitions itself. The rest
+ * of the response (the tail) is worked out on a worker thread: the audio
+ * thread hands it each input spectrum through a lock-free ring; the worker
+ * keeps them in a frequency-domain delay line and hands back the tail's
+ * part of the output spectrum headPartitions blocks ahead of when it is
+ * needed, through a second ring. The callback then only adds that spectrum
+ * in before its one inverse FFT, so its cost does not grow with the length
+ * of the response.
+ *
+ * A tail block the worker has not delivered in time is left out (and
+ * counted in Stats::lateTailBlocks); the audio thread never waits. The
+ * reverb comes out blockFrames late (see getLatencyFrames()), which reads
+ * as a little pre-delay; the dry signal is untouched.
+ *
+ * A mono response is used for every channel; a stereo one goes left to
+ * left and right to right. Responses at another rate are resampled
+ * (linearly) when the reverb is built.
+ *
+ * Threading: the constructor and destructor from a control thread;
+ * process() from the audio thread only; setWetLevel() and getters from any
+ * thread.
+ */
+class ConvolutionReverb {
+public:
+  static constexpr int MAX_CHANNELS = 2;
+  static constexpr int32_t DEFAULT_BLOCK_FRAMES = 128;
+  static constexpr int DEFAULT_HEAD_PARTITIONS = 4;
+  // Blocks each ring holds: how far the worker may fall behind before input
+  // to the tail is dropped
+  static constexpr int RING_BLOCKS = 32;
+  static constexpr double MAX_SECONDS = 10.0;
+
+  struct Stats {
+    // Blocks of blockFrames the audio thread has processed
+    std::atomic<int64_t> blocks{0};
+    // Tail blocks the worker computed, and the time it spent on them
+    std::atomic<int64_t> tailBlocks{0};
+    std::atomic<int64_t> tailNanos{0};
+    // Blocks played without their tail because the worker was late
+    std::atomic<int64_t> lateTailBlocks{0};
+    // Input blocks the tail never saw because the worker fell a whole ring
+    // behind
+    std::atomic<int64_t> droppedBlocks{0};
+  };
+
+  // Partitions `impulse` for `channels` (1 or 2) interleaved channels at
+  // sampleRate and starts the tail worker if the response is longer than
+  // the head. blockFrames is rounded up to a power of two, at least 16.
+  ConvolutionReverb(const ImpulseResponse &impulse, int32_t sampleRate, int channels,
+                    int32_t blockFrames = DEFAULT_BLOCK_FRAMES,
+                    int headPartitions = DEFAULT_HEAD_PARTITIONS);
+  ~ConvolutionReverb();
+
+  ConvolutionReverb(const ConvolutionReverb &) = delete;
+  ConvolutionReverb &operator=(const ConvolutionReverb &) = delete;
+
+  // Linear gain of the reverb added to the signal; ramped over a block
+  void setWetLevel(float level) { wetTarget.store(level, std::memory_order_relaxed); }
+
+  // For offline renders that outrun real time: process() waits for each
+  // tail block instead of playing on without it. Never on an audio thread.
+  void setOffline(bool offline) { waitForTail.store(offline, std::memory_order_relaxed); }
+
+  int getChannelCount() const { return channels; }
+  int32_t getBlockFrames() const { return blockFrames; }
+  int getPartitionCount() const { return partitions; }
+  int getHeadPartitions() const { return headPartitions; }
+  int32_t getLatencyFrames() const { return blockFrames; }
+  const Stats &getStats() const { return stats; }
+
+  // Audio thread: adds the reverb of numFrames interleaved frames to them,
+  // in place
+  void process(float *output, int32_t numFrames);
+
+private:
+  // One spectrum per channel, as bins real parts then bins imaginary parts
+  // per channel, tagged with the block it belongs to
+  struct Slot {
+    std::atomic<int64_t> block{-1};
+  };
+
+  const int channels;
+  const int32_t blockFrames;
+  int bins = 0;
+  int partitions = 0;
+  int headPartitions = 0;
+  int tailPartitions = 0;
+  // Floats in one spectrum of every channel
+  size_t spectrumFloats = 0;
+
+  // The partitioned response: spectrum p at p * spectrumFloats
+  std::vector<float> response;
+
+  // Audio thread
+  RealFft headFft;
+  std::vector<float> input;      // planar, blockFrames per channel
+  std::vector<float> previous;   // last block's input, same layout
+  std::vector<float> wet;        // reverb being played out, same layout
+  std::vector<float> headHistory; // last headPartitions input spectra
+  std::vector<float> sum;
+  std::vector<float> time;
+  int32_t filled = 0;
+  int64_t block = 0;
+  float wetNow = 0.0f;
+  std::atomic<float> wetTarget{1.0f};
+  std::atomic<bool> waitForTail{false};
+
+  // Input spectra to the worker and tail spectra back, RING_BLOCKS each
+  std::vector<float> toTail;
+  std::vector<float> fromTail;
+  Slot toTailSlots[RING_BLOCKS];
+  Slot fromTailSlots[RING_BLOCKS];
+  std::atomic<int64_t> blocksSent{0};
+  std::atomic<int64_t> blocksTaken{0};
+
+  // Worker
+  std::vector<float> tailHistory; // last tailPartitions input spectra
+  std::vector<float> tailSum;
+  std::thread worker;
+  std::atomic<bool> running{true};
+  std::mutex parkLock;
+  std::condition_variable parkSignal;
+  std::atomic<bool> parked{false};
+
+  Stats stats;
+
+  void processBlock();
+  void workerLoop();
+  // Worker: the tail for the output block `headPartitions` after input
+  // block `next`, whose spectrum is at the front of tailHistory
+  void computeTail(int64_t next);
+};
@@ -0,0 +1,260 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Master and send effects bus built from the fxlab effects
+ */
+
+#include "EffectsBus.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// fxlab's effect templates; Effects.h defines the SAMPLE_RATE their
+// constructors default to, which the bus always overrides
+#include "Effects.h"
+#include "EchoEffect.h"
+#include "FlangerEffect.h"
+#include "TremoloEffect.h"
+#include "WhiteChorusEffect.h"
+
+struct EffectsBus::Chain {
+    std::vector<std::unique_ptr<Effect>> master[MAX_CHANNELS];
+    std::vector<std::unique_ptr<Effect>> send[MAX_CHANNELS];
+    int32_t sampleRate = 48000;
+
+    bool empty() const { return master[0].empty() && send[0].empty(); }
+};
+
+namespace {
+
+// One channel of an fxlab effect, run through its block (begin, end) operator
+template <class Fx>
+class FxlabEffect final : public EffectsBus::Effect {
+public:
+    template <class... Args>
+    explicit FxlabEffect(Args &&...args) : fx(std::forward<Args>(args)...) {}
+
+    void process(float *samples, int32_t numFrames) override {
+        fx(samples, samples + numFrames);
+    }
+
+private:
+    Fx fx;
+};
+
+float clampTime(float ms) { return std::clamp(ms, 0.1f, 2000.0f); }
+float clampFeedback(float gain) { return std::clamp(gain, -0.99f, 0.99f); }
+
+// dst[i] = src[i] * gain, gain moving linearly from `from` (exclusive) to
+// `to` (reached on the last frame)
+void applyRamp(float *dst, const float *src, int32_t numFrames, float from, float to) {
+    const float step = (to - from) / static_cast<float>(numFrames);
+    for (int32_t i = 0; i < numFrames; i++) {
+        dst[i] = src[i] * (from + step * static_cast<float>(i + 1));
+    }
+}
+
+} // namespace
+
+EffectSpec EffectSpec::echo(float feedback, float delayMs) {
+    return {Type::ECHO, {feedback, delayMs}};
+}
+
+EffectSpec EffectSpec::flanger(float depthMs, float frequency, float feedback) {
+    return {Type::FLANGER, {depthMs, frequency, feedback}};
+}
+
+EffectSpec EffectSpec::whiteChorus(float depthMs, float delayMs, float noisePass) {
+    return {Type::WHITE_CHORUS, {depthMs, delayMs, noisePass}};
+}
+
+EffectSpec EffectSpec::tremolo(float frequency, float height) {
+    return {Type::TREMOLO, {frequency, height}};
+}
+
+EffectSpec EffectSpec::delayLine(float blend, float feedForward, float feedBack, float delayMs) {
+    return {Type::DELAY_LINE, {blend, feedForward, feedBack, delayMs}};
+}
+
+std::unique_ptr<EffectsBus::Effect> EffectsBus::makeEffect(const EffectSpec &spec,
+                                                           int32_t sampleRate, int channel) {
+    const float *p = spec.params;
+    switch (spec.type) {
+    case EffectSpec::Type::ECHO:
+        return std::make_unique<FxlabEffect<EchoEffect<float *>>>(
+            clampFeedback(p[0]), clampTime(p[1]), sampleRate);
+    case EffectSpec::Type::FLANGER:
+        return std::make_unique<FxlabEffect<FlangerEffect<float *>>>(
+            clampTime(p[0]), p[1], clampFeedback(p[2]), sampleRate);
+    case EffectSpec::Type::WHITE_CHORUS:
+        // Per-channel noise, so the two sides drift apart and widen the image
+        return std::make_unique<FxlabEffect<WhiteChorusEffect<float *>>>(
+            clampTime(p[0]), clampTime(p[1]), p[2], sampleRate,
+            static_cast<uint32_t>(channel + 1));
+    case EffectSpec::Type::TREMOLO:
+        return std::make_unique<FxlabEffect<TremoloEffect>>(p[0], std::clamp(p[1], 0.0f, 1.0f),
+                                                            sampleRate);
+    case EffectSpec::Type::DELAY_LINE: {
+        const int delay = std::max(1, static_cast<int>(clampTime(p[3]) * sampleRate / 1000));
+        return std::make_unique<FxlabEffect<DelayLineEffect<float *>>>(
+            p[0], p[1], clampFeedback(p[2]), delay, 0, std::function<float()>{[]() {
+                return 0.0f;
+            }});
+    }
+    default:
+        return nullptr;
+    }
+}
+
+EffectsBus::EffectsBus() = default;
+
+EffectsBus::~EffectsBus() {
+    // Nothing renders any more, so every snapshot can go
+    delete current;
+    delete pending.exchange(nullptr);
+    std::lock_guard<std::mutex> lock(controlLock);
+    reclaimLocked();
+}
+
+void EffectsBus::setSampleRate(int32_t rate) {
+    std::lock_guard<std::mutex> lock(controlLock);
+    sampleRate = rate;
+    publishLocked();
+}
+
+void EffectsBus::setMasterChain(const std::vector<EffectSpec> &effects) {
+    std::lock_guard<std::mutex> lock(controlLock);
+    masterSpecs = effects;
+    publishLocked();
+}
+
+void EffectsBus::setSendChain(const std::vector<EffectSpec> &effects) {
+    std::lock_guard<std::mutex> lock(controlLock);
+    sendSpecs = effects;
+    publishLocked();
+}
+
+void EffectsBus::setSendLevel(float level) {
+    sendLevel.target.store(level, std::memory_order_relaxed);
+}
+
+void EffectsBus::setOutputGain(float gain) {
+    outputGain.target.store(gain, std::memory_order_relaxed);
+}
+
+void EffectsBus::reclaimLocked() {
+    Chain *chain;
+    while (retired.pop(chain)) {
+        delete chain;
+    }
+}
+
+void EffectsBus::publishLocked() {
+    reclaimLocked();
+
+    auto chain = std::make_unique<Chain>();
+    chain->sampleRate = sampleRate;
+    for (int c = 0; c < MAX_CHANNELS; c++) {
+        for (const EffectSpec &spec : masterSpecs) {
+            if (auto effect = makeEffect(spec, sampleRate, c)) {
+                chain->master[c].push_back(std::move(effect));
+            }
+        }
+        for (const EffectSpec &spec : sendSpecs) {
+            if (auto effect = makeEffect(spec, sampleRate, c)) {
+                chain->send[c].push_back(std::move(effect));
+            }
+        }
+    }
+
+    // A snapshot the audio thread never took can be freed right here
+    delete pending.exchange(chain.release(), std::memory_order_acq_rel);
+}
+
+float EffectsBus::SmoothedGain::next(int32_t numFrames, int32_t sampleRate) {
+    const float goal = target.load(std::memory_order_relaxed);
+    const double k = 1.0 - std::exp(-numFrames / (SMOOTHING_TIME * sampleRate));
+    current += static_cast<float>((goal - current) * k);
+    if (std::abs(goal - current) < 1e-4f) {
+        current = goal;
+    }
+    return current;
+}
+
+void EffectsBus::process(float *output, int32_t numFrames, int channels) {
+    if (pending.load(std::memory_order_relaxed) != nullptr) {
+        // Every publish drains `retired` first, so at most two snapshots are
+        // ever on their way back and the push cannot fail
+        if (Chain *next = pending.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (current != nullptr) {
+                retired.push(current);
+            }
+            current = next;
+        }
+    }
+
+    if ((current == nullptr || current->empty()) && outputGain.settled() &&
+        outputGain.current == 1.0f) {
+        return;
+    }
+
+    for (int32_t offset = 0; offset < numFrames; offset += BLOCK_FRAMES) {
+        processBlock(output + offset * channels, std::min(BLOCK_FRAMES, numFrames - offset),
+                     channels);
+    }
+}
+
+void EffectsBus::processBlock(float *output, int32_t numFrames, int channels) {
+    const int32_t rate = current != nullptr ? current->sampleRate : 48000;
+
+    // Planar working copy; mono works on the output directly
+    float *planes[MAX_CHANNELS] = {left, right};
+    float *sends[MAX_CHANNELS] = {sendLeft, sendRight};
+    if (channels == 2) {
+        for (int32_t i = 0; i < numFrames; i++) {
+            left[i] = output[2 * i];
+            right[i] = output[2 * i + 1];
+        }
+    } else {
+        planes[0] = output;
+    }
+
+    if (current != nullptr && !current->send[0].empty()) {
+        const float from = sendLevel.current;
+        const float to = sendLevel.next(numFrames, rate);
+        for (int c = 0; c < channels; c++) {
+            applyRamp(sends[c], planes[c], numFrames, from, to);
+            for (auto &effect : current->send[c]) {
+                effect->process(sends[c], numFrames);
+            }
+            float *plane = planes[c];
+            const float *send = sends[c];
+            for (int32_t i = 0; i < numFrames; i++) {
+                plane[i] += send[i];
+            }
+        }
+    }
+
+    if (current != nullptr) {
+        for (int c = 0; c < channels; c++) {
+            for (auto &effect : current->master[c]) {
+                effect->process(planes[c], numFrames);
+            }
+        }
+    }
+
+    const float from = outputGain.current;
+    const float to = outputGain.next(numFrames, rate);
+    if (channels == 2) {
+        const float step = (to - from) / static_cast<float>(numFrames);
+        for (int32_t i = 0; i < numFrames; i++) {
+            const float gain = from + step * static_cast<float>(i + 1);
+            output[2 * i] = left[i] * gain;
+            output[2 * i + 1] = right[i] * gain;
+        }
+    } else if (from != 1.0f || to != 1.0f) {
+        applyRamp(output, output, numFrames, from, to);
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Master and send effects bus built from the fxlab effects
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "NoteEventQueue.h"
+
+// One effect in a chain. The parameters are the fxlab ones, in the order of
+// the effect's constructor; build specs with the helpers below.
+struct EffectSpec {
+  enum class Type : int32_t { ECHO, FLANGER, WHITE_CHORUS, TREMOLO, DELAY_LINE, COUNT };
+  static constexpr int MAX_PARAMS = 4;
+
+  Type type = Type::ECHO;
+  float params[MAX_PARAMS] = {};
+
+  static EffectSpec echo(float feedback, float delayMs);
+  // feedback should be about 0.7071
+  static EffectSpec flanger(float depthMs, float frequency, float feedback);
+  static EffectSpec whiteChorus(float depthMs, float delayMs, float noisePass);
+  static EffectSpec tremolo(float frequency, float height);
+  // Fixed (unmodulated) DelayLineEffect
+  static EffectSpec delayLine(float blend, float feedForward, float feedBack, float delayMs);
+};
+
+/*
+ * Post-synth effects, processed in place on the rendered buffer:
+ *
+ *     dry ──┬──────────────────────(+)── master chain ── gain ──> out
+ *           └── send level ── send chain ──┘
+ *
+ * The send chain is an aux loop (echo, chorus: their output is added back
+ * to the dry signal); the master chain is a series of inserts. Each effect
+ * runs over a planar block of up to BLOCK_FRAMES frames per channel, so the
+ * per-sample work is a tight loop over contiguous floats, and the send level
+ * and output gain are linear ramps across the block that the compiler
+ * vectorises. Both gains glide towards their targets over ~SMOOTHING_TIME
+ * seconds, block after block, so parameter changes never click.
+ *
+ * Chains are immutable snapshots. The control side builds a new one (all
+ * allocation happens there) and publishes it with one atomic exchange; the
+ * audio thread picks it up at the start of its next buffer and hands the old
+ * one back through a lock-free queue for the control side to delete. The
+ * audio thread never allocates, frees or waits.
+ *
+ * With both chains empty and the gain at unity, process() returns without
+ * touching the buffer.
+ *
+ * Threading: setMasterChain/setSendChain/setSendLevel/setOutputGain from any
+ * thread; process() from the audio thread only; setSampleRate() must not
+ * race process().
+ */
+class EffectsBus {
+public:
+  static constexpr int32_t BLOCK_FRAMES = 256;
+  static constexpr int MAX_CHANNELS = 2;
+  static constexpr double SMOOTHING_TIME = 0.02;
+
+  EffectsBus();
+  ~EffectsBus();
+
+  EffectsBus(const EffectsBus &) = delete;
+  EffectsBus &operator=(const EffectsBus &) = delete;
+
+  // Rebuilds the chains for the new rate (delay lengths and LFO rates are
+  // in samples); effect state starts from silence
+  void setSampleRate(int32_t rate);
+
+  // Replace a whole chain; effects in the old chain lose their tails
+  void setMasterChain(const std::vector<EffectSpec> &effects);
+  void setSendChain(const std::vector<EffectSpec> &effects);
+
+  // Linear gains; applied with smoothing
+  void setSendLevel(float level);
+  void setOutputGain(float gain);
+
+  // Audio thread: numFrames frames of `channels` (1 or 2) interleaved samples
+  void process(float *output, int32_t numFrames, int channels);
+
+  // Builds one channel of an fxlab effect; the bus's own factory, exposed for
+  // benchmarks. Returns nullptr for an unknown type.
+  class Effect {
+  public:
+    virtual ~Effect() = default;
+    virtual void process(float *samples, int32_t numFrames) = 0;
+  };
+  static std::unique_ptr<Effect> makeEffect(const EffectSpec &spec, int32_t sampleRate,
+                                            int channel);
+
+private:
+  struct Chain;
+
+  // Linear gain that moves a fixed fraction of the way to its target per block
+  struct SmoothedGain {
+    std::atomic<float> target{1.0f};
+    float current = 1.0f;
+    bool settled() const { return current == target.load(std::memory_order_relaxed); }
+    float next(int32_t numFrames, int32_t sampleRate);
+  };
+
+  // Control side
+  std::mutex controlLock;
+  std::vector<EffectSpec> masterSpecs;
+  std::vector<EffectSpec> sendSpecs;
+  int32_t sampleRate = 48000;
+
+  // Published by the control side, taken by the audio thread
+  std::atomic<Chain *> pending{nullptr};
+  // Old snapshots on their way back to the control side. Pushed only by the
+  // audio thread, popped only under controlLock.
+  NoteEventQueue<Chain *, 8> retired;
+
+  // Audio thread only
+  Chain *current = nullptr;
+  SmoothedGain sendLevel;
+  SmoothedGain outputGain;
+  float left[BLOCK_FRAMES];
+  float right[BLOCK_FRAMES];
+  float sendLeft[BLOCK_FRAMES];
+  float sendRight[BLOCK_FRAMES];
+
+  void publishLocked();
+  void reclaimLocked();
+  void processBlock(float *output, int32_t numFrames, int channels);
+};
@@ -0,0 +1,135 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Lock-free audio-thread health counters
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Every counter is an atomic int64 written by the audio thread with relaxed
+ * plain stores (single writer, so no read-modify-write is needed) and read
+ * by any thread with relaxed loads. Readers may see a snapshot that mixes two
+ * callbacks, which is fine for telemetry.
+ *
+ * The only multi-writer counter is DROPPED_EVENTS, bumped by whichever
+ * thread found the note event queue full.
+ */
+class EngineStats {
+public:
+  // Layout of snapshot(); also the layout of the nativeGetStats array
+  enum Index : int {
+    CALLBACKS,
+    FRAMES_RENDERED,
+    LAST_RENDER_NANOS,
+    MAX_RENDER_NANOS,
+    // Render time as a fraction of the buffer period, in 1/1000
+    LAST_LOAD_PERMILLE,
+    MAX_LOAD_PERMILLE,
+    ACTIVE_VOICES,
+    PEAK_VOICES,
+    VOICE_STEALS,
+    // Events whose frame had already passed when the audio thread saw them
+    LATE_EVENTS,
+    DROPPED_EVENTS,
+    XRUNS,
+    // Device buffer size in frames (latency), as last reported by the stream
+    BUFFER_FRAMES,
+    // Sampler blocks that needed tail frames the prefetch thread had not
+    // streamed in yet (played as silence)
+    STREAM_UNDERRUNS,
+    // Callbacks on the silent fast path (see SynthCore::isIdle()), the frames
+    // they covered and the render time they took: the wakeups and CPU the
+    // engine still costs while nothing plays
+    IDLE_CALLBACKS,
+    IDLE_FRAMES,
+    IDLE_RENDER_NANOS,
+    // Times the stream was stopped after a long idle stretch and restarted
+    // by a new event
+    SUSPENDS,
+    RESUMES,
+    // From the event that restarted the stream to its first non-zero output
+    // sample
+    LAST_RESUME_NANOS,
+    MAX_RESUME_NANOS,
+    // Callbacks per 10% load band: [0, 10%), ..., [90, 100%), >= 100%
+    LOAD_HISTOGRAM,
+    COUNT = LOAD_HISTOGRAM + 11
+  };
+  static constexpr int LOAD_BUCKETS = COUNT - LOAD_HISTOGRAM;
+
+  EngineStats() { reset(); }
+
+  // Audio thread, once per callback
+  void recordCallback(int64_t renderNanos, int32_t numFrames, int32_t sampleRate) {
+    const int64_t periodNanos = static_cast<int64_t>(numFrames) * 1000000000LL /
+                                (sampleRate > 0 ? sampleRate : 1);
+    const int64_t permille = periodNanos > 0 ? renderNanos * 1000 / periodNanos : 0;
+    bump(CALLBACKS);
+    set(FRAMES_RENDERED, get(FRAMES_RENDERED) + numFrames);
+    set(LAST_RENDER_NANOS, renderNanos);
+    raise(MAX_RENDER_NANOS, renderNanos);
+    set(LAST_LOAD_PERMILLE, permille);
+    raise(MAX_LOAD_PERMILLE, permille);
+    int bucket = static_cast<int>(permille / 100);
+    bump(LOAD_HISTOGRAM + (bucket < LOAD_BUCKETS ? bucket : LOAD_BUCKETS - 1));
+  }
+
+  // Audio thread, instead of recordCallback() for a fast-path callback
+  void recordIdleCallback(int64_t renderNanos, int32_t numFrames, int32_t sampleRate) {
+    recordCallback(renderNanos, numFrames, sampleRate);
+    bump(IDLE_CALLBACKS);
+    set(IDLE_FRAMES, get(IDLE_FRAMES) + numFrames);
+    set(IDLE_RENDER_NANOS, get(IDLE_RENDER_NANOS) + renderNanos);
+  }
+
+  // Audio thread
+  void countSuspend() { bump(SUSPENDS); }
+  void recordResume(int64_t latencyNanos) {
+    bump(RESUMES);
+    set(LAST_RESUME_NANOS, latencyNanos);
+    raise(MAX_RESUME_NANOS, latencyNanos);
+  }
+  void recordVoices(int active) {
+    set(ACTIVE_VOICES, active);
+    raise(PEAK_VOICES, active);
+  }
+  void countSteal() { bump(VOICE_STEALS); }
+  void countLateEvent() { bump(LATE_EVENTS); }
+  void countStreamUnderrun() { bump(STREAM_UNDERRUNS); }
+
+  // Any thread
+  void countDroppedEvent(int64_t count = 1) {
+    values[DROPPED_EVENTS].fetch_add(count, std::memory_order_relaxed);
+  }
+  void setXRuns(int64_t xruns) { set(XRUNS, xruns); }
+  void setBufferFrames(int64_t frames) { set(BUFFER_FRAMES, frames); }
+
+  void snapshot(int64_t *out) const {
+    for (int i = 0; i < COUNT; i++) {
+      out[i] = values[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  int64_t get(int i) const { return values[i].load(std::memory_order_relaxed); }
+
+  // Not safe against a running audio thread; for setup and tests
+  void reset() {
+    for (auto &value : values) {
+      value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  std::atomic<int64_t> values[COUNT];
+
+  void set(int i, int64_t value) { values[i].store(value, std::memory_order_relaxed); }
+  void bump(int i) { set(i, get(i) + 1); }
+  void raise(int i, int64_t value) {
+    if (value > get(i)) set(i, value);
+  }
+};
@@ -0,0 +1,1839 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Synth core tests, shared by the JNI test hook and the host test runner.
+ * Returns a string with "FAIL: reason" per failing check and a summary line.
+ */
+
+#include "EngineTests.h"
+#include "ConvolutionReverb.h"
+#include "EffectsBus.h"
+#include "EventRing.h"
+#include "OutputRecorder.h"
+#include "RealFft.h"
+#include "SampleLibrary.h"
+#include "Sequencer.h"
+#include "StreamingSampler.h"
+#include "SynthCore.h"
+#include "Tuning.h"
+#include "VoiceFilter.h"
+#include "VoiceModulation.h"
+#include "VoiceWorkerPool.h"
+#include "WavWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifdef ONGOMA_COUNT_ALLOCATIONS
+#include "AllocationCounter.h"
+#else
+// Only the host test runner links the counting operator new; elsewhere (the
+// on-device test hook) nothing is counted and the allocation checks pass
+static thread_local bool t_countAllocations = false;
+static thread_local int t_allocationCount = 0;
+#endif
+
+std::string runEngineTests() {
+    std::ostringstream results;
+    int passed = 0;
+    int failed = 0;
+
+    auto check = [&](const char* name, bool condition, const char* detail = "") {
+        if (condition) {
+            passed++;
+        } else {
+            failed++;
+            results << "FAIL: " << name << " " << detail << "\n";
+        }
+    };
+
+    // Runs body() with allocation counting armed, then checks it allocated
+    // nothing: for everything that runs on the audio thread
+    auto expectNoAllocations = [&](const char *name, auto &&body) {
+        t_allocationCount = 0;
+        t_countAllocations = true;
+        body();
+        t_countAllocations = false;
+        check(name, t_allocationCount == 0,
+              ("allocations=" + std::to_string(t_allocationCount)).c_str());
+    };
+
+    // --- midiNoteToFrequency tests ---
+    {
+        SynthCore engine;
+        // A4 = MIDI 69 = 440 Hz
+        double a4 = 440.0 * std::pow(2.0, (69.0 - 69.0) / 12.0);
+        check("A4 is 440Hz", std::abs(a4 - 440.0) < 0.01);
+
+        // C4 = MIDI 60 ≈ 261.63 Hz
+        double c4 = 440.0 * std::pow(2.0, (60.0 - 69.0) / 12.0);
+        check("C4 is ~261.63Hz", std::abs(c4 - 261.63) < 0.1);
+
+        // MIDI 0 = C-1 ≈ 8.18 Hz
+        double c_neg1 = 440.0 * std::pow(2.0, (0.0 - 69.0) / 12.0);
+        check("MIDI 0 is ~8.18Hz", std::abs(c_neg1 - 8.18) < 0.01);
+
+        // MIDI 127 = G9 ≈ 12543.85 Hz
+        double g9 = 440.0 * std::pow(2.0, (127.0 - 69.0) / 12.0);
+        check("MIDI 127 is ~12543Hz", std::abs(g9 - 12543.85) < 1.0);
+
+        // Octave relationship: MIDI N+12 = 2x frequency of MIDI N
+        double f60 = 440.0 * std::pow(2.0, (60.0 - 69.0) / 12.0);
+        double f72 = 440.0 * std::pow(2.0, (72.0 - 69.0) / 12.0);
+        check("Octave doubles frequency", std::abs(f72 / f60 - 2.0) < 0.001);
+    }
+
+    // --- Tuning ---
+    {
+        Tuning tuning;
+        bool matches12Tet = true;
+        for (int note = 0; note < Tuning::NUM_NOTES; note++) {
+            const double expected = SynthCore::midiNoteToFrequency(note);
+            matches12Tet &= std::abs(tuning.frequency(note) / expected - 1.0) < 1e-12 &&
+                            tuning.phaseIncrement(note) ==
+                                OscillatorKernel::phaseIncrementFor(expected, 48000);
+        }
+        check("Default tuning is 12-TET at 48 kHz", matches12Tet);
+
+        TuningScale edo = TuningScale::equalDivisions(24);
+        edo.rootNote = 62;
+        tuning.setScale(edo);
+        const double before = tuning.frequency(63);
+        tuning.beginBlock();
+        const double root = SynthCore::midiNoteToFrequency(62);
+        check("New tables apply from the next block",
+              std::abs(before / SynthCore::midiNoteToFrequency(63) - 1.0) < 1e-12 &&
+                  std::abs(tuning.frequency(63) / root - std::exp2(1.0 / 24)) < 1e-12 &&
+                  std::abs(tuning.frequency(86) / root - 2.0) < 1e-12 &&
+                  std::abs(tuning.frequency(38) / root - 0.5) < 1e-12 &&
+                  std::abs(tuning.frequency(61) / root - std::exp2(-1.0 / 24)) < 1e-12);
+
+        tuning.setSampleRate(96000);
+        check("Increments follow the sample rate",
+              tuning.phaseIncrement(63) ==
+                      OscillatorKernel::phaseIncrementFor(tuning.frequency(63), 96000) &&
+                  tuning.phaseIncrement(127) < 0x80000000u);
+
+        TuningScale scala;
+        const bool parsed = TuningScale::parseScala("! just.scl\n!\nJust major\n 7\n!\n"
+                                                    " 9/8\n 5/4 major third\n 4/3\n"
+                                                    " 701.955\n 5/3\n 15/8\n 2\n",
+                                                    scala);
+        scala.rootNote = 60;
+        tuning.setScale(scala);
+        tuning.beginBlock();
+        const double c4 = SynthCore::midiNoteToFrequency(60);
+        check("Scala scales map degrees onto notes",
+              parsed && scala.cents.size() == 7 &&
+                  std::abs(tuning.frequency(62) / c4 - 1.25) < 1e-9 &&
+                  std::abs(tuning.frequency(64) / c4 - 1.5) < 1e-5 &&
+                  std::abs(tuning.frequency(67) / c4 - 2.0) < 1e-9 &&
+                  std::abs(tuning.frequency(59) / c4 - 15.0 / 16) < 1e-9);
+
+        TuningScale untouched = scala;
+        check("Malformed Scala text is rejected",
+              !TuningScale::parseScala("Too few\n 3\n 100.0\n 1200.0\n", untouched) &&
+                  !TuningScale::parseScala("Bad ratio\n 1\n 3/0\n", untouched) &&
+                  !TuningScale::parseScala("Falling\n 1\n -100.0\n", untouched) &&
+                  untouched.cents == scala.cents);
+
+        // The engine plays what the table says: 19-EDO a step above the root
+        // should match the same pitch played from a custom 12-TET root
+        SynthCore tuned;
+        TuningScale nineteen = TuningScale::equalDivisions(19);
+        nineteen.rootNote = 60;
+        tuned.getTuning().setScale(nineteen);
+        SynthCore reference;
+        TuningScale shifted;
+        shifted.rootNote = 61;
+        shifted.rootFrequency = c4 * std::exp2(1.0 / 19);
+        reference.getTuning().setScale(shifted);
+        tuned.postNoteOn(61, 0, 0.0f);
+        reference.postNoteOn(61, 0, 0.0f);
+        float a[512], b[512];
+        tuned.render(a, 512);
+        reference.render(b, 512);
+        check("Engine notes follow the tuning", std::memcmp(a, b, sizeof(a)) == 0 &&
+                                                    std::abs(a[300]) > 1e-4f);
+    }
+
+    // --- Wave table tests ---
+    {
+        SynthCore engine;
+        engine.initWaveTable();
+
+        // Wave table should be initialized (not all zeros)
+        bool hasNonZero = false;
+        for (int i = 0; i < 4096; i++) {
+            if (std::abs(SynthCore::waveTable[i]) > 0.001f) {
+                hasNonZero = true;
+                break;
+            }
+        }
+        check("Wave table has non-zero values", hasNonZero);
+
+        // Wave table at index 0 should be ~0 (sin(0) = 0)
+        check("Wave table[0] near zero", std::abs(SynthCore::waveTable[0]) < 0.01f);
+
+        // Wave table should be periodic: first and last entries close
+        float first = SynthCore::waveTable[0];
+        float last = SynthCore::waveTable[4095];
+        check("Wave table wraps smoothly", std::abs(last - first) < 0.01f,
+              ("diff=" + std::to_string(std::abs(last - first))).c_str());
+
+        // Peak should be <= 1.0 (normalized)
+        float maxVal = 0.0f;
+        for (int i = 0; i < 4096; i++) {
+            float v = std::abs(SynthCore::waveTable[i]);
+            if (v > maxVal) maxVal = v;
+        }
+        check("Wave table peak <= 1.0", maxVal <= 1.001f);
+    }
+
+    // --- ADSR constants sanity ---
+    {
+        check("Attack < 50ms", SynthCore::ATTACK_TIME < 0.05);
+        check("Decay < 500ms", SynthCore::DECAY_TIME < 0.5);
+        check("Sustain 0-1", SynthCore::SUSTAIN_LEVEL > 0.0 &&
+                              SynthCore::SUSTAIN_LEVEL <= 1.0);
+        check("Release > 0", SynthCore::RELEASE_TIME > 0.0);
+        check("Max polyphony >= 8", SynthCore::MAX_POLYPHONY >= 8);
+    }
+
+    // --- Note event queue ---
+    {
+        NoteEventQueue<NoteEvent, 4> queue;
+        bool pushedAll = true;
+        for (int i = 0; i < 4; i++) {
+            pushedAll &= queue.push(NoteEvent::noteOn(60 + i, 0, 0.0f, 100));
+        }
+        check("Queue accepts up to capacity", pushedAll);
+        check("Queue rejects when full",
+              !queue.push(NoteEvent::noteOff(0, 0)));
+
+        NoteEvent event{};
+        bool inOrder = true;
+        for (int i = 0; i < 4; i++) {
+            inOrder &= queue.pop(event) && event.midiNote == 60 + i;
+        }
+        check("Queue pops in FIFO order", inOrder);
+        check("Queue empty after drain", !queue.pop(event));
+
+        // Indices keep running past the first lap
+        bool wraps = true;
+        for (int i = 0; i < 10; i++) {
+            wraps &= queue.push(NoteEvent::noteOn(i, 0, 0.0f, 100));
+            wraps &= queue.pop(event) && event.midiNote == i;
+        }
+        check("Queue wraps around", wraps);
+
+        // A batch takes what fits, in order, with one claim
+        NoteEvent batch[5];
+        for (int i = 0; i < 5; i++) {
+            batch[i] = NoteEvent::noteOn(70 + i, 0, 0.0f, 100);
+        }
+        queue.push(NoteEvent::noteOff(69, 0));
+        const uint32_t pushed = queue.push(batch, 5);
+        bool batchInOrder = queue.pop(event) && event.midiNote == 69;
+        for (int i = 0; i < 3; i++) {
+            batchInOrder &= queue.pop(event) && event.midiNote == 70 + i;
+        }
+        check("Queue batch push fills to capacity in order",
+              pushed == 3 && batchInOrder && !queue.pop(event) && queue.push(batch, 0) == 0);
+    }
+
+    // --- Sample-clocked envelope ---
+    {
+        auto params = EnvelopeParams::make(48000, 0.001, 0.002, 0.5, 0.01);
+        EnvelopeGenerator env;
+        env.noteOn(params);
+        check("Attack lasts attackFrames", env.framesLeft == params.attackFrames);
+
+        auto runStage = [&]() {
+            int32_t frames = env.framesLeft;
+            for (int32_t i = 0; i < frames; i++) {
+                env.level = env.level * env.mul + env.add;
+            }
+            env.framesLeft = 0;
+            env.advance(params);
+            return frames;
+        };
+
+        runStage();
+        check("Attack peaks at 1.0", env.level == 1.0f &&
+              env.stage == EnvelopeGenerator::Stage::DECAY);
+        runStage();
+        check("Decay settles on sustain", env.level == params.sustainLevel &&
+              env.stage == EnvelopeGenerator::Stage::SUSTAIN);
+
+        env.noteOff(params);
+        int32_t releaseFrames = runStage();
+        check("Release is exactly releaseFrames", releaseFrames == 480);
+        check("Release ends in DONE", env.isDone() && env.level == 0.0f);
+    }
+
+    // --- Sample-accurate note onset ---
+    {
+        SynthCore engine;
+        engine.initWaveTable();
+        float buffer[256];
+
+        engine.postNoteOn(69, 100);
+        engine.render(buffer, 64);
+        bool silentBefore = true;
+        for (int i = 0; i < 64; i++) {
+            silentBefore &= buffer[i] == 0.0f;
+        }
+        engine.render(buffer, 192);
+        // Output trails the event frame by the limiter's look-ahead
+        const int latency = engine.getLatencyFrames();
+        for (int i = 0; i < 36 + latency; i++) {
+            silentBefore &= buffer[i] == 0.0f;
+        }
+        bool soundsAfter = false;
+        for (int i = 37 + latency; i < 64 + latency; i++) {
+            soundsAfter |= buffer[i] != 0.0f;
+        }
+        check("Note is silent before its frame", silentBefore);
+        check("Note sounds right after its frame", soundsAfter);
+        check("Frame position advances", engine.getFramePosition() == 256);
+    }
+
+    // --- Voice pool ---
+    {
+        auto params = EnvelopeParams::make(48000, 0.001, 0.002, 0.5, 0.01);
+        VoicePool<4> pool;
+        for (int n = 0; n < 4; n++) {
+            pool.enterSegment(pool.allocate(60 + n, n), params.attackFrom(0.0f));
+        }
+        check("Pool reports full", pool.isFull() && pool.activeCount() == 4);
+        check("Note lookup finds voice", pool.midiNote[pool.find(62)] == 62);
+        check("Victim is oldest active", pool.findVictim() == pool.find(60));
+
+        pool.enterSegment(pool.find(62), params.release());
+        check("Victim prefers releasing", pool.findVictim() == pool.find(62));
+
+        pool.release(pool.find(60));
+        check("Released note is unmapped",
+              pool.find(60) == VoicePool<4>::NO_VOICE && pool.activeCount() == 3);
+        int v = pool.allocate(70, 4);
+        check("Freed voice is reused", pool.find(70) == v && pool.isFull());
+    }
+
+    // --- Band-limited mipmaps ---
+    {
+        SynthCore engine;
+        const MipmappedWavetable &mipmaps = engine.getWavetable();
+        const double nyquist = SynthCore::SAMPLE_RATE / 2.0;
+
+        check("Low notes keep every harmonic", mipmaps.harmonicsInLevel(0) == 4);
+
+        bool belowNyquist = true;
+        for (int note = 0; note < 128; note++) {
+            double f = 440.0 * std::pow(2.0, (note - 69) / 12.0);
+            int level = mipmaps.levelFor(f);
+            belowNyquist &= f * mipmaps.harmonicsInLevel(level) <= nyquist;
+        }
+        check("No note plays harmonics above Nyquist", belowNyquist);
+
+        // MIDI 127 (~12.5 kHz) can only carry its fundamental
+        double g9 = 440.0 * std::pow(2.0, (127 - 69) / 12.0);
+        check("Top note is a pure fundamental",
+              mipmaps.harmonicsInLevel(mipmaps.levelFor(g9)) == 1);
+
+        // Level 0 matches the full-band reference table
+        float maxDiff = 0.0f;
+        const float *level0 = mipmaps.levelPairs(0);
+        for (int i = 0; i < SynthCore::WAVE_TABLE_SIZE; i++) {
+            maxDiff = std::max(maxDiff, std::abs(level0[2 * i] - SynthCore::waveTable[i]));
+        }
+        check("Mipmap level 0 matches wave table", maxDiff < 1e-5f);
+
+        check("Table offset selects the level",
+              mipmaps.tableOffsetFor(g9) ==
+                  static_cast<uint32_t>(mipmaps.levelFor(g9)) * OscillatorKernel::TABLE_SIZE);
+    }
+
+    // --- Oscillator kernel ---
+    {
+        SynthCore engine;
+        engine.initWaveTable();
+        const float *table = SynthCore::waveTable;
+        float pairs[OscillatorKernel::PAIR_TABLE_FLOATS];
+        OscillatorKernel::buildPairTable(table, pairs);
+
+        // A quarter cycle per sample hits 0, 1/4, 1/2, 3/4 of the table
+        uint32_t phase = 0;
+        uint32_t increment = 1u << 30;
+        uint32_t offset = 0;
+        float level = 1.0f, mul = 1.0f, add = 0.0f;
+        float out[4] = {};
+        OscillatorKernel::Voices one{&phase, &increment, &offset, &level, &mul, &add, 1};
+        OscillatorKernel::renderScalar(pairs, one, 1.0f, out, 4);
+        check("Kernel reads table at phase", out[1] == table[1024] && out[2] == table[2048]);
+        check("Kernel phase wraps", phase == 0);
+
+        // Halfway between two entries interpolates linearly
+        phase = (7u << OscillatorKernel::FRAC_BITS) + (OscillatorKernel::FRAC_MASK + 1) / 2;
+        increment = 0;
+        out[0] = 0.0f;
+        OscillatorKernel::renderScalar(pairs, one, 1.0f, out, 1);
+        check("Kernel interpolates", std::abs(out[0] - 0.5f * (table[7] + table[8])) < 1e-6f);
+
+        // Interpolation wraps from the last entry back to the first
+        phase = 0xFFFFFFFFu;
+        out[0] = 0.0f;
+        OscillatorKernel::renderScalar(pairs, one, 1.0f, out, 1);
+        check("Kernel interpolates across the wrap",
+              std::abs(out[0] - table[0]) < std::abs(table[1] - table[0]) + 1e-6f);
+
+        // Dispatched SIMD kernel matches the scalar reference, with voices
+        // spread over different mipmap levels
+        const float *mipmaps = engine.getWavetable().pairs();
+        constexpr int N = 11;
+        uint32_t phaseA[N], phaseB[N], inc[N], offsets[N];
+        float levelA[N], levelB[N], mulN[N], addN[N];
+        for (int v = 0; v < N; v++) {
+            phaseA[v] = phaseB[v] = 0x12345678u * (v + 1);
+            inc[v] = OscillatorKernel::phaseIncrementFor(110.0 * (v + 1), 48000.0);
+            offsets[v] = engine.getWavetable().tableOffsetFor(110.0 * (v + 1));
+            levelA[v] = levelB[v] = 0.1f * v;
+            mulN[v] = v % 2 ? 0.9995f : 1.0f;
+            addN[v] = v % 2 ? 0.0f : 0.0001f;
+        }
+        float outScalar[256] = {}, outSimd[256] = {};
+        OscillatorKernel::Voices a{phaseA, inc, offsets, levelA, mulN, addN, N};
+        OscillatorKernel::Voices b{phaseB, inc, offsets, levelB, mulN, addN, N};
+        OscillatorKernel::renderScalar(mipmaps, a, 0.25f, outScalar, 256);
+        OscillatorKernel::render(mipmaps, b, 0.25f, outSimd, 256);
+        float maxDiff = 0.0f;
+        for (int i = 0; i < 256; i++) {
+            maxDiff = std::max(maxDiff, std::abs(outScalar[i] - outSimd[i]));
+        }
+        bool sameState = true;
+        for (int v = 0; v < N; v++) {
+            sameState &= phaseA[v] == phaseB[v] && std::abs(levelA[v] - levelB[v]) < 1e-5f;
+        }
+        check("SIMD kernel matches scalar", maxDiff < 1e-5f,
+              (std::string(OscillatorKernel::name()) + " diff=" + std::to_string(maxDiff)).c_str());
+        check("SIMD kernel state matches scalar", sameState);
+
+        // Stereo kernels agree too, across every lane-group width
+        constexpr int S = 21;
+        uint32_t phaseS[2][S], incS[S], offsetS[S];
+        float levelS[2][S], mulS[S], addS[S], panL[S], panR[S];
+        for (int v = 0; v < S; v++) {
+            phaseS[0][v] = phaseS[1][v] = 0x9E3779B9u * (v + 1);
+            incS[v] = OscillatorKernel::phaseIncrementFor(55.0 * (v + 1), 48000.0);
+            offsetS[v] = engine.getWavetable().tableOffsetFor(55.0 * (v + 1));
+            levelS[0][v] = levelS[1][v] = 0.05f * v;
+            mulS[v] = 0.9999f;
+            addS[v] = 0.00001f;
+            OscillatorKernel::panGains(v / 10.0f - 1.0f, panL[v], panR[v]);
+        }
+        float stereoScalar[2 * 128] = {}, stereoSimd[2 * 128] = {};
+        OscillatorKernel::Voices sa{phaseS[0], incS, offsetS, levelS[0], mulS, addS, S, panL, panR};
+        OscillatorKernel::Voices sb{phaseS[1], incS, offsetS, levelS[1], mulS, addS, S, panL, panR};
+        OscillatorKernel::renderStereoScalar(mipmaps, sa, 0.25f, stereoScalar, 128);
+        OscillatorKernel::renderStereo(mipmaps, sb, 0.25f, stereoSimd, 128);
+        maxDiff = 0.0f;
+        for (int i = 0; i < 2 * 128; i++) {
+            maxDiff = std::max(maxDiff, std::abs(stereoScalar[i] - stereoSimd[i]));
+        }
+        check("SIMD stereo kernel matches scalar", maxDiff < 1e-5f,
+              ("diff=" + std::to_string(maxDiff)).c_str());
+    }
+
+    // --- Stereo pan ---
+    {
+        float left, right;
+        OscillatorKernel::panGains(0.0f, left, right);
+        check("Centre pan is -3 dB each side",
+              std::abs(left - 0.70710678f) < 1e-6f && std::abs(right - left) < 1e-6f);
+        OscillatorKernel::panGains(-1.0f, left, right);
+        check("Hard left silences the right", left == 1.0f && std::abs(right) < 1e-7f);
+        OscillatorKernel::panGains(0.3f, left, right);
+        check("Pan law keeps constant power", std::abs(left * left + right * right - 1.0f) < 1e-6f);
+
+        SynthCore engine;
+        engine.setChannelCount(2);
+        float buffer[2 * 256];
+        engine.postNoteOn(69, 0, 1.0f);
+        engine.render(buffer, 256);
+        float leftPeak = 0.0f, rightPeak = 0.0f;
+        for (int i = 0; i < 256; i++) {
+            leftPeak = std::max(leftPeak, std::abs(buffer[2 * i]));
+            rightPeak = std::max(rightPeak, std::abs(buffer[2 * i + 1]));
+        }
+        check("Hard-right note renders on the right only",
+              rightPeak > 0.01f && leftPeak < 1e-6f);
+
+        engine.postAllNotesOff(0);
+        engine.postNoteOn(60, 0, 0.0f);
+        engine.render(buffer, 256);
+        bool balanced = true;
+        // Skip what the limiter still held of the hard-right note
+        for (int i = engine.getLatencyFrames(); i < 256; i++) {
+            balanced &= buffer[2 * i] == buffer[2 * i + 1];
+        }
+        check("Centred note is identical on both channels", balanced);
+    }
+
+    // --- Voice filter ---
+    {
+        float maxError = 0.0f;
+        for (float octave = VoiceFilter::MIN_OCTAVE; octave <= VoiceFilter::MAX_OCTAVE;
+             octave += 0.01f) {
+            const double exact = std::tan(M_PI * std::exp2(static_cast<double>(octave)));
+            maxError = std::max(maxError, static_cast<float>(
+                                              std::abs(VoiceFilter::cutoffGain(octave) - exact) /
+                                              exact));
+        }
+        check("Cutoff table tracks tan()", maxError < 1e-3f,
+              ("relative error=" + std::to_string(maxError)).c_str());
+        check("Cutoff clamps below Nyquist",
+              VoiceFilter::cutoffGain(0.0f) == VoiceFilter::cutoffGain(VoiceFilter::MAX_OCTAVE));
+
+        // Filtered SIMD kernel against the scalar one, coefficients ramping,
+        // across every lane-group width
+        SynthCore engine;
+        const float *mipmaps = engine.getWavetable().pairs();
+        constexpr int S = 21;
+        uint32_t phase[2][S], inc[S], offsets[S];
+        float level[2][S], mul[S], add[S], panL[S], panR[S];
+        float s1[2][S], s2[2][S], g[2][S], a1[2][S], a2[2][S], gStep[S], a1Step[S], a2Step[S];
+        for (int v = 0; v < S; v++) {
+            phase[0][v] = phase[1][v] = 0x9E3779B9u * (v + 1);
+            inc[v] = OscillatorKernel::phaseIncrementFor(55.0 * (v + 1), 48000.0);
+            offsets[v] = engine.getWavetable().tableOffsetFor(55.0 * (v + 1));
+            level[0][v] = level[1][v] = 0.05f * v;
+            mul[v] = 0.9999f;
+            add[v] = 0.00001f;
+            OscillatorKernel::panGains(v / 10.0f - 1.0f, panL[v], panR[v]);
+            const float octave = -8.0f + 0.3f * v;
+            const VoiceFilter::Coefficients from =
+                VoiceFilter::coefficients(octave, 0.1f * (v % 9));
+            const VoiceFilter::Coefficients to = VoiceFilter::coefficients(octave - 1.0f, 0.5f);
+            s1[0][v] = s1[1][v] = 0.0f;
+            s2[0][v] = s2[1][v] = 0.0f;
+            g[0][v] = g[1][v] = from.g;
+            a1[0][v] = a1[1][v] = from.a1;
+            a2[0][v] = a2[1][v] = from.a2;
+            gStep[v] = (to.g - from.g) / 128.0f;
+            a1Step[v] = (to.a1 - from.a1) / 128.0f;
+            a2Step[v] = (to.a2 - from.a2) / 128.0f;
+        }
+        OscillatorKernel::Voices lanes[2];
+        for (int k = 0; k < 2; k++) {
+            lanes[k] = {phase[k], inc, offsets, level[k], mul, add, S, panL, panR,
+                        {s1[k], s2[k], g[k], a1[k], a2[k], gStep, a1Step, a2Step}};
+        }
+        float stereoScalar[2 * 128] = {}, stereoSimd[2 * 128] = {};
+        OscillatorKernel::renderStereoScalar(mipmaps, lanes[0], 0.25f, stereoScalar, 128);
+        OscillatorKernel::renderStereo(mipmaps, lanes[1], 0.25f, stereoSimd, 128);
+        float maxDiff = 0.0f;
+        for (int i = 0; i < 2 * 128; i++) {
+            maxDiff = std::max(maxDiff, std::abs(stereoScalar[i] - stereoSimd[i]));
+        }
+        bool sameState = true;
+        for (int v = 0; v < S; v++) {
+            sameState &= std::abs(s1[0][v] - s1[1][v]) < 1e-5f &&
+                         std::abs(s2[0][v] - s2[1][v]) < 1e-5f &&
+                         std::abs(g[0][v] - g[1][v]) < 1e-6f * g[0][v];
+        }
+        check("Filtered SIMD kernel matches scalar", maxDiff < 1e-5f,
+              ("diff=" + std::to_string(maxDiff)).c_str());
+        check("Filtered SIMD kernel state matches scalar", sameState);
+        check("Filter coefficients ramp by their steps",
+              std::abs(g[0][S - 1] - VoiceFilter::coefficients(-2.0f - 1.0f, 0.5f).g) <
+                  1e-3f * g[0][S - 1]);
+
+        // A closed filter takes the upper harmonics off a note; the same
+        // engine renders the note unfiltered once the filter is off
+        auto noteRms = [](SynthCore &synth) {
+            float buffer[480];
+            double sum = 0.0;
+            synth.postNoteOn(57, 0);
+            for (int b = 0; b < 20; b++) {
+                synth.render(buffer, 480);
+                for (float x : buffer) {
+                    sum += x * x;
+                }
+            }
+            synth.postAllNotesOff(0);
+            synth.render(buffer, 480);
+            return std::sqrt(sum / (20 * 480));
+        };
+        SynthCore::Patch patch;
+        patch.harmonics[0] = 0.0;
+        patch.harmonics[3] = 1.0;
+        patch.filterEnabled = true;
+        patch.filterCutoff = 0.0;
+        patch.filterEnvAmount = 0.0;
+        SynthCore filtered(patch);
+        const double closed = noteRms(filtered);
+        filtered.setFilter(false, 0.0f, 0.0f);
+        const double open = noteRms(filtered);
+        check("Closed filter attenuates the upper harmonics", closed < 0.5 * open,
+              ("closed=" + std::to_string(closed) + " open=" + std::to_string(open)).c_str());
+
+        // Enabled while the note sounds, at full resonance: stays bounded
+        filtered.setFilter(true, 1.0f, 1.0f);
+        const double resonant = noteRms(filtered);
+        check("Resonant filter stays bounded", std::isfinite(resonant) && resonant < 1.0,
+              ("rms=" + std::to_string(resonant)).c_str());
+    }
+
+    // --- Voice modulation ---
+    {
+        double maxExp2Error = 0.0;
+        for (float octaves = -VoiceModulation::MAX_OCTAVES;
+             octaves <= VoiceModulation::MAX_OCTAVES; octaves += 0.013f) {
+            const double exact = std::exp2(static_cast<double>(octaves));
+            maxExp2Error = std::max(maxExp2Error,
+                                    std::abs(VoiceModulation::exp2(octaves) - exact) / exact);
+        }
+        float maxLfoError = 0.0f;
+        for (uint32_t phase = 0; phase < 0xFFF00000u; phase += 0x00100003u) {
+            const double exact = std::sin(2.0 * M_PI * phase / 4294967296.0);
+            maxLfoError = std::max(maxLfoError,
+                                   static_cast<float>(std::abs(VoiceModulation::lfo(phase) -
+                                                               exact)));
+        }
+        check("Pitch table tracks exp2()", maxExp2Error < 1e-5,
+              ("relative error=" + std::to_string(maxExp2Error)).c_str());
+        check("LFO table tracks sin()", maxLfoError < 1e-4f,
+              ("error=" + std::to_string(maxLfoError)).c_str());
+        check("Increments stay below Nyquist",
+              VoiceModulation::scaleIncrement(1u << 30, 4.0f) == VoiceModulation::MAX_INCREMENT &&
+                  VoiceModulation::scaleIncrement(12345u, 0.0f) == 12345u);
+
+        // Modulated SIMD kernel against the scalar one, increments and gains
+        // ramping both ways, with and without the filter
+        SynthCore engine;
+        const float *mipmaps = engine.getWavetable().pairs();
+        constexpr int S = 21;
+        constexpr int FRAMES = 128;
+        uint32_t phase[2][S], inc[2][S], offsets[S];
+        int32_t incStep[S];
+        float level[2][S], mul[S], add[S], panL[S], panR[S], gain[2][S], gainStep[S];
+        float s1[2][S], s2[2][S], g[S], a1[S], a2[S], zero[S] = {};
+        bool kernelsMatch = true;
+        float maxDiff = 0.0f;
+        for (bool filtered : {false, true}) {
+            for (int v = 0; v < S; v++) {
+                phase[0][v] = phase[1][v] = 0x9E3779B9u * (v + 1);
+                inc[0][v] = inc[1][v] =
+                    OscillatorKernel::phaseIncrementFor(55.0 * (v + 1), 48000.0);
+                incStep[v] = static_cast<int32_t>(inc[0][v] / 4000) * (v % 2 == 0 ? 1 : -1);
+                offsets[v] = engine.getWavetable().tableOffsetFor(110.0 * (v + 1));
+                level[0][v] = level[1][v] = 0.05f * v;
+                mul[v] = 0.9999f;
+                add[v] = 0.00001f;
+                gain[0][v] = gain[1][v] = 1.0f + 0.02f * v;
+                gainStep[v] = (v % 3 - 1) * 0.001f;
+                OscillatorKernel::panGains(v / 10.0f - 1.0f, panL[v], panR[v]);
+                const VoiceFilter::Coefficients c = VoiceFilter::coefficients(-4.0f, 0.4f);
+                s1[0][v] = s1[1][v] = s2[0][v] = s2[1][v] = 0.0f;
+                g[v] = c.g;
+                a1[v] = c.a1;
+                a2[v] = c.a2;
+            }
+            OscillatorKernel::Voices lanes[2];
+            for (int k = 0; k < 2; k++) {
+                lanes[k] = {phase[k], inc[k], offsets, level[k], mul, add, S, panL, panR};
+                if (filtered) {
+                    lanes[k].filter = {s1[k], s2[k], g, a1, a2, zero, zero, zero};
+                }
+                lanes[k].modulation = {incStep, gain[k], gainStep};
+            }
+            float stereoScalar[2 * FRAMES] = {}, stereoSimd[2 * FRAMES] = {};
+            OscillatorKernel::renderStereoScalar(mipmaps, lanes[0], 0.25f, stereoScalar, FRAMES);
+            OscillatorKernel::renderStereo(mipmaps, lanes[1], 0.25f, stereoSimd, FRAMES);
+            for (int i = 0; i < 2 * FRAMES; i++) {
+                maxDiff = std::max(maxDiff, std::abs(stereoScalar[i] - stereoSimd[i]));
+            }
+            for (int v = 0; v < S; v++) {
+                kernelsMatch &= inc[0][v] == inc[1][v] && phase[0][v] == phase[1][v] &&
+                                std::abs(gain[0][v] - gain[1][v]) < 1e-6f &&
+                                inc[0][v] == static_cast<uint32_t>(
+                                                 OscillatorKernel::phaseIncrementFor(
+                                                     55.0 * (v + 1), 48000.0) +
+                                                 FRAMES * incStep[v]);
+            }
+        }
+        check("Modulated SIMD kernel matches scalar", maxDiff < 1e-5f,
+              ("diff=" + std::to_string(maxDiff)).c_str());
+        check("Modulated kernel ramps increments and gains", kernelsMatch);
+
+        // Pitch of a sine note from its rising zero crossings (interpolated
+        // between frames) over the next `frames` frames
+        auto measureHz = [](SynthCore &synth, int frames) {
+            float buffer[480];
+            int crossings = 0;
+            double first = 0.0, last = 0.0;
+            float previous = 0.0f;
+            for (int done = 0; done < frames; done += 480) {
+                synth.render(buffer, 480);
+                for (int i = 0; i < 480; i++) {
+                    const float x = buffer[i];
+                    if (previous < 0.0f && x >= 0.0f) {
+                        last = done + i - x / (x - previous);
+                        first = crossings++ == 0 ? last : first;
+                    }
+                    previous = x;
+                }
+            }
+            return crossings < 2 ? 0.0 : (crossings - 1) * SynthCore::SAMPLE_RATE / (last - first);
+        };
+        auto near = [](double hz, double expected) { return std::abs(hz - expected) < 1.0; };
+        SynthCore::Patch patch;
+        std::fill(std::begin(patch.harmonics), std::end(patch.harmonics), 0.0);
+        patch.harmonics[0] = 1.0;
+        patch.attackTime = 0.001;
+        patch.releaseTime = 0.001;
+        patch.pressureGain = 1.0;
+        SynthCore synth(patch);
+
+        synth.postNoteOn(69, 0);
+        measureHz(synth, 4800);
+        const double plain = measureHz(synth, 9600);
+        synth.postPitchBend(69, 0, 12.0f);
+        measureHz(synth, 4800);
+        const double bent = measureHz(synth, 9600);
+        synth.postPitchBend(-1, 0, -12.0f);
+        measureHz(synth, 4800);
+        const double both = measureHz(synth, 9600);
+        synth.postPitchBend(69, 0, 0.0f);
+        synth.postPitchBend(-1, 0, 0.0f);
+        measureHz(synth, 4800);
+        const double back = measureHz(synth, 9600);
+        check("Pitch bend moves a note and returns",
+              near(plain, 440.0) && near(bent, 880.0) && near(both, 440.0) &&
+                  near(back, 440.0),
+              ("hz=" + std::to_string(plain) + "/" + std::to_string(bent) + "/" +
+               std::to_string(both) + "/" + std::to_string(back))
+                  .c_str());
+
+        // A note bent up an octave moves to a table level with fewer
+        // harmonics, and gets them back when bent home. A6's 8th harmonic
+        // fits its own level but not the next one up.
+        {
+            auto harmonicRatio = [](SynthCore &synth, double hz) {
+                float buffer[480];
+                double re[2] = {}, im[2] = {};
+                for (int done = 0; done < 4800; done += 480) {
+                    synth.render(buffer, 480);
+                    for (int i = 0; i < 480; i++) {
+                        for (int h = 0; h < 2; h++) {
+                            const double w = 2.0 * M_PI * hz * (h == 0 ? 1 : 8) * (done + i) /
+                                             SynthCore::SAMPLE_RATE;
+                            re[h] += buffer[i] * std::cos(w);
+                            im[h] -= buffer[i] * std::sin(w);
+                        }
+                    }
+                }
+                return std::hypot(re[1], im[1]) / std::hypot(re[0], im[0]);
+            };
+            SynthCore::Patch bright;
+            std::fill(std::begin(bright.harmonics), std::end(bright.harmonics), 0.0);
+            bright.harmonics[0] = 1.0;
+            bright.harmonics[7] = 1.0;
+            bright.numHarmonics = 8;
+            bright.attackTime = 0.001;
+            bright.sustainLevel = 1.0;
+            SynthCore synth(bright);
+            const double a6 = 1760.0;
+
+            synth.postNoteOn(93, 0);
+            harmonicRatio(synth, a6);
+            const double before = harmonicRatio(synth, a6);
+            synth.postPitchBend(93, 0, 12.0f);
+            harmonicRatio(synth, a6);
+            synth.postPitchBend(93, 0, 0.0f);
+            harmonicRatio(synth, a6);
+            const double after = harmonicRatio(synth, a6);
+            check("Bending back restores the note's table level",
+                  before > 0.5 && std::abs(after - before) < 0.05,
+                  ("8th/1st=" + std::to_string(before) + "/" + std::to_string(after)).c_str());
+        }
+
+        // Pressure raises the level by up to pressureGain
+        auto rms = [](SynthCore &synth) {
+            float buffer[480];
+            double sum = 0.0;
+            for (int b = 0; b < 10; b++) {
+                synth.render(buffer, 480);
+                for (float x : buffer) {
+                    sum += x * x;
+                }
+            }
+            return std::sqrt(sum / (10 * 480));
+        };
+        const double soft = rms(synth);
+        synth.postPressure(69, 0, 0.5f);
+        rms(synth);
+        const double pressed = rms(synth);
+        check("Pressure raises a note's level",
+              std::abs(pressed / soft - 1.5) < 0.02 && synth.postPressure(-1, 0, 2.0f),
+              ("ratio=" + std::to_string(pressed / soft)).c_str());
+        synth.postAllNotesOff(0);
+        rms(synth);
+
+        // A glide starts at the previous note and settles on the new one
+        synth.setGlide(0.2f);
+        synth.postNoteOn(57, 0);
+        measureHz(synth, 4800);
+        synth.postNoteOff(57, 0);
+        synth.postNoteOn(69, 0);
+        const double early = measureHz(synth, 2400);
+        measureHz(synth, 9600);
+        const double settled = measureHz(synth, 9600);
+        check("Glide slides into the new note",
+              early > 230.0 && early < 330.0 && near(settled, 440.0),
+              ("early=" + std::to_string(early) + " settled=" + std::to_string(settled))
+                  .c_str());
+        synth.setGlide(0.0f);
+
+        // Vibrato: pitch swings around the note without allocating
+        synth.setVibrato(5.0f, 0.5f);
+        double lowest = 1e9, highest = 0.0;
+        expectNoAllocations("Modulated render does not allocate", [&] {
+            for (int i = 0; i < 20; i++) {
+                const double hz = measureHz(synth, 960);
+                lowest = std::min(lowest, hz);
+                highest = std::max(highest, hz);
+            }
+        });
+        check("Vibrato swings the pitch", lowest < 430.0 && highest > 450.0 && highest < 460.0,
+              ("range=" + std::to_string(lowest) + ".." + std::to_string(highest)).c_str());
+    }
+
+    // --- Patches ---
+    {
+        SynthCore::Patch patch;
+        const double harmonics[] = {1.0, 0.5, 0.25, 0.125, 0.08};
+        std::copy(std::begin(harmonics), std::end(harmonics), patch.harmonics);
+        patch.numHarmonics = 5;
+        patch.maxVoices = 4;
+        SynthCore engine(patch);
+        check("Patch harmonics reach the mipmaps",
+              engine.getWavetable().harmonicsInLevel(0) == 5);
+
+        float buffer[64];
+        for (int n = 0; n < 6; n++) {
+            engine.postNoteOn(60 + n, 0);
+        }
+        engine.render(buffer, 64);
+        check("Patch caps polyphony", engine.activeVoiceCount() == 4);
+    }
+
+    // --- Telemetry ---
+    {
+        SynthCore::Patch patch;
+        patch.maxVoices = 2;
+        SynthCore engine(patch);
+        float buffer[128];
+        engine.render(buffer, 128);
+        for (int n = 0; n < 3; n++) {
+            engine.postNoteOn(60 + n, 0); // frame 0 has passed: late
+        }
+        engine.render(buffer, 128);
+
+        int64_t stats[EngineStats::COUNT];
+        engine.getStats().snapshot(stats);
+        check("Stats count callbacks and frames",
+              stats[EngineStats::CALLBACKS] == 2 && stats[EngineStats::FRAMES_RENDERED] == 256);
+        check("Stats count late events", stats[EngineStats::LATE_EVENTS] == 3);
+        check("Stats count voice steals", stats[EngineStats::VOICE_STEALS] == 1);
+        check("Stats track voices",
+              stats[EngineStats::ACTIVE_VOICES] == 2 && stats[EngineStats::PEAK_VOICES] == 2);
+        int64_t histogram = 0;
+        for (int b = 0; b < EngineStats::LOAD_BUCKETS; b++) {
+            histogram += stats[EngineStats::LOAD_HISTOGRAM + b];
+        }
+        check("Load histogram covers every callback", histogram == 2);
+
+        EngineStats load;
+        load.recordCallback(2000000, 480, 48000); // 2 ms of a 10 ms buffer
+        load.recordCallback(15000000, 480, 48000);
+        check("Load is measured against the buffer period",
+              load.get(EngineStats::LAST_LOAD_PERMILLE) == 1500 &&
+              load.get(EngineStats::MAX_LOAD_PERMILLE) == 1500 &&
+              load.get(EngineStats::LOAD_HISTOGRAM + 2) == 1 &&
+              load.get(EngineStats::LOAD_HISTOGRAM + EngineStats::LOAD_BUCKETS - 1) == 1);
+    }
+
+    // --- Batched events ---
+    {
+        SynthCore engine;
+        float buffer[128];
+        engine.render(buffer, 128);
+
+        // Offset by one byte: a direct ByteBuffer only promises byte alignment
+        unsigned char storage[4 * sizeof(PackedNoteEvent) + 1] = {};
+        unsigned char *ring = storage + 1;
+        auto put = [ring](int index, uint8_t type, uint8_t note, uint8_t flags, float pan) {
+            PackedNoteEvent record{type, note, 0, flags, pan, 0};
+            std::memcpy(ring + index * sizeof(PackedNoteEvent), &record, sizeof(record));
+        };
+        EventRing events;
+        events.attach(ring, 4 * sizeof(PackedNoteEvent) + 3);
+        put(0, PackedNoteEvent::NOTE_ON, 60, 0, 0.0f);
+        put(1, PackedNoteEvent::NOTE_ON, 64, PackedNoteEvent::HAS_PAN, 2.0f);
+        put(2, 9, 0, 0, 0.0f);
+        put(3, PackedNoteEvent::NOTE_OFF, 60, 0, 0.0f);
+        const int queued = events.submit(engine, 4);
+        for (int b = 0; b < 8; b++) {
+            engine.render(buffer, 128);
+        }
+        check("Event ring posts a batch and skips unknown records",
+              events.capacity() == 4 && queued == 3 && engine.activeVoiceCount() == 2,
+              ("queued=" + std::to_string(queued)).c_str());
+
+        // The read position wraps like the writer's
+        put(0, PackedNoteEvent::ALL_OFF, 0, 0, 0.0f);
+        const int allOff = events.submit(engine, 1);
+        for (int b = 0; b < 8; b++) {
+            engine.render(buffer, 128);
+        }
+        check("Event ring wraps around", allOff == 1 && engine.activeVoiceCount() == 0);
+
+        // Stamped events keep their spacing; future stamps count as now
+        const int64_t now = SynthCore::nowNanos();
+        const int64_t spacing = engine.eventFrameAt(now) - engine.eventFrameAt(now - 10000000);
+        check("Event stamps map onto frames",
+              std::abs(spacing - SynthCore::SAMPLE_RATE / 100) <= 1 &&
+                  engine.eventFrameAt(INT64_MAX) <= engine.eventFrameNow(),
+              ("spacing=" + std::to_string(spacing)).c_str());
+
+        SynthCore idle;
+        std::vector<NoteEvent> flood(SynthCore::EVENT_QUEUE_CAPACITY + 44,
+                                     NoteEvent::noteOff(60, 0));
+        const int accepted = idle.postEvents(flood.data(), static_cast<int>(flood.size()));
+        check("Batch overflow is dropped and counted",
+              accepted == static_cast<int>(SynthCore::EVENT_QUEUE_CAPACITY) &&
+                  idle.getStats().get(EngineStats::DROPPED_EVENTS) == 44);
+    }
+
+    // --- Streaming sampler ---
+    // Needs a writable temp directory; skipped where there is none (the app
+    // sandbox only has its own files dir)
+    const char *tmpEnv = std::getenv("TMPDIR");
+    const std::string tmp = tmpEnv != nullptr ? tmpEnv : "/tmp";
+    const std::string longPath = tmp + "/ongoma_test_long.wav";
+    const std::string shortPath = tmp + "/ongoma_test_short.wav";
+    const std::string mapPath = tmp + "/ongoma_test.map";
+    WavWriter longWav;
+    if (longWav.open(longPath.c_str(), SynthCore::SAMPLE_RATE, 2)) {
+        // Long enough that two thirds of it must stream through a ring
+        const int32_t longFrames = 3 * SampleLibrary::HEAD_FRAMES;
+        std::vector<float> source(2 * longFrames);
+        for (int32_t i = 0; i < longFrames; i++) {
+            source[2 * i] = static_cast<float>(std::sin(i * 0.01));
+            source[2 * i + 1] = static_cast<float>(0.5 * std::cos(i * 0.013));
+        }
+        longWav.write(source.data(), longFrames);
+        longWav.close();
+
+        // 16-bit mono, written by hand: the header WavWriter does not make
+        const int16_t pcm[4] = {0, 16384, -32768, 32767};
+        if (FILE *f = std::fopen(shortPath.c_str(), "wb")) {
+            const uint32_t dataBytes = sizeof(pcm);
+            const uint32_t riffBytes = 36 + dataBytes;
+            const uint32_t fmtBytes = 16, rate = 22050, byteRate = rate * 2;
+            const uint16_t format = 1, channels = 1, blockAlign = 2, bits = 16;
+            std::fwrite("RIFF", 1, 4, f);
+            std::fwrite(&riffBytes, 4, 1, f);
+            std::fwrite("WAVEfmt ", 1, 8, f);
+            std::fwrite(&fmtBytes, 4, 1, f);
+            std::fwrite(&format, 2, 1, f);
+            std::fwrite(&channels, 2, 1, f);
+            std::fwrite(&rate, 4, 1, f);
+            std::fwrite(&byteRate, 4, 1, f);
+            std::fwrite(&blockAlign, 2, 1, f);
+            std::fwrite(&bits, 2, 1, f);
+            std::fwrite("data", 1, 4, f);
+            std::fwrite(&dataBytes, 4, 1, f);
+            std::fwrite(pcm, sizeof(pcm), 1, f);
+            std::fclose(f);
+        }
+        if (FILE *f = std::fopen(mapPath.c_str(), "w")) {
+            std::fputs("# file root low high [velocities]\n", f);
+            std::fputs("ongoma_test_long.wav 60 0 72\n", f);
+            std::fputs("ongoma_test_short.wav 80 73 127 1 63\n", f);
+            std::fclose(f);
+        }
+
+        SampleLibrary library;
+        check("Sample map loads every zone", library.loadMap(mapPath) == 2);
+        const SampleLibrary::Zone *longZone = library.findZone(60, 100);
+        const SampleLibrary::Zone *shortZone = library.findZone(80, 10);
+        check("Zones match key and velocity ranges",
+              longZone != nullptr && shortZone != nullptr && longZone != shortZone &&
+              library.findZone(80, 100) == nullptr);
+        check("Only attack heads are resident",
+              longZone && longZone->frames == longFrames &&
+              longZone->headFrames() == SampleLibrary::HEAD_FRAMES &&
+              library.residentBytes() == (SampleLibrary::HEAD_FRAMES + 4) * 2 * sizeof(float));
+        check("PCM16 mono decodes to stereo float",
+              shortZone && shortZone->sampleRate == 22050 && shortZone->head.size() == 8 &&
+              shortZone->head[2] == 0.5f && shortZone->head[3] == 0.5f &&
+              shortZone->head[4] == -1.0f && std::abs(shortZone->head[6] - 1.0f) < 1e-4f);
+
+        // At the root note the output is the source scaled by velocity, pan
+        // and the one-voice headroom, across the head/tail seam
+        {
+            StreamingSampler sampler(library);
+            float left, right;
+            OscillatorKernel::panGains(0.0f, left, right);
+            const float gain = 0.7f * left;
+
+            sampler.noteOn(60, 127, 0.0f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::vector<float> out(2 * (longFrames + 1024), 0.0f);
+            for (int32_t offset = 0; offset < longFrames + 1024; offset += 192) {
+                sampler.render(out.data() + 2 * offset,
+                               std::min(192, longFrames + 1024 - offset), 2);
+            }
+            float maxError = 0.0f;
+            for (int32_t i = 0; i < longFrames; i++) {
+                maxError = std::max(maxError, std::abs(out[2 * i] - source[2 * i] * gain));
+                maxError = std::max(maxError,
+                                    std::abs(out[2 * i + 1] - source[2 * i + 1] * gain));
+            }
+            check("Streamed tail continues the resident head", maxError < 1e-5f,
+                  ("maxError=" + std::to_string(maxError)).c_str());
+            check("Prefetch keeps ahead of playback",
+                  sampler.getStats().get(EngineStats::STREAM_UNDERRUNS) == 0);
+            check("Sampler voice ends with its sample", sampler.activeVoiceCount() == 0);
+
+            // An octave above the root reads the source twice as fast
+            std::fill(out.begin(), out.end(), 0.0f);
+            sampler.noteOn(72, 127, 0.0f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            for (int32_t offset = 0; offset < longFrames / 2 + 256; offset += 256) {
+                sampler.render(out.data() + 2 * offset, 256, 2);
+            }
+            maxError = 0.0f;
+            for (int32_t i = 0; i < longFrames / 2 - 1; i++) {
+                maxError = std::max(maxError, std::abs(out[2 * i] - source[4 * i] * gain));
+            }
+            check("Pitch follows the root note", maxError < 1e-5f &&
+                  sampler.activeVoiceCount() == 0 &&
+                  sampler.getStats().get(EngineStats::STREAM_UNDERRUNS) == 0,
+                  ("maxError=" + std::to_string(maxError)).c_str());
+        }
+
+        // Through the core: events route to the sampler, sample-accurately
+        {
+            SynthCore engine;
+            engine.setChannelCount(2);
+            StreamingSampler sampler(library);
+            engine.attachSampler(&sampler);
+            engine.postNoteOn(48, 100, 0.0f, 127); // an octave below the root
+            float buffer[2 * 256];
+            engine.render(buffer, 256);
+            const int latency = engine.getLatencyFrames();
+            check("Sampler notes start on their frame",
+                  buffer[2 * (99 + latency)] == 0.0f && buffer[2 * (101 + latency)] != 0.0f &&
+                  engine.activeVoiceCount() == 1);
+
+            expectNoAllocations("Sampler render does not allocate", [&] {
+                for (int b = 0; b < 50; b++) {
+                    engine.render(buffer, 256);
+                }
+            });
+            engine.attachSampler(nullptr);
+        }
+
+        unlink(longPath.c_str());
+        unlink(shortPath.c_str());
+        unlink(mapPath.c_str());
+    }
+
+    // --- Effects bus ---
+    {
+        EffectsBus bus;
+        bus.setSampleRate(48000);
+        bus.setMasterChain({EffectSpec::echo(0.5f, 10.0f)});
+        std::vector<float> buffer(2 * 1200, 0.0f);
+        buffer[0] = buffer[1] = 1.0f;
+        for (int32_t offset = 0; offset < 1200; offset += 192) {
+            bus.process(buffer.data() + 2 * offset, std::min(192, 1200 - offset), 2);
+        }
+        bool onlyRepeats = true;
+        for (int i = 0; i < 1200; i++) {
+            const float expected = i == 0 ? 1.0f : i == 480 ? 0.5f : i == 960 ? 0.25f : 0.0f;
+            onlyRepeats &= buffer[2 * i] == expected && buffer[2 * i + 1] == expected;
+        }
+        check("Master echo repeats after its delay", onlyRepeats);
+
+        // Pure 5 ms delay on the send, at half level
+        bus.setMasterChain({});
+        bus.setSendChain({EffectSpec::delayLine(0.0f, 1.0f, 0.0f, 5.0f)});
+        bus.setSendLevel(0.5f);
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        for (int b = 0; b < 100; b++) {
+            bus.process(buffer.data(), 480, 2); // settle the send level
+        }
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        buffer[0] = 1.0f;
+        bus.process(buffer.data(), 480, 2);
+        check("Send returns the delayed signal on top of the dry one",
+              buffer[0] == 1.0f && std::abs(buffer[2 * 240] - 0.5f) < 1e-6f &&
+                  buffer[1] == 0.0f && buffer[2 * 240 + 1] == 0.0f);
+
+        bus.setSendChain({});
+        std::vector<float> dry(2 * 480);
+        for (size_t i = 0; i < dry.size(); i++) {
+            dry[i] = std::sin(0.01f * static_cast<float>(i));
+        }
+        std::vector<float> processed = dry;
+        bus.process(processed.data(), 480, 2);
+        check("Empty chains pass audio through untouched", processed == dry);
+
+        // Gain changes glide: no sample jumps by more than a smoothing step
+        bus.setOutputGain(0.0f);
+        float previous = 1.0f;
+        float maxStep = 0.0f;
+        for (int b = 0; b < 50; b++) {
+            std::fill(buffer.begin(), buffer.begin() + 192, 1.0f);
+            bus.process(buffer.data(), 192, 1);
+            for (int i = 0; i < 192; i++) {
+                maxStep = std::max(maxStep, std::abs(buffer[i] - previous));
+                previous = buffer[i];
+            }
+        }
+        check("Output gain glides without steps", maxStep < 2e-3f);
+        check("Output gain reaches its target", previous == 0.0f);
+
+        bool finite = true;
+        bool audible = true;
+        for (int type = 0; type < static_cast<int>(EffectSpec::Type::COUNT); type++) {
+            EffectSpec spec;
+            spec.type = static_cast<EffectSpec::Type>(type);
+            const float params[][EffectSpec::MAX_PARAMS] = {
+                {0.5f, 20.0f}, {2.0f, 0.5f, 0.7071f}, {5.0f, 10.0f, 0.5f},
+                {4.0f, 0.5f}, {0.5f, 0.5f, 0.3f, 15.0f}};
+            std::copy(params[type], params[type] + EffectSpec::MAX_PARAMS, spec.params);
+            auto effect = EffectsBus::makeEffect(spec, 44100, 0);
+            std::vector<float> samples(4096);
+            for (size_t i = 0; i < samples.size(); i++) {
+                samples[i] = std::sin(0.05f * static_cast<float>(i));
+            }
+            effect->process(samples.data(), 4096);
+            float energy = 0.0f;
+            for (float sample : samples) {
+                finite &= std::isfinite(sample);
+                energy += sample * sample;
+            }
+            audible &= energy > 1.0f;
+        }
+        check("Every effect type renders finite audio", finite && audible);
+    }
+
+    // --- Effects bus on the render path ---
+    {
+        SynthCore engine;
+        engine.setChannelCount(2);
+        EffectsBus &bus = engine.getEffectsBus();
+        bus.setMasterChain(
+            {EffectSpec::tremolo(5.0f, 0.5f), EffectSpec::flanger(2.0f, 0.3f, 0.7071f)});
+        bus.setSendChain({EffectSpec::echo(0.4f, 120.0f),
+                          EffectSpec::whiteChorus(5.0f, 10.0f, 0.5f),
+                          EffectSpec::delayLine(0.0f, 1.0f, 0.2f, 30.0f)});
+        bus.setSendLevel(0.3f);
+        float buffer[2 * 192];
+        for (int n = 0; n < 8; n++) {
+            engine.postNoteOn(48 + n * 3, n * 40);
+        }
+        engine.render(buffer, 192);
+
+        // The next snapshot is built here and swapped in by the armed render
+        bus.setMasterChain({EffectSpec::echo(0.3f, 80.0f)});
+        expectNoAllocations("Effects bus does not allocate while rendering or swapping", [&] {
+            for (int b = 0; b < 50; b++) {
+                engine.render(buffer, 192);
+            }
+            bus.setOutputGain(0.5f);
+            for (int b = 0; b < 50; b++) {
+                engine.render(buffer, 192);
+            }
+        });
+    }
+
+    // --- Output limiter ---
+    {
+        using oboe::flowgraph::LookAheadLimiter;
+        constexpr int32_t frames = 48000;
+        std::vector<float> input(2 * frames);
+        uint32_t seed = 7;
+        for (int32_t i = 0; i < frames; i++) {
+            // Bursts up to +12 dB over quiet stretches
+            const float level = (i / 3000) % 2 == 0 ? 0.4f : 4.0f * ((i / 6000) % 3 + 1) / 3;
+            for (int c = 0; c < 2; c++) {
+                seed = seed * 1664525u + 1013904223u;
+                input[2 * i + c] = level * (static_cast<int32_t>(seed) * (1.0f / 2147483648.0f));
+            }
+        }
+
+        LookAheadLimiter whole(2, 48000);
+        std::vector<float> reference(input.size());
+        whole.process(input.data(), reference.data(), frames);
+        float peak = 0.0f;
+        for (float sample : reference) {
+            peak = std::max(peak, std::abs(sample));
+        }
+        check("Limiter output never exceeds its threshold",
+              peak <= whole.getThreshold() * 1.00001f && peak > 0.8f * whole.getThreshold(),
+              ("peak=" + std::to_string(peak)).c_str());
+
+        // Odd buffer sizes, processed in place
+        LookAheadLimiter chunked(2, 48000);
+        std::vector<float> inPlace = input;
+        const int32_t sizes[] = {37, 256, 500, 1, 192};
+        for (int32_t offset = 0, k = 0; offset < frames; k++) {
+            const int32_t n = std::min(sizes[k % 5], frames - offset);
+            chunked.process(inPlace.data() + 2 * offset, inPlace.data() + 2 * offset, n);
+            offset += n;
+        }
+        check("Limiter output does not depend on buffer size", inPlace == reference);
+
+        const int32_t latency = whole.getLatencyFrames();
+        bool delayedOnly = true;
+        for (int32_t i = latency; i < 3000; i++) {
+            delayedOnly &= reference[2 * i] == input[2 * (i - latency)] &&
+                           reference[2 * i + 1] == input[2 * (i - latency) + 1];
+        }
+        check("Limiter passes quiet audio through, delayed", delayedOnly && latency == 96);
+
+        LookAheadLimiter release(1, 48000);
+        std::vector<float> burst(24000, 0.1f);
+        std::fill(burst.begin(), burst.begin() + 480, 3.0f);
+        release.process(burst.data(), burst.data(), 500);
+        const float limited = release.getCurrentGain();
+        release.process(burst.data() + 500, burst.data() + 500, 24000 - 500);
+        check("Limiter releases after a peak",
+              limited < 0.5f && release.getCurrentGain() > 0.99f);
+
+        SynthCore engine;
+        engine.setChannelCount(2);
+        for (int n = 0; n < SynthCore::MAX_POLYPHONY; n++) {
+            engine.postNoteOn(36 + n * 2, 0);
+        }
+        float buffer[2 * 256];
+        float chordPeak = 0.0f;
+        for (int b = 0; b < 40; b++) {
+            engine.render(buffer, 256);
+            for (float sample : buffer) {
+                chordPeak = std::max(chordPeak, std::abs(sample));
+            }
+        }
+        check("Full chord does not clip",
+              chordPeak <= engine.getLimiter().getThreshold() * 1.00001f && chordPeak > 0.5f,
+              ("peak=" + std::to_string(chordPeak)).c_str());
+    }
+
+    // --- Sequencer ---
+    {
+        // 120 bpm at 48 kHz: exactly 25 frames per tick, a lap of two beats
+        // is 48000 frames
+        SequencerPattern pattern;
+        pattern.lengthTicks = 2 * SequencerPattern::TICKS_PER_QUARTER;
+        pattern.addNote(0, 0, 480, 60);
+        pattern.addNote(0, 7, 10, 64);
+        pattern.addNote(2, 100, 10, 70);
+        pattern.tracks[2].muted = true;
+        pattern.tracks[1].events.push_back(
+            SequencerEvent::control(960, SequencerEvent::Control::OUTPUT_GAIN, 0.5f));
+
+        Sequencer sequencer;
+        sequencer.setPattern(pattern);
+        sequencer.play(1000);
+
+        struct Seen {
+            int64_t frame;
+            SequencerEvent::Type type;
+            int number;
+        };
+        std::vector<Seen> seen;
+        bool inBlock = true;
+        const int32_t sizes[] = {37, 256, 500, 1, 192};
+        int64_t frame = 0;
+        for (int k = 0; frame < 1000 + 2 * 48000 + 200; k++) {
+            const int32_t n = sizes[k % 5];
+            sequencer.beginBlock(frame, n);
+            Sequencer::Dispatch dispatch;
+            while (sequencer.pop(dispatch)) {
+                inBlock &= dispatch.frame >= frame && dispatch.frame < frame + n;
+                seen.push_back({dispatch.frame, dispatch.event.type, dispatch.event.number});
+            }
+            frame += n;
+        }
+        std::vector<Seen> expected;
+        using Type = SequencerEvent::Type;
+        for (int64_t lap = 1000; lap < frame; lap += 48000) {
+            const Seen one[] = {{lap, Type::NOTE_ON, 60},
+                                {lap + 175, Type::NOTE_ON, 64},
+                                {lap + 425, Type::NOTE_OFF, 64},
+                                {lap + 12000, Type::NOTE_OFF, 60},
+                                {lap + 24000, Type::CONTROL, 0}};
+            for (const Seen &event : one) {
+                if (event.frame < frame) {
+                    expected.push_back(event);
+                }
+            }
+        }
+        bool exact = seen.size() == expected.size();
+        for (size_t i = 0; exact && i < seen.size(); i++) {
+            exact = seen[i].frame == expected[i].frame && seen[i].type == expected[i].type &&
+                    seen[i].number == expected[i].number;
+        }
+        check("Sequencer events land on their exact frames across laps",
+              exact && inBlock && seen.size() >= 11,
+              ("events=" + std::to_string(seen.size())).c_str());
+
+        // Swap to half tempo mid-note: position holds, the old note stops
+        sequencer.beginBlock(frame, 100);
+        const int64_t before = sequencer.getPositionTicks();
+        Sequencer::Dispatch dispatch;
+        while (sequencer.pop(dispatch)) {
+        }
+        frame += 100;
+        SequencerPattern slow = pattern;
+        slow.tempo = 60.0;
+        sequencer.setPattern(slow);
+        sequencer.beginBlock(frame, 64);
+        const bool released = sequencer.pop(dispatch) && dispatch.frame == frame &&
+                              dispatch.event.type == Type::NOTE_OFF &&
+                              dispatch.event.number == 60;
+        check("Pattern swap keeps the position and releases held notes",
+              released && std::abs(sequencer.getPositionTicks() - (before + 4)) <= 1,
+              ("position=" + std::to_string(sequencer.getPositionTicks())).c_str());
+
+        sequencer.stop();
+        sequencer.beginBlock(frame + 64, 64);
+        check("Stopped sequencer is silent",
+              !sequencer.pop(dispatch) && sequencer.getPositionTicks() == -1);
+
+        // Through the engine: output trails the event frame by the latency only
+        SynthCore engine;
+        SequencerPattern single;
+        single.addNote(0, 4, 960, 69);
+        engine.getSequencer().setPattern(single);
+        engine.getSequencer().play(200);
+        std::vector<float> output(2000);
+        for (int32_t offset = 0, k = 0; offset < 2000; k++) {
+            const int32_t n = std::min(sizes[k % 5], 2000 - offset);
+            engine.render(output.data() + offset, n);
+            offset += n;
+        }
+        const int32_t onset = 200 + 4 * 25 + engine.getLatencyFrames();
+        bool silentBefore = true;
+        for (int32_t i = 0; i < onset + 1; i++) {
+            silentBefore &= output[i] == 0.0f;
+        }
+        bool soundsAfter = false;
+        for (int32_t i = onset + 1; i < onset + 32; i++) {
+            soundsAfter |= output[i] != 0.0f;
+        }
+        check("Sequenced note starts on its exact frame", silentBefore && soundsAfter);
+    }
+
+    // --- Output recorder ---
+    {
+        auto readFile = [](const std::string &path) {
+            std::vector<char> bytes;
+            if (FILE *f = std::fopen(path.c_str(), "rb")) {
+                char chunk[4096];
+                size_t n;
+                while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+                    bytes.insert(bytes.end(), chunk, chunk + n);
+                }
+                std::fclose(f);
+            }
+            return bytes;
+        };
+        const char *tmpEnv = std::getenv("TMPDIR");
+        const std::string path =
+            std::string(tmpEnv != nullptr ? tmpEnv : "/tmp") + "/ongoma_test_record.wav";
+
+        // Punch in at 1000, out at 5000, across odd buffer sizes
+        SynthCore engine;
+        engine.setChannelCount(2);
+        OutputRecorder recorder;
+        engine.attachRecorder(&recorder);
+        for (int n = 0; n < 6; n++) {
+            engine.postNoteOn(50 + n * 5, n * 300);
+        }
+        const bool started = recorder.start(path, SynthCore::SAMPLE_RATE, 2,
+                                            WavWriter::Format::FLOAT32, 1000, 5000);
+        std::vector<float> direct(2 * 8000);
+        const int32_t sizes[] = {37, 256, 500, 1, 192};
+        expectNoAllocations("Recording does not allocate in render", [&] {
+            for (int32_t offset = 0, k = 0; offset < 8000; k++) {
+                const int32_t n = std::min(sizes[k % 5], 8000 - offset);
+                engine.render(direct.data() + 2 * offset, n);
+                offset += n;
+            }
+        });
+        const bool stoppedItself = !recorder.isRecording();
+        const bool finished = recorder.finish();
+        const std::vector<char> file = readFile(path);
+        const size_t dataBytes = 4000 * 2 * sizeof(float);
+        check("Recorder captures exactly its punch-in window",
+              started && finished && stoppedItself && file.size() == 44 + dataBytes &&
+                  std::memcmp(file.data() + 44, direct.data() + 2 * 1000, dataBytes) == 0 &&
+                  recorder.getOverrunFrames() == 0,
+              ("bytes=" + std::to_string(file.size())).c_str());
+
+        // A FIFO smaller than one buffer must overrun, not block
+        recorder.start(path, SynthCore::SAMPLE_RATE, 2, WavWriter::Format::FLOAT32, 0,
+                       OutputRecorder::FOREVER, 256);
+        float buffer[2 * 512];
+        for (int b = 0; b < 4; b++) {
+            engine.render(buffer, 512);
+        }
+        const int64_t captured = recorder.getFramesCaptured();
+        const int64_t overrun = recorder.getOverrunFrames();
+        check("Recorder counts overruns instead of blocking",
+              recorder.finish() && overrun > 0 && captured + overrun == 4 * 512 &&
+                  readFile(path).size() == 44 + static_cast<size_t>(captured) * 8,
+              ("overrun=" + std::to_string(overrun)).c_str());
+
+        WavWriter pcm24;
+        const float samples[4] = {0.5f, -1.0f, 1.0f, 2.0f};
+        pcm24.open(path.c_str(), 48000, 2, WavWriter::Format::PCM24);
+        pcm24.write(samples, 2);
+        pcm24.close();
+        const std::vector<char> bytes = readFile(path);
+        const uint8_t expected[12] = {0x00, 0x00, 0x40, 0x00, 0x00, 0x80,
+                                      0xff, 0xff, 0x7f, 0xff, 0xff, 0x7f};
+        check("24-bit WAV has a PCM header and clipped samples",
+              bytes.size() == 56 && bytes[20] == 1 && bytes[34] == 24 &&
+                  std::memcmp(bytes.data() + 44, expected, sizeof(expected)) == 0);
+        std::remove(path.c_str());
+    }
+
+    // --- Multi-core voice rendering ---
+    {
+        // Records who ran each task; runInline can stall the audio thread
+        // (so workers get a look in even on one core) and runOnWorker can
+        // stall a worker past the deadline
+        struct RecordingJob final : VoiceWorkerPool::Job {
+            int inlineRuns[VoiceWorkerPool::MAX_TASKS] = {};
+            int workerRuns[VoiceWorkerPool::MAX_TASKS] = {};
+            int commits[VoiceWorkerPool::MAX_TASKS] = {};
+            std::atomic<int> workerStarted{0};
+            // Bumped by a caller that rewrites the job; a worker that sees
+            // it change under it has raced that caller
+            std::atomic<int> stamp{0};
+            std::atomic<bool> overwritten{false};
+            std::chrono::milliseconds inlineStall{0};
+            std::chrono::milliseconds workerStall{0};
+
+            void runInline(int task) override {
+                if (inlineRuns[task]++ == 0 && task == 0) {
+                    std::this_thread::sleep_for(inlineStall);
+                }
+            }
+            void runOnWorker(int task, int) override {
+                workerStarted.fetch_add(1);
+                const int before = stamp.load();
+                std::this_thread::sleep_for(workerStall);
+                if (stamp.load() != before) {
+                    overwritten.store(true);
+                }
+                workerRuns[task]++;
+            }
+            void commit(int task, int) override { commits[task]++; }
+
+            bool eachRanOnce(int tasks) const {
+                for (int t = 0; t < tasks; t++) {
+                    if (inlineRuns[t] + commits[t] != 1) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+        constexpr int tasks = 16;
+        VoiceWorkerPool pool(3, false);
+        const auto &poolStats = pool.getStats();
+
+        RecordingJob shared;
+        shared.inlineStall = std::chrono::milliseconds(20);
+        pool.run(shared, tasks, VoiceWorkerPool::nowNanos() + 1000000000LL);
+        check("Worker pool runs every task exactly once", shared.eachRanOnce(tasks));
+        check("Worker pool shares tasks with its workers",
+              poolStats.workerTasks.load() > 0 && poolStats.lateTasks.load() == 0,
+              ("workerTasks=" + std::to_string(poolStats.workerTasks.load())).c_str());
+
+        RecordingJob stalled;
+        stalled.inlineStall = std::chrono::milliseconds(20);
+        stalled.workerStall = std::chrono::milliseconds(300);
+        const int64_t start = VoiceWorkerPool::nowNanos();
+        pool.run(stalled, tasks, start + 25000000LL);
+        const int64_t elapsed = VoiceWorkerPool::nowNanos() - start;
+        check("Tasks late past the deadline are rendered inline",
+              stalled.eachRanOnce(tasks) && poolStats.lateTasks.load() > 0 &&
+                  stalled.workerStarted.load() > 0 && elapsed < 200000000LL,
+              ("elapsed ms=" + std::to_string(elapsed / 1000000)).c_str());
+
+        // The stalled workers are still busy with the abandoned tasks
+        RecordingJob next;
+        pool.run(next, tasks, VoiceWorkerPool::nowNanos() + 1000000000LL);
+        check("Busy workers make the next dispatch run inline",
+              next.eachRanOnce(tasks) && poolStats.inlineFallbacks.load() == 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+        // Straight after a deadline miss the late worker still reads the
+        // job, so a caller must not prepare the next dispatch in it
+        RecordingJob reused;
+        reused.inlineStall = std::chrono::milliseconds(20);
+        reused.workerStall = std::chrono::milliseconds(300);
+        pool.run(reused, tasks, VoiceWorkerPool::nowNanos() + 25000000LL);
+        const bool readyAfterMiss = pool.ready();
+        if (readyAfterMiss) {
+            reused.stamp.fetch_add(1);
+            pool.run(reused, tasks, VoiceWorkerPool::nowNanos() + 1000000000LL);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        check("Pool is not ready while a late worker reads the last job",
+              !readyAfterMiss && !reused.overwritten.load() && reused.workerStarted.load() > 0 &&
+                  poolStats.inlineFallbacks.load() == 2 && pool.ready());
+
+        // Whole engine: same notes with and without the pool
+        SynthCore single;
+        SynthCore parallel;
+        parallel.attachWorkerPool(&pool);
+        for (SynthCore *engine : {&single, &parallel}) {
+            engine->setChannelCount(2);
+            for (int n = 0; n < SynthCore::MAX_POLYPHONY; n++) {
+                engine->postNoteOn(30 + n * 3, n * 11, (n % 7) / 3.0f - 1.0f);
+            }
+            for (int n = 0; n < 6; n++) {
+                engine->postNoteOff(30 + n * 9, 3000 + n * 500);
+            }
+        }
+        float a[2 * 480];
+        float b[2 * 480];
+        float maxDiff = 0.0f;
+        float maxLevel = 0.0f;
+        for (int buf = 0; buf < 60; buf++) {
+            single.render(a, 480);
+            parallel.render(b, 480);
+            for (int i = 0; i < 2 * 480; i++) {
+                maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+                maxLevel = std::max(maxLevel, std::abs(a[i]));
+            }
+        }
+        check("Multi-core render matches single-threaded",
+              maxDiff < 1e-5f && maxLevel > 0.1f &&
+                  single.activeVoiceCount() == parallel.activeVoiceCount(),
+              ("maxDiff=" + std::to_string(maxDiff)).c_str());
+
+        expectNoAllocations("Multi-core render does not allocate", [&] {
+            for (int buf = 0; buf < 20; buf++) {
+                parallel.render(b, 480);
+            }
+        });
+
+        // Filter and modulation state go through the worker snapshot and
+        // back. Reset so both limiters start from the same state again.
+        for (SynthCore *engine : {&single, &parallel}) {
+            engine->reset();
+            engine->setFilter(true, 1.5f, 0.6f);
+            engine->setGlide(0.05f);
+            engine->setVibrato(6.0f, 0.3f);
+            for (int n = 0; n < SynthCore::MAX_POLYPHONY; n++) {
+                engine->postNoteOn(36 + n * 2, n * 13, (n % 5) / 2.0f - 1.0f);
+                engine->postPitchBend(36 + n * 2, 2000 + n * 100, (n % 4) - 1.5f);
+                engine->postPressure(36 + n * 2, 4000, (n % 3) / 2.0f);
+            }
+        }
+        maxDiff = 0.0f;
+        maxLevel = 0.0f;
+        expectNoAllocations("Filtered, modulated multi-core render does not allocate", [&] {
+            for (int buf = 0; buf < 30; buf++) {
+                single.render(a, 480);
+                parallel.render(b, 480);
+                for (int i = 0; i < 2 * 480; i++) {
+                    maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+                    maxLevel = std::max(maxLevel, std::abs(a[i]));
+                }
+            }
+        });
+        check("Filtered, modulated multi-core render matches single-threaded",
+              maxDiff < 1e-5f && maxLevel > 0.1f,
+              ("maxDiff=" + std::to_string(maxDiff)).c_str());
+    }
+
+    // --- Convolution reverb ---
+    {
+        // FFT against a direct DFT, and back
+        RealFft fft(64);
+        float x[64], re[33], im[33], back[64];
+        for (int i = 0; i < 64; i++) {
+            x[i] = static_cast<float>(std::sin(i * 0.37) + 0.25 * std::cos(i * 1.9)) +
+                   (i == 5 ? 1.0f : 0.0f);
+        }
+        fft.forward(x, re, im);
+        double maxDftError = 0.0;
+        for (int k = 0; k <= 32; k++) {
+            double dftRe = 0.0, dftIm = 0.0;
+            for (int i = 0; i < 64; i++) {
+                dftRe += x[i] * std::cos(2.0 * M_PI * k * i / 64);
+                dftIm -= x[i] * std::sin(2.0 * M_PI * k * i / 64);
+            }
+            maxDftError =
+                std::max({maxDftError, std::abs(re[k] - dftRe), std::abs(im[k] - dftIm)});
+        }
+        fft.inverse(re, im, back);
+        float maxRoundTrip = 0.0f;
+        for (int i = 0; i < 64; i++) {
+            maxRoundTrip = std::max(maxRoundTrip, std::abs(back[i] / 64.0f - x[i]));
+        }
+        check("Real FFT matches the DFT", maxDftError < 1e-4,
+              ("error=" + std::to_string(maxDftError)).c_str());
+        check("Real FFT inverts", maxRoundTrip < 1e-5f,
+              ("error=" + std::to_string(maxRoundTrip)).c_str());
+
+        // A stereo response long enough for a tail thread, against direct
+        // convolution; input in chunks that straddle the blocks
+        constexpr int32_t IR_FRAMES = 3000;
+        constexpr int32_t FRAMES = 6000;
+        constexpr int32_t BLOCK = 64;
+        ImpulseResponse impulse;
+        impulse.channels = 2;
+        impulse.sampleRate = SynthCore::SAMPLE_RATE;
+        impulse.samples.resize(2 * IR_FRAMES);
+        for (int32_t i = 0; i < IR_FRAMES; i++) {
+            const float decay = static_cast<float>(std::exp(-i / 700.0));
+            impulse.samples[2 * i] = decay * static_cast<float>(std::sin(i * 0.61));
+            impulse.samples[2 * i + 1] = decay * static_cast<float>(std::cos(i * 0.23));
+        }
+        std::vector<float> dry(2 * FRAMES);
+        for (int32_t i = 0; i < FRAMES; i++) {
+            dry[2 * i] = (i == 10 ? 1.0f : 0.0f) + 0.3f * static_cast<float>(std::sin(i * 0.05));
+            dry[2 * i + 1] = i % 97 == 0 ? 0.5f : 0.0f;
+        }
+        ConvolutionReverb reverb(impulse, SynthCore::SAMPLE_RATE, 2, BLOCK, 2);
+        reverb.setOffline(true);
+        std::vector<float> out(dry);
+        for (int32_t offset = 0; offset < FRAMES; offset += 100) {
+            reverb.process(out.data() + 2 * offset, std::min(100, FRAMES - offset));
+        }
+        double maxError = 0.0, peak = 0.0;
+        for (int32_t t = 0; t < FRAMES; t++) {
+            for (int c = 0; c < 2; c++) {
+                double expected = 0.0;
+                for (int32_t k = 0; k < IR_FRAMES && k <= t - BLOCK; k++) {
+                    expected += impulse.samples[2 * k + c] * dry[2 * (t - BLOCK - k) + c];
+                }
+                const double wet = out[2 * t + c] - dry[2 * t + c];
+                maxError = std::max(maxError, std::abs(wet - expected));
+                peak = std::max(peak, std::abs(expected));
+            }
+        }
+        check("Reverb partitions the whole response",
+              reverb.getPartitionCount() == (IR_FRAMES + BLOCK - 1) / BLOCK &&
+                  reverb.getHeadPartitions() == 2 && reverb.getLatencyFrames() == BLOCK);
+        check("Partitioned reverb matches direct convolution",
+              maxError < 1e-4 * peak && peak > 1.0 &&
+                  reverb.getStats().tailBlocks.load() > 0 &&
+                  reverb.getStats().lateTailBlocks.load() == 0,
+              ("error=" + std::to_string(maxError) + " peak=" + std::to_string(peak)).c_str());
+
+        // Responses load through parselib and are resampled to the stream
+        const char *tmpEnv = std::getenv("TMPDIR");
+        const std::string irPath =
+            std::string(tmpEnv != nullptr ? tmpEnv : "/tmp") + "/ongoma_test_ir.wav";
+        WavWriter irWav;
+        if (irWav.open(irPath.c_str(), 24000, 2)) {
+            irWav.write(impulse.samples.data(), IR_FRAMES);
+            irWav.close();
+            ImpulseResponse loaded;
+            check("Impulse response loads from WAV",
+                  loaded.load(irPath) && loaded.channels == 2 && loaded.sampleRate == 24000 &&
+                      loaded.samples == impulse.samples);
+            ConvolutionReverb upsampled(loaded, 48000, 1, 128);
+            check("Impulse response is resampled to the stream rate",
+                  upsampled.getPartitionCount() == (2 * IR_FRAMES + 127) / 128 &&
+                      upsampled.getChannelCount() == 1);
+            std::remove(irPath.c_str());
+        }
+        ImpulseResponse missing;
+        check("Missing impulse response is rejected",
+              !missing.load(irPath) && missing.frames() == 0);
+
+        // In the engine: after the effects, a tail after the note, and no
+        // allocation on the audio thread
+        ConvolutionReverb engineReverb(impulse, SynthCore::SAMPLE_RATE, 1, 128);
+        engineReverb.setOffline(true);
+        SynthCore::Patch patch;
+        patch.releaseTime = 0.001;
+        SynthCore engine(patch);
+        engine.attachReverb(&engineReverb);
+        float buffer[480];
+        engine.postNoteOn(60, 0);
+        engine.render(buffer, 480);
+        engine.postAllNotesOff(0);
+        float tail = 0.0f;
+        expectNoAllocations("Reverb does not allocate", [&] {
+            for (int b = 0; b < 4; b++) {
+                engine.render(buffer, 480);
+                for (float sample : buffer) {
+                    tail = std::max(tail, std::abs(sample));
+                }
+            }
+        });
+        check("Reverb rings on after the note", tail > 1e-3f && engine.activeVoiceCount() == 0,
+              ("tail=" + std::to_string(tail)).c_str());
+        engine.attachReverb(nullptr);
+    }
+
+    // --- Idle fast path ---
+    {
+        SynthCore::Patch patch;
+        patch.releaseTime = 0.001;
+        SynthCore engine(patch);
+        float buffer[480];
+        const int64_t settleFrames =
+            static_cast<int64_t>(SynthCore::IDLE_SETTLE_SECONDS * SynthCore::SAMPLE_RATE);
+
+        // A held note never goes idle, however long it sounds
+        engine.postNoteOn(60, 0);
+        for (int64_t f = 0; f < settleFrames + 48000; f += 480) {
+            engine.render(buffer, 480);
+        }
+        check("Sounding note keeps render on the full path", !engine.isIdle());
+
+        // Once released, silence has to last IDLE_SETTLE_SECONDS
+        engine.postNoteOff(60, 0);
+        const int64_t releasedAt = engine.getFramePosition();
+        while (!engine.isIdle() && engine.getFramePosition() - releasedAt < 2 * settleFrames) {
+            engine.render(buffer, 480);
+        }
+        const int64_t idleAfter = engine.getFramePosition() - releasedAt;
+        check("Render goes idle after the settle time",
+              engine.isIdle() && idleAfter >= settleFrames && idleAfter < settleFrames + 4800,
+              ("frames=" + std::to_string(idleAfter)).c_str());
+
+        const int64_t idleCallbacks = engine.getStats().get(EngineStats::IDLE_CALLBACKS);
+        const int64_t position = engine.getFramePosition();
+        bool silent = true;
+        expectNoAllocations("Idle render does not allocate", [&] {
+            for (int b = 0; b < 10; b++) {
+                std::fill(std::begin(buffer), std::end(buffer), 1.0f);
+                engine.render(buffer, 480);
+                silent = silent && std::all_of(std::begin(buffer), std::end(buffer),
+                                               [](float s) { return s == 0.0f; });
+            }
+        });
+        check("Idle render is silent and keeps the clock running",
+              silent && engine.getFramePosition() == position + 4800 &&
+                  engine.getIdleFrames() == 4800 &&
+                  engine.getStats().get(EngineStats::IDLE_CALLBACKS) == idleCallbacks + 10 &&
+                  engine.getStats().get(EngineStats::IDLE_FRAMES) == 4800);
+
+        // A suspended stream: events posted meanwhile land on the first frame
+        // rendered after it restarts, however long that takes
+        engine.suspend();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const int64_t wakeFrame = engine.eventFrameNow();
+        check("Suspended clock holds events for the restart",
+              wakeFrame == engine.getFramePosition(),
+              ("frame=" + std::to_string(wakeFrame) + " position=" +
+               std::to_string(engine.getFramePosition()))
+                  .c_str());
+        const int64_t late = engine.getStats().get(EngineStats::LATE_EVENTS);
+        engine.postNoteOn(69, wakeFrame);
+        engine.render(buffer, 480);
+        int firstSound = -1;
+        for (int i = 0; i < 480 && firstSound < 0; i++) {
+            if (buffer[i] != 0.0f) {
+                firstSound = i;
+            }
+        }
+        check("Event wakes the idle engine on its frame",
+              !engine.isIdle() && firstSound >= 0 &&
+                  firstSound <= engine.getLatencyFrames() + 1 &&
+                  engine.getStats().get(EngineStats::LATE_EVENTS) == late,
+              ("first=" + std::to_string(firstSound)).c_str());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        check("Clock runs again after the restart",
+              engine.eventFrameNow() >= engine.getFramePosition() + 480);
+
+        // Detection off: silence goes through the full path
+        SynthCore full(patch);
+        full.setIdleDetection(false);
+        for (int64_t f = 0; f < 2 * settleFrames; f += 480) {
+            full.render(buffer, 480);
+        }
+        check("Idle detection can be turned off",
+              !full.isIdle() && full.getStats().get(EngineStats::IDLE_CALLBACKS) == 0);
+
+        // A one-shot pattern stops holding the engine awake once it has
+        // played out, and releases the note it never ended
+        SynthCore shot(patch);
+        SequencerPattern once;
+        once.loop = false;
+        once.lengthTicks = SequencerPattern::TICKS_PER_QUARTER;
+        once.addNote(0, 0, 240, 60);
+        once.tracks[0].events.push_back(SequencerEvent::noteOn(480, 64));
+        shot.getSequencer().setPattern(once);
+        shot.getSequencer().play(0);
+        while (!shot.isIdle() && shot.getFramePosition() < 2 * settleFrames) {
+            shot.render(buffer, 480);
+        }
+        check("Finished one-shot pattern lets the engine go idle",
+              shot.isIdle() && !shot.getSequencer().isPlaying() &&
+                  shot.activeVoiceCount() == 0,
+              ("frames=" + std::to_string(shot.getFramePosition())).c_str());
+    }
+
+    // --- Render is allocation-free ---
+    {
+        SynthCore engine;
+        float buffer[192];
+
+        // More notes than voices, so stealing runs inside render() too
+        for (int n = 0; n < SynthCore::MAX_POLYPHONY + 8; n++) {
+            engine.postNoteOn(40 + n, n * 7);
+        }
+        for (int n = 0; n < 8; n++) {
+            engine.postNoteOff(48 + n, 400 + n);
+        }
+        engine.postNoteOn(48, 800);
+        SequencerPattern pattern;
+        pattern.lengthTicks = 96;
+        pattern.addNote(0, 0, 40, 72);
+        pattern.addNote(0, 50, 40, 74);
+        engine.getSequencer().setPattern(pattern);
+        engine.getSequencer().play(300);
+
+        expectNoAllocations("Render does not allocate", [&] {
+            for (int b = 0; b < 50; b++) {
+                engine.render(buffer, 192);
+            }
+        });
+    }
+
+    // --- Summary ---
+    results << "Tests: " << passed << " passed, " << failed << " failed\n";
+    return results.str();
+}
@@ -0,0 +1,14 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Synth core test suite entry point
+ */
+
+#pragma once
+
+#include <string>
+
+// Runs every core test. Failing checks appear as "FAIL: ..." lines and the
+// last line is "Tests: N passed, M failed".
+std::string runEngineTests();
@@ -0,0 +1,131 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Sample-clocked ADSR envelope generator
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/*
+ * Every envelope stage is an affine one-pole step evaluated once per sample:
+ *
+ *     level = level * mul + add
+ *
+ * Linear ramps use mul = 1, exponential ramps use add = 0. Each stage runs for
+ * an exact number of frames, so stage changes land on sample boundaries
+ * regardless of buffer size or callback scheduling.
+ */
+enum class EnvelopeStage : uint8_t { ATTACK, DECAY, SUSTAIN, RELEASE, DONE };
+
+struct EnvelopeSegment {
+  static constexpr int32_t FOREVER = std::numeric_limits<int32_t>::max();
+
+  EnvelopeStage stage;
+  float mul;
+  float add;
+  int32_t frames;
+};
+
+struct EnvelopeParams {
+  int32_t attackFrames = 1;
+  int32_t decayFrames = 1;
+  int32_t releaseFrames = 1;
+  float sustainLevel = 1.0f;
+  float attackStep = 1.0f;
+  float decayStep = 0.0f;
+  float releaseMul = 0.0f;
+
+  // Release decays to this level over releaseFrames, then the voice ends
+  static constexpr float RELEASE_FLOOR = 0.001f;
+
+  static EnvelopeParams make(double sampleRate, double attackTime,
+                             double decayTime, double sustainLevel,
+                             double releaseTime) {
+    EnvelopeParams p;
+    p.attackFrames = std::max(1, static_cast<int32_t>(attackTime * sampleRate));
+    p.decayFrames = std::max(1, static_cast<int32_t>(decayTime * sampleRate));
+    p.releaseFrames =
+        std::max(1, static_cast<int32_t>(releaseTime * sampleRate));
+    p.sustainLevel = static_cast<float>(sustainLevel);
+    p.attackStep = 1.0f / p.attackFrames;
+    p.decayStep = static_cast<float>(-(1.0 - sustainLevel) / p.decayFrames);
+    p.releaseMul = static_cast<float>(
+        std::pow(static_cast<double>(RELEASE_FLOOR), 1.0 / p.releaseFrames));
+    return p;
+  }
+
+  // Attack starts from the current level, so a re-struck note ramps up
+  // instead of jumping back to zero.
+  EnvelopeSegment attackFrom(float level) const {
+    float remaining = std::max(0.0f, 1.0f - level);
+    int32_t frames = std::max(
+        1, static_cast<int32_t>(std::ceil(remaining / attackStep)));
+    return {EnvelopeStage::ATTACK, 1.0f, attackStep, frames};
+  }
+
+  EnvelopeSegment release() const {
+    return {EnvelopeStage::RELEASE, releaseMul, 0.0f, releaseFrames};
+  }
+
+  // The segment that follows `stage` once its frames run out. Snaps `level`
+  // to the stage target so float drift never accumulates across stages.
+  EnvelopeSegment after(EnvelopeStage stage, float &level) const {
+    switch (stage) {
+      case EnvelopeStage::ATTACK:
+        level = 1.0f;
+        return {EnvelopeStage::DECAY, 1.0f, decayStep, decayFrames};
+      case EnvelopeStage::DECAY:
+      case EnvelopeStage::SUSTAIN:
+        level = sustainLevel;
+        return {EnvelopeStage::SUSTAIN, 1.0f, 0.0f, EnvelopeSegment::FOREVER};
+      case EnvelopeStage::RELEASE:
+      case EnvelopeStage::DONE:
+        break;
+    }
+    level = 0.0f;
+    return {EnvelopeStage::DONE, 0.0f, 0.0f, EnvelopeSegment::FOREVER};
+  }
+};
+
+inline bool isReleasing(EnvelopeStage stage) {
+  return stage == EnvelopeStage::RELEASE || stage == EnvelopeStage::DONE;
+}
+
+// Single-voice envelope, for callers that do not keep voices in a pool
+struct EnvelopeGenerator {
+  using Stage = EnvelopeStage;
+
+  Stage stage = Stage::DONE;
+  float level = 0.0f;
+  float mul = 1.0f;
+  float add = 0.0f;
+  int32_t framesLeft = EnvelopeSegment::FOREVER;
+
+  bool isReleasing() const { return ::isReleasing(stage); }
+  bool isDone() const { return stage == Stage::DONE; }
+
+  void noteOn(const EnvelopeParams &p) { enter(p.attackFrom(level)); }
+
+  void noteOff(const EnvelopeParams &p) {
+    if (!isReleasing()) {
+      enter(p.release());
+    }
+  }
+
+  // Called when framesLeft reaches zero
+  void advance(const EnvelopeParams &p) { enter(p.after(stage, level)); }
+
+private:
+  void enter(const EnvelopeSegment &segment) {
+    stage = segment.stage;
+    mul = segment.mul;
+    add = segment.add;
+    framesLeft = segment.frames;
+  }
+};
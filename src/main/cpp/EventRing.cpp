@@ -0,0 +1,95 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Note events batched through a buffer shared with Kotlin
+ */
+
+#include "EventRing.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "SynthCore.h"
+
+void EventRing::attach(const void *base, size_t bytes) {
+    records = static_cast<const unsigned char *>(base);
+    size = base != nullptr ? static_cast<uint32_t>(bytes / sizeof(PackedNoteEvent)) : 0;
+    readIndex = 0;
+}
+
+void EventRing::skip(int count) {
+    if (size > 0 && count > 0) {
+        readIndex = (readIndex + static_cast<uint32_t>(count) % size) % size;
+    }
+}
+
+int EventRing::submit(SynthCore &synth, int count) {
+    if (size == 0 || count <= 0) {
+        return 0;
+    }
+    // Anything beyond one lap was overwritten by the writer already
+    if (static_cast<uint32_t>(count) > size) {
+        skip(count - static_cast<int>(size));
+        count = static_cast<int>(size);
+    }
+
+    NoteEvent batch[BATCH];
+    int queued = 0;
+    int64_t nowFrame = -1;
+    while (count > 0) {
+        const int n = std::min(count, BATCH);
+        int built = 0;
+        for (int i = 0; i < n; i++) {
+            // The ByteBuffer only promises byte alignment
+            PackedNoteEvent record;
+            std::memcpy(&record, records + readIndex * sizeof(PackedNoteEvent), sizeof(record));
+            readIndex = readIndex + 1 == size ? 0 : readIndex + 1;
+            if (record.type > PackedNoteEvent::PRESSURE) {
+                continue;
+            }
+
+            NoteEvent &event = batch[built++];
+            if (record.timeNanos > 0) {
+                event.frame = synth.eventFrameAt(record.timeNanos);
+            } else {
+                // Read the clock once for every unstamped event in the call
+                if (nowFrame < 0) {
+                    nowFrame = synth.eventFrameNow();
+                }
+                event.frame = nowFrame;
+            }
+            event.midiNote = std::min<int>(record.note, 127);
+            event.pan = 0.0f;
+            event.velocity = SynthCore::DEFAULT_VELOCITY;
+            if (record.type == PackedNoteEvent::NOTE_ON) {
+                event.type = NoteEvent::Type::NOTE_ON;
+                event.pan = (record.flags & PackedNoteEvent::HAS_PAN) != 0
+                                ? std::clamp(record.pan, -1.0f, 1.0f)
+                                : synth.keyPan(event.midiNote);
+                if (record.velocity != 0) {
+                    event.velocity = static_cast<uint8_t>(std::min<int>(record.velocity, 127));
+                }
+            } else if (record.type == PackedNoteEvent::NOTE_OFF) {
+                event.type = NoteEvent::Type::NOTE_OFF;
+            } else if (record.type == PackedNoteEvent::PITCH_BEND) {
+                event.type = NoteEvent::Type::PITCH_BEND;
+                event.amount = record.pan;
+            } else if (record.type == PackedNoteEvent::PRESSURE) {
+                event.type = NoteEvent::Type::PRESSURE;
+                event.amount = std::clamp(record.pan, 0.0f, 1.0f);
+            } else {
+                event.type = NoteEvent::Type::ALL_OFF;
+                event.midiNote = -1;
+            }
+            if ((record.flags & PackedNoteEvent::ALL_NOTES) != 0 &&
+                (record.type == PackedNoteEvent::PITCH_BEND ||
+                 record.type == PackedNoteEvent::PRESSURE)) {
+                event.midiNote = -1;
+            }
+        }
+        queued += synth.postEvents(batch, built);
+        count -= n;
+    }
+    return queued;
+}
@@ -0,0 +1,74 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Note events batched through a buffer shared with Kotlin
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class SynthCore;
+
+// One record as Kotlin writes it into the shared direct ByteBuffer, in
+// native byte order (ByteOrder.nativeOrder()): 16 bytes, no padding
+struct PackedNoteEvent {
+  // PITCH_BEND and PRESSURE carry their amount (semitones, 0..1) in `pan`
+  enum Type : uint8_t { NOTE_ON, NOTE_OFF, ALL_OFF, PITCH_BEND, PRESSURE };
+  enum Flags : uint8_t {
+    // `pan` is set; otherwise the note gets SynthCore::keyPan()
+    HAS_PAN = 1,
+    // PITCH_BEND, PRESSURE: for every note rather than `note`
+    ALL_NOTES = 2,
+  };
+
+  uint8_t type;
+  uint8_t note;
+  // NOTE_ON: 1..127; 0 for the default
+  uint8_t velocity;
+  uint8_t flags;
+  // -1 hard left .. +1 hard right
+  float pan;
+  // System.nanoTime() when the event happened (e.g. the touch); 0 for now
+  int64_t timeNanos;
+};
+static_assert(sizeof(PackedNoteEvent) == 16, "Record layout is shared with Kotlin");
+
+/*
+ * Replaces one JNI call per note with one per batch: Kotlin appends records
+ * to a ring of PackedNoteEvent in a direct ByteBuffer and calls submit()
+ * with how many it appended. submit() reads them from where the previous
+ * call stopped (wrapping at the end of the ring, as the writer does), works
+ * out each event's frame from its timestamp and queues the whole batch with
+ * one claim on SynthCore's event queue. Records of an unknown type are
+ * skipped.
+ *
+ * The call is synchronous, so the records are consumed before it returns
+ * and the writer may reuse them right away; no index is shared.
+ *
+ * Threading: attach/submit/skip from one thread at a time, the one that
+ * writes the ring.
+ */
+class EventRing {
+public:
+  // Records converted and posted per claim on the event queue
+  static constexpr int BATCH = 32;
+
+  // `bytes` is rounded down to whole records. The memory must stay valid
+  // until the next attach() or detach(). Starts reading at record 0.
+  void attach(const void *base, size_t bytes);
+  void detach() { attach(nullptr, 0); }
+  int capacity() const { return static_cast<int>(size); }
+
+  // Posts the next `count` records; returns how many were queued
+  int submit(SynthCore &synth, int count);
+  // Consumes the next `count` records without posting them
+  void skip(int count);
+
+private:
+  const unsigned char *records = nullptr;
+  uint32_t size = 0;
+  uint32_t readIndex = 0;
+};
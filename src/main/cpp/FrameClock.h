@@ -0,0 +1,75 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Maps wall-clock event times onto the audio render frame clock
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * The audio callback publishes (frame position, steady_clock nanos) at the
+ * start of every buffer. A JNI thread posting an event extrapolates from the
+ * latest snapshot to the frame that corresponds to "now", plus one buffer of
+ * scheduling delay. Every event therefore lands a constant distance after it
+ * was posted, instead of at whatever point the next callback happens to run.
+ *
+ * While the stream is suspended (see pause()) there is no clock to
+ * extrapolate from: events land on the first frame rendered once it
+ * resumes.
+ *
+ * The snapshot is guarded by a sequence counter: the single writer never
+ * waits, readers retry if they raced with a publish.
+ */
+class FrameClock {
+public:
+  // Audio thread only
+  void publish(int64_t framePosition, int64_t nanos, int32_t bufferFrames) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    frame.store(framePosition, std::memory_order_relaxed);
+    time.store(nanos, std::memory_order_relaxed);
+    delay.store(bufferFrames, std::memory_order_relaxed);
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  // Audio thread, after the last buffer before callbacks stop for a while:
+  // until the next publish(), every event lands on `framePosition`
+  void pause(int64_t framePosition) { publish(framePosition, PAUSED, 0); }
+
+  // Any thread. Returns 0 ("as soon as possible") before the first callback.
+  int64_t eventFrame(int64_t nowNanos, int32_t sampleRate) const {
+    int64_t snapFrame, snapTime;
+    int32_t snapDelay;
+    uint32_t before, after;
+    do {
+      before = sequence.load(std::memory_order_acquire);
+      snapFrame = frame.load(std::memory_order_relaxed);
+      snapTime = time.load(std::memory_order_relaxed);
+      snapDelay = delay.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1u));
+
+    if (snapTime == 0) {
+      return 0;
+    }
+    if (snapTime == PAUSED) {
+      return snapFrame;
+    }
+    double elapsed = static_cast<double>(nowNanos - snapTime) * 1e-9;
+    return snapFrame + static_cast<int64_t>(elapsed * sampleRate) + snapDelay;
+  }
+
+private:
+  static constexpr int64_t PAUSED = -1;
+
+  std::atomic<uint32_t> sequence{0};
+  std::atomic<int64_t> frame{0};
+  std::atomic<int64_t> time{0};
+  std::atomic<int32_t> delay{0};
+};
@@ -7,13 +7,25 @@
 
 #include "JUCEAudioEngine.h"
 
-JUCEAudioEngine::JUCEAudioEngine() : sampleRate(SAMPLE_RATE) {
+#include <algorithm>
+#include <iterator>
+
+JUCEAudioEngine::JUCEAudioEngine() : synth(makePatch()) {
 	LOGI("JUCEAudioEngine constructor called");
+}
 
-	voices.resize(MAX_VOICES);
-	for (auto &voice : voices) {
-		voice = Voice();
-	}
+SynthCore::Patch JUCEAudioEngine::makePatch() {
+	// Brighter than the Oboe voice: five harmonics, halving in level
+	SynthCore::Patch patch;
+	const double harmonics[] = {1.0, 0.5, 0.25, 0.125, 0.08};
+	std::copy(std::begin(harmonics), std::end(harmonics), patch.harmonics);
+	patch.numHarmonics = 5;
+	patch.attackTime = ATTACK_TIME;
+	patch.decayTime = DECAY_TIME;
+	patch.sustainLevel = SUSTAIN_LEVEL;
+	patch.releaseTime = RELEASE_TIME;
+	patch.maxVoices = MAX_VOICES;
+	return patch;
 }
 
 void JUCEAudioEngine::initialize() {
@@ -34,12 +46,14 @@ void JUCEAudioEngine::initialize() {
 		return;
 	}
 
+	// audioDeviceAboutToStart() picks up the device rate before the
+	// first callback
 	deviceManager->addAudioCallback(this);
 
 	if (auto *device = deviceManager->getCurrentAudioDevice()) {
-		sampleRate = device->getCurrentSampleRate();
 		LOGI("Audio device initialized: sampleRate=%.0f, bufferSize=%d",
-		     sampleRate, device->getCurrentBufferSizeSamples());
+		     device->getCurrentSampleRate(),
+		     device->getCurrentBufferSizeSamples());
 	}
 
 	LOGI("JUCE audio engine started successfully");
@@ -52,133 +66,40 @@ JUCEAudioEngine::~JUCEAudioEngine() {
 void JUCEAudioEngine::shutdown() {
 	LOGI("Shutting down JUCEAudioEngine");
 
-	stopAllNotes();
-
 	if (deviceManager) {
 		deviceManager->removeAudioCallback(this);
 		deviceManager->closeAudioDevice();
 		deviceManager.reset();
 	}
 
-	LOGI("JUCEAudioEngine destroyed");
-}
-
-double JUCEAudioEngine::midiNoteToFrequency(int midiNote) {
-	return 440.0 * std::pow(2.0, (midiNote - 69) / 12.0);
-}
-
-JUCEAudioEngine::Voice *JUCEAudioEngine::findFreeVoice() {
-	for (auto &voice : voices) {
-		if (!voice.active && voice.envelopePhase == Voice::Idle) {
-			return &voice;
-		}
-	}
-
-	for (auto &voice : voices) {
-		if (voice.envelopePhase == Voice::Release) {
-			return &voice;
-		}
-	}
-
-	return &voices[0];
-}
+	// The callback is no longer running, so the voices can be cleared here
+	synth.reset();
 
-JUCEAudioEngine::Voice *JUCEAudioEngine::findVoiceForNote(int midiNote) {
-	for (auto &voice : voices) {
-		if (voice.active && voice.midiNote == midiNote) {
-			return &voice;
-		}
-	}
-	return nullptr;
+	LOGI("JUCEAudioEngine destroyed");
 }
 
 void JUCEAudioEngine::playNotePolyphonic(int midiNote) {
-	std::lock_guard<std::mutex> lock(voicesMutex);
-
-	if (findVoiceForNote(midiNote) != nullptr) {
-		LOGI("Note %d already playing, ignoring", midiNote);
+	if (!synth.postNoteOn(midiNote, synth.eventFrameNow())) {
+		LOGI("Note event queue full - dropping note %d", midiNote);
 		return;
 	}
-
-	Voice *voice = findFreeVoice();
-	if (!voice) {
-		LOGI("No free voices available");
-		return;
-	}
-
-	voice->midiNote = midiNote;
-	voice->frequency = midiNoteToFrequency(midiNote);
-	voice->phase = 0.0;
-	voice->active = true;
-	voice->envelopePhase = Voice::Attack;
-	voice->envelopeValue = 0.0;
-	voice->amplitude = 0.3;
-
-	LOGI("Playing note: %d (%.2f Hz) on voice", midiNote, voice->frequency);
+	LOGI("Playing note: %d", midiNote);
 }
 
 void JUCEAudioEngine::stopNotePolyphonic(int midiNote) {
-	std::lock_guard<std::mutex> lock(voicesMutex);
-
-	Voice *voice = findVoiceForNote(midiNote);
-	if (voice) {
-		voice->envelopePhase = Voice::Release;
-		LOGI("Stopped note: %d (entering release)", midiNote);
+	if (!synth.postNoteOff(midiNote, synth.eventFrameNow())) {
+		LOGI("Note event queue full - dropping release of %d", midiNote);
+		return;
 	}
+	LOGI("Stopped note: %d (entering release)", midiNote);
 }
 
 void JUCEAudioEngine::stopAllNotes() {
-	std::lock_guard<std::mutex> lock(voicesMutex);
-
-	for (auto &voice : voices) {
-		if (voice.active) {
-			voice.envelopePhase = Voice::Release;
-		}
-	}
-
-	LOGI("All notes entering release phase");
-}
-
-void JUCEAudioEngine::updateEnvelope(Voice &voice, int numSamples) {
-	double timeStep = 1.0 / sampleRate;
-
-	switch (voice.envelopePhase) {
-		case Voice::Attack:
-			voice.envelopeValue += timeStep / ATTACK_TIME;
-			if (voice.envelopeValue >= 1.0) {
-				voice.envelopeValue = 1.0;
-				voice.envelopePhase = Voice::Decay;
-			}
-			break;
-
-		case Voice::Decay:
-			voice.envelopeValue -=
-			    (1.0 - SUSTAIN_LEVEL) * timeStep / DECAY_TIME;
-			if (voice.envelopeValue <= SUSTAIN_LEVEL) {
-				voice.envelopeValue = SUSTAIN_LEVEL;
-				voice.envelopePhase = Voice::Sustain;
-			}
-			break;
-
-		case Voice::Sustain:
-			voice.envelopeValue = SUSTAIN_LEVEL;
-			break;
-
-		case Voice::Release:
-			voice.envelopeValue -=
-			    SUSTAIN_LEVEL * timeStep / RELEASE_TIME;
-			if (voice.envelopeValue <= 0.0) {
-				voice.envelopeValue = 0.0;
-				voice.envelopePhase = Voice::Idle;
-				voice.active = false;
-			}
-			break;
-
-		case Voice::Idle:
-			voice.envelopeValue = 0.0;
-			voice.active = false;
-			break;
+	if (!synth.postAllNotesOff(synth.eventFrameNow())) {
+		LOGI("Note event queue full - dropping all-notes-off");
+		return;
 	}
+	LOGI("All notes off");
 }
 
 void JUCEAudioEngine::audioDeviceIOCallbackWithContext(
@@ -189,51 +110,26 @@ void JUCEAudioEngine::audioDeviceIOCallbackWithContext(
     int numSamples,
     const juce::AudioIODeviceCallbackContext &context) {
 
+	// Render mono once into the first live channel, then copy it out
+	float *mono = nullptr;
 	for (int channel = 0; channel < numOutputChannels; ++channel) {
-		if (outputChannelData[channel] != nullptr) {
-			std::fill_n(outputChannelData[channel], numSamples,
-				    0.0f);
-		}
-	}
-
-	std::lock_guard<std::mutex> lock(voicesMutex);
-
-	for (auto &voice : voices) {
-		if (!voice.active && voice.envelopePhase == Voice::Idle) {
+		float *out = outputChannelData[channel];
+		if (out == nullptr) {
 			continue;
 		}
-
-		double phaseIncrement = TWO_PI * voice.frequency / sampleRate;
-
-		for (int i = 0; i < numSamples; ++i) {
-			updateEnvelope(voice, 1);
-			float sample = 0.0f;
-			sample += std::sin(voice.phase) * 1.0f;
-			sample += std::sin(voice.phase * 2.0) * 0.5f;
-			sample += std::sin(voice.phase * 3.0) * 0.25f;
-			sample += std::sin(voice.phase * 4.0) * 0.125f;
-			sample += std::sin(voice.phase * 5.0) * 0.08f;
-
-			sample *= static_cast<float>(
-			    voice.amplitude * voice.envelopeValue * 0.5f);
-
-			for (int channel = 0; channel < numOutputChannels;
-			     ++channel) {
-				if (outputChannelData[channel] != nullptr) {
-					outputChannelData[channel][i] += sample;
-				}
-			}
-			voice.phase += phaseIncrement;
-			if (voice.phase >= TWO_PI) {
-				voice.phase -= TWO_PI;
-			}
+		if (mono == nullptr) {
+			mono = out;
+			synth.render(mono, numSamples);
+		} else {
+			std::copy_n(mono, numSamples, out);
 		}
 	}
 }
 
 void JUCEAudioEngine::audioDeviceAboutToStart(juce::AudioIODevice *device) {
-	sampleRate = device->getCurrentSampleRate();
-	LOGI("Audio device about to start: sampleRate=%.0f", sampleRate);
+	synth.setSampleRate(static_cast<int32_t>(device->getCurrentSampleRate()));
+	LOGI("Audio device about to start: sampleRate=%d",
+	     synth.getSampleRate());
 }
 
 void JUCEAudioEngine::audioDeviceStopped() {
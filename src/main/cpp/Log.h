@@ -0,0 +1,33 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Android log macros; the chatty levels compile out of release builds
+ */
+
+#pragma once
+
+#include <android/log.h>
+
+// Define LOG_TAG before including. LOGI and LOGD are for development:
+// unless ONGOMA_VERBOSE_LOGGING is set, a release (NDEBUG) build compiles
+// them to nothing, format string and argument evaluation included. They are
+// still type-checked, so a log-only variable does not turn into a warning.
+// LOGW and LOGE always log; keep them off per-note and per-buffer paths.
+#if !defined(NDEBUG) || defined(ONGOMA_VERBOSE_LOGGING)
+#define ONGOMA_VERBOSE_LOG 1
+#else
+#define ONGOMA_VERBOSE_LOG 0
+#endif
+
+#define ONGOMA_LOG_IF(enabled, priority, ...)                        \
+  do {                                                               \
+    if (enabled) {                                                   \
+      __android_log_print(priority, LOG_TAG, __VA_ARGS__);           \
+    }                                                                \
+  } while (0)
+
+#define LOGD(...) ONGOMA_LOG_IF(ONGOMA_VERBOSE_LOG, ANDROID_LOG_DEBUG, __VA_ARGS__)
+#define LOGI(...) ONGOMA_LOG_IF(ONGOMA_VERBOSE_LOG, ANDROID_LOG_INFO, __VA_ARGS__)
+#define LOGW(...) ONGOMA_LOG_IF(1, ANDROID_LOG_WARN, __VA_ARGS__)
+#define LOGE(...) ONGOMA_LOG_IF(1, ANDROID_LOG_ERROR, __VA_ARGS__)
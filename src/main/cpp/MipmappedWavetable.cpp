@@ -0,0 +1,69 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Band-limited, octave-mipmapped wavetable set
+ */
+
+#include "MipmappedWavetable.h"
+
+#include <algorithm>
+#include <cmath>
+
+void MipmappedWavetable::build(const double *amplitudes, int numHarmonics,
+                               double sampleRate) {
+    constexpr int N = OscillatorKernel::TABLE_SIZE;
+    numHarmonics = std::min(numHarmonics, MAX_HARMONICS);
+
+    // Harmonic h of entry i is sin(2*pi*h*i/N) = sine[(h*i) mod N], so one
+    // sine cycle serves every harmonic without further trig calls
+    std::vector<double> sine(N);
+    for (int i = 0; i < N; i++) {
+        sine[i] = std::sin(2.0 * M_PI * i / N);
+    }
+
+    double amplitudeSum = 0.0;
+    for (int h = 0; h < numHarmonics; h++) {
+        amplitudeSum += std::abs(amplitudes[h]);
+    }
+    const double norm = amplitudeSum > 0.0 ? 1.0 / amplitudeSum : 0.0;
+
+    pairTables.assign(static_cast<size_t>(NUM_LEVELS) * OscillatorKernel::PAIR_TABLE_FLOATS, 0.0f);
+    std::vector<double> cycle(N);
+    std::vector<float> table(N);
+    const double nyquist = sampleRate / 2.0;
+
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        double topFrequency = LEVEL_0_TOP_HZ * std::ldexp(1.0, level);
+        int harmonics = std::min(numHarmonics,
+                                 static_cast<int>(nyquist / topFrequency));
+        levelHarmonics[level] = harmonics;
+
+        std::fill(cycle.begin(), cycle.end(), 0.0);
+        for (int h = 1; h <= harmonics; h++) {
+            const double amp = amplitudes[h - 1] * norm;
+            if (amp == 0.0) {
+                continue;
+            }
+            for (int i = 0; i < N; i++) {
+                cycle[i] += amp * sine[(static_cast<int64_t>(h) * i) & (N - 1)];
+            }
+        }
+        for (int i = 0; i < N; i++) {
+            table[i] = static_cast<float>(cycle[i]);
+        }
+        OscillatorKernel::buildPairTable(
+            table.data(), pairTables.data() + level * OscillatorKernel::PAIR_TABLE_FLOATS);
+    }
+}
+
+int MipmappedWavetable::levelFor(double frequency) const {
+    double top = LEVEL_0_TOP_HZ;
+    for (int level = 0; level < NUM_LEVELS - 1; level++) {
+        if (frequency <= top) {
+            return level;
+        }
+        top *= 2.0;
+    }
+    return NUM_LEVELS - 1;
+}
@@ -0,0 +1,51 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Band-limited, octave-mipmapped wavetable set
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "OscillatorKernel.h"
+
+/*
+ * One table per octave of fundamental frequency, each holding only the
+ * harmonics that stay below Nyquist for the highest note of that octave.
+ * All levels live in one contiguous pair-table array, so a voice selects its
+ * level with a fixed entry offset (tableOffset) chosen at note-on and the
+ * oscillator kernel's per-sample cost is unchanged.
+ *
+ * Built once off the audio thread; read-only afterwards.
+ */
+class MipmappedWavetable {
+public:
+  static constexpr int NUM_LEVELS = 11;
+  // Top fundamental of level 0; level k covers up to LEVEL_0_TOP_HZ * 2^k
+  static constexpr double LEVEL_0_TOP_HZ = 40.0;
+  // Keeps each table itself free of aliasing at TABLE_SIZE points
+  static constexpr int MAX_HARMONICS = OscillatorKernel::TABLE_SIZE / 2 - 1;
+
+  // amplitudes[h] is the level of harmonic h + 1. The result is normalized
+  // by the sum of all amplitudes so every level peaks at or below 1.0.
+  void build(const double *amplitudes, int numHarmonics, double sampleRate);
+
+  const float *pairs() const { return pairTables.data(); }
+  const float *levelPairs(int level) const {
+    return pairTables.data() + level * OscillatorKernel::PAIR_TABLE_FLOATS;
+  }
+  int harmonicsInLevel(int level) const { return levelHarmonics[level]; }
+
+  // Cheap enough for note-on: a compare per octave, no transcendental math
+  int levelFor(double frequency) const;
+  uint32_t tableOffsetFor(double frequency) const {
+    return static_cast<uint32_t>(levelFor(frequency)) * OscillatorKernel::TABLE_SIZE;
+  }
+
+private:
+  std::vector<float> pairTables;
+  int levelHarmonics[NUM_LEVELS] = {};
+};
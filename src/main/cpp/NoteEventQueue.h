@@ -0,0 +1,160 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Lock-free note event queue between JNI threads and the audio callback
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+struct NoteEvent {
+  // PITCH_BEND and PRESSURE act on one sounding note, or with midiNote -1
+  // on every note
+  enum class Type : uint8_t { NOTE_ON, NOTE_OFF, ALL_OFF, PITCH_BEND, PRESSURE };
+
+  Type type;
+  int midiNote;
+  int64_t frame; // render frame the event takes effect on
+  union {
+    float pan = 0.0f; // NOTE_ON: -1 hard left .. +1 hard right
+    float amount; // PITCH_BEND: semitones; PRESSURE: 0..1
+  };
+  uint8_t velocity = 100; // NOTE_ON only: 1..127
+
+  static NoteEvent noteOn(int midiNote, int64_t frame, float pan, int velocity) {
+    return NoteEvent{Type::NOTE_ON, midiNote, frame, pan, static_cast<uint8_t>(velocity)};
+  }
+  static NoteEvent noteOff(int midiNote, int64_t frame) {
+    return NoteEvent{Type::NOTE_OFF, midiNote, frame, 0.0f, 100};
+  }
+  static NoteEvent pitchBend(int midiNote, int64_t frame, float semitones) {
+    NoteEvent event{Type::PITCH_BEND, midiNote, frame, 0.0f, 100};
+    event.amount = semitones;
+    return event;
+  }
+  static NoteEvent pressure(int midiNote, int64_t frame, float pressure) {
+    NoteEvent event{Type::PRESSURE, midiNote, frame, 0.0f, 100};
+    event.amount = pressure;
+    return event;
+  }
+};
+
+/*
+ * Bounded multi-producer / single-consumer ring (Vyukov-style sequenced
+ * slots). Any number of JNI threads may push; only the audio callback pops.
+ *
+ * Each slot carries a sequence number: a producer claims a slot by CAS on
+ * writeIndex, fills it, then publishes it by bumping the slot sequence. The
+ * consumer never waits or retries - if the next slot is not yet published it
+ * simply stops draining and picks it up on the next callback.
+ */
+template <typename T, uint32_t CAPACITY>
+class NoteEventQueue {
+public:
+  static constexpr bool isPowerOfTwo(uint32_t n) { return (n & (n - 1)) == 0; }
+  static_assert(isPowerOfTwo(CAPACITY), "Capacity must be a power of 2");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Queue items are copied on the audio thread");
+
+  NoteEventQueue() {
+    for (uint32_t i = 0; i < CAPACITY; i++) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Producer side (any thread). Returns false if the queue is full.
+  bool push(const T &item) {
+    uint32_t pos = writeIndex.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = slots[pos & MASK];
+      uint32_t seq = slot.sequence.load(std::memory_order_acquire);
+      int32_t diff = static_cast<int32_t>(seq - pos);
+      if (diff == 0) {
+        if (writeIndex.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          slot.item = item;
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = writeIndex.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Producer side (any thread): pushes as many of `items` as fit, in order,
+  // with a single claim on writeIndex. Returns how many were pushed.
+  uint32_t push(const T *items, uint32_t count) {
+    if (count == 0) {
+      return 0;
+    }
+    uint32_t pos = writeIndex.load(std::memory_order_relaxed);
+    for (;;) {
+      // Count the free slots from pos. None of them can be taken by anyone
+      // else without moving writeIndex, which would fail the CAS below.
+      uint32_t free = 0;
+      int32_t diff = 0;
+      while (free < count) {
+        uint32_t seq = slots[(pos + free) & MASK].sequence.load(std::memory_order_acquire);
+        diff = static_cast<int32_t>(seq - (pos + free));
+        if (diff != 0) {
+          break;
+        }
+        free++;
+      }
+      if (free == 0) {
+        if (diff < 0) {
+          return 0;
+        }
+        pos = writeIndex.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (writeIndex.compare_exchange_weak(pos, pos + free, std::memory_order_relaxed)) {
+        for (uint32_t i = 0; i < free; i++) {
+          Slot &slot = slots[(pos + i) & MASK];
+          slot.item = items[i];
+          slot.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return free;
+      }
+    }
+  }
+
+  // Consumer side (audio thread only). Wait-free.
+  bool pop(T &item) {
+    Slot &slot = slots[readIndex & MASK];
+    uint32_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(seq - (readIndex + 1)) < 0) {
+      return false;
+    }
+    item = slot.item;
+    slot.sequence.store(readIndex + CAPACITY, std::memory_order_release);
+    readIndex++;
+    return true;
+  }
+
+  // Consumer side: whether pop() would find nothing
+  bool empty() const {
+    const Slot &slot = slots[readIndex & MASK];
+    const uint32_t seq = slot.sequence.load(std::memory_order_acquire);
+    return static_cast<int32_t>(seq - (readIndex + 1)) < 0;
+  }
+
+private:
+  static constexpr uint32_t MASK = CAPACITY - 1;
+
+  struct Slot {
+    std::atomic<uint32_t> sequence;
+    T item;
+  };
+
+  Slot slots[CAPACITY];
+  alignas(64) std::atomic<uint32_t> writeIndex{0};
+  alignas(64) uint32_t readIndex = 0;
+};
@@ -0,0 +1,847 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Multi-voice wavetable oscillator kernels
+ */
+
+#include "OscillatorKernel.h"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define OSC_HAVE_SSE2 1
+#if defined(__GNUC__)
+#define OSC_HAVE_AVX2 1
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OSC_HAVE_NEON 1
+#endif
+
+/*
+ * Every SIMD kernel walks the voices two lane groups at a time. The envelope
+ * recurrence is a serial multiply-add chain per group, so interleaving two
+ * independent groups hides its latency, and summing both groups before the
+ * horizontal add halves the per-frame reduction cost.
+ */
+
+namespace {
+
+constexpr float FRAC_SCALE = 1.0f / (1u << OscillatorKernel::FRAC_BITS);
+
+using RenderFn = void (*)(const float *, const OscillatorKernel::Voices &,
+                          float, float *, int32_t);
+
+OscillatorKernel::Voices offsetVoices(const OscillatorKernel::Voices &voices, int first) {
+    OscillatorKernel::Voices rest{voices.phase + first, voices.phaseIncrement + first,
+                                  voices.tableOffset + first, voices.envLevel + first,
+                                  voices.envMul + first, voices.envAdd + first,
+                                  voices.count - first};
+    if (voices.panLeft != nullptr) {
+        rest.panLeft = voices.panLeft + first;
+        rest.panRight = voices.panRight + first;
+    }
+    rest.filter = voices.filter.offset(first);
+    rest.modulation = voices.modulation.offset(first);
+    return rest;
+}
+
+// CHANNELS is 1 (mono) or 2 (interleaved stereo, weighted by voice pan);
+// FILTERED runs each voice through its state-variable filter; MODULATED
+// ramps its phase increment and output gain
+template <int CHANNELS, bool FILTERED, bool MODULATED>
+void renderScalarVoices(const float *pairs, const OscillatorKernel::Voices &voices,
+                        float gain, float *output, int32_t numFrames) {
+    const OscillatorKernel::Filter &filter = voices.filter;
+    const OscillatorKernel::Modulation &modulation = voices.modulation;
+    for (int v = 0; v < voices.count; v++) {
+        uint32_t phase = voices.phase[v];
+        uint32_t increment = voices.phaseIncrement[v];
+        const uint32_t incrementStep =
+            MODULATED ? static_cast<uint32_t>(modulation.incrementStep[v]) : 0;
+        float modGain = MODULATED ? modulation.gain[v] : 1.0f;
+        const float modGainStep = MODULATED ? modulation.gainStep[v] : 0.0f;
+        const float *table = pairs + 2 * static_cast<size_t>(voices.tableOffset[v]);
+        float level = voices.envLevel[v];
+        const float mul = voices.envMul[v];
+        const float add = voices.envAdd[v];
+        const float left = CHANNELS == 2 ? voices.panLeft[v] * gain : gain;
+        const float right = CHANNELS == 2 ? voices.panRight[v] * gain : 0.0f;
+        float s1 = 0.0f, s2 = 0.0f, g = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float gStep = 0.0f, a1Step = 0.0f, a2Step = 0.0f;
+        if (FILTERED) {
+            s1 = filter.s1[v];
+            s2 = filter.s2[v];
+            g = filter.g[v];
+            a1 = filter.a1[v];
+            a2 = filter.a2[v];
+            gStep = filter.gStep[v];
+            a1Step = filter.a1Step[v];
+            a2Step = filter.a2Step[v];
+        }
+
+        for (int32_t i = 0; i < numFrames; i++) {
+            const float *pair = table + 2 * (phase >> OscillatorKernel::FRAC_BITS);
+            float frac = static_cast<float>(phase & OscillatorKernel::FRAC_MASK) * FRAC_SCALE;
+            float sample = pair[0] + pair[1] * frac;
+            if (FILTERED) {
+                const float v3 = sample - s2;
+                const float v1 = a1 * s1 + a2 * v3;
+                const float v2 = s2 + g * v1;
+                s1 = (v1 + v1) - s1;
+                s2 = (v2 + v2) - s2;
+                sample = v2;
+                g += gStep;
+                a1 += a1Step;
+                a2 += a2Step;
+            }
+            sample *= level;
+            if (MODULATED) {
+                sample *= modGain;
+            }
+            if (CHANNELS == 2) {
+                output[2 * i] += sample * left;
+                output[2 * i + 1] += sample * right;
+            } else {
+                output[i] += sample * left;
+            }
+            level = level * mul + add;
+            phase += increment;
+            if (MODULATED) {
+                increment += incrementStep;
+                modGain += modGainStep;
+            }
+        }
+
+        voices.phase[v] = phase;
+        voices.envLevel[v] = level;
+        if (MODULATED) {
+            voices.phaseIncrement[v] = increment;
+            modulation.gain[v] = modGain;
+        }
+        if (FILTERED) {
+            filter.s1[v] = s1;
+            filter.s2[v] = s2;
+            filter.g[v] = g;
+            filter.a1[v] = a1;
+            filter.a2[v] = a2;
+        }
+    }
+}
+
+template <int CHANNELS>
+void renderScalarKernel(const float *pairs, const OscillatorKernel::Voices &voices, float gain,
+                        float *output, int32_t numFrames) {
+    const bool filtered = voices.filter.s1 != nullptr;
+    if (voices.modulation.gain != nullptr) {
+        if (filtered) {
+            renderScalarVoices<CHANNELS, true, true>(pairs, voices, gain, output, numFrames);
+        } else {
+            renderScalarVoices<CHANNELS, false, true>(pairs, voices, gain, output, numFrames);
+        }
+    } else if (filtered) {
+        renderScalarVoices<CHANNELS, true, false>(pairs, voices, gain, output, numFrames);
+    } else {
+        renderScalarVoices<CHANNELS, false, false>(pairs, voices, gain, output, numFrames);
+    }
+}
+
+#if OSC_HAVE_SSE2
+inline float horizontalSum(__m128 x) {
+    __m128 shuf = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(x, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+// Adds {sum(left), sum(right)} * gain to one interleaved stereo frame
+inline void accumulateStereo(float *frame, __m128 left, __m128 right, __m128 gain) {
+    __m128 sums = _mm_add_ps(_mm_unpacklo_ps(left, right), _mm_unpackhi_ps(left, right));
+    sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+    __m128 out = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(frame));
+    _mm_storel_pi(reinterpret_cast<__m64 *>(frame), _mm_add_ps(out, _mm_mul_ps(sums, gain)));
+}
+
+struct Sse2Group {
+    __m128i phase;
+    __m128i increment;
+    __m128i offset;
+    __m128 level;
+    __m128 mul;
+    __m128 add;
+    __m128 panLeft;
+    __m128 panRight;
+    __m128 s1, s2, g, a1, a2;
+    __m128 gStep, a1Step, a2Step;
+    __m128i incrementStep;
+    __m128 gain, gainStep;
+
+    Sse2Group(const OscillatorKernel::Voices &voices, int v)
+        : phase(_mm_loadu_si128(reinterpret_cast<const __m128i *>(voices.phase + v))),
+          increment(_mm_loadu_si128(reinterpret_cast<const __m128i *>(voices.phaseIncrement + v))),
+          offset(_mm_loadu_si128(reinterpret_cast<const __m128i *>(voices.tableOffset + v))),
+          level(_mm_loadu_ps(voices.envLevel + v)),
+          mul(_mm_loadu_ps(voices.envMul + v)),
+          add(_mm_loadu_ps(voices.envAdd + v)) {}
+
+    void loadPan(const OscillatorKernel::Voices &voices, int v) {
+        panLeft = _mm_loadu_ps(voices.panLeft + v);
+        panRight = _mm_loadu_ps(voices.panRight + v);
+    }
+
+    void loadFilter(const OscillatorKernel::Filter &filter, int v) {
+        s1 = _mm_loadu_ps(filter.s1 + v);
+        s2 = _mm_loadu_ps(filter.s2 + v);
+        g = _mm_loadu_ps(filter.g + v);
+        a1 = _mm_loadu_ps(filter.a1 + v);
+        a2 = _mm_loadu_ps(filter.a2 + v);
+        gStep = _mm_loadu_ps(filter.gStep + v);
+        a1Step = _mm_loadu_ps(filter.a1Step + v);
+        a2Step = _mm_loadu_ps(filter.a2Step + v);
+    }
+
+    void loadModulation(const OscillatorKernel::Modulation &modulation, int v) {
+        incrementStep =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(modulation.incrementStep + v));
+        gain = _mm_loadu_ps(modulation.gain + v);
+        gainStep = _mm_loadu_ps(modulation.gainStep + v);
+    }
+
+    void store(const OscillatorKernel::Voices &voices, int v) const {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(voices.phase + v), phase);
+        _mm_storeu_ps(voices.envLevel + v, level);
+    }
+
+    void storeModulation(const OscillatorKernel::Voices &voices, int v) const {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(voices.phaseIncrement + v), increment);
+        _mm_storeu_ps(voices.modulation.gain + v, gain);
+    }
+
+    void storeFilter(const OscillatorKernel::Filter &filter, int v) const {
+        _mm_storeu_ps(filter.s1 + v, s1);
+        _mm_storeu_ps(filter.s2 + v, s2);
+        _mm_storeu_ps(filter.g + v, g);
+        _mm_storeu_ps(filter.a1 + v, a1);
+        _mm_storeu_ps(filter.a2 + v, a2);
+    }
+
+    // One low-pass step per lane, in the same order as the scalar kernel
+    __m128 filterStep(__m128 x) {
+        __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, s1), _mm_mul_ps(a2, _mm_sub_ps(x, s2)));
+        __m128 v2 = _mm_add_ps(s2, _mm_mul_ps(g, v1));
+        s1 = _mm_sub_ps(_mm_add_ps(v1, v1), s1);
+        s2 = _mm_sub_ps(_mm_add_ps(v2, v2), s2);
+        g = _mm_add_ps(g, gStep);
+        a1 = _mm_add_ps(a1, a1Step);
+        a2 = _mm_add_ps(a2, a2Step);
+        return v2;
+    }
+
+    // One sample for four voices, already scaled by the envelope
+    template <bool FILTERED, bool MODULATED>
+    __m128 next(const float *pairs) {
+        alignas(16) uint32_t idx[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(idx),
+                        _mm_add_epi32(_mm_srli_epi32(phase, OscillatorKernel::FRAC_BITS), offset));
+        // The fraction is < 2^FRAC_BITS, so the signed conversion is exact
+        __m128 frac = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_and_si128(phase, _mm_set1_epi32(OscillatorKernel::FRAC_MASK))),
+            _mm_set1_ps(FRAC_SCALE));
+        __m128 p01 = _mm_loadh_pi(
+            _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pairs + 2 * idx[0]))),
+            reinterpret_cast<const __m64 *>(pairs + 2 * idx[1]));
+        __m128 p23 = _mm_loadh_pi(
+            _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pairs + 2 * idx[2]))),
+            reinterpret_cast<const __m64 *>(pairs + 2 * idx[3]));
+        __m128 value = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 delta = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 y = _mm_add_ps(value, _mm_mul_ps(delta, frac));
+        if (FILTERED) {
+            y = filterStep(y);
+        }
+        y = _mm_mul_ps(y, level);
+        if (MODULATED) {
+            y = _mm_mul_ps(y, gain);
+        }
+
+        level = _mm_add_ps(_mm_mul_ps(level, mul), add);
+        phase = _mm_add_epi32(phase, increment);
+        if (MODULATED) {
+            increment = _mm_add_epi32(increment, incrementStep);
+            gain = _mm_add_ps(gain, gainStep);
+        }
+        return y;
+    }
+};
+
+template <int CHANNELS, bool FILTERED, bool MODULATED>
+void renderSse2Voices(const float *pairs, const OscillatorKernel::Voices &voices,
+                      float gain, float *output, int32_t numFrames) {
+    const __m128 gains = _mm_set1_ps(gain);
+    int v = 0;
+    for (; v + 8 <= voices.count; v += 8) {
+        Sse2Group a(voices, v);
+        Sse2Group b(voices, v + 4);
+        if (FILTERED) {
+            a.loadFilter(voices.filter, v);
+            b.loadFilter(voices.filter, v + 4);
+        }
+        if (MODULATED) {
+            a.loadModulation(voices.modulation, v);
+            b.loadModulation(voices.modulation, v + 4);
+        }
+        if (CHANNELS == 2) {
+            a.loadPan(voices, v);
+            b.loadPan(voices, v + 4);
+            for (int32_t i = 0; i < numFrames; i++) {
+                __m128 ya = a.next<FILTERED, MODULATED>(pairs);
+                __m128 yb = b.next<FILTERED, MODULATED>(pairs);
+                accumulateStereo(output + 2 * i,
+                                 _mm_add_ps(_mm_mul_ps(ya, a.panLeft), _mm_mul_ps(yb, b.panLeft)),
+                                 _mm_add_ps(_mm_mul_ps(ya, a.panRight), _mm_mul_ps(yb, b.panRight)),
+                                 gains);
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                __m128 ya = a.next<FILTERED, MODULATED>(pairs);
+                __m128 yb = b.next<FILTERED, MODULATED>(pairs);
+                output[i] += horizontalSum(_mm_add_ps(ya, yb)) * gain;
+            }
+        }
+        a.store(voices, v);
+        b.store(voices, v + 4);
+        if (FILTERED) {
+            a.storeFilter(voices.filter, v);
+            b.storeFilter(voices.filter, v + 4);
+        }
+        if (MODULATED) {
+            a.storeModulation(voices, v);
+            b.storeModulation(voices, v + 4);
+        }
+    }
+    if (v + 4 <= voices.count) {
+        Sse2Group a(voices, v);
+        if (FILTERED) {
+            a.loadFilter(voices.filter, v);
+        }
+        if (MODULATED) {
+            a.loadModulation(voices.modulation, v);
+        }
+        if (CHANNELS == 2) {
+            a.loadPan(voices, v);
+            for (int32_t i = 0; i < numFrames; i++) {
+                __m128 y = a.next<FILTERED, MODULATED>(pairs);
+                accumulateStereo(output + 2 * i, _mm_mul_ps(y, a.panLeft),
+                                 _mm_mul_ps(y, a.panRight), gains);
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                output[i] += horizontalSum(a.next<FILTERED, MODULATED>(pairs)) * gain;
+            }
+        }
+        a.store(voices, v);
+        if (FILTERED) {
+            a.storeFilter(voices.filter, v);
+        }
+        if (MODULATED) {
+            a.storeModulation(voices, v);
+        }
+        v += 4;
+    }
+    renderScalarVoices<CHANNELS, FILTERED, MODULATED>(pairs, offsetVoices(voices, v), gain, output,
+                                                       numFrames);
+}
+
+template <int CHANNELS>
+void renderSse2(const float *pairs, const OscillatorKernel::Voices &voices,
+                float gain, float *output, int32_t numFrames) {
+    const bool filtered = voices.filter.s1 != nullptr;
+    if (voices.modulation.gain != nullptr) {
+        if (filtered) {
+            renderSse2Voices<CHANNELS, true, true>(pairs, voices, gain, output, numFrames);
+        } else {
+            renderSse2Voices<CHANNELS, false, true>(pairs, voices, gain, output, numFrames);
+        }
+    } else if (filtered) {
+        renderSse2Voices<CHANNELS, true, false>(pairs, voices, gain, output, numFrames);
+    } else {
+        renderSse2Voices<CHANNELS, false, false>(pairs, voices, gain, output, numFrames);
+    }
+}
+#endif
+
+#if OSC_HAVE_AVX2
+#define OSC_AVX2 __attribute__((target("avx2")))
+
+struct Avx2Group {
+    __m256i phase;
+    __m256i increment;
+    __m256i offset;
+    __m256 level;
+    __m256 mul;
+    __m256 add;
+    __m256 panLeft;
+    __m256 panRight;
+    __m256 s1, s2, g, a1, a2;
+    __m256 gStep, a1Step, a2Step;
+    __m256i incrementStep;
+    __m256 gain, gainStep;
+
+    OSC_AVX2 Avx2Group(const OscillatorKernel::Voices &voices, int v)
+        : phase(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(voices.phase + v))),
+          increment(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(voices.phaseIncrement + v))),
+          offset(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(voices.tableOffset + v))),
+          level(_mm256_loadu_ps(voices.envLevel + v)),
+          mul(_mm256_loadu_ps(voices.envMul + v)),
+          add(_mm256_loadu_ps(voices.envAdd + v)) {}
+
+    OSC_AVX2 void loadPan(const OscillatorKernel::Voices &voices, int v) {
+        panLeft = _mm256_loadu_ps(voices.panLeft + v);
+        panRight = _mm256_loadu_ps(voices.panRight + v);
+    }
+
+    OSC_AVX2 void loadFilter(const OscillatorKernel::Filter &filter, int v) {
+        s1 = _mm256_loadu_ps(filter.s1 + v);
+        s2 = _mm256_loadu_ps(filter.s2 + v);
+        g = _mm256_loadu_ps(filter.g + v);
+        a1 = _mm256_loadu_ps(filter.a1 + v);
+        a2 = _mm256_loadu_ps(filter.a2 + v);
+        gStep = _mm256_loadu_ps(filter.gStep + v);
+        a1Step = _mm256_loadu_ps(filter.a1Step + v);
+        a2Step = _mm256_loadu_ps(filter.a2Step + v);
+    }
+
+    OSC_AVX2 void loadModulation(const OscillatorKernel::Modulation &modulation, int v) {
+        incrementStep =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(modulation.incrementStep + v));
+        gain = _mm256_loadu_ps(modulation.gain + v);
+        gainStep = _mm256_loadu_ps(modulation.gainStep + v);
+    }
+
+    OSC_AVX2 void store(const OscillatorKernel::Voices &voices, int v) const {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(voices.phase + v), phase);
+        _mm256_storeu_ps(voices.envLevel + v, level);
+    }
+
+    OSC_AVX2 void storeModulation(const OscillatorKernel::Voices &voices, int v) const {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(voices.phaseIncrement + v), increment);
+        _mm256_storeu_ps(voices.modulation.gain + v, gain);
+    }
+
+    OSC_AVX2 void storeFilter(const OscillatorKernel::Filter &filter, int v) const {
+        _mm256_storeu_ps(filter.s1 + v, s1);
+        _mm256_storeu_ps(filter.s2 + v, s2);
+        _mm256_storeu_ps(filter.g + v, g);
+        _mm256_storeu_ps(filter.a1 + v, a1);
+        _mm256_storeu_ps(filter.a2 + v, a2);
+    }
+
+    // Unfused like the scalar kernel, so every ISA filters bit-identically
+    OSC_AVX2 __m256 filterStep(__m256 x) {
+        __m256 v1 = _mm256_add_ps(_mm256_mul_ps(a1, s1), _mm256_mul_ps(a2, _mm256_sub_ps(x, s2)));
+        __m256 v2 = _mm256_add_ps(s2, _mm256_mul_ps(g, v1));
+        s1 = _mm256_sub_ps(_mm256_add_ps(v1, v1), s1);
+        s2 = _mm256_sub_ps(_mm256_add_ps(v2, v2), s2);
+        g = _mm256_add_ps(g, gStep);
+        a1 = _mm256_add_ps(a1, a1Step);
+        a2 = _mm256_add_ps(a2, a2Step);
+        return v2;
+    }
+
+    template <bool FILTERED, bool MODULATED>
+    OSC_AVX2 __m256 next(const float *pairs) {
+        __m256i idx = _mm256_add_epi32(_mm256_srli_epi32(phase, OscillatorKernel::FRAC_BITS), offset);
+        __m256 frac = _mm256_mul_ps(
+            _mm256_cvtepi32_ps(_mm256_and_si256(phase, _mm256_set1_epi32(OscillatorKernel::FRAC_MASK))),
+            _mm256_set1_ps(FRAC_SCALE));
+        // Scale 8 steps over whole {value, delta} pairs
+        __m256 value = _mm256_i32gather_ps(pairs, idx, 8);
+        __m256 delta = _mm256_i32gather_ps(pairs + 1, idx, 8);
+        __m256 y = _mm256_add_ps(value, _mm256_mul_ps(delta, frac));
+        if (FILTERED) {
+            y = filterStep(y);
+        }
+        y = _mm256_mul_ps(y, level);
+        if (MODULATED) {
+            y = _mm256_mul_ps(y, gain);
+        }
+
+        level = _mm256_add_ps(_mm256_mul_ps(level, mul), add);
+        phase = _mm256_add_epi32(phase, increment);
+        if (MODULATED) {
+            increment = _mm256_add_epi32(increment, incrementStep);
+            gain = _mm256_add_ps(gain, gainStep);
+        }
+        return y;
+    }
+};
+
+OSC_AVX2 inline float horizontalSum(__m256 x) {
+    return horizontalSum(_mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1)));
+}
+
+OSC_AVX2 inline __m128 foldLanes(__m256 x) {
+    return _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+}
+
+template <int CHANNELS, bool FILTERED, bool MODULATED>
+OSC_AVX2 void renderAvx2Voices(const float *pairs, const OscillatorKernel::Voices &voices,
+                               float gain, float *output, int32_t numFrames) {
+    const __m128 gains = _mm_set1_ps(gain);
+    int v = 0;
+    for (; v + 16 <= voices.count; v += 16) {
+        Avx2Group a(voices, v);
+        Avx2Group b(voices, v + 8);
+        if (FILTERED) {
+            a.loadFilter(voices.filter, v);
+            b.loadFilter(voices.filter, v + 8);
+        }
+        if (MODULATED) {
+            a.loadModulation(voices.modulation, v);
+            b.loadModulation(voices.modulation, v + 8);
+        }
+        if (CHANNELS == 2) {
+            a.loadPan(voices, v);
+            b.loadPan(voices, v + 8);
+            for (int32_t i = 0; i < numFrames; i++) {
+                __m256 ya = a.next<FILTERED, MODULATED>(pairs);
+                __m256 yb = b.next<FILTERED, MODULATED>(pairs);
+                __m256 left = _mm256_add_ps(_mm256_mul_ps(ya, a.panLeft), _mm256_mul_ps(yb, b.panLeft));
+                __m256 right = _mm256_add_ps(_mm256_mul_ps(ya, a.panRight), _mm256_mul_ps(yb, b.panRight));
+                accumulateStereo(output + 2 * i, foldLanes(left), foldLanes(right), gains);
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                __m256 ya = a.next<FILTERED, MODULATED>(pairs);
+                __m256 yb = b.next<FILTERED, MODULATED>(pairs);
+                output[i] += horizontalSum(_mm256_add_ps(ya, yb)) * gain;
+            }
+        }
+        a.store(voices, v);
+        b.store(voices, v + 8);
+        if (FILTERED) {
+            a.storeFilter(voices.filter, v);
+            b.storeFilter(voices.filter, v + 8);
+        }
+        if (MODULATED) {
+            a.storeModulation(voices, v);
+            b.storeModulation(voices, v + 8);
+        }
+    }
+    if (v + 8 <= voices.count) {
+        Avx2Group a(voices, v);
+        if (FILTERED) {
+            a.loadFilter(voices.filter, v);
+        }
+        if (MODULATED) {
+            a.loadModulation(voices.modulation, v);
+        }
+        if (CHANNELS == 2) {
+            a.loadPan(voices, v);
+            for (int32_t i = 0; i < numFrames; i++) {
+                __m256 y = a.next<FILTERED, MODULATED>(pairs);
+                accumulateStereo(output + 2 * i, foldLanes(_mm256_mul_ps(y, a.panLeft)),
+                                 foldLanes(_mm256_mul_ps(y, a.panRight)), gains);
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                output[i] += horizontalSum(a.next<FILTERED, MODULATED>(pairs)) * gain;
+            }
+        }
+        a.store(voices, v);
+        if (FILTERED) {
+            a.storeFilter(voices.filter, v);
+        }
+        if (MODULATED) {
+            a.storeModulation(voices, v);
+        }
+        v += 8;
+    }
+    renderSse2Voices<CHANNELS, FILTERED, MODULATED>(pairs, offsetVoices(voices, v), gain, output,
+                                                     numFrames);
+}
+
+template <int CHANNELS>
+OSC_AVX2 void renderAvx2(const float *pairs, const OscillatorKernel::Voices &voices,
+                         float gain, float *output, int32_t numFrames) {
+    const bool filtered = voices.filter.s1 != nullptr;
+    if (voices.modulation.gain != nullptr) {
+        if (filtered) {
+            renderAvx2Voices<CHANNELS, true, true>(pairs, voices, gain, output, numFrames);
+        } else {
+            renderAvx2Voices<CHANNELS, false, true>(pairs, voices, gain, output, numFrames);
+        }
+    } else if (filtered) {
+        renderAvx2Voices<CHANNELS, true, false>(pairs, voices, gain, output, numFrames);
+    } else {
+        renderAvx2Voices<CHANNELS, false, false>(pairs, voices, gain, output, numFrames);
+    }
+}
+#endif
+
+#if OSC_HAVE_NEON
+inline float horizontalSum(float32x4_t x) {
+#if defined(__aarch64__)
+    return vaddvq_f32(x);
+#else
+    float32x2_t pair = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+}
+
+// Adds {sum(left), sum(right)} * gain to one interleaved stereo frame
+inline void accumulateStereo(float *frame, float32x4_t left, float32x4_t right, float gain) {
+    float32x4x2_t zipped = vzipq_f32(left, right); // {l0 r0 l1 r1}, {l2 r2 l3 r3}
+    float32x4_t sums = vaddq_f32(zipped.val[0], zipped.val[1]);
+    float32x2_t lr = vadd_f32(vget_low_f32(sums), vget_high_f32(sums));
+    vst1_f32(frame, vmla_n_f32(vld1_f32(frame), lr, gain));
+}
+
+struct NeonGroup {
+    uint32x4_t phase;
+    uint32x4_t increment;
+    uint32x4_t offset;
+    float32x4_t level;
+    float32x4_t mul;
+    float32x4_t add;
+    float32x4_t panLeft;
+    float32x4_t panRight;
+    float32x4_t s1, s2, g, a1, a2;
+    float32x4_t gStep, a1Step, a2Step;
+    uint32x4_t incrementStep;
+    float32x4_t gain, gainStep;
+
+    NeonGroup(const OscillatorKernel::Voices &voices, int v)
+        : phase(vld1q_u32(voices.phase + v)),
+          increment(vld1q_u32(voices.phaseIncrement + v)),
+          offset(vld1q_u32(voices.tableOffset + v)),
+          level(vld1q_f32(voices.envLevel + v)),
+          mul(vld1q_f32(voices.envMul + v)),
+          add(vld1q_f32(voices.envAdd + v)) {}
+
+    void loadPan(const OscillatorKernel::Voices &voices, int v) {
+        panLeft = vld1q_f32(voices.panLeft + v);
+        panRight = vld1q_f32(voices.panRight + v);
+    }
+
+    void loadFilter(const OscillatorKernel::Filter &filter, int v) {
+        s1 = vld1q_f32(filter.s1 + v);
+        s2 = vld1q_f32(filter.s2 + v);
+        g = vld1q_f32(filter.g + v);
+        a1 = vld1q_f32(filter.a1 + v);
+        a2 = vld1q_f32(filter.a2 + v);
+        gStep = vld1q_f32(filter.gStep + v);
+        a1Step = vld1q_f32(filter.a1Step + v);
+        a2Step = vld1q_f32(filter.a2Step + v);
+    }
+
+    void loadModulation(const OscillatorKernel::Modulation &modulation, int v) {
+        incrementStep = vreinterpretq_u32_s32(vld1q_s32(modulation.incrementStep + v));
+        gain = vld1q_f32(modulation.gain + v);
+        gainStep = vld1q_f32(modulation.gainStep + v);
+    }
+
+    void store(const OscillatorKernel::Voices &voices, int v) const {
+        vst1q_u32(voices.phase + v, phase);
+        vst1q_f32(voices.envLevel + v, level);
+    }
+
+    void storeModulation(const OscillatorKernel::Voices &voices, int v) const {
+        vst1q_u32(voices.phaseIncrement + v, increment);
+        vst1q_f32(voices.modulation.gain + v, gain);
+    }
+
+    void storeFilter(const OscillatorKernel::Filter &filter, int v) const {
+        vst1q_f32(filter.s1 + v, s1);
+        vst1q_f32(filter.s2 + v, s2);
+        vst1q_f32(filter.g + v, g);
+        vst1q_f32(filter.a1 + v, a1);
+        vst1q_f32(filter.a2 + v, a2);
+    }
+
+    float32x4_t filterStep(float32x4_t x) {
+        float32x4_t v1 = vmlaq_f32(vmulq_f32(a1, s1), a2, vsubq_f32(x, s2));
+        float32x4_t v2 = vmlaq_f32(s2, g, v1);
+        s1 = vsubq_f32(vaddq_f32(v1, v1), s1);
+        s2 = vsubq_f32(vaddq_f32(v2, v2), s2);
+        g = vaddq_f32(g, gStep);
+        a1 = vaddq_f32(a1, a1Step);
+        a2 = vaddq_f32(a2, a2Step);
+        return v2;
+    }
+
+    template <bool FILTERED, bool MODULATED>
+    float32x4_t next(const float *pairs) {
+        alignas(16) uint32_t idx[4];
+        vst1q_u32(idx, vaddq_u32(vshrq_n_u32(phase, OscillatorKernel::FRAC_BITS), offset));
+        float32x4_t frac = vmulq_n_f32(
+            vcvtq_f32_u32(vandq_u32(phase, vdupq_n_u32(OscillatorKernel::FRAC_MASK))),
+            FRAC_SCALE);
+        float32x4_t p01 = vcombine_f32(vld1_f32(pairs + 2 * idx[0]), vld1_f32(pairs + 2 * idx[1]));
+        float32x4_t p23 = vcombine_f32(vld1_f32(pairs + 2 * idx[2]), vld1_f32(pairs + 2 * idx[3]));
+        float32x4x2_t split = vuzpq_f32(p01, p23); // {values, deltas}
+        float32x4_t y = vmlaq_f32(split.val[0], split.val[1], frac);
+        if (FILTERED) {
+            y = filterStep(y);
+        }
+        y = vmulq_f32(y, level);
+        if (MODULATED) {
+            y = vmulq_f32(y, gain);
+        }
+
+        level = vmlaq_f32(add, level, mul);
+        phase = vaddq_u32(phase, increment);
+        if (MODULATED) {
+            increment = vaddq_u32(increment, incrementStep);
+            gain = vaddq_f32(gain, gainStep);
+        }
+        return y;
+    }
+};
+
+template <int CHANNELS, bool FILTERED, bool MODULATED>
+void renderNeonVoices(const float *pairs, const OscillatorKernel::Voices &voices,
+                      float gain, float *output, int32_t numFrames) {
+    int v = 0;
+    for (; v + 8 <= voices.count; v += 8) {
+        NeonGroup a(voices, v);
+        NeonGroup b(voices, v + 4);
+        if (FILTERED) {
+            a.loadFilter(voices.filter, v);
+            b.loadFilter(voices.filter, v + 4);
+        }
+        if (MODULATED) {
+            a.loadModulation(voices.modulation, v);
+            b.loadModulation(voices.modulation, v + 4);
+        }
+        if (CHANNELS == 2) {
+            a.loadPan(voices, v);
+            b.loadPan(voices, v + 4);
+            for (int32_t i = 0; i < numFrames; i++) {
+                float32x4_t ya = a.next<FILTERED, MODULATED>(pairs);
+                float32x4_t yb = b.next<FILTERED, MODULATED>(pairs);
+                accumulateStereo(output + 2 * i,
+                                 vmlaq_f32(vmulq_f32(ya, a.panLeft), yb, b.panLeft),
+                                 vmlaq_f32(vmulq_f32(ya, a.panRight), yb, b.panRight),
+                                 gain);
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                float32x4_t ya = a.next<FILTERED, MODULATED>(pairs);
+                float32x4_t yb = b.next<FILTERED, MODULATED>(pairs);
+                output[i] += horizontalSum(vaddq_f32(ya, yb)) * gain;
+            }
+        }
+        a.store(voices, v);
+        b.store(voices, v + 4);
+        if (FILTERED) {
+            a.storeFilter(voices.filter, v);
+            b.storeFilter(voices.filter, v + 4);
+        }
+        if (MODULATED) {
+            a.storeModulation(voices, v);
+            b.storeModulation(voices, v + 4);
+        }
+    }
+    if (v + 4 <= voices.count) {
+        NeonGroup a(voices, v);
+        if (FILTERED) {
+            a.loadFilter(voices.filter, v);
+        }
+        if (MODULATED) {
+            a.loadModulation(voices.modulation, v);
+        }
+        if (CHANNELS == 2) {
+            a.loadPan(voices, v);
+            for (int32_t i = 0; i < numFrames; i++) {
+                float32x4_t y = a.next<FILTERED, MODULATED>(pairs);
+                accumulateStereo(output + 2 * i, vmulq_f32(y, a.panLeft),
+                                 vmulq_f32(y, a.panRight), gain);
+            }
+        } else {
+            for (int32_t i = 0; i < numFrames; i++) {
+                output[i] += horizontalSum(a.next<FILTERED, MODULATED>(pairs)) * gain;
+            }
+        }
+        a.store(voices, v);
+        if (FILTERED) {
+            a.storeFilter(voices.filter, v);
+        }
+        if (MODULATED) {
+            a.storeModulation(voices, v);
+        }
+        v += 4;
+    }
+    renderScalarVoices<CHANNELS, FILTERED, MODULATED>(pairs, offsetVoices(voices, v), gain, output,
+                                                       numFrames);
+}
+
+template <int CHANNELS>
+void renderNeon(const float *pairs, const OscillatorKernel::Voices &voices,
+                float gain, float *output, int32_t numFrames) {
+    const bool filtered = voices.filter.s1 != nullptr;
+    if (voices.modulation.gain != nullptr) {
+        if (filtered) {
+            renderNeonVoices<CHANNELS, true, true>(pairs, voices, gain, output, numFrames);
+        } else {
+            renderNeonVoices<CHANNELS, false, true>(pairs, voices, gain, output, numFrames);
+        }
+    } else if (filtered) {
+        renderNeonVoices<CHANNELS, true, false>(pairs, voices, gain, output, numFrames);
+    } else {
+        renderNeonVoices<CHANNELS, false, false>(pairs, voices, gain, output, numFrames);
+    }
+}
+#endif
+
+struct Kernel {
+    RenderFn render;
+    RenderFn renderStereo;
+    const char *name;
+};
+
+Kernel selectKernel() {
+#if OSC_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return {renderAvx2<1>, renderAvx2<2>, "avx2"};
+    }
+#endif
+#if OSC_HAVE_SSE2
+    return {renderSse2<1>, renderSse2<2>, "sse2"};
+#elif OSC_HAVE_NEON
+    return {renderNeon<1>, renderNeon<2>, "neon"};
+#else
+    return {renderScalarKernel<1>, renderScalarKernel<2>, "scalar"};
+#endif
+}
+
+// Resolved at load time so the audio thread never hits a static-init guard
+const Kernel kKernel = selectKernel();
+
+} // namespace
+
+void OscillatorKernel::render(const float *pairs, const Voices &voices, float gain,
+                              float *output, int32_t numFrames) {
+    kKernel.render(pairs, voices, gain, output, numFrames);
+}
+
+void OscillatorKernel::renderScalar(const float *pairs, const Voices &voices,
+                                    float gain, float *output, int32_t numFrames) {
+    renderScalarKernel<1>(pairs, voices, gain, output, numFrames);
+}
+
+void OscillatorKernel::renderStereo(const float *pairs, const Voices &voices, float gain,
+                                    float *output, int32_t numFrames) {
+    kKernel.renderStereo(pairs, voices, gain, output, numFrames);
+}
+
+void OscillatorKernel::renderStereoScalar(const float *pairs, const Voices &voices,
+                                          float gain, float *output, int32_t numFrames) {
+    renderScalarKernel<2>(pairs, voices, gain, output, numFrames);
+}
+
+const char *OscillatorKernel::name() {
+    return kKernel.name;
+}
@@ -0,0 +1,133 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Multi-voice wavetable oscillator kernels (NEON / SSE2 / AVX2 / scalar)
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/*
+ * Renders a run of voices into a mono or interleaved stereo buffer, several
+ * voices per SIMD lane group. Each voice has a 32-bit fixed-point phase accumulator: the top
+ * TABLE_BITS select a table entry and the rest interpolate linearly.
+ *
+ * Kernels read a "pair table" holding {value, next - value} per entry, so one
+ * 64-bit load per lane fetches both interpolation points. Build it from a
+ * plain table with buildPairTable(). Several tables may be stored back to
+ * back; each voice picks one with tableOffset (in entries, not floats).
+ *
+ * Within one call every voice's envelope follows a single affine segment
+ * (level = level * mul + add per sample), so callers split buffers at
+ * envelope stage boundaries.
+ *
+ * Stereo kernels weight each voice by its own left/right gains and reduce the
+ * lanes straight into the interleaved frame, so no mono-to-stereo pass is
+ * needed afterwards.
+ *
+ * Voices may also run through a resonant low-pass each (a TPT state-variable
+ * filter, see VoiceFilter) between the table read and the envelope. Its
+ * state sits in the same lanes as the voice, and its coefficients ramp
+ * linearly by a per-voice step every sample, so the caller only works them
+ * out at control rate. Modulated voices ramp their phase increment (glide,
+ * vibrato, pitch bend) and an extra output gain the same way.
+ */
+class OscillatorKernel {
+public:
+  static constexpr int TABLE_BITS = 12;
+  static constexpr int TABLE_SIZE = 1 << TABLE_BITS;
+  static constexpr int FRAC_BITS = 32 - TABLE_BITS;
+  static constexpr uint32_t FRAC_MASK = (1u << FRAC_BITS) - 1;
+
+  // Per-voice filter lanes: state s1/s2, coefficients g/a1/a2 and their
+  // per-sample steps. State and coefficients are written back.
+  struct Filter {
+    float *s1 = nullptr;
+    float *s2 = nullptr;
+    float *g = nullptr;
+    float *a1 = nullptr;
+    float *a2 = nullptr;
+    const float *gStep = nullptr;
+    const float *a1Step = nullptr;
+    const float *a2Step = nullptr;
+
+    Filter offset(int first) const {
+      return s1 == nullptr ? Filter{}
+                           : Filter{s1 + first,     s2 + first,     g + first,
+                                    a1 + first,     a2 + first,     gStep + first,
+                                    a1Step + first, a2Step + first};
+    }
+  };
+
+  // Per-voice modulation lanes: each phase increment ramps by its step and
+  // each output gain by its own every sample. Increments and gains are
+  // written back.
+  struct Modulation {
+    const int32_t *incrementStep = nullptr;
+    float *gain = nullptr;
+    const float *gainStep = nullptr;
+
+    Modulation offset(int first) const {
+      return gain == nullptr ? Modulation{}
+                             : Modulation{incrementStep + first, gain + first, gainStep + first};
+    }
+  };
+
+  struct Voices {
+    uint32_t *phase;
+    // Only written when modulated
+    uint32_t *phaseIncrement;
+    const uint32_t *tableOffset;
+    float *envLevel;
+    const float *envMul;
+    const float *envAdd;
+    int count;
+    // Per-voice channel gains; only read by the stereo kernels
+    const float *panLeft = nullptr;
+    const float *panRight = nullptr;
+    // Unfiltered while filter.s1 is null
+    Filter filter = {};
+    // Fixed pitch and unit gain while modulation.gain is null
+    Modulation modulation = {};
+  };
+
+  static constexpr int PAIR_TABLE_FLOATS = 2 * TABLE_SIZE;
+
+  // `table` holds TABLE_SIZE entries of one cycle; wraps around at the end
+  static void buildPairTable(const float *table, float *pairs) {
+    for (int i = 0; i < TABLE_SIZE; i++) {
+      pairs[2 * i] = table[i];
+      pairs[2 * i + 1] = table[(i + 1) & (TABLE_SIZE - 1)] - table[i];
+    }
+  }
+
+  // Constant-power pan law: pan -1 is hard left, 0 centre (-3 dB), +1 right
+  static void panGains(float pan, float &left, float &right) {
+    const float theta = (pan + 1.0f) * 0.78539816f; // pi / 4
+    left = std::cos(theta);
+    right = std::sin(theta);
+  }
+
+  static uint32_t phaseIncrementFor(double frequency, double sampleRate) {
+    return static_cast<uint32_t>(frequency / sampleRate * 4294967296.0);
+  }
+
+  // Best kernel for this CPU, chosen once at load time
+  static void render(const float *pairs, const Voices &voices, float gain,
+                     float *output, int32_t numFrames);
+
+  // Portable reference implementation
+  static void renderScalar(const float *pairs, const Voices &voices,
+                           float gain, float *output, int32_t numFrames);
+
+  // Interleaved stereo variants; `output` holds 2 * numFrames floats
+  static void renderStereo(const float *pairs, const Voices &voices, float gain,
+                           float *output, int32_t numFrames);
+  static void renderStereoScalar(const float *pairs, const Voices &voices,
+                                 float gain, float *output, int32_t numFrames);
+
+  static const char *name();
+};
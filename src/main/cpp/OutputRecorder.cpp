@@ -0,0 +1,152 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Records the engine output to a WAV file without blocking the callback
+ */
+
+#include "OutputRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// How long the writer naps when less than a block is queued. At 48 kHz a
+// block is ~170 ms, so the FIFO never gets near full between naps.
+constexpr auto WRITER_IDLE = std::chrono::milliseconds(10);
+
+} // namespace
+
+OutputRecorder::~OutputRecorder() {
+    finish();
+}
+
+bool OutputRecorder::start(const std::string &path, int32_t sampleRate, int channelCount,
+                           WavWriter::Format format, int64_t first, int64_t last,
+                           int32_t fifoFrames) {
+    finish();
+    if (!wav.open(path.c_str(), sampleRate, channelCount, format)) {
+        return false;
+    }
+    if (fifoFrames <= 0) {
+        fifoFrames = static_cast<int32_t>(DEFAULT_FIFO_SECONDS * sampleRate);
+    }
+    channels = channelCount;
+    fifo = std::make_unique<oboe::FifoBuffer>(
+        static_cast<uint32_t>(channelCount * sizeof(float)), static_cast<uint32_t>(fifoFrames));
+    framesCaptured.store(0, std::memory_order_relaxed);
+    overrunFrames.store(0, std::memory_order_relaxed);
+    writeFailed.store(false, std::memory_order_relaxed);
+    startFrame.store(first, std::memory_order_relaxed);
+    stopFrame.store(last, std::memory_order_relaxed);
+
+    // The audio thread may look at the FIFO from here on
+    state.store(ARMED, std::memory_order_release);
+    writer = std::thread(&OutputRecorder::writerLoop, this);
+    return true;
+}
+
+void OutputRecorder::stopAt(int64_t frame) {
+    stopFrame.store(frame, std::memory_order_relaxed);
+}
+
+bool OutputRecorder::finish() {
+    if (!writer.joinable()) {
+        return true;
+    }
+    uint8_t expected = ARMED;
+    state.compare_exchange_strong(expected, DONE, std::memory_order_seq_cst);
+    // A capture() that saw ARMED finishes within one callback
+    while (capturing.load(std::memory_order_seq_cst)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    writer.join();
+    const bool ok = wav.close() && !writeFailed.load(std::memory_order_relaxed);
+    fifo.reset();
+    state.store(IDLE, std::memory_order_release);
+    return ok;
+}
+
+void OutputRecorder::waitForSpace(int32_t numFrames) {
+    // While recording the writer leaves up to a block queued, so wait for
+    // no more than the rest
+    const int64_t capacity = fifo ? fifo->getBufferCapacityInFrames() : 0;
+    const int64_t wanted = std::min<int64_t>(numFrames, capacity - WRITE_BLOCK_FRAMES);
+    while (isRecording() && capacity - fifo->getFullFramesAvailable() < wanted &&
+           !writeFailed.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+void OutputRecorder::capture(const float *output, int32_t numFrames, int64_t firstFrame) {
+    if (state.load(std::memory_order_relaxed) != ARMED) {
+        return;
+    }
+    // Pairs with finish(): either it sees us capturing and waits, or we see
+    // DONE and leave the FIFO alone
+    capturing.store(true, std::memory_order_seq_cst);
+    if (state.load(std::memory_order_seq_cst) == ARMED) {
+        const int64_t first = std::max(firstFrame, startFrame.load(std::memory_order_relaxed));
+        const int64_t last = std::min(firstFrame + numFrames,
+                                      stopFrame.load(std::memory_order_relaxed));
+        if (last > first) {
+            const int32_t count = static_cast<int32_t>(last - first);
+            const int32_t written = std::max(
+                0, fifo->write(output + (first - firstFrame) * channels, count));
+            framesCaptured.store(framesCaptured.load(std::memory_order_relaxed) + written,
+                                 std::memory_order_relaxed);
+            if (written < count) {
+                overrunFrames.store(overrunFrames.load(std::memory_order_relaxed) + count -
+                                        written,
+                                    std::memory_order_relaxed);
+            }
+        }
+        if (firstFrame + numFrames >= stopFrame.load(std::memory_order_relaxed)) {
+            state.store(DONE, std::memory_order_release);
+        }
+    }
+    capturing.store(false, std::memory_order_release);
+}
+
+int32_t OutputRecorder::drainBlock(float *block) {
+    const int32_t available = static_cast<int32_t>(
+        std::min<uint32_t>(fifo->getFullFramesAvailable(), WRITE_BLOCK_FRAMES));
+    if (available <= 0) {
+        return 0;
+    }
+    const int32_t frames = std::max(0, fifo->read(block, available));
+    if (frames > 0 && !wav.write(block, frames)) {
+        writeFailed.store(true, std::memory_order_relaxed);
+    }
+    return frames;
+}
+
+void OutputRecorder::writerLoop() {
+#if defined(__linux__)
+    // Per-thread on Linux and Android: keep the disk work out of the way
+    setpriority(PRIO_PROCESS, 0, 10);
+#endif
+    std::vector<float> block(static_cast<size_t>(WRITE_BLOCK_FRAMES) * channels);
+    for (;;) {
+        // Only whole blocks while recording, so each write is a large one
+        while (fifo->getFullFramesAvailable() >= static_cast<uint32_t>(WRITE_BLOCK_FRAMES)) {
+            drainBlock(block.data());
+        }
+        if (state.load(std::memory_order_seq_cst) == DONE &&
+            !capturing.load(std::memory_order_seq_cst)) {
+            // Nothing more can arrive: write out the rest
+            while (drainBlock(block.data()) > 0) {
+            }
+            return;
+        }
+        if (fifo->getFullFramesAvailable() < static_cast<uint32_t>(WRITE_BLOCK_FRAMES)) {
+            std::this_thread::sleep_for(WRITER_IDLE);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Records the engine output to a WAV file without blocking the callback
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "WavWriter.h"
+#include "oboe/FifoBuffer.h"
+
+/*
+ * The audio thread copies the frames of each rendered buffer that fall in
+ * the recording window [startFrame, stopFrame) into an oboe::FifoBuffer
+ * (single producer / single consumer, allocated by start()). A writer
+ * thread at background priority drains it in blocks of WRITE_BLOCK_FRAMES
+ * into a WavWriter, so the disk sees a few large writes per second and the
+ * callback never waits on I/O.
+ *
+ * If the writer falls behind and the FIFO fills, the frames that do not fit
+ * are dropped and counted in getOverrunFrames(); the callback never blocks.
+ * The window is in render frames (SynthCore::getFramePosition()), so a
+ * recording can punch in and out on exact frames, e.g. at sequencer bar
+ * lines.
+ *
+ * Threading: start/stopAt/finish from a control thread (one at a time);
+ * capture() from the audio thread only; getters from any thread.
+ */
+class OutputRecorder {
+public:
+  static constexpr int64_t FOREVER = INT64_MAX;
+  static constexpr int32_t WRITE_BLOCK_FRAMES = 8192;
+  // Default FIFO depth: covers the writer being descheduled for a while
+  static constexpr double DEFAULT_FIFO_SECONDS = 2.0;
+
+  OutputRecorder() = default;
+  ~OutputRecorder();
+
+  OutputRecorder(const OutputRecorder &) = delete;
+  OutputRecorder &operator=(const OutputRecorder &) = delete;
+
+  // Opens `path` and records frames [startFrame, stopFrame) of the output.
+  // Finishes any recording in progress first. Returns false if the file
+  // cannot be created.
+  bool start(const std::string &path, int32_t sampleRate, int channelCount,
+             WavWriter::Format format = WavWriter::Format::FLOAT32, int64_t startFrame = 0,
+             int64_t stopFrame = FOREVER, int32_t fifoFrames = 0);
+
+  // Moves the punch-out point (already passed: stop at the next buffer)
+  void stopAt(int64_t frame);
+
+  // Stops now if still recording, waits for the writer to drain and closes
+  // the file. Returns false if any write failed.
+  bool finish();
+
+  // Blocks until the FIFO has room for numFrames more frames; for offline
+  // renders that outrun real time. Never on an audio thread.
+  void waitForSpace(int32_t numFrames);
+
+  bool isRecording() const { return state.load(std::memory_order_acquire) == ARMED; }
+  // Frames captured into the file so far (including those still queued)
+  int64_t getFramesCaptured() const { return framesCaptured.load(std::memory_order_relaxed); }
+  // Frames dropped because the FIFO was full
+  int64_t getOverrunFrames() const { return overrunFrames.load(std::memory_order_relaxed); }
+
+  // Audio thread: `output` holds numFrames frames starting at render frame
+  // `firstFrame`, with the channel count passed to start()
+  void capture(const float *output, int32_t numFrames, int64_t firstFrame);
+
+private:
+  enum State : uint8_t { IDLE, ARMED, DONE };
+
+  std::atomic<uint8_t> state{IDLE};
+  // Set while capture() may touch the FIFO
+  std::atomic<bool> capturing{false};
+  std::atomic<int64_t> startFrame{0};
+  std::atomic<int64_t> stopFrame{FOREVER};
+  std::atomic<int64_t> framesCaptured{0};
+  std::atomic<int64_t> overrunFrames{0};
+
+  int channels = 1;
+  std::unique_ptr<oboe::FifoBuffer> fifo;
+  WavWriter wav;
+  std::atomic<bool> writeFailed{false};
+  std::thread writer;
+
+  void writerLoop();
+  // Writer thread: moves up to one block from the FIFO to the file; returns
+  // the number of frames moved
+  int32_t drainBlock(float *block);
+};
@@ -0,0 +1,112 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Radix-2 FFT of real signals for block convolution
+ */
+
+#include "RealFft.h"
+
+#include <cmath>
+
+RealFft::RealFft(int requested) : size(4) {
+    while (size < requested) {
+        size <<= 1;
+    }
+    half = size / 2;
+
+    twiddleRe.resize(half / 2);
+    twiddleIm.resize(half / 2);
+    for (int k = 0; k < half / 2; k++) {
+        const double angle = -2.0 * M_PI * k / half;
+        twiddleRe[k] = static_cast<float>(std::cos(angle));
+        twiddleIm[k] = static_cast<float>(std::sin(angle));
+    }
+    splitRe.resize(half + 1);
+    splitIm.resize(half + 1);
+    for (int k = 0; k <= half; k++) {
+        const double angle = -2.0 * M_PI * k / size;
+        splitRe[k] = static_cast<float>(std::cos(angle));
+        splitIm[k] = static_cast<float>(std::sin(angle));
+    }
+
+    int bits = 0;
+    while ((1 << bits) < half) {
+        bits++;
+    }
+    bitReverse.resize(half);
+    for (int i = 0; i < half; i++) {
+        uint32_t reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((static_cast<uint32_t>(i) >> b) & 1u) << (bits - 1 - b);
+        }
+        bitReverse[i] = reversed;
+    }
+    workRe.resize(half);
+    workIm.resize(half);
+}
+
+void RealFft::transform(float *re, float *im) const {
+    for (int length = 2; length <= half; length <<= 1) {
+        const int span = length / 2;
+        const int stride = half / length;
+        for (int start = 0; start < half; start += length) {
+            float *aRe = re + start;
+            float *aIm = im + start;
+            float *bRe = aRe + span;
+            float *bIm = aIm + span;
+            for (int k = 0; k < span; k++) {
+                const float wRe = twiddleRe[k * stride];
+                const float wIm = twiddleIm[k * stride];
+                const float vRe = bRe[k] * wRe - bIm[k] * wIm;
+                const float vIm = bRe[k] * wIm + bIm[k] * wRe;
+                bRe[k] = aRe[k] - vRe;
+                bIm[k] = aIm[k] - vIm;
+                aRe[k] += vRe;
+                aIm[k] += vIm;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float *in, float *re, float *im) {
+    // Even samples as the real part, odd ones as the imaginary part
+    for (int n = 0; n < half; n++) {
+        workRe[bitReverse[n]] = in[2 * n];
+        workIm[bitReverse[n]] = in[2 * n + 1];
+    }
+    transform(workRe.data(), workIm.data());
+
+    // Untangle the two half-size spectra and join them
+    for (int k = 0; k <= half; k++) {
+        const int a = k == half ? 0 : k;
+        const int b = k == 0 ? 0 : half - k;
+        const float evenRe = 0.5f * (workRe[a] + workRe[b]);
+        const float evenIm = 0.5f * (workIm[a] - workIm[b]);
+        const float oddRe = 0.5f * (workIm[a] + workIm[b]);
+        const float oddIm = -0.5f * (workRe[a] - workRe[b]);
+        re[k] = evenRe + splitRe[k] * oddRe - splitIm[k] * oddIm;
+        im[k] = evenIm + splitRe[k] * oddIm + splitIm[k] * oddRe;
+    }
+}
+
+void RealFft::inverse(const float *re, const float *im, float *out) {
+    // Split into the even and odd half-size spectra and pack them as one
+    // complex spectrum, conjugated so the forward transform runs it backwards
+    for (int k = 0; k < half; k++) {
+        const float sumRe = re[k] + re[half - k];
+        const float sumIm = im[k] - im[half - k];
+        const float diffRe = re[k] - re[half - k];
+        const float diffIm = im[k] + im[half - k];
+        // (diff) * exp(+2 pi i k / size)
+        const float oddRe = diffRe * splitRe[k] + diffIm * splitIm[k];
+        const float oddIm = diffIm * splitRe[k] - diffRe * splitIm[k];
+        workRe[bitReverse[k]] = sumRe - oddIm;
+        workIm[bitReverse[k]] = -(sumIm + oddRe);
+    }
+    transform(workRe.data(), workIm.data());
+    for (int n = 0; n < half; n++) {
+        out[2 * n] = workRe[n];
+        out[2 * n + 1] = -workIm[n];
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Radix-2 FFT of real signals for block convolution
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Forward and inverse FFT of a real signal of `size` samples (a power of
+ * two), through one complex FFT of size / 2 points and a split step.
+ * Spectra are split-complex: size / 2 + 1 real parts and as many imaginary
+ * parts, so a spectrum product is two plain float loops the compiler
+ * vectorises.
+ *
+ * Tables and the work buffer are allocated by the constructor; forward()
+ * and inverse() never allocate. They share the work buffer, so give each
+ * thread its own instance.
+ */
+class RealFft {
+public:
+  // `size` is rounded up to a power of two, at least 4
+  explicit RealFft(int size);
+
+  int getSize() const { return size; }
+  // Bins per spectrum, DC to Nyquist
+  int getBins() const { return half + 1; }
+
+  // in: getSize() samples; re, im: getBins() each
+  void forward(const float *in, float *re, float *im);
+  // Unnormalised: inverse(forward(x)) gives getSize() * x
+  void inverse(const float *re, const float *im, float *out);
+
+private:
+  int size;
+  int half;
+  // exp(-2 pi i k / half), k < half / 2: the complex FFT's twiddles
+  std::vector<float> twiddleRe, twiddleIm;
+  // exp(-2 pi i k / size), k <= half: the split step's
+  std::vector<float> splitRe, splitIm;
+  std::vector<uint32_t> bitReverse;
+  std::vector<float> workRe, workIm;
+
+  // In-place forward FFT of `half` points, input already bit-reversed
+  void transform(float *re, float *im) const;
+};
@@ -0,0 +1,237 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Memory-mapped multi-sample library with resident attack heads
+ */
+
+#include "SampleLibrary.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+struct SampleLibrary::Mapping {
+    void *base = MAP_FAILED;
+    size_t length = 0;
+
+    ~Mapping() {
+        if (base != MAP_FAILED) {
+            munmap(base, length);
+        }
+    }
+};
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 1;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t readU16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+uint32_t readU32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Walks the RIFF chunks for "fmt " and "data". Fills everything in `zone`
+// except the head.
+bool parseWav(const uint8_t *file, size_t size, SampleLibrary::Zone &zone) {
+    if (size < 12 || std::memcmp(file, "RIFF", 4) != 0 ||
+        std::memcmp(file + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool haveFormat = false;
+    uint16_t format = 0;
+    uint16_t bits = 0;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t *chunk = file + pos;
+        const size_t chunkSize = readU32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+        const size_t available = std::min(chunkSize, size - pos - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = readU16(body);
+            zone.channels = readU16(body + 2);
+            zone.sampleRate = static_cast<int32_t>(readU32(body + 4));
+            bits = readU16(body + 14);
+            if (format == WAVE_FORMAT_EXTENSIBLE && available >= 26) {
+                // The sub-format GUID starts with the plain format tag
+                format = readU16(body + 24);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0 && haveFormat) {
+            if (zone.channels < 1 || zone.channels > 2 || zone.sampleRate <= 0) {
+                return false;
+            }
+            if (format == WAVE_FORMAT_PCM && bits == 16) {
+                zone.encoding = SampleLibrary::Encoding::PCM_16;
+            } else if (format == WAVE_FORMAT_PCM && bits == 24) {
+                zone.encoding = SampleLibrary::Encoding::PCM_24;
+            } else if (format == WAVE_FORMAT_PCM && bits == 32) {
+                zone.encoding = SampleLibrary::Encoding::PCM_32;
+            } else if (format == WAVE_FORMAT_IEEE_FLOAT && bits == 32) {
+                zone.encoding = SampleLibrary::Encoding::FLOAT_32;
+            } else {
+                return false;
+            }
+            zone.bytesPerFrame = zone.channels * bits / 8;
+            zone.data = body;
+            zone.frames = static_cast<int64_t>(available / zone.bytesPerFrame);
+            return zone.frames > 0;
+        }
+        // Chunks are padded to an even size
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+float sampleAt(const uint8_t *p, SampleLibrary::Encoding encoding) {
+    switch (encoding) {
+        case SampleLibrary::Encoding::PCM_16:
+            return static_cast<int16_t>(readU16(p)) * (1.0f / 32768.0f);
+        case SampleLibrary::Encoding::PCM_24: {
+            // Sign-extend by building the value in the top 24 bits
+            const int32_t value = static_cast<int32_t>(
+                (static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) |
+                (static_cast<uint32_t>(p[2]) << 24));
+            return (value >> 8) * (1.0f / 8388608.0f);
+        }
+        case SampleLibrary::Encoding::PCM_32:
+            return static_cast<int32_t>(readU32(p)) * (1.0f / 2147483648.0f);
+        case SampleLibrary::Encoding::FLOAT_32: {
+            float value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    }
+    return 0.0f;
+}
+
+} // namespace
+
+SampleLibrary::SampleLibrary() = default;
+SampleLibrary::~SampleLibrary() = default;
+
+bool SampleLibrary::addZone(const std::string &path, int rootNote, int lowNote,
+                            int highNote, int lowVelocity, int highVelocity) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    auto mapping = std::make_unique<Mapping>();
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        mapping->length = static_cast<size_t>(info.st_size);
+        mapping->base = mmap(nullptr, mapping->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // the mapping keeps the file alive
+    if (mapping->base == MAP_FAILED) {
+        return false;
+    }
+
+    auto zone = std::make_unique<Zone>();
+    zone->path = path;
+    zone->rootNote = rootNote;
+    zone->rootFrequency = equalTemperedFrequency(rootNote);
+    zone->lowNote = lowNote;
+    zone->highNote = highNote;
+    zone->lowVelocity = lowVelocity;
+    zone->highVelocity = highVelocity;
+    if (!parseWav(static_cast<const uint8_t *>(mapping->base), mapping->length, *zone)) {
+        return false;
+    }
+
+    // Tails are read front to back by the prefetch thread
+    madvise(mapping->base, mapping->length, MADV_SEQUENTIAL);
+
+    const int32_t headFrames =
+        static_cast<int32_t>(std::min<int64_t>(zone->frames, HEAD_FRAMES));
+    zone->head.resize(static_cast<size_t>(headFrames) * 2);
+    decode(*zone, 0, headFrames, zone->head.data());
+    releasePages(*zone, 0, headFrames);
+
+    zones.push_back(std::move(zone));
+    mappings.push_back(std::move(mapping));
+    return true;
+}
+
+int SampleLibrary::loadMap(const std::string &mapPath) {
+    std::ifstream in(mapPath);
+    if (!in) {
+        return 0;
+    }
+    const size_t slash = mapPath.find_last_of('/');
+    const std::string directory =
+        slash == std::string::npos ? std::string() : mapPath.substr(0, slash + 1);
+
+    int added = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string file;
+        int root, low, high;
+        if (!(fields >> file) || file[0] == '#' || !(fields >> root >> low >> high)) {
+            continue;
+        }
+        int lowVelocity = 1, highVelocity = 127;
+        fields >> lowVelocity >> highVelocity;
+        const std::string path = file[0] == '/' ? file : directory + file;
+        if (addZone(path, root, low, high, lowVelocity, highVelocity)) {
+            added++;
+        }
+    }
+    return added;
+}
+
+const SampleLibrary::Zone *SampleLibrary::findZone(int note, int velocity) const {
+    for (const auto &zone : zones) {
+        if (zone->matches(note, velocity)) {
+            return zone.get();
+        }
+    }
+    return nullptr;
+}
+
+size_t SampleLibrary::residentBytes() const {
+    size_t bytes = 0;
+    for (const auto &zone : zones) {
+        bytes += zone->head.size() * sizeof(float);
+    }
+    return bytes;
+}
+
+void SampleLibrary::decode(const Zone &zone, int64_t start, int32_t numFrames,
+                           float *stereoOut) {
+    const int bytesPerSample = zone.bytesPerFrame / zone.channels;
+    const uint8_t *p = zone.data + start * zone.bytesPerFrame;
+    for (int32_t i = 0; i < numFrames; i++, p += zone.bytesPerFrame) {
+        const float left = sampleAt(p, zone.encoding);
+        const float right =
+            zone.channels == 2 ? sampleAt(p + bytesPerSample, zone.encoding) : left;
+        stereoOut[2 * i] = left;
+        stereoOut[2 * i + 1] = right;
+    }
+}
+
+void SampleLibrary::releasePages(const Zone &zone, int64_t start, int64_t end) {
+    static const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    // Only whole pages inside the range, so a neighbouring read never faults
+    // back in a page we just dropped
+    const uintptr_t first = reinterpret_cast<uintptr_t>(zone.data + start * zone.bytesPerFrame);
+    const uintptr_t last = reinterpret_cast<uintptr_t>(zone.data + end * zone.bytesPerFrame);
+    const uintptr_t from = (first + pageSize - 1) & ~(pageSize - 1);
+    const uintptr_t to = last & ~(pageSize - 1);
+    if (to > from) {
+        madvise(reinterpret_cast<void *>(from), to - from, MADV_DONTNEED);
+    }
+}
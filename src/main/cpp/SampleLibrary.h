@@ -0,0 +1,116 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Memory-mapped multi-sample library with resident attack heads
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * A set of zones, each mapping a key/velocity range to one WAV file. Files
+ * are mmap()ed read-only rather than loaded: only the first HEAD_FRAMES of
+ * every zone are decoded into resident memory, so a note can start sounding
+ * the instant it is struck. The rest of the file (the tail) is decoded from
+ * the mapping by StreamingSampler's prefetch thread and its pages are dropped
+ * again once consumed, so resident memory is bounded by the zone count and
+ * the streaming rings, not by how long the samples are.
+ *
+ * Heads and streamed tails are always decoded to interleaved stereo floats.
+ * Supports 16/24/32-bit PCM and 32-bit float, mono or stereo.
+ *
+ * Loading (addZone/loadMap) does blocking I/O: call it off the audio thread
+ * and before the library is handed to a sampler. After that the library is
+ * read-only and may be shared between threads.
+ */
+class SampleLibrary {
+public:
+  // ~170 ms at 48 kHz: comfortably longer than the prefetch thread needs to
+  // get the first tail block into a voice's ring
+  static constexpr int32_t HEAD_FRAMES = 8192;
+
+  enum class Encoding : uint8_t { PCM_16, PCM_24, PCM_32, FLOAT_32 };
+
+  struct Zone {
+    std::string path;
+    int rootNote = 60;
+    // The recorded pitch: rootNote in 12-TET
+    double rootFrequency = 261.6255653005986;
+    int lowNote = 0;
+    int highNote = 127;
+    int lowVelocity = 1;
+    int highVelocity = 127;
+
+    int32_t sampleRate = 0;
+    int channels = 0;
+    Encoding encoding = Encoding::PCM_16;
+    int64_t frames = 0;
+
+    // First min(frames, HEAD_FRAMES) frames, interleaved stereo
+    std::vector<float> head;
+    int32_t headFrames() const { return static_cast<int32_t>(head.size() / 2); }
+
+    // Mapping of the whole file; `data` points at the first sample frame
+    const uint8_t *data = nullptr;
+    int bytesPerFrame = 0;
+
+    bool matches(int note, int velocity) const {
+      return note >= lowNote && note <= highNote && velocity >= lowVelocity &&
+             velocity <= highVelocity;
+    }
+  };
+
+  SampleLibrary();
+  ~SampleLibrary();
+
+  // A4 = 440 Hz
+  static double equalTemperedFrequency(int midiNote) {
+    return 440.0 * std::exp2((midiNote - 69) / 12.0);
+  }
+
+  SampleLibrary(const SampleLibrary &) = delete;
+  SampleLibrary &operator=(const SampleLibrary &) = delete;
+
+  // Maps `path` and decodes its head. Returns false (and adds nothing) if the
+  // file cannot be mapped or is not a supported WAV.
+  bool addZone(const std::string &path, int rootNote, int lowNote,
+               int highNote, int lowVelocity = 1, int highVelocity = 127);
+
+  // Reads a map file with one zone per line:
+  //
+  //     file.wav root low high [lowVelocity highVelocity]
+  //
+  // Relative paths resolve against the map's directory; blank lines and
+  // lines starting with '#' are skipped. Returns the number of zones added.
+  int loadMap(const std::string &mapPath);
+
+  // The first zone covering note/velocity, or nullptr
+  const Zone *findZone(int note, int velocity) const;
+
+  int zoneCount() const { return static_cast<int>(zones.size()); }
+  const Zone &zone(int i) const { return *zones[i]; }
+
+  // Bytes of decoded heads held in memory (the mappings are not counted)
+  size_t residentBytes() const;
+
+  // Decodes frames [start, start + numFrames) of `zone` from its mapping to
+  // interleaved stereo. Touches the file, so never on the audio thread.
+  static void decode(const Zone &zone, int64_t start, int32_t numFrames,
+                     float *stereoOut);
+
+  // Tells the kernel the mapped pages covering frames [start, end) are no
+  // longer needed, so they stop counting against resident memory
+  static void releasePages(const Zone &zone, int64_t start, int64_t end);
+
+private:
+  struct Mapping;
+  std::vector<std::unique_ptr<Zone>> zones;
+  std::vector<std::unique_ptr<Mapping>> mappings;
+};
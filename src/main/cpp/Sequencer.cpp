@@ -0,0 +1,267 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Sample-accurate pattern sequencer driven from the audio callback
+ */
+
+#include "Sequencer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+struct Sequencer::Pattern {
+    // Every unmuted event, sorted by (tick, type), stable across tracks
+    std::vector<SequencerEvent> events;
+    double tempo = 120.0;
+    int64_t lengthTicks = 1;
+    bool loop = true;
+};
+
+SequencerEvent SequencerEvent::noteOn(int64_t tick, int midiNote, int velocity, float pan) {
+    SequencerEvent event;
+    event.tick = tick;
+    event.type = Type::NOTE_ON;
+    event.number = static_cast<uint8_t>(std::clamp(midiNote, 0, 127));
+    event.velocity = static_cast<uint8_t>(std::clamp(velocity, 1, 127));
+    event.value = std::clamp(pan, -1.0f, 1.0f);
+    return event;
+}
+
+SequencerEvent SequencerEvent::noteOff(int64_t tick, int midiNote) {
+    SequencerEvent event;
+    event.tick = tick;
+    event.type = Type::NOTE_OFF;
+    event.number = static_cast<uint8_t>(std::clamp(midiNote, 0, 127));
+    return event;
+}
+
+SequencerEvent SequencerEvent::control(int64_t tick, Control control, float value) {
+    SequencerEvent event;
+    event.tick = tick;
+    event.type = Type::CONTROL;
+    event.number = static_cast<uint8_t>(control);
+    event.value = value;
+    return event;
+}
+
+void SequencerPattern::addNote(int track, int64_t tick, int64_t length, int midiNote,
+                               int velocity, float pan) {
+    if (track < 0) {
+        return;
+    }
+    if (static_cast<size_t>(track) >= tracks.size()) {
+        tracks.resize(static_cast<size_t>(track) + 1);
+    }
+    std::vector<SequencerEvent> &events = tracks[static_cast<size_t>(track)].events;
+    events.push_back(SequencerEvent::noteOn(tick, midiNote, velocity, pan));
+    events.push_back(SequencerEvent::noteOff(tick + std::max<int64_t>(1, length), midiNote));
+}
+
+Sequencer::Sequencer() = default;
+
+Sequencer::~Sequencer() {
+    delete current;
+    delete pending.exchange(nullptr);
+    std::lock_guard<std::mutex> lock(controlLock);
+    reclaimLocked();
+}
+
+void Sequencer::setSampleRate(int32_t rate) {
+    sampleRate = rate;
+    if (current != nullptr) {
+        framesPerTick = framesPerTickFor(*current);
+    }
+}
+
+void Sequencer::reclaimLocked() {
+    Pattern *pattern;
+    while (retired.pop(pattern)) {
+        delete pattern;
+    }
+}
+
+void Sequencer::setPattern(const SequencerPattern &source) {
+    std::lock_guard<std::mutex> lock(controlLock);
+    reclaimLocked();
+
+    auto pattern = std::make_unique<Pattern>();
+    pattern->tempo = std::clamp(source.tempo, 1.0, 1000.0);
+    pattern->lengthTicks = std::max<int64_t>(1, source.lengthTicks);
+    pattern->loop = source.loop;
+    for (const SequencerTrack &track : source.tracks) {
+        if (track.muted) {
+            continue;
+        }
+        for (const SequencerEvent &event : track.events) {
+            if (event.tick >= 0 && event.tick < pattern->lengthTicks) {
+                pattern->events.push_back(event);
+            }
+        }
+    }
+    std::stable_sort(pattern->events.begin(), pattern->events.end(),
+                     [](const SequencerEvent &a, const SequencerEvent &b) {
+                         return a.tick != b.tick ? a.tick < b.tick : a.type < b.type;
+                     });
+
+    // A snapshot the audio thread never took can be freed right here
+    delete pending.exchange(pattern.release(), std::memory_order_acq_rel);
+}
+
+void Sequencer::play(int64_t frame) {
+    requestedFrame.store(std::max<int64_t>(frame, 0), std::memory_order_relaxed);
+    transportSerial.fetch_add(1, std::memory_order_release);
+}
+
+void Sequencer::stop() {
+    requestedFrame.store(STOPPED, std::memory_order_relaxed);
+    transportSerial.fetch_add(1, std::memory_order_release);
+}
+
+double Sequencer::framesPerTickFor(const Pattern &pattern) const {
+    return sampleRate * 60.0 / (pattern.tempo * SequencerPattern::TICKS_PER_QUARTER);
+}
+
+int64_t Sequencer::loopFrames() const {
+    return std::max<int64_t>(1, std::llround(current->lengthTicks * framesPerTick));
+}
+
+int64_t Sequencer::frameOf(const SequencerEvent &event) const {
+    return loopStart + std::llround(event.tick * framesPerTick);
+}
+
+void Sequencer::seek(int64_t frame) {
+    const std::vector<SequencerEvent> &events = current->events;
+    cursor = static_cast<size_t>(
+        std::lower_bound(events.begin(), events.end(), frame,
+                         [this](const SequencerEvent &event, int64_t target) {
+                             return frameOf(event) < target;
+                         }) -
+        events.begin());
+}
+
+void Sequencer::flushSounding() {
+    for (int i = 0; i < 2; i++) {
+        flushing[i] |= sounding[i];
+        sounding[i] = 0;
+    }
+}
+
+void Sequencer::beginBlock(int64_t start, int32_t numFrames) {
+    blockStart = start;
+    blockEnd = start + numFrames;
+
+    if (pending.load(std::memory_order_relaxed) != nullptr) {
+        if (Pattern *next = pending.exchange(nullptr, std::memory_order_acq_rel)) {
+            adoptPattern(next);
+        }
+    }
+    applyTransport();
+
+    if (playing && current != nullptr && !current->loop &&
+        cursor == current->events.size() && blockStart >= loopStart + loopFrames()) {
+        // Played out: release what it left sounding and report stopped
+        flushSounding();
+        playing = false;
+        finishedSerial.store(seenSerial, std::memory_order_relaxed);
+    }
+
+    int64_t position = -1;
+    if (playing && current != nullptr) {
+        const double ticks = std::max(0.0, (blockStart - loopStart) / framesPerTick);
+        position = static_cast<int64_t>(current->loop ? std::fmod(ticks, current->lengthTicks)
+                                                      : ticks);
+    }
+    positionTicks.store(position, std::memory_order_relaxed);
+}
+
+void Sequencer::adoptPattern(Pattern *next) {
+    // Position in ticks under the old pattern's tempo. A start still in the
+    // future stays where it is.
+    const bool started = playing && blockStart > loopStart;
+    double ticks = 0.0;
+    if (started && current != nullptr) {
+        ticks = (blockStart - loopStart) / framesPerTick;
+    }
+    if (current != nullptr) {
+        // Every publish drains `retired` first, so the push cannot fail
+        retired.push(current);
+    }
+    current = next;
+    framesPerTick = framesPerTickFor(*current);
+    if (!playing) {
+        return;
+    }
+
+    flushSounding();
+    if (current->loop) {
+        ticks = std::fmod(ticks, static_cast<double>(current->lengthTicks));
+    }
+    if (started) {
+        loopStart = blockStart - std::llround(ticks * framesPerTick);
+    }
+    seek(blockStart);
+}
+
+void Sequencer::applyTransport() {
+    const uint32_t serial = transportSerial.load(std::memory_order_acquire);
+    if (serial == seenSerial) {
+        return;
+    }
+    seenSerial = serial;
+    const int64_t frame = requestedFrame.load(std::memory_order_relaxed);
+
+    flushSounding();
+    playing = frame != STOPPED;
+    if (playing) {
+        loopStart = std::max(frame, blockStart);
+        cursor = 0;
+    }
+}
+
+int64_t Sequencer::peekFrame() {
+    if ((flushing[0] | flushing[1]) != 0) {
+        return blockStart;
+    }
+    if (!playing || current == nullptr || current->events.empty()) {
+        return NO_EVENT;
+    }
+    const std::vector<SequencerEvent> &events = current->events;
+    while (cursor == events.size()) {
+        // Past the last event: the next one is the first of the next lap
+        const int64_t loopEnd = loopStart + loopFrames();
+        if (!current->loop || loopEnd >= blockEnd) {
+            return NO_EVENT;
+        }
+        loopStart = loopEnd;
+        cursor = 0;
+    }
+    const int64_t frame = frameOf(events[cursor]);
+    return frame < blockEnd ? frame : NO_EVENT;
+}
+
+bool Sequencer::pop(Dispatch &dispatch) {
+    const int64_t frame = peekFrame();
+    if (frame == NO_EVENT) {
+        return false;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (flushing[i] != 0) {
+            const int bit = __builtin_ctzll(flushing[i]);
+            flushing[i] &= flushing[i] - 1;
+            dispatch = {blockStart, SequencerEvent::noteOff(0, 64 * i + bit)};
+            return true;
+        }
+    }
+
+    dispatch = {frame, current->events[cursor++]};
+    const SequencerEvent &event = dispatch.event;
+    const uint64_t bit = 1ull << (event.number % 64);
+    if (event.type == SequencerEvent::Type::NOTE_ON) {
+        sounding[event.number / 64] |= bit;
+    } else if (event.type == SequencerEvent::Type::NOTE_OFF) {
+        sounding[event.number / 64] &= ~bit;
+    }
+    return true;
+}
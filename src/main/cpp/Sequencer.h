@@ -0,0 +1,165 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Sample-accurate pattern sequencer driven from the audio callback
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "NoteEventQueue.h"
+
+// One event on a sequencer track, at a musical position in ticks
+struct SequencerEvent {
+  // Also the order of events that share a tick: controls first, then
+  // note-offs, so a note re-struck on the tick it ends sounds again
+  enum class Type : uint8_t { CONTROL, NOTE_OFF, NOTE_ON };
+  enum class Control : uint8_t { OUTPUT_GAIN, SEND_LEVEL, COUNT };
+
+  int64_t tick = 0;
+  Type type = Type::NOTE_ON;
+  // MIDI note, or the Control
+  uint8_t number = 0;
+  // NOTE_ON only: 1..127
+  uint8_t velocity = 100;
+  // NOTE_ON: pan, -1 hard left .. +1 hard right; CONTROL: the value
+  float value = 0.0f;
+
+  static SequencerEvent noteOn(int64_t tick, int midiNote, int velocity = 100, float pan = 0.0f);
+  static SequencerEvent noteOff(int64_t tick, int midiNote);
+  static SequencerEvent control(int64_t tick, Control control, float value);
+};
+
+struct SequencerTrack {
+  std::vector<SequencerEvent> events;
+  bool muted = false;
+};
+
+// What the UI edits; handed to Sequencer::setPattern() as a whole
+struct SequencerPattern {
+  static constexpr int TICKS_PER_QUARTER = 960;
+
+  // Quarter notes per minute
+  double tempo = 120.0;
+  // Events at or past the end are ignored
+  int64_t lengthTicks = 4 * TICKS_PER_QUARTER;
+  bool loop = true;
+  std::vector<SequencerTrack> tracks;
+
+  // Note-on at `tick` and its note-off `length` ticks later; adds tracks up
+  // to `track` as needed
+  void addNote(int track, int64_t tick, int64_t length, int midiNote, int velocity = 100,
+               float pan = 0.0f);
+};
+
+/*
+ * Plays a looping pattern of note and control events at exact frames,
+ * entirely on the audio thread, so timing does not depend on the UI thread
+ * or GC pauses.
+ *
+ * setPattern() merges the unmuted tracks into one array sorted by tick,
+ * which the audio thread walks with a single cursor; an event's frame is
+ * loopStart + round(tick * framesPerTick), computed from the start of the
+ * loop each time, so rounding never accumulates. Patterns are immutable
+ * snapshots swapped in the same way as EffectsBus chains: built and freed
+ * on the control side, taken by the audio thread with one atomic exchange
+ * at the start of a block. A swap keeps the playback position (in ticks,
+ * so a tempo change does not jump) and releases the notes the old pattern
+ * left sounding.
+ *
+ * The audio side is beginBlock() once per render call, then peekFrame() /
+ * pop() while splitting the buffer at event frames (SynthCore does this).
+ *
+ * Threading: setPattern/play/stop/getPositionTicks from any thread;
+ * beginBlock/peekFrame/pop from the audio thread only; setSampleRate()
+ * must not race the audio thread.
+ */
+class Sequencer {
+public:
+  static constexpr int64_t NO_EVENT = INT64_MAX;
+
+  // An event and the absolute render frame it lands on
+  struct Dispatch {
+    int64_t frame;
+    SequencerEvent event;
+  };
+
+  Sequencer();
+  ~Sequencer();
+
+  Sequencer(const Sequencer &) = delete;
+  Sequencer &operator=(const Sequencer &) = delete;
+
+  void setSampleRate(int32_t rate);
+
+  void setPattern(const SequencerPattern &pattern);
+
+  // Start the pattern from its first tick at render frame `frame` (the next
+  // block if that has passed); restarts if already playing
+  void play(int64_t frame);
+  // Stops at the next block and releases every note the pattern started
+  void stop();
+  // False once stopped, and once a pattern with loop off has played to its
+  // end and released its notes
+  bool isPlaying() const {
+    return requestedFrame.load(std::memory_order_relaxed) != STOPPED &&
+           finishedSerial.load(std::memory_order_relaxed) !=
+               transportSerial.load(std::memory_order_relaxed);
+  }
+
+  // Playback position as of the last block, or -1 when stopped
+  int64_t getPositionTicks() const { return positionTicks.load(std::memory_order_relaxed); }
+
+  // Audio thread
+  void beginBlock(int64_t blockStart, int32_t numFrames);
+  // Frame of the next event in the current block, or NO_EVENT
+  int64_t peekFrame();
+  // Takes the event peekFrame() returned; false if there is none
+  bool pop(Dispatch &dispatch);
+
+private:
+  struct Pattern;
+
+  static constexpr int64_t STOPPED = INT64_MIN;
+
+  // Control side
+  std::mutex controlLock;
+
+  std::atomic<Pattern *> pending{nullptr};
+  NoteEventQueue<Pattern *, 8> retired;
+
+  std::atomic<int64_t> requestedFrame{STOPPED};
+  std::atomic<uint32_t> transportSerial{0};
+  // The transportSerial whose play() ran out, set by the audio thread
+  std::atomic<uint32_t> finishedSerial{0};
+  std::atomic<int64_t> positionTicks{-1};
+
+  // Audio thread only
+  Pattern *current = nullptr;
+  int32_t sampleRate = 48000;
+  uint32_t seenSerial = 0;
+  bool playing = false;
+  double framesPerTick = 0.0;
+  int64_t loopStart = 0;
+  size_t cursor = 0;
+  int64_t blockStart = 0;
+  int64_t blockEnd = 0;
+  // Notes the pattern started and has not stopped yet
+  uint64_t sounding[2] = {};
+  // Notes to release at the start of this block
+  uint64_t flushing[2] = {};
+
+  void reclaimLocked();
+  void applyTransport();
+  void adoptPattern(Pattern *next);
+  double framesPerTickFor(const Pattern &pattern) const;
+  int64_t loopFrames() const;
+  int64_t frameOf(const SequencerEvent &event) const;
+  void seek(int64_t frame);
+  void flushSounding();
+};
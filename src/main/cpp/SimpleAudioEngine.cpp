@@ -6,13 +6,19 @@
  */
 
 #include "SimpleAudioEngine.h"
+
+#define LOG_TAG "OngomaAudioEngine"
+#include "Log.h"
+
 #include <algorithm>
 
-float SimpleAudioEngine::waveTable[WAVE_TABLE_SIZE] = {};
+#include "common/Trace.h"
 
 SimpleAudioEngine::SimpleAudioEngine()
     : engineStartTime(std::chrono::steady_clock::now()) {
     LOGI("AudioEngine constructor called");
+    synth.attachRecorder(&recorder);
+    resumeThread = std::thread(&SimpleAudioEngine::resumeLoop, this);
 }
 
 double SimpleAudioEngine::getCurrentTime() {
@@ -21,42 +27,79 @@ double SimpleAudioEngine::getCurrentTime() {
     return std::chrono::duration<double>(elapsed).count();
 }
 
-void SimpleAudioEngine::initWaveTable() {
-    const double harmonicSum =
-        HARMONIC_1_AMP + HARMONIC_2_AMP + HARMONIC_3_AMP + HARMONIC_4_AMP;
-    for (int i = 0; i < WAVE_TABLE_SIZE; i++) {
-        double phase = TWO_PI * i / WAVE_TABLE_SIZE;
-        waveTable[i] = static_cast<float>(
-            (HARMONIC_1_AMP * std::sin(phase) +
-             HARMONIC_2_AMP * std::sin(phase * 2.0) +
-             HARMONIC_3_AMP * std::sin(phase * 3.0) +
-             HARMONIC_4_AMP * std::sin(phase * 4.0)) /
-            harmonicSum);
+int64_t SimpleAudioEngine::getFramePosition() const {
+    return synth.getFramePosition();
+}
+
+void SimpleAudioEngine::getStats(int64_t *out) {
+    // Polled from the UI: skip the device figures rather than wait out a
+    // stream reopen or restart
+    std::unique_lock<std::mutex> lock(streamLock, std::try_to_lock);
+    if (lock.owns_lock() && audioStream) {
+        auto xruns = audioStream->getXRunCount();
+        if (xruns) {
+            synth.getStats().setXRuns(xruns.value());
+        }
+        synth.getStats().setBufferFrames(audioStream->getBufferSizeInFrames());
+    }
+    synth.getStats().snapshot(out);
+}
+
+void SimpleAudioEngine::setTracingEnabled(bool enabled) {
+    if (enabled) {
+        // Idempotent: resolves the ATrace symbols from libandroid
+        Trace::initialize();
     }
-    LOGI("Wave table initialized (%d entries)", WAVE_TABLE_SIZE);
+    tracing.store(enabled, std::memory_order_relaxed);
+    LOGI("Audio callback tracing %s", enabled ? "enabled" : "disabled");
 }
 
 void SimpleAudioEngine::initialize() {
-    initWaveTable();
-    LOGI("SimpleAudioEngine initializing with Oboe");
+    std::lock_guard<std::mutex> lock(streamLock);
+    startStream();
+}
 
-    oboe::AudioStreamBuilder builder;
-    builder.setDirection(oboe::Direction::Output);
-    builder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
-    builder.setSharingMode(oboe::SharingMode::Shared);
-    builder.setFormat(oboe::AudioFormat::Float);
-    builder.setChannelCount(oboe::ChannelCount::Mono);
-    builder.setSampleRate(SAMPLE_RATE);
-    builder.setDataCallback(this);
+void SimpleAudioEngine::startStream() {
+    LOGI("SimpleAudioEngine initializing with Oboe (%s latency mode)",
+         lowLatencyMode ? "low" : "default");
 
-    oboe::Result result = builder.openStream(audioStream);
+    oboe::Result result = openStream(lowLatencyMode ? oboe::SharingMode::Exclusive
+                                                    : oboe::SharingMode::Shared);
+    if (result != oboe::Result::OK && lowLatencyMode) {
+        LOGI("Exclusive stream unavailable (%s), falling back to shared",
+             oboe::convertToText(result));
+        result = openStream(oboe::SharingMode::Shared);
+    }
     if (result != oboe::Result::OK) {
         LOGE("Failed to create audio stream: %s", oboe::convertToText(result));
         return;
     }
+    streamOpen.store(true, std::memory_order_relaxed);
+
+    // Envelope timing and pitch follow the rate the device actually gave us
+    synth.setSampleRate(audioStream->getSampleRate());
+    LOGI("Wave table initialized (%d entries, %d band-limited levels)",
+         SynthCore::WAVE_TABLE_SIZE, MipmappedWavetable::NUM_LEVELS);
+
+    // Mono and stereo devices are rendered into directly; wider layouts get
+    // stereo on the first two channels
+    deviceChannels = audioStream->getChannelCount();
+    synth.setChannelCount(std::min(deviceChannels, SynthCore::MAX_CHANNELS));
+    LOGI("Output limiter look-ahead: %d frames", synth.getLatencyFrames());
+    rebuildReverb();
+
+    if (lowLatencyMode) {
+        // Starts at the smallest safe buffer and grows a burst per underrun
+        latencyTuner = std::make_unique<oboe::LatencyTuner>(*audioStream);
+        // Lets Oboe's AdpfWrapper report the measured callback duration to
+        // the CPU governor, so a burst of notes gets clocks before it glitches
+        audioStream->setPerformanceHintEnabled(true);
+    }
 
-    LOGI("Audio stream created: %dHz, %d frames",
-         audioStream->getSampleRate(), audioStream->getBufferSizeInFrames());
+    LOGI("Audio stream created: %dHz, %d channels, %s, burst %d, buffer %d frames",
+         audioStream->getSampleRate(), deviceChannels,
+         oboe::convertToText(audioStream->getSharingMode()),
+         audioStream->getFramesPerBurst(), audioStream->getBufferSizeInFrames());
 
     result = audioStream->requestStart();
     if (result != oboe::Result::OK) {
@@ -67,206 +110,477 @@ void SimpleAudioEngine::initialize() {
     LOGI("Audio stream started successfully");
 }
 
-SimpleAudioEngine::~SimpleAudioEngine() {
-    LOGI("Shutting down SimpleAudioEngine");
-    stopAllNotes();
+oboe::Result SimpleAudioEngine::openStream(oboe::SharingMode sharingMode) {
+    oboe::AudioStreamBuilder builder;
+    builder.setDirection(oboe::Direction::Output);
+    builder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
+    builder.setSharingMode(sharingMode);
+    builder.setFormat(oboe::AudioFormat::Float);
+    // Leave the channel count unspecified so the stream opens at the
+    // device's native layout and Oboe adds no channel conversion stage
+    builder.setSampleRate(SAMPLE_RATE);
+    builder.setDataCallback(this);
+    return builder.openStream(audioStream);
+}
 
+void SimpleAudioEngine::closeStream() {
+    streamOpen.store(false, std::memory_order_relaxed);
     if (audioStream) {
         audioStream->requestStop();
         audioStream->close();
         audioStream.reset();
     }
+    suspended.store(false, std::memory_order_relaxed);
+    resumeNanos.store(0, std::memory_order_relaxed);
+    // Only the callback uses the tuner, and it has stopped
+    latencyTuner.reset();
+    // The next stream may have another channel count or rate
+    if (recorder.isRecording()) {
+        stopRecording();
+    }
+}
 
-    LOGI("SimpleAudioEngine destroyed");
+bool SimpleAudioEngine::startRecording(const std::string &path, bool pcm24) {
+    const bool started = recorder.start(
+        path, synth.getSampleRate(), synth.getChannelCount(),
+        pcm24 ? WavWriter::Format::PCM24 : WavWriter::Format::FLOAT32, synth.eventFrameNow());
+    if (started) {
+        wake();
+        LOGI("Recording %s-bit to %s", pcm24 ? "24" : "float 32", path.c_str());
+    } else {
+        LOGE("Cannot record to %s", path.c_str());
+    }
+    return started;
 }
 
-void SimpleAudioEngine::playNote(int midiNote) {
-    playNotePolyphonic(midiNote);
+bool SimpleAudioEngine::stopRecording() {
+    const bool ok = recorder.finish();
+    LOGI("Recording stopped: %lld frames, %lld dropped%s",
+         static_cast<long long>(recorder.getFramesCaptured()),
+         static_cast<long long>(recorder.getOverrunFrames()), ok ? "" : ", write failed");
+    return ok;
 }
 
-void SimpleAudioEngine::stopNote() {
-    stopAllNotes();
+void SimpleAudioEngine::setIdleSuspend(float seconds) {
+    idleSuspendSeconds.store(std::max(0.0f, seconds), std::memory_order_relaxed);
+    LOGI("Idle suspend: %s", seconds > 0.0f ? "on" : "off");
 }
 
-void SimpleAudioEngine::playNotePolyphonic(int midiNote) {
-    if (!audioStream) {
-        LOGE("Cannot play note - audio stream not initialized");
+void SimpleAudioEngine::wake() {
+    // Pairs with the fence in suspendIfIdle(): either the callback sees the
+    // event posted before this, or this sees the stream suspended
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!suspended.load(std::memory_order_relaxed)) {
         return;
     }
+    int64_t unset = 0;
+    resumeNanos.compare_exchange_strong(unset, SynthCore::nowNanos(),
+                                        std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(resumeLock);
+        if (resumeRequested) {
+            return;
+        }
+        resumeRequested = true;
+    }
+    resumeSignal.notify_one();
+}
 
-    std::lock_guard<std::mutex> lock(notesMutex);
+void SimpleAudioEngine::resumeLoop() {
+    std::unique_lock<std::mutex> lock(resumeLock);
+    while (true) {
+        resumeSignal.wait(lock, [&] { return resumeRequested || !resumeRunning; });
+        if (!resumeRunning) {
+            return;
+        }
+        resumeRequested = false;
+        lock.unlock();
+        resumeStream();
+        lock.lock();
+    }
+}
 
-    auto existing = activeNotes.find(midiNote);
-    if (existing != activeNotes.end()) {
-        // Re-trigger: reset to attack phase for immediate response
-        auto& noteData = existing->second;
-        noteData->state = EnvelopeState::ATTACK;
-        noteData->stateStartTime = getCurrentTime();
-        noteData->isReleasing = false;
-        noteData->noteId = nextNoteId++;
+void SimpleAudioEngine::resumeStream() {
+    std::lock_guard<std::mutex> lock(streamLock);
+    // closeStream() clears the flag, so a reopened stream is left alone
+    if (!suspended.load(std::memory_order_relaxed) || !audioStream) {
         return;
     }
 
-    // Evict a note if at capacity: prefer releasing notes, then oldest
-    if (activeNotes.size() >= MAX_POLYPHONY) {
-        auto victim = activeNotes.end();
-
-        // First pass: find oldest releasing note
-        for (auto it = activeNotes.begin(); it != activeNotes.end(); ++it) {
-            if (it->second->isReleasing) {
-                if (victim == activeNotes.end() || it->second->noteId < victim->second->noteId) {
-                    victim = it;
-                }
-            }
+    // The stream stops itself after the callback returns Stop, and may not
+    // have got there yet; starting it before then would be undone
+    oboe::StreamState state = audioStream->getState();
+    for (oboe::StreamState from : {oboe::StreamState::Started, oboe::StreamState::Stopping}) {
+        if (state == from) {
+            audioStream->waitForStateChange(from, &state, RESUME_WAIT_NANOS);
         }
+    }
+    suspended.store(false, std::memory_order_relaxed);
+    const oboe::Result result = audioStream->requestStart();
+    if (result != oboe::Result::OK) {
+        LOGE("Failed to resume audio stream: %s", oboe::convertToText(result));
+    }
+}
 
-        // Second pass: if no releasing notes, evict oldest active note
-        if (victim == activeNotes.end()) {
-            for (auto it = activeNotes.begin(); it != activeNotes.end(); ++it) {
-                if (victim == activeNotes.end() || it->second->noteId < victim->second->noteId) {
-                    victim = it;
-                }
-            }
-        }
+void SimpleAudioEngine::setLowLatencyMode(bool enabled) {
+    std::lock_guard<std::mutex> lock(streamLock);
+    if (enabled == lowLatencyMode) {
+        return;
+    }
+    lowLatencyMode = enabled;
+    if (audioStream) {
+        // Sharing mode is fixed at open, so renegotiate the stream
+        closeStream();
+        startStream();
+    }
+}
 
-        if (victim != activeNotes.end()) {
-            activeNotes.erase(victim);
-        }
+void SimpleAudioEngine::setMultiCoreRendering(bool enabled) {
+    std::lock_guard<std::mutex> lock(streamLock);
+    if (enabled == (workerPool != nullptr)) {
+        return;
+    }
+    const int workers = VoiceWorkerPool::defaultWorkerCount();
+    if (enabled && workers == 0) {
+        LOGI("Multi-core rendering needs a spare core; staying single-threaded");
+        return;
+    }
+    // The callback renders through the pool, so swap it with the stream stopped
+    const bool wasRunning = audioStream != nullptr;
+    closeStream();
+    synth.attachWorkerPool(nullptr);
+    workerPool.reset();
+    if (enabled) {
+        workerPool = std::make_unique<VoiceWorkerPool>(workers);
+        synth.attachWorkerPool(workerPool.get());
     }
+    LOGI("Multi-core rendering %s (%d workers)", enabled ? "enabled" : "disabled",
+         enabled ? workers : 0);
+    if (wasRunning) {
+        startStream();
+    }
+}
 
-    double frequency = midiNoteToFrequency(midiNote);
-    double currentTime = getCurrentTime();
-    auto noteData = std::make_shared<NoteData>(midiNote, frequency, currentTime, nextNoteId++);
-    activeNotes[midiNote] = noteData;
+bool SimpleAudioEngine::loadSampleMap(const std::string &mapPath) {
+    auto library = std::make_unique<SampleLibrary>();
+    if (library->loadMap(mapPath) == 0) {
+        LOGE("No playable zones in sample map %s", mapPath.c_str());
+        return false;
+    }
+    LOGI("Loaded %d sample zones from %s (%zu KB resident)", library->zoneCount(),
+         mapPath.c_str(), library->residentBytes() / 1024);
+    replaceSamples(std::move(library));
+    return true;
 }
 
-void SimpleAudioEngine::stopNotePolyphonic(int midiNote) {
-    std::lock_guard<std::mutex> lock(notesMutex);
+void SimpleAudioEngine::clearSamples() {
+    replaceSamples(nullptr);
+}
 
-    auto it = activeNotes.find(midiNote);
-    if (it != activeNotes.end() && !it->second->isReleasing) {
-        auto& noteData = it->second;
-        noteData->state = EnvelopeState::RELEASE;
-        noteData->stateStartTime = getCurrentTime();
-        noteData->isReleasing = true;
+void SimpleAudioEngine::replaceSamples(std::unique_ptr<SampleLibrary> library) {
+    // The callback holds a raw pointer to the sampler, so swap it with the
+    // stream stopped
+    std::lock_guard<std::mutex> lock(streamLock);
+    const bool wasRunning = audioStream != nullptr;
+    closeStream();
+    synth.attachSampler(nullptr);
+    sampler.reset();
+    sampleLibrary = std::move(library);
+    if (sampleLibrary) {
+        sampler = std::make_unique<StreamingSampler>(*sampleLibrary);
+        synth.attachSampler(sampler.get());
+    }
+    if (wasRunning) {
+        startStream();
     }
 }
 
-void SimpleAudioEngine::stopAllNotes() {
-    std::lock_guard<std::mutex> lock(notesMutex);
-    activeNotes.clear();
+bool SimpleAudioEngine::loadReverb(const std::string &impulsePath) {
+    ImpulseResponse impulse;
+    if (!impulse.load(impulsePath)) {
+        LOGE("Cannot read impulse response %s", impulsePath.c_str());
+        return false;
+    }
+    LOGI("Loaded impulse response %s: %d frames, %d channels at %d Hz", impulsePath.c_str(),
+         impulse.frames(), impulse.channels, impulse.sampleRate);
+    replaceReverb(std::move(impulse));
+    return true;
 }
 
-double SimpleAudioEngine::midiNoteToFrequency(int midiNote) {
-    return 440.0 * std::pow(2.0, ((double)midiNote - 69.0) / 12.0);
+void SimpleAudioEngine::clearReverb() {
+    replaceReverb(ImpulseResponse{});
 }
 
-double SimpleAudioEngine::calculateEnvelope(const std::shared_ptr<NoteData>& noteData, double currentTime) {
-    double timeInState = currentTime - noteData->stateStartTime;
+void SimpleAudioEngine::setReverbLevel(float level) {
+    // Reloads and reopens rebuild the reverb under the lock
+    std::lock_guard<std::mutex> lock(streamLock);
+    reverbLevel = level;
+    if (reverb) {
+        reverb->setWetLevel(level);
+    }
+}
 
-    switch (noteData->state) {
-        case EnvelopeState::ATTACK: {
-            if (timeInState >= ATTACK_TIME) {
-                return 1.0;
-            }
-            return timeInState / ATTACK_TIME;
-        }
+void SimpleAudioEngine::replaceReverb(ImpulseResponse impulse) {
+    // The callback holds a raw pointer to the reverb, so swap it with the
+    // stream stopped; startStream() builds the new one for the stream
+    std::lock_guard<std::mutex> lock(streamLock);
+    const bool wasRunning = audioStream != nullptr;
+    closeStream();
+    synth.attachReverb(nullptr);
+    reverb.reset();
+    reverbImpulse = std::move(impulse);
+    if (wasRunning) {
+        startStream();
+    }
+}
 
-        case EnvelopeState::DECAY: {
-            if (timeInState >= DECAY_TIME) {
-                return SUSTAIN_LEVEL;
-            }
-            double progress = timeInState / DECAY_TIME;
-            return 1.0 - (1.0 - SUSTAIN_LEVEL) * progress;
-        }
+// Stream open but not started: partitions the response for its rate and
+// channel count
+void SimpleAudioEngine::rebuildReverb() {
+    synth.attachReverb(nullptr);
+    reverb.reset();
+    if (reverbImpulse.frames() == 0) {
+        return;
+    }
+    reverb = std::make_unique<ConvolutionReverb>(reverbImpulse, synth.getSampleRate(),
+                                                 synth.getChannelCount());
+    reverb->setWetLevel(reverbLevel);
+    synth.attachReverb(reverb.get());
+    LOGI("Reverb: %d partitions of %d frames, %d in the callback",
+         reverb->getPartitionCount(), reverb->getBlockFrames(), reverb->getHeadPartitions());
+}
 
-        case EnvelopeState::SUSTAIN:
-            return SUSTAIN_LEVEL;
+SimpleAudioEngine::~SimpleAudioEngine() {
+    LOGI("Shutting down SimpleAudioEngine");
 
-        case EnvelopeState::RELEASE: {
-            if (timeInState >= RELEASE_TIME) {
-                return 0.0;
-            }
-            double progress = timeInState / RELEASE_TIME;
-            return SUSTAIN_LEVEL * std::exp(-3.0 * progress);
-        }
+    {
+        std::lock_guard<std::mutex> lock(resumeLock);
+        resumeRunning = false;
+    }
+    resumeSignal.notify_all();
+    resumeThread.join();
 
-        case EnvelopeState::DONE:
-            return 0.0;
+    {
+        std::lock_guard<std::mutex> lock(streamLock);
+        closeStream();
     }
 
-    return 0.0;
+    // The callback is no longer running, so the voices can be cleared here
+    synth.reset();
+
+    LOGI("SimpleAudioEngine destroyed");
 }
 
-oboe::DataCallbackResult SimpleAudioEngine::onAudioReady(
-    oboe::AudioStream *audioStream,
-    void *audioData,
-    int32_t numFrames) {
+void SimpleAudioEngine::playNote(int midiNote) {
+    playNotePolyphonic(midiNote);
+}
 
-    float *outputBuffer = static_cast<float *>(audioData);
-    std::fill_n(outputBuffer, numFrames, 0.0f);
+void SimpleAudioEngine::stopNote() {
+    stopAllNotes();
+}
 
-    // try_lock: never block the audio thread - skip frame if UI has the lock
-    if (!notesMutex.try_lock()) {
-        return oboe::DataCallbackResult::Continue;
+void SimpleAudioEngine::playNotePolyphonic(int midiNote) {
+    if (!streamOpen.load(std::memory_order_relaxed)) {
+        LOGE("Cannot play note - audio stream not initialized");
+        return;
     }
 
-    if (activeNotes.empty()) {
-        notesMutex.unlock();
-        return oboe::DataCallbackResult::Continue;
+    logIfDropped(synth.postNoteOn(midiNote, synth.eventFrameNow()), midiNote);
+    wake();
+}
+
+void SimpleAudioEngine::playNotePolyphonic(int midiNote, float pan) {
+    if (!streamOpen.load(std::memory_order_relaxed)) {
+        LOGE("Cannot play note - audio stream not initialized");
+        return;
     }
 
-    double currentTime = getCurrentTime();
+    logIfDropped(synth.postNoteOn(midiNote, synth.eventFrameNow(), pan), midiNote);
+    wake();
+}
+
+void SimpleAudioEngine::setEqualTuning(int divisions, int rootNote) {
+    TuningScale scale = TuningScale::equalDivisions(divisions);
+    scale.rootNote = rootNote;
+    synth.getTuning().setScale(scale);
+    LOGI("Tuning: %d-EDO, root %d", std::max(1, divisions), rootNote);
+}
 
-    int activeCount = 0;
-    for (auto& p : activeNotes) {
-        if (!p.second->isReleasing) activeCount++;
+bool SimpleAudioEngine::loadScalaTuning(const std::string &path, int rootNote) {
+    TuningScale scale;
+    if (!TuningScale::loadScala(path, scale)) {
+        LOGE("Not a valid Scala scale: %s", path.c_str());
+        return false;
     }
-    const double volumePerNote = 0.7 / std::max(1.0, std::sqrt(static_cast<double>(std::max(1, activeCount))));
+    scale.rootNote = rootNote;
+    synth.getTuning().setScale(scale);
+    LOGI("Tuning: %zu-note scale from %s, root %d", scale.cents.size(), path.c_str(),
+         rootNote);
+    return true;
+}
 
-    std::vector<int> notesToRemove;
+void SimpleAudioEngine::setTuningRoot(int rootNote) {
+    TuningScale scale = synth.getTuning().getScale();
+    scale.rootNote = rootNote;
+    synth.getTuning().setScale(scale);
+}
 
-    for (auto& pair : activeNotes) {
-        auto& noteData = pair.second;
+void SimpleAudioEngine::setVoiceFilter(bool enabled, float cutoffOctaves, float resonance) {
+    synth.setFilter(enabled, cutoffOctaves, resonance);
+}
 
-        double timeInState = currentTime - noteData->stateStartTime;
+void SimpleAudioEngine::setGlide(float seconds) {
+    synth.setGlide(seconds);
+}
 
-        if (noteData->state == EnvelopeState::ATTACK && timeInState >= ATTACK_TIME) {
-            noteData->state = EnvelopeState::DECAY;
-            noteData->stateStartTime = currentTime;
-        } else if (noteData->state == EnvelopeState::DECAY && timeInState >= DECAY_TIME) {
-            noteData->state = EnvelopeState::SUSTAIN;
-            noteData->stateStartTime = currentTime;
-        } else if (noteData->state == EnvelopeState::RELEASE && timeInState >= RELEASE_TIME) {
-            notesToRemove.push_back(noteData->midiNote);
-            continue;
-        }
+void SimpleAudioEngine::setVibrato(float rateHz, float depthSemitones) {
+    synth.setVibrato(rateHz, depthSemitones);
+}
 
-        double envelope = calculateEnvelope(noteData, currentTime);
+void SimpleAudioEngine::pitchBend(int midiNote, float semitones) {
+    logIfDropped(synth.postPitchBend(midiNote, synth.eventFrameNow(), semitones), midiNote);
+    wake();
+}
 
-        if (noteData->isReleasing && envelope <= 0.001) {
-            notesToRemove.push_back(noteData->midiNote);
-            continue;
-        }
+void SimpleAudioEngine::pressure(int midiNote, float amount) {
+    logIfDropped(synth.postPressure(midiNote, synth.eventFrameNow(), amount), midiNote);
+    wake();
+}
 
-        double phaseIncrement = TWO_PI * noteData->frequency / SAMPLE_RATE;
-        float envVol = static_cast<float>(envelope * volumePerNote);
+void SimpleAudioEngine::setEventBuffer(const void *buffer, size_t bytes) {
+    eventRing.attach(buffer, bytes);
+    LOGI("Event ring: %d records", eventRing.capacity());
+}
 
-        for (int32_t i = 0; i < numFrames; ++i) {
-            int idx = static_cast<int>(noteData->phase * WAVE_TABLE_SCALE) & WAVE_TABLE_MASK;
-            outputBuffer[i] += waveTable[idx] * envVol;
+int SimpleAudioEngine::submitEvents(int count) {
+    if (!streamOpen.load(std::memory_order_relaxed)) {
+        // Keep reading in step with the writer
+        eventRing.skip(count);
+        LOGE("Cannot play notes - audio stream not initialized");
+        return 0;
+    }
+    const int queued = eventRing.submit(synth, count);
+    if (queued < count) {
+        LOGE("Note event queue full - dropped %d of %d batched events", count - queued, count);
+    }
+    if (queued > 0) {
+        wake();
+    }
+    return queued;
+}
+
+void SimpleAudioEngine::stopNotePolyphonic(int midiNote) {
+    logIfDropped(synth.postNoteOff(midiNote, synth.eventFrameNow()), midiNote);
+    wake();
+}
+
+void SimpleAudioEngine::stopAllNotes() {
+    logIfDropped(synth.postAllNotesOff(synth.eventFrameNow()), -1);
+    wake();
+}
+
+void SimpleAudioEngine::scheduleNoteOn(int midiNote, int64_t frame) {
+    logIfDropped(synth.postNoteOn(midiNote, frame), midiNote);
+    wake();
+}
+
+void SimpleAudioEngine::scheduleNoteOff(int midiNote, int64_t frame) {
+    logIfDropped(synth.postNoteOff(midiNote, frame), midiNote);
+    wake();
+}
+
+void SimpleAudioEngine::logIfDropped(bool posted, int midiNote) {
+    if (!posted) {
+        LOGE("Note event queue full - dropping event for note %d", midiNote);
+    }
+}
+
+oboe::DataCallbackResult SimpleAudioEngine::onAudioReady(
+    oboe::AudioStream *audioStream,
+    void *audioData,
+    int32_t numFrames) {
 
-            noteData->phase += phaseIncrement;
-            if (noteData->phase >= TWO_PI) {
-                noteData->phase -= TWO_PI;
-            }
+    const bool traced = tracing.load(std::memory_order_relaxed);
+    if (traced) {
+        Trace::beginSection("OngomaRender");
+    }
+
+    const bool resuming = resumeNanos.load(std::memory_order_relaxed) != 0;
+    const int64_t startNanos = resuming ? SynthCore::nowNanos() : 0;
+
+    float *output = static_cast<float *>(audioData);
+    if (deviceChannels <= SynthCore::MAX_CHANNELS) {
+        synth.render(output, numFrames);
+    } else {
+        renderMultichannel(output, numFrames);
+    }
+    if (resuming) {
+        measureResume(output, numFrames, startNanos);
+    }
+
+    if (latencyTuner) {
+        latencyTuner->tune();
+    }
+
+    const oboe::DataCallbackResult result =
+        synth.isIdle() ? suspendIfIdle() : oboe::DataCallbackResult::Continue;
+    if (traced) {
+        Trace::endSection();
+    }
+    return result;
+}
+
+// Audio thread: records the time from wake() to the first sample of sound
+// in this buffer, if it has any
+void SimpleAudioEngine::measureResume(const float *output, int32_t numFrames,
+                                      int64_t callbackNanos) {
+    const int32_t samples = numFrames * deviceChannels;
+    for (int32_t i = 0; i < samples; i++) {
+        if (output[i] != 0.0f) {
+            const int64_t offsetNanos = static_cast<int64_t>(i / deviceChannels) *
+                                        1000000000LL / synth.getSampleRate();
+            synth.getStats().recordResume(callbackNanos + offsetNanos -
+                                          resumeNanos.load(std::memory_order_relaxed));
+            resumeNanos.store(0, std::memory_order_relaxed);
+            return;
         }
     }
+    // Woken by an event that made no sound
+    if (synth.isIdle()) {
+        resumeNanos.store(0, std::memory_order_relaxed);
+    }
+}
 
-    for (int midiNote : notesToRemove) {
-        activeNotes.erase(midiNote);
+// Audio thread, while the synth is idle: Stop once it has been idle for
+// idleSuspendSeconds, leaving the stream open for wake()
+oboe::DataCallbackResult SimpleAudioEngine::suspendIfIdle() {
+    const float seconds = idleSuspendSeconds.load(std::memory_order_relaxed);
+    if (seconds <= 0.0f || recorder.isRecording() ||
+        synth.getIdleFrames() < static_cast<int64_t>(seconds * synth.getSampleRate())) {
+        return oboe::DataCallbackResult::Continue;
     }
+    suspended.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (synth.hasQueuedEvents() || synth.getSequencer().isPlaying()) {
+        // Something was posted after render() looked; its wake() may or may
+        // not have seen the flag, so keep running
+        suspended.store(false, std::memory_order_relaxed);
+        return oboe::DataCallbackResult::Continue;
+    }
+    synth.suspend();
+    synth.getStats().countSuspend();
+    return oboe::DataCallbackResult::Stop;
+}
 
-    notesMutex.unlock();
-    return oboe::DataCallbackResult::Continue;
+void SimpleAudioEngine::renderMultichannel(float *output, int32_t numFrames) {
+    for (int32_t offset = 0; offset < numFrames; offset += MULTICHANNEL_CHUNK) {
+        const int32_t n = std::min(MULTICHANNEL_CHUNK, numFrames - offset);
+        synth.render(stereoScratch, n);
+        float *frame = output + static_cast<size_t>(offset) * deviceChannels;
+        for (int32_t i = 0; i < n; i++, frame += deviceChannels) {
+            frame[0] = stereoScratch[2 * i];
+            frame[1] = stereoScratch[2 * i + 1];
+            std::fill(frame + 2, frame + deviceChannels, 0.0f);
+        }
+    }
 }
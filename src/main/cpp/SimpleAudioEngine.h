@@ -2,25 +2,27 @@
  * kwada (C) 2026
  * Author: phedwin
  *
- * Audio engine header with ADSR envelope definitions
+ * Oboe output stream driving the synth core
  */
 
 #pragma once
 
-#include <android/log.h>
 #include <atomic>
 #include <chrono>
-#include <cmath>
+#include <condition_variable>
 #include <jni.h>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <oboe/Oboe.h>
-#include <vector>
+#include <string>
+#include <thread>
 
-#define LOG_TAG "OngomaAudioEngine"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#include "ConvolutionReverb.h"
+#include "EventRing.h"
+#include "OutputRecorder.h"
+#include "SampleLibrary.h"
+#include "StreamingSampler.h"
+#include "SynthCore.h"
 
 class SimpleAudioEngine : public oboe::AudioStreamDataCallback {
 public:
@@ -29,68 +31,176 @@ public:
 
   void initialize();
 
+  // Opt-in: request an exclusive (MMAP) stream, falling back to shared,
+  // tune the buffer down to the smallest size that does not underrun, and
+  // enable ADPF performance hints. Reopens the stream if it is running.
+  void setLowLatencyMode(bool enabled);
+
+  // Opt-in: render the wavetable voices across a pool of pinned worker
+  // threads (one per spare core, at most 3) as well as the callback thread.
+  // A no-op on single-core devices. Restarts the stream if it is running.
+  void setMultiCoreRendering(bool enabled);
+
+  // Switches notes from the wavetable voices to the zones in a sample map
+  // (see SampleLibrary::loadMap). Files are memory-mapped and streamed, so
+  // large libraries are fine. Restarts the stream if it is running; returns
+  // false and keeps the current sound if the map has no usable zones.
+  bool loadSampleMap(const std::string &mapPath);
+  // Back to the wavetable voices
+  void clearSamples();
+
+  // Convolution reverb on the master output, from an impulse-response WAV
+  // of up to ConvolutionReverb::MAX_SECONDS. Restarts the stream if it is
+  // running; returns false and keeps the current reverb if the file cannot
+  // be read.
+  bool loadReverb(const std::string &impulsePath);
+  void clearReverb();
+  // Linear gain of the reverb on top of the dry signal
+  void setReverbLevel(float level);
+
   void playNote(int midiNote);
   void stopNote();
 
   void playNotePolyphonic(int midiNote);
+  // pan: -1 hard left .. +1 hard right, e.g. the key's horizontal position
+  void playNotePolyphonic(int midiNote, float pan);
   void stopNotePolyphonic(int midiNote);
   void stopAllNotes();
 
-  double getCurrentTime();
-
-  static constexpr int SAMPLE_RATE = 48000;
-  static constexpr double TWO_PI = 2.0 * M_PI;
-  static constexpr int MAX_POLYPHONY = 24;
+  // Tuning for notes struck from now on (see TuningScale); any thread.
+  // setEqualTuning(12, 60) is the default 12-TET.
+  void setEqualTuning(int divisions, int rootNote);
+  // Returns false and keeps the current tuning if the file is not valid Scala
+  bool loadScalaTuning(const std::string &path, int rootNote);
+  // Moves the root of the current scale, keeping the new root at its 12-TET pitch
+  void setTuningRoot(int rootNote);
+
+  // Per-voice low-pass; cutoff in octaves above each note. Any thread.
+  void setVoiceFilter(bool enabled, float cutoffOctaves, float resonance);
+
+  // Portamento time for newly struck notes, 0 for none; any thread
+  void setGlide(float seconds);
+  // Shared vibrato; depth in semitones, 0 for none. Any thread.
+  void setVibrato(float rateHz, float depthSemitones);
+  // Per-note expression (MPE-style) for a sounding note, or every note
+  // with midiNote -1: bend in semitones, pressure 0..1
+  void pitchBend(int midiNote, float semitones);
+  void pressure(int midiNote, float amount);
+
+  // Batched events: `buffer` is the direct ByteBuffer ring Kotlin writes
+  // PackedNoteEvent records into (see EventRing); it must stay alive until
+  // replaced or cleared with nullptr. submitEvents() posts the next `count`
+  // records in one go and returns how many were queued.
+  void setEventBuffer(const void *buffer, size_t bytes);
+  int submitEvents(int count);
+
+  // Sample-accurate variants: the event lands exactly at the given render
+  // frame (or at the start of the next buffer if that frame already passed)
+  void scheduleNoteOn(int midiNote, int64_t frame);
+  void scheduleNoteOff(int midiNote, int64_t frame);
+
+  // Records the output from the next buffer on to a WAV file (24-bit PCM or
+  // 32-bit float) through a FIFO and a background writer, so the callback
+  // never touches the disk. Reopening the stream ends the recording.
+  bool startRecording(const std::string &path, bool pcm24);
+  // Stops, flushes and closes the file; false if any write failed
+  bool stopRecording();
+  OutputRecorder &getRecorder() { return recorder; }
 
-  static constexpr double ATTACK_TIME = 0.008;
-  static constexpr double DECAY_TIME = 0.15;
-  static constexpr double SUSTAIN_LEVEL = 0.6;
-  static constexpr double RELEASE_TIME = 2.0;
+  double getCurrentTime();
+  int64_t getFramePosition() const;
 
-  static constexpr double HARMONIC_1_AMP = 1.0;
-  static constexpr double HARMONIC_2_AMP = 0.4;
-  static constexpr double HARMONIC_3_AMP = 0.2;
-  static constexpr double HARMONIC_4_AMP = 0.1;
+  // Fills EngineStats::COUNT values (see EngineStats::Index)
+  void getStats(int64_t *out);
 
-  static constexpr int WAVE_TABLE_SIZE = 4096;
-  static constexpr int WAVE_TABLE_MASK = WAVE_TABLE_SIZE - 1;
-  static constexpr double WAVE_TABLE_SCALE =
-      static_cast<double>(WAVE_TABLE_SIZE) / TWO_PI;
-  static float waveTable[WAVE_TABLE_SIZE];
+  // Stops the stream once the synth has sat on its silent fast path (see
+  // SynthCore::isIdle()) for `seconds`, 0 for never; any thread. The stream
+  // stays open and restarts on the next event, and the time from that event
+  // to the first sound is kept in EngineStats (RESUMES, *_RESUME_NANOS).
+  // Never while recording.
+  void setIdleSuspend(float seconds);
+  // Restarts a suspended stream. Never blocks on Oboe: the restart is handed
+  // to the engine's resume thread and the queued event plays from its first
+  // buffer. Every note, expression and event-ring call here does this itself;
+  // call it after driving the synth or sequencer directly (e.g.
+  // Sequencer::play()).
+  void wake();
 
-  void initWaveTable();
+  // Emits systrace/Perfetto sections from the audio callback. Off by
+  // default; when off the probes cost one predictable branch.
+  void setTracingEnabled(bool enabled);
 
-private:
+  // Tuning constants live with the core; re-exported for existing callers
+  static constexpr int SAMPLE_RATE = SynthCore::SAMPLE_RATE;
+  static constexpr int MAX_POLYPHONY = SynthCore::MAX_POLYPHONY;
 
-  enum class EnvelopeState { ATTACK, DECAY, SUSTAIN, RELEASE, DONE };
+  SynthCore &getSynth() { return synth; }
 
-  struct NoteData {
-    int midiNote;
-    double frequency;
-    double phase;
-    EnvelopeState state;
-    double stateStartTime;
-    double noteStartTime;
-    bool isReleasing;
-    uint64_t noteId;
+  // Pattern playback from inside the callback; any thread
+  Sequencer &getSequencer() { return synth.getSequencer(); }
 
-    NoteData(int note, double freq, double startTime, uint64_t id)
-        : midiNote(note), frequency(freq), phase(0.0),
-          state(EnvelopeState::ATTACK), stateStartTime(startTime),
-          noteStartTime(startTime), isReleasing(false), noteId(id) {}
-  };
+  // Master/send effects; any thread, glitch-free while playing
+  EffectsBus &getEffectsBus() { return synth.getEffectsBus(); }
 
-  std::map<int, std::shared_ptr<NoteData>> activeNotes;
-  std::mutex notesMutex;
-  uint64_t nextNoteId = 0;
+private:
+  // Frames rendered per pass when the device has more than two channels
+  static constexpr int32_t MULTICHANNEL_CHUNK = 256;
+  static constexpr float DEFAULT_IDLE_SUSPEND_SECONDS = 30.0f;
+  // Longest the resume thread waits for a stopping stream before restarting it
+  static constexpr int64_t RESUME_WAIT_NANOS = 100000000;
+
+  SynthCore synth;
+  // Declared library first so the sampler (and its prefetch thread) goes first
+  std::unique_ptr<SampleLibrary> sampleLibrary;
+  std::unique_ptr<StreamingSampler> sampler;
+  std::unique_ptr<VoiceWorkerPool> workerPool;
+  OutputRecorder recorder;
+  EventRing eventRing;
+  // Rebuilt for the stream's rate and channel count by startStream()
+  ImpulseResponse reverbImpulse;
+  std::unique_ptr<ConvolutionReverb> reverb;
+  float reverbLevel = 0.5f;
 
   std::shared_ptr<oboe::AudioStream> audioStream;
+  // Whether audioStream is open, for the note calls that check it without
+  // streamLock; written under the lock
+  std::atomic<bool> streamOpen{false};
+  std::unique_ptr<oboe::LatencyTuner> latencyTuner;
+  bool lowLatencyMode = false;
+  int32_t deviceChannels = 1;
+  std::atomic<bool> tracing{false};
+  std::atomic<float> idleSuspendSeconds{DEFAULT_IDLE_SUSPEND_SECONDS};
+  // Held while the stream is opened, closed or restarted, which the resume
+  // thread and the JNI threads that reopen the stream may do at once; also
+  // guards the reverb and its level, which are rebuilt with the stream
+  std::mutex streamLock;
+  // Set by the callback when it stops the stream, cleared by the resume thread
+  std::atomic<bool> suspended{false};
+  // When wake() asked for a restart, until the callback sees sound (0: not
+  // measuring)
+  std::atomic<int64_t> resumeNanos{0};
+  std::thread resumeThread;
+  std::mutex resumeLock;
+  std::condition_variable resumeSignal;
+  bool resumeRequested = false;
+  bool resumeRunning = true;
+  float stereoScratch[SynthCore::MAX_CHANNELS * MULTICHANNEL_CHUNK];
 
   std::chrono::steady_clock::time_point engineStartTime;
 
-  double midiNoteToFrequency(int midiNote);
-  double calculateEnvelope(const std::shared_ptr<NoteData> &noteData,
-                           double currentTime);
+  // Callers hold streamLock
+  void startStream();
+  oboe::Result openStream(oboe::SharingMode sharingMode);
+  void closeStream();
+  void replaceSamples(std::unique_ptr<SampleLibrary> library);
+  void replaceReverb(ImpulseResponse impulse);
+  void rebuildReverb();
+  void logIfDropped(bool posted, int midiNote);
+  void renderMultichannel(float *output, int32_t numFrames);
+  void measureResume(const float *output, int32_t numFrames, int64_t callbackNanos);
+  oboe::DataCallbackResult suspendIfIdle();
+  void resumeLoop();
+  void resumeStream();
 
   oboe::DataCallbackResult onAudioReady(oboe::AudioStream *audioStream,
                                         void *audioData,
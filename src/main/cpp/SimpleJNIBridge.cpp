@@ -5,13 +5,13 @@
  * JNI bindings for native audio engine
  */
 
-#include <android/log.h>
+#include <algorithm>
 #include <jni.h>
+#include <vector>
 #include "SimpleAudioEngine.h"
 
 #define LOG_TAG "JNIBridge"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#include "Log.h"
 
 static SimpleAudioEngine *g_engine = nullptr;
 
@@ -57,9 +57,7 @@ Java_com_ongoma_AudioEngine_nativeStopNote(JNIEnv *env, jobject thiz) {
 
 JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativePlayNotePolyphonic(
     JNIEnv *env, jobject thiz, jint midiNote) {
-	LOGI("nativePlayNotePolyphonic called with MIDI=%d", midiNote);
 	if (g_engine != nullptr) {
-		LOGI("Engine exists, calling playNotePolyphonic(%d)", midiNote);
 		g_engine->playNotePolyphonic(static_cast<int>(midiNote));
 	} else {
 		LOGE(
@@ -68,6 +66,14 @@ JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativePlayNotePolyphonic(
 	}
 }
 
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativePlayNotePanned(
+    JNIEnv *env, jobject thiz, jint midiNote, jfloat pan) {
+	if (g_engine != nullptr) {
+		g_engine->playNotePolyphonic(static_cast<int>(midiNote),
+					     static_cast<float>(pan));
+	}
+}
+
 JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeStopNotePolyphonic(
     JNIEnv *env, jobject thiz, jint midiNote) {
 	if (g_engine != nullptr) {
@@ -75,6 +81,35 @@ JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeStopNotePolyphonic(
 	}
 }
 
+// eventBuffer: a direct ByteBuffer in native byte order holding a ring of
+// 16-byte records (see PackedNoteEvent), or null to detach. Keep a
+// reference to it on the Kotlin side for as long as it is attached.
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetEventBuffer(
+    JNIEnv *env, jobject thiz, jobject eventBuffer) {
+	if (g_engine == nullptr) {
+		return;
+	}
+	void *base = eventBuffer != nullptr
+			 ? env->GetDirectBufferAddress(eventBuffer)
+			 : nullptr;
+	const jlong bytes =
+	    base != nullptr ? env->GetDirectBufferCapacity(eventBuffer) : 0;
+	if (eventBuffer != nullptr && (base == nullptr || bytes <= 0)) {
+		LOGE("Event buffer must be a direct ByteBuffer");
+	}
+	g_engine->setEventBuffer(base, static_cast<size_t>(std::max<jlong>(bytes, 0)));
+}
+
+// Posts the next `count` records of the event ring (a chord is one call);
+// returns how many were queued
+JNIEXPORT jint JNICALL Java_com_ongoma_AudioEngine_nativeSubmitEvents(
+    JNIEnv *env, jobject thiz, jint count) {
+	if (g_engine == nullptr) {
+		return 0;
+	}
+	return static_cast<jint>(g_engine->submitEvents(static_cast<int>(count)));
+}
+
 JNIEXPORT void JNICALL
 Java_com_ongoma_AudioEngine_nativeStopAllNotes(JNIEnv *env, jobject thiz) {
 	if (g_engine != nullptr) {
@@ -82,6 +117,346 @@ Java_com_ongoma_AudioEngine_nativeStopAllNotes(JNIEnv *env, jobject thiz) {
 	}
 }
 
+// Returns EngineStats::COUNT longs laid out as EngineStats::Index, or null
+// before the engine exists
+JNIEXPORT jlongArray JNICALL
+Java_com_ongoma_AudioEngine_nativeGetStats(JNIEnv *env, jobject thiz) {
+	if (g_engine == nullptr) {
+		return nullptr;
+	}
+	int64_t values[EngineStats::COUNT];
+	g_engine->getStats(values);
+	jlongArray result = env->NewLongArray(EngineStats::COUNT);
+	if (result != nullptr) {
+		env->SetLongArrayRegion(result, 0, EngineStats::COUNT,
+					reinterpret_cast<const jlong *>(values));
+	}
+	return result;
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetLowLatencyMode(
+    JNIEnv *env, jobject thiz, jboolean enabled) {
+	if (g_engine != nullptr) {
+		g_engine->setLowLatencyMode(enabled == JNI_TRUE);
+	}
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetMultiCoreRendering(
+    JNIEnv *env, jobject thiz, jboolean enabled) {
+	if (g_engine != nullptr) {
+		g_engine->setMultiCoreRendering(enabled == JNI_TRUE);
+	}
+}
+
+// divisions equal steps per octave, degree 0 on rootNote
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetEqualTuning(
+    JNIEnv *env, jobject thiz, jint divisions, jint rootNote) {
+	if (g_engine != nullptr) {
+		g_engine->setEqualTuning(static_cast<int>(divisions),
+					 static_cast<int>(rootNote));
+	}
+}
+
+// Returns false (keeping the current tuning) if the .scl file is invalid
+JNIEXPORT jboolean JNICALL Java_com_ongoma_AudioEngine_nativeLoadScalaTuning(
+    JNIEnv *env, jobject thiz, jstring scalaPath, jint rootNote) {
+	if (g_engine == nullptr || scalaPath == nullptr) {
+		return JNI_FALSE;
+	}
+	const char *path = env->GetStringUTFChars(scalaPath, nullptr);
+	if (path == nullptr) {
+		return JNI_FALSE;
+	}
+	const bool loaded =
+	    g_engine->loadScalaTuning(path, static_cast<int>(rootNote));
+	env->ReleaseStringUTFChars(scalaPath, path);
+	return loaded ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetTuningRoot(
+    JNIEnv *env, jobject thiz, jint rootNote) {
+	if (g_engine != nullptr) {
+		g_engine->setTuningRoot(static_cast<int>(rootNote));
+	}
+}
+
+// cutoffOctaves above each note's pitch; resonance 0..1
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetVoiceFilter(
+    JNIEnv *env, jobject thiz, jboolean enabled, jfloat cutoffOctaves,
+    jfloat resonance) {
+	if (g_engine != nullptr) {
+		g_engine->setVoiceFilter(enabled == JNI_TRUE,
+					 static_cast<float>(cutoffOctaves),
+					 static_cast<float>(resonance));
+	}
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetGlide(
+    JNIEnv *env, jobject thiz, jfloat seconds) {
+	if (g_engine != nullptr) {
+		g_engine->setGlide(static_cast<float>(seconds));
+	}
+}
+
+// depthSemitones 0 turns vibrato off
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetVibrato(
+    JNIEnv *env, jobject thiz, jfloat rateHz, jfloat depthSemitones) {
+	if (g_engine != nullptr) {
+		g_engine->setVibrato(static_cast<float>(rateHz),
+				     static_cast<float>(depthSemitones));
+	}
+}
+
+// midiNote -1 bends every note
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativePitchBend(
+    JNIEnv *env, jobject thiz, jint midiNote, jfloat semitones) {
+	if (g_engine != nullptr) {
+		g_engine->pitchBend(static_cast<int>(midiNote),
+				    static_cast<float>(semitones));
+	}
+}
+
+// pressure 0..1; midiNote -1 for every note
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativePressure(
+    JNIEnv *env, jobject thiz, jint midiNote, jfloat pressure) {
+	if (g_engine != nullptr) {
+		g_engine->pressure(static_cast<int>(midiNote),
+				   static_cast<float>(pressure));
+	}
+}
+
+// Returns true if the map had at least one playable zone
+JNIEXPORT jboolean JNICALL Java_com_ongoma_AudioEngine_nativeLoadSampleMap(
+    JNIEnv *env, jobject thiz, jstring mapPath) {
+	if (g_engine == nullptr || mapPath == nullptr) {
+		return JNI_FALSE;
+	}
+	const char *path = env->GetStringUTFChars(mapPath, nullptr);
+	if (path == nullptr) {
+		return JNI_FALSE;
+	}
+	const bool loaded = g_engine->loadSampleMap(path);
+	env->ReleaseStringUTFChars(mapPath, path);
+	return loaded ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeClearSamples(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine != nullptr) {
+		g_engine->clearSamples();
+	}
+}
+
+// Returns false and keeps the current reverb if the WAV cannot be read
+JNIEXPORT jboolean JNICALL Java_com_ongoma_AudioEngine_nativeLoadReverb(
+    JNIEnv *env, jobject thiz, jstring impulsePath) {
+	if (g_engine == nullptr || impulsePath == nullptr) {
+		return JNI_FALSE;
+	}
+	const char *path = env->GetStringUTFChars(impulsePath, nullptr);
+	if (path == nullptr) {
+		return JNI_FALSE;
+	}
+	const bool loaded = g_engine->loadReverb(path);
+	env->ReleaseStringUTFChars(impulsePath, path);
+	return loaded ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeClearReverb(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine != nullptr) {
+		g_engine->clearReverb();
+	}
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetReverbLevel(
+    JNIEnv *env, jobject thiz, jfloat level) {
+	if (g_engine != nullptr) {
+		g_engine->setReverbLevel(static_cast<float>(level));
+	}
+}
+
+// Stops the stream after this many seconds of silence (0: never); the next
+// note restarts it
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetIdleSuspend(
+    JNIEnv *env, jobject thiz, jfloat seconds) {
+	if (g_engine != nullptr) {
+		g_engine->setIdleSuspend(seconds);
+	}
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetTracingEnabled(
+    JNIEnv *env, jobject thiz, jboolean enabled) {
+	if (g_engine != nullptr) {
+		g_engine->setTracingEnabled(enabled == JNI_TRUE);
+	}
+}
+
+// types: EffectSpec::Type per effect; params: EffectSpec::MAX_PARAMS floats
+// per effect, in the order of the EffectSpec builders
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetEffectChain(
+    JNIEnv *env, jobject thiz, jboolean send, jintArray types, jfloatArray params) {
+	if (g_engine == nullptr || types == nullptr || params == nullptr) {
+		return;
+	}
+	const jsize count = env->GetArrayLength(types);
+	if (env->GetArrayLength(params) < count * EffectSpec::MAX_PARAMS) {
+		LOGE("nativeSetEffectChain: %d effects need %d params", count,
+		     count * EffectSpec::MAX_PARAMS);
+		return;
+	}
+	std::vector<jint> typeValues(count);
+	std::vector<jfloat> paramValues(count * EffectSpec::MAX_PARAMS);
+	env->GetIntArrayRegion(types, 0, count, typeValues.data());
+	env->GetFloatArrayRegion(params, 0, count * EffectSpec::MAX_PARAMS,
+				 paramValues.data());
+
+	std::vector<EffectSpec> chain;
+	for (jsize i = 0; i < count; i++) {
+		if (typeValues[i] < 0 ||
+		    typeValues[i] >= static_cast<jint>(EffectSpec::Type::COUNT)) {
+			LOGE("nativeSetEffectChain: unknown effect type %d", typeValues[i]);
+			continue;
+		}
+		EffectSpec spec;
+		spec.type = static_cast<EffectSpec::Type>(typeValues[i]);
+		for (int p = 0; p < EffectSpec::MAX_PARAMS; p++) {
+			spec.params[p] = paramValues[i * EffectSpec::MAX_PARAMS + p];
+		}
+		chain.push_back(spec);
+	}
+	if (send == JNI_TRUE) {
+		g_engine->getEffectsBus().setSendChain(chain);
+	} else {
+		g_engine->getEffectsBus().setMasterChain(chain);
+	}
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetEffectLevels(
+    JNIEnv *env, jobject thiz, jfloat sendLevel, jfloat outputGain) {
+	if (g_engine != nullptr) {
+		g_engine->getEffectsBus().setSendLevel(sendLevel);
+		g_engine->getEffectsBus().setOutputGain(outputGain);
+	}
+}
+
+// events: SEQUENCER_EVENT_INTS ints per event (track, tick, type, number,
+// velocity; type and number as in SequencerEvent); values: one float per
+// event (pan for notes, the level for controls)
+static constexpr int SEQUENCER_EVENT_INTS = 5;
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSetPattern(
+    JNIEnv *env, jobject thiz, jdouble tempo, jint lengthTicks, jboolean loop,
+    jintArray events, jfloatArray values) {
+	if (g_engine == nullptr || events == nullptr || values == nullptr) {
+		return;
+	}
+	const jsize count = env->GetArrayLength(values);
+	if (env->GetArrayLength(events) < count * SEQUENCER_EVENT_INTS) {
+		LOGE("nativeSetPattern: %d events need %d ints", count,
+		     count * SEQUENCER_EVENT_INTS);
+		return;
+	}
+	std::vector<jint> ints(count * SEQUENCER_EVENT_INTS);
+	std::vector<jfloat> floats(count);
+	env->GetIntArrayRegion(events, 0, count * SEQUENCER_EVENT_INTS, ints.data());
+	env->GetFloatArrayRegion(values, 0, count, floats.data());
+
+	SequencerPattern pattern;
+	pattern.tempo = tempo;
+	pattern.lengthTicks = lengthTicks;
+	pattern.loop = loop == JNI_TRUE;
+	for (jsize i = 0; i < count; i++) {
+		const jint *e = &ints[i * SEQUENCER_EVENT_INTS];
+		const jint track = e[0];
+		const jint type = e[2];
+		if (track < 0 || track > 255 || type < 0 ||
+		    type > static_cast<jint>(SequencerEvent::Type::NOTE_ON)) {
+			LOGE("nativeSetPattern: bad event (track %d, type %d)", track, type);
+			continue;
+		}
+		SequencerEvent event;
+		switch (static_cast<SequencerEvent::Type>(type)) {
+		case SequencerEvent::Type::NOTE_ON:
+			event = SequencerEvent::noteOn(e[1], e[3], e[4], floats[i]);
+			break;
+		case SequencerEvent::Type::NOTE_OFF:
+			event = SequencerEvent::noteOff(e[1], e[3]);
+			break;
+		case SequencerEvent::Type::CONTROL:
+			if (e[3] < 0 || e[3] >= static_cast<jint>(SequencerEvent::Control::COUNT)) {
+				continue;
+			}
+			event = SequencerEvent::control(
+			    e[1], static_cast<SequencerEvent::Control>(e[3]), floats[i]);
+			break;
+		}
+		if (static_cast<size_t>(track) >= pattern.tracks.size()) {
+			pattern.tracks.resize(track + 1);
+		}
+		pattern.tracks[track].events.push_back(event);
+	}
+	g_engine->getSequencer().setPattern(pattern);
+}
+
+// Starts the pattern from its first tick, right away
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSequencerPlay(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine != nullptr) {
+		g_engine->getSequencer().play(g_engine->getSynth().eventFrameNow());
+		g_engine->wake();
+	}
+}
+
+JNIEXPORT void JNICALL Java_com_ongoma_AudioEngine_nativeSequencerStop(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine != nullptr) {
+		g_engine->getSequencer().stop();
+	}
+}
+
+// Playhead in ticks (SequencerPattern::TICKS_PER_QUARTER per beat), -1 when stopped
+JNIEXPORT jlong JNICALL Java_com_ongoma_AudioEngine_nativeGetSequencerPosition(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine == nullptr) {
+		return -1;
+	}
+	return static_cast<jlong>(g_engine->getSequencer().getPositionTicks());
+}
+
+// format24Bit: 24-bit PCM, otherwise 32-bit float
+JNIEXPORT jboolean JNICALL Java_com_ongoma_AudioEngine_nativeStartRecording(
+    JNIEnv *env, jobject thiz, jstring filePath, jboolean format24Bit) {
+	if (g_engine == nullptr || filePath == nullptr) {
+		return JNI_FALSE;
+	}
+	const char *path = env->GetStringUTFChars(filePath, nullptr);
+	if (path == nullptr) {
+		return JNI_FALSE;
+	}
+	const bool started = g_engine->startRecording(path, format24Bit == JNI_TRUE);
+	env->ReleaseStringUTFChars(filePath, path);
+	return started ? JNI_TRUE : JNI_FALSE;
+}
+
+// Blocks until the file is flushed and closed
+JNIEXPORT jboolean JNICALL Java_com_ongoma_AudioEngine_nativeStopRecording(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine == nullptr) {
+		return JNI_FALSE;
+	}
+	return g_engine->stopRecording() ? JNI_TRUE : JNI_FALSE;
+}
+
+// Frames dropped because the writer fell behind; 0 for a clean take
+JNIEXPORT jlong JNICALL Java_com_ongoma_AudioEngine_nativeGetRecordingOverruns(
+    JNIEnv *env, jobject thiz) {
+	if (g_engine == nullptr) {
+		return 0;
+	}
+	return static_cast<jlong>(g_engine->getRecorder().getOverrunFrames());
+}
+
 JNIEXPORT jdouble JNICALL
 Java_com_ongoma_AudioEngine_nativeGetCurrentTime(JNIEnv *env, jobject thiz) {
 	if (g_engine != nullptr) {
@@ -0,0 +1,320 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Disk-streaming multi-sample voice engine
+ */
+
+#include "StreamingSampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "OscillatorKernel.h"
+
+namespace {
+
+// How long the prefetch thread naps when no ring needed topping up. A ring
+// holds RING_FRAMES (~340 ms at 48 kHz), so this is far inside the deadline.
+constexpr auto PREFETCH_IDLE = std::chrono::milliseconds(2);
+
+} // namespace
+
+StreamingSampler::StreamingSampler(const SampleLibrary &library) : library(library) {
+    setSampleRate(sampleRate);
+    prefetchThread = std::thread(&StreamingSampler::prefetchLoop, this);
+}
+
+StreamingSampler::~StreamingSampler() {
+    running.store(false, std::memory_order_relaxed);
+    prefetchThread.join();
+}
+
+void StreamingSampler::setSampleRate(int32_t rate) {
+    sampleRate = rate;
+    setReleaseTime(RELEASE_TIME);
+}
+
+void StreamingSampler::setReleaseTime(double seconds) {
+    // Samples carry their own attack and decay: sound at full level from the
+    // first frame and only shape the release
+    envelopeParams = EnvelopeParams::make(sampleRate, 0.0, 0.0, 1.0, seconds);
+}
+
+bool StreamingSampler::noteOn(int midiNote, int velocity, float pan) {
+    return noteOn(midiNote, velocity, pan, SampleLibrary::equalTemperedFrequency(midiNote));
+}
+
+bool StreamingSampler::noteOn(int midiNote, int velocity, float pan, double frequency) {
+    const SampleLibrary::Zone *zone = library.findZone(midiNote, velocity);
+    if (zone == nullptr) {
+        return false;
+    }
+
+    // A re-struck key lets the previous strike ring out under the new one
+    noteOff(midiNote);
+
+    Voice *voice = nullptr;
+    for (Voice &v : voices) {
+        if (!v.active) {
+            voice = &v;
+            break;
+        }
+    }
+    if (voice == nullptr) {
+        // Steal: prefer releasing voices, then the oldest
+        voice = &voices[0];
+        for (Voice &v : voices) {
+            const bool releasing = v.envelope.isReleasing();
+            if (releasing != voice->envelope.isReleasing() ? releasing
+                                                            : v.noteId < voice->noteId) {
+                voice = &v;
+            }
+        }
+        stopVoice(*voice);
+        stats->countSteal();
+    }
+
+    int stream = -1;
+    for (int s = 0; s < NUM_STREAMS; s++) {
+        if (streams[s].state.load(std::memory_order_acquire) == FREE) {
+            stream = s;
+            break;
+        }
+    }
+    if (stream < 0) {
+        return false;
+    }
+    streams[stream].zone = zone;
+    streams[stream].state.store(STARTING, std::memory_order_release);
+
+    voice->active = true;
+    voice->midiNote = midiNote;
+    voice->noteId = nextNoteId++;
+    voice->stream = stream;
+    voice->zone = zone;
+    voice->headFrame = 0;
+    voice->sourceDone = false;
+    voice->windowFrames = 0;
+    voice->position = 0.0;
+    voice->rate = std::min(MAX_PITCH_RATIO,
+                           frequency / zone->rootFrequency * zone->sampleRate / sampleRate);
+    const float gain = std::max(0, std::min(velocity, 127)) / 127.0f;
+    OscillatorKernel::panGains(pan, voice->gainLeft, voice->gainRight);
+    voice->gainLeft *= gain;
+    voice->gainRight *= gain;
+    voice->envelope = EnvelopeGenerator{};
+    voice->envelope.noteOn(envelopeParams);
+
+    activeVoices.store(activeVoices.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    return true;
+}
+
+void StreamingSampler::noteOff(int midiNote) {
+    for (Voice &v : voices) {
+        if (v.active && v.midiNote == midiNote) {
+            v.envelope.noteOff(envelopeParams);
+        }
+    }
+}
+
+void StreamingSampler::allNotesOff() {
+    for (Voice &v : voices) {
+        if (v.active) {
+            stopVoice(v);
+        }
+    }
+}
+
+void StreamingSampler::stopVoice(Voice &voice) {
+    // Hand the stream back; the prefetch thread resets and frees it
+    streams[voice.stream].state.store(STOPPING, std::memory_order_release);
+    voice.active = false;
+    voice.stream = -1;
+    activeVoices.store(activeVoices.load(std::memory_order_relaxed) - 1,
+                       std::memory_order_relaxed);
+}
+
+// Pulls the next numFrames source frames: the resident head first, then the
+// stream ring. Pads with silence on underrun or at the end of the sample.
+int32_t StreamingSampler::fetch(Voice &voice, float *stereo, int32_t numFrames) {
+    int32_t done = 0;
+
+    const int32_t headFrames = voice.zone->headFrames();
+    if (voice.headFrame < headFrames) {
+        done = std::min(numFrames, headFrames - voice.headFrame);
+        std::memcpy(stereo, voice.zone->head.data() + 2 * voice.headFrame,
+                    sizeof(float) * 2 * done);
+        voice.headFrame += done;
+    }
+
+    if (done < numFrames && !voice.sourceDone) {
+        Stream &stream = streams[voice.stream];
+        // Load before reading: if the tail was complete by then, a short read
+        // means the sample really has ended
+        const bool complete = stream.endOfStream.load(std::memory_order_acquire);
+        done += std::max(0, stream.ring.read(stereo + 2 * done, numFrames - done));
+        if (done < numFrames) {
+            if (complete || voice.headFrame >= voice.zone->frames) {
+                voice.sourceDone = true;
+            } else {
+                stats->countStreamUnderrun();
+            }
+        }
+    }
+
+    std::fill(stereo + 2 * done, stereo + 2 * numFrames, 0.0f);
+    return done;
+}
+
+void StreamingSampler::render(float *output, int32_t numFrames, int channels) {
+    int sounding = 0;
+    for (const Voice &v : voices) {
+        if (v.active && !v.envelope.isReleasing()) sounding++;
+    }
+    // Same headroom rule as the wavetable voices
+    const float gain = static_cast<float>(
+        0.7 / std::max(1.0, std::sqrt(static_cast<double>(std::max(1, sounding)))));
+
+    for (Voice &v : voices) {
+        for (int32_t offset = 0; v.active && offset < numFrames; offset += BLOCK_FRAMES) {
+            renderVoice(v, output + offset * channels,
+                        std::min(BLOCK_FRAMES, numFrames - offset), channels, gain);
+        }
+    }
+}
+
+void StreamingSampler::renderVoice(Voice &voice, float *output, int32_t numFrames,
+                                   int channels, float gain) {
+    // Source frames this block interpolates over, including the right-hand
+    // neighbour of the last output frame
+    const int32_t needed =
+        static_cast<int32_t>(voice.position + (numFrames - 1) * voice.rate) + 2;
+    if (needed > voice.windowFrames) {
+        fetch(voice, voice.window + 2 * voice.windowFrames, needed - voice.windowFrames);
+        voice.windowFrames = needed;
+    }
+
+    const float left = voice.gainLeft * gain;
+    const float right = voice.gainRight * gain;
+    EnvelopeGenerator &env = voice.envelope;
+    double position = voice.position;
+    for (int32_t i = 0; i < numFrames; i++) {
+        const int32_t index = static_cast<int32_t>(position);
+        const float frac = static_cast<float>(position - index);
+        const float *frame = voice.window + 2 * index;
+        const float sampleLeft = frame[0] + (frame[2] - frame[0]) * frac;
+        const float sampleRight = frame[1] + (frame[3] - frame[1]) * frac;
+
+        env.level = env.level * env.mul + env.add;
+        if (--env.framesLeft == 0) {
+            env.advance(envelopeParams);
+        }
+
+        if (channels == 2) {
+            output[2 * i] += sampleLeft * left * env.level;
+            output[2 * i + 1] += sampleRight * right * env.level;
+        } else {
+            output[i] += 0.5f * (sampleLeft * left + sampleRight * right) * env.level;
+        }
+
+        if (env.isDone()) {
+            stopVoice(voice);
+            return;
+        }
+        position += voice.rate;
+    }
+
+    // Drop the frames the read position has moved past
+    const int32_t consumed = std::min(static_cast<int32_t>(position), voice.windowFrames);
+    std::memmove(voice.window, voice.window + 2 * consumed,
+                 sizeof(float) * 2 * (voice.windowFrames - consumed));
+    voice.windowFrames -= consumed;
+    voice.position = position - consumed;
+
+    if (voice.sourceDone) {
+        stopVoice(voice);
+    }
+}
+
+void StreamingSampler::waitForPrefetch() {
+    for (Stream &stream : streams) {
+        for (;;) {
+            const int state = stream.state.load(std::memory_order_acquire);
+            if (state == FREE || state == STOPPING ||
+                stream.endOfStream.load(std::memory_order_acquire)) {
+                break;
+            }
+            // Same test topUp() uses to decide a whole block no longer fits
+            const uint32_t space = stream.ring.getBufferCapacityInFrames() -
+                                   stream.ring.getFullFramesAvailable();
+            if (state == STREAMING && space < static_cast<uint32_t>(PREFETCH_FRAMES)) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+void StreamingSampler::prefetchLoop() {
+    std::vector<float> scratch(2 * PREFETCH_FRAMES);
+    while (running.load(std::memory_order_relaxed)) {
+        bool busy = false;
+        for (Stream &stream : streams) {
+            int expected = STARTING;
+            switch (stream.state.load(std::memory_order_acquire)) {
+                case STARTING:
+                    stream.readFrame = stream.zone->headFrames();
+                    stream.state.compare_exchange_strong(expected, STREAMING,
+                                                         std::memory_order_acq_rel);
+                    busy |= topUp(stream, scratch.data());
+                    break;
+                case STREAMING:
+                    busy |= topUp(stream, scratch.data());
+                    break;
+                case STOPPING:
+                    stream.ring.setReadCounter(0);
+                    stream.ring.setWriteCounter(0);
+                    stream.endOfStream.store(false, std::memory_order_relaxed);
+                    stream.zone = nullptr;
+                    stream.state.store(FREE, std::memory_order_release);
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (!busy) {
+            std::this_thread::sleep_for(PREFETCH_IDLE);
+        }
+    }
+}
+
+// Decodes as much of the tail as the ring has room for. Returns true if it
+// wrote anything.
+bool StreamingSampler::topUp(Stream &stream, float *scratch) {
+    const SampleLibrary::Zone &zone = *stream.zone;
+    bool wrote = false;
+    while (stream.readFrame < zone.frames) {
+        const int32_t space = static_cast<int32_t>(
+            stream.ring.getBufferCapacityInFrames() - stream.ring.getFullFramesAvailable());
+        const int32_t count = static_cast<int32_t>(std::min<int64_t>(
+            std::min(space, PREFETCH_FRAMES), zone.frames - stream.readFrame));
+        if (count < std::min<int64_t>(PREFETCH_FRAMES, zone.frames - stream.readFrame)) {
+            break; // wait until a whole decode block fits
+        }
+        SampleLibrary::decode(zone, stream.readFrame, count, scratch);
+        stream.ring.write(scratch, count);
+        SampleLibrary::releasePages(zone, stream.readFrame, stream.readFrame + count);
+        stream.readFrame += count;
+        wrote = true;
+    }
+    if (stream.readFrame >= zone.frames &&
+        !stream.endOfStream.load(std::memory_order_relaxed)) {
+        stream.endOfStream.store(true, std::memory_order_release);
+    }
+    return wrote;
+}
@@ -0,0 +1,154 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Disk-streaming multi-sample voice engine
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "EngineStats.h"
+#include "Envelope.h"
+#include "SampleLibrary.h"
+#include "oboe/FifoBuffer.h"
+
+/*
+ * Plays SampleLibrary zones without ever touching the disk on the audio
+ * thread. A voice starts on its zone's resident head; meanwhile a background
+ * prefetch thread decodes the tail from the memory mapping into a per-stream
+ * lock-free ring (oboe::FifoBuffer, single producer / single consumer) and
+ * drops the mapped pages it has consumed. When the head runs out the voice
+ * carries on from the ring.
+ *
+ * Streams are handed between the threads with one atomic state each:
+ *
+ *     FREE --audio--> STARTING --prefetch--> STREAMING
+ *       ^                 |                      |
+ *       +---prefetch--- STOPPING <----audio------+
+ *
+ * Only the prefetch thread resets a ring, and only once the audio thread has
+ * let go of it, so neither side ever waits for the other. There are twice as
+ * many streams as voices so a stolen voice's stream can drain while its
+ * replacement starts.
+ *
+ * Pitch follows the zone's root note by resampling (linear interpolation),
+ * up to MAX_PITCH_RATIO. Output is added to the caller's buffer.
+ *
+ * Threading: noteOn/noteOff/allNotesOff/render belong to the audio thread;
+ * setSampleRate/setReleaseTime must not race render. The library must
+ * outlive the sampler.
+ */
+class StreamingSampler {
+public:
+  static constexpr int MAX_VOICES = 16;
+  static constexpr int NUM_STREAMS = 2 * MAX_VOICES;
+  // Stereo frames per stream ring, and per prefetch decode
+  static constexpr int32_t RING_FRAMES = 16384;
+  static constexpr int32_t PREFETCH_FRAMES = 2048;
+  // Frames rendered per interpolation pass
+  static constexpr int32_t BLOCK_FRAMES = 256;
+  static constexpr double MAX_PITCH_RATIO = 4.0;
+  static constexpr double RELEASE_TIME = 0.3;
+
+  explicit StreamingSampler(const SampleLibrary &library);
+  ~StreamingSampler();
+
+  StreamingSampler(const StreamingSampler &) = delete;
+  StreamingSampler &operator=(const StreamingSampler &) = delete;
+
+  void setSampleRate(int32_t rate);
+  void setReleaseTime(double seconds);
+
+  // Where steals and stream underruns are counted; defaults to the
+  // sampler's own counters. Must not race render.
+  void setStats(EngineStats *engineStats) { stats = engineStats ? engineStats : &ownStats; }
+  const EngineStats &getStats() const { return *stats; }
+
+  // Audio thread. noteOn returns false if no zone covers the note or every
+  // stream is still draining.
+  bool noteOn(int midiNote, int velocity, float pan);
+  // Plays the note's zone at `frequency` (from a Tuning) rather than at its
+  // 12-TET pitch
+  bool noteOn(int midiNote, int velocity, float pan, double frequency);
+  void noteOff(int midiNote);
+  void allNotesOff();
+
+  // Audio thread: adds numFrames frames of `channels` (1 or 2) interleaved
+  // samples to `output`
+  void render(float *output, int32_t numFrames, int channels);
+
+  // Offline (faster than real time) rendering: blocks until every stream
+  // ring is full or holds the rest of its sample. Never on an audio thread.
+  void waitForPrefetch();
+
+  // Readable from any thread
+  int activeVoiceCount() const { return activeVoices.load(std::memory_order_relaxed); }
+
+  const SampleLibrary &getLibrary() const { return library; }
+
+private:
+  enum StreamState : int { FREE, STARTING, STREAMING, STOPPING };
+
+  struct Stream {
+    oboe::FifoBuffer ring{2 * sizeof(float), RING_FRAMES};
+    std::atomic<int> state{FREE};
+    // Set by the prefetch thread once the whole tail is in the ring
+    std::atomic<bool> endOfStream{false};
+    // Written by the audio thread before STARTING
+    const SampleLibrary::Zone *zone = nullptr;
+    // Prefetch thread only
+    int64_t readFrame = 0;
+  };
+
+  // Enough for one block at the maximum pitch ratio, plus the
+  // interpolation neighbour and the fractional carry
+  static constexpr int32_t WINDOW_FRAMES =
+      static_cast<int32_t>(BLOCK_FRAMES * MAX_PITCH_RATIO) + 4;
+
+  // Audio thread only
+  struct Voice {
+    bool active = false;
+    int midiNote = -1;
+    uint64_t noteId = 0;
+    int stream = -1;
+    const SampleLibrary::Zone *zone = nullptr;
+    int32_t headFrame = 0;
+    bool sourceDone = false;
+    // Source frames not yet consumed, interleaved stereo; `position` is the
+    // fractional read position within it
+    float window[2 * WINDOW_FRAMES];
+    int32_t windowFrames = 0;
+    double position = 0.0;
+    double rate = 1.0;
+    float gainLeft = 0.0f;
+    float gainRight = 0.0f;
+    EnvelopeGenerator envelope;
+  };
+
+  const SampleLibrary &library;
+  Stream streams[NUM_STREAMS];
+  Voice voices[MAX_VOICES];
+  uint64_t nextNoteId = 0;
+
+  int32_t sampleRate = 48000;
+  EnvelopeParams envelopeParams;
+
+  std::atomic<int> activeVoices{0};
+  EngineStats ownStats;
+  EngineStats *stats = &ownStats;
+
+  std::atomic<bool> running{true};
+  std::thread prefetchThread;
+
+  void stopVoice(Voice &voice);
+  int32_t fetch(Voice &voice, float *stereo, int32_t numFrames);
+  void renderVoice(Voice &voice, float *output, int32_t numFrames, int channels,
+                   float gain);
+
+  void prefetchLoop();
+  bool topUp(Stream &stream, float *scratch);
+};
@@ -0,0 +1,891 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Platform-independent polyphonic synth core
+ */
+
+#include "SynthCore.h"
+
+#include "ConvolutionReverb.h"
+#include "OutputRecorder.h"
+#include "StreamingSampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+using oboe::flowgraph::LookAheadLimiter;
+
+float SynthCore::waveTable[WAVE_TABLE_SIZE] = {};
+
+namespace {
+
+// The kernel's view of the first `count` voices; filter and modulation
+// lanes only if asked
+OscillatorKernel::Voices kernelVoices(VoicePool<SynthCore::MAX_POLYPHONY> &voices, int count,
+                                      bool filtered, bool modulated) {
+    OscillatorKernel::Voices lanes{voices.phase, voices.phaseIncrement, voices.tableOffset,
+                                   voices.envLevel, voices.envMul, voices.envAdd, count,
+                                   voices.panLeft, voices.panRight};
+    if (filtered) {
+        lanes.filter = {voices.filterS1, voices.filterS2, voices.filterG,
+                        voices.filterA1, voices.filterA2, voices.filterGStep,
+                        voices.filterA1Step, voices.filterA2Step};
+    }
+    if (modulated) {
+        lanes.modulation = {voices.incrementStep, voices.modGain, voices.modGainStep};
+    }
+    return lanes;
+}
+
+} // namespace
+
+// One dispatch of the voice kernel across a VoiceWorkerPool. Task t covers
+// voices [t * VOICES_PER_TASK, ...). Inline tasks render straight from the
+// pool into the output; worker tasks start from a snapshot of the voices
+// taken before the dispatch, render into that worker's scratch, and are
+// copied back by commit(), so an abandoned task leaves nothing behind.
+struct SynthCore::ParallelVoices final : VoiceWorkerPool::Job {
+    static constexpr int MAX_TASKS = (MAX_POLYPHONY + VOICES_PER_TASK - 1) / VOICES_PER_TASK;
+
+    struct Scratch {
+        alignas(64) float output[MAX_TASKS][MAX_CHANNELS * WORKER_BLOCK_FRAMES];
+        alignas(64) uint32_t phase[MAX_POLYPHONY];
+        alignas(64) float envLevel[MAX_POLYPHONY];
+        alignas(64) float filterS1[MAX_POLYPHONY];
+        alignas(64) float filterS2[MAX_POLYPHONY];
+        alignas(64) float filterG[MAX_POLYPHONY];
+        alignas(64) float filterA1[MAX_POLYPHONY];
+        alignas(64) float filterA2[MAX_POLYPHONY];
+        alignas(64) uint32_t phaseIncrement[MAX_POLYPHONY];
+        alignas(64) float modGain[MAX_POLYPHONY];
+    };
+
+    // The voices as they were when the dispatch started
+    alignas(64) uint32_t phase[MAX_POLYPHONY];
+    alignas(64) uint32_t phaseIncrement[MAX_POLYPHONY];
+    alignas(64) uint32_t tableOffset[MAX_POLYPHONY];
+    alignas(64) float envLevel[MAX_POLYPHONY];
+    alignas(64) float envMul[MAX_POLYPHONY];
+    alignas(64) float envAdd[MAX_POLYPHONY];
+    alignas(64) float panLeft[MAX_POLYPHONY];
+    alignas(64) float panRight[MAX_POLYPHONY];
+    alignas(64) float filterS1[MAX_POLYPHONY];
+    alignas(64) float filterS2[MAX_POLYPHONY];
+    alignas(64) float filterG[MAX_POLYPHONY];
+    alignas(64) float filterA1[MAX_POLYPHONY];
+    alignas(64) float filterA2[MAX_POLYPHONY];
+    alignas(64) float filterGStep[MAX_POLYPHONY];
+    alignas(64) float filterA1Step[MAX_POLYPHONY];
+    alignas(64) float filterA2Step[MAX_POLYPHONY];
+    alignas(64) int32_t incrementStep[MAX_POLYPHONY];
+    alignas(64) float modGain[MAX_POLYPHONY];
+    alignas(64) float modGainStep[MAX_POLYPHONY];
+    std::vector<Scratch> scratch;
+
+    VoicePool<MAX_POLYPHONY> *voices = nullptr;
+    const float *pairs = nullptr;
+    float gain = 1.0f;
+    float *output = nullptr;
+    int32_t numFrames = 0;
+    int channels = 1;
+    int count = 0;
+    bool filtered = false;
+    bool modulated = false;
+
+    explicit ParallelVoices(int workers) : scratch(static_cast<size_t>(workers)) {}
+
+    int taskCount() const { return (count + VOICES_PER_TASK - 1) / VOICES_PER_TASK; }
+
+    void snapshot() {
+        const size_t n = static_cast<size_t>(count);
+        std::memcpy(phase, voices->phase, n * sizeof(uint32_t));
+        std::memcpy(phaseIncrement, voices->phaseIncrement, n * sizeof(uint32_t));
+        std::memcpy(tableOffset, voices->tableOffset, n * sizeof(uint32_t));
+        std::memcpy(envLevel, voices->envLevel, n * sizeof(float));
+        std::memcpy(envMul, voices->envMul, n * sizeof(float));
+        std::memcpy(envAdd, voices->envAdd, n * sizeof(float));
+        std::memcpy(panLeft, voices->panLeft, n * sizeof(float));
+        std::memcpy(panRight, voices->panRight, n * sizeof(float));
+        if (filtered) {
+            std::memcpy(filterS1, voices->filterS1, n * sizeof(float));
+            std::memcpy(filterS2, voices->filterS2, n * sizeof(float));
+            std::memcpy(filterG, voices->filterG, n * sizeof(float));
+            std::memcpy(filterA1, voices->filterA1, n * sizeof(float));
+            std::memcpy(filterA2, voices->filterA2, n * sizeof(float));
+            std::memcpy(filterGStep, voices->filterGStep, n * sizeof(float));
+            std::memcpy(filterA1Step, voices->filterA1Step, n * sizeof(float));
+            std::memcpy(filterA2Step, voices->filterA2Step, n * sizeof(float));
+        }
+        if (modulated) {
+            std::memcpy(incrementStep, voices->incrementStep, n * sizeof(int32_t));
+            std::memcpy(modGain, voices->modGain, n * sizeof(float));
+            std::memcpy(modGainStep, voices->modGainStep, n * sizeof(float));
+        }
+    }
+
+    // Renders this task's share of `all` (laid out like the pool) into out
+    void render(const OscillatorKernel::Voices &all, int first, float *out) const {
+        OscillatorKernel::Voices lanes{all.phase + first,   all.phaseIncrement + first,
+                                       all.tableOffset + first, all.envLevel + first,
+                                       all.envMul + first,  all.envAdd + first,
+                                       std::min(VOICES_PER_TASK, count - first),
+                                       all.panLeft + first, all.panRight + first,
+                                       all.filter.offset(first),
+                                       all.modulation.offset(first)};
+        if (channels == 2) {
+            OscillatorKernel::renderStereo(pairs, lanes, gain, out, numFrames);
+        } else {
+            OscillatorKernel::render(pairs, lanes, gain, out, numFrames);
+        }
+    }
+
+    void runInline(int task) override {
+        render(kernelVoices(*voices, count, filtered, modulated), task * VOICES_PER_TASK,
+               output);
+    }
+
+    void runOnWorker(int task, int worker) override {
+        Scratch &own = scratch[worker];
+        const int first = task * VOICES_PER_TASK;
+        const int n = std::min(VOICES_PER_TASK, count - first);
+        std::copy(phase + first, phase + first + n, own.phase + first);
+        std::copy(envLevel + first, envLevel + first + n, own.envLevel + first);
+        OscillatorKernel::Voices all{own.phase, phaseIncrement, tableOffset, own.envLevel,
+                                     envMul,    envAdd,         count,       panLeft,
+                                     panRight};
+        if (filtered) {
+            std::copy(filterS1 + first, filterS1 + first + n, own.filterS1 + first);
+            std::copy(filterS2 + first, filterS2 + first + n, own.filterS2 + first);
+            std::copy(filterG + first, filterG + first + n, own.filterG + first);
+            std::copy(filterA1 + first, filterA1 + first + n, own.filterA1 + first);
+            std::copy(filterA2 + first, filterA2 + first + n, own.filterA2 + first);
+            all.filter = {own.filterS1, own.filterS2, own.filterG,  own.filterA1,
+                          own.filterA2, filterGStep,  filterA1Step, filterA2Step};
+        }
+        if (modulated) {
+            std::copy(phaseIncrement + first, phaseIncrement + first + n,
+                      own.phaseIncrement + first);
+            std::copy(modGain + first, modGain + first + n, own.modGain + first);
+            all.phaseIncrement = own.phaseIncrement;
+            all.modulation = {incrementStep, own.modGain, modGainStep};
+        }
+        float *out = own.output[task];
+        std::fill(out, out + channels * numFrames, 0.0f);
+        render(all, first, out);
+    }
+
+    void commit(int task, int worker) override {
+        const Scratch &own = scratch[worker];
+        const int first = task * VOICES_PER_TASK;
+        const int n = std::min(VOICES_PER_TASK, count - first);
+        std::copy(own.phase + first, own.phase + first + n, voices->phase + first);
+        std::copy(own.envLevel + first, own.envLevel + first + n, voices->envLevel + first);
+        if (filtered) {
+            std::copy(own.filterS1 + first, own.filterS1 + first + n, voices->filterS1 + first);
+            std::copy(own.filterS2 + first, own.filterS2 + first + n, voices->filterS2 + first);
+            std::copy(own.filterG + first, own.filterG + first + n, voices->filterG + first);
+            std::copy(own.filterA1 + first, own.filterA1 + first + n, voices->filterA1 + first);
+            std::copy(own.filterA2 + first, own.filterA2 + first + n, voices->filterA2 + first);
+        }
+        if (modulated) {
+            std::copy(own.phaseIncrement + first, own.phaseIncrement + first + n,
+                      voices->phaseIncrement + first);
+            std::copy(own.modGain + first, own.modGain + first + n, voices->modGain + first);
+        }
+        const float *partial = own.output[task];
+        const int32_t samples = channels * numFrames;
+        for (int32_t i = 0; i < samples; i++) {
+            output[i] += partial[i];
+        }
+    }
+};
+
+SynthCore::SynthCore(const Patch &patch) : patch(patch) {
+    this->patch.numHarmonics =
+        std::max(1, std::min(patch.numHarmonics, Patch::MAX_HARMONICS));
+    this->patch.maxVoices = std::max(1, std::min(patch.maxVoices, MAX_POLYPHONY));
+    setFilter(patch.filterEnabled, static_cast<float>(patch.filterCutoff),
+              static_cast<float>(patch.filterResonance));
+    filterCutoffNow = filterCutoff.load(std::memory_order_relaxed);
+    filterResonanceNow = filterResonance.load(std::memory_order_relaxed);
+    setGlide(static_cast<float>(patch.glideTime));
+    setVibrato(static_cast<float>(patch.vibratoRate), static_cast<float>(patch.vibratoDepth));
+    setSampleRate(SAMPLE_RATE);
+}
+
+SynthCore::~SynthCore() = default;
+
+void SynthCore::setSampleRate(int32_t rate) {
+    sampleRate = rate;
+    envelopeParams = EnvelopeParams::make(sampleRate, patch.attackTime, patch.decayTime,
+                                          patch.sustainLevel, patch.releaseTime);
+    initWaveTable();
+    if (sampler != nullptr) {
+        sampler->setSampleRate(sampleRate);
+    }
+    effects.setSampleRate(sampleRate);
+    sequencer.setSampleRate(sampleRate);
+    tuning.setSampleRate(sampleRate);
+    filterEnvDecay = static_cast<float>(std::exp(
+        -CONTROL_FRAMES / (std::max(patch.filterEnvDecay, 1e-3) * sampleRate)));
+    rebuildLimiter();
+}
+
+void SynthCore::rebuildLimiter() {
+    const float threshold =
+        limiter ? limiter->getThreshold() : LookAheadLimiter::kDefaultThreshold;
+    limiter = std::make_unique<LookAheadLimiter>(channelCount, sampleRate);
+    limiter->setThreshold(threshold);
+}
+
+void SynthCore::initWaveTable() {
+    const double harmonicSum =
+        HARMONIC_1_AMP + HARMONIC_2_AMP + HARMONIC_3_AMP + HARMONIC_4_AMP;
+    for (int i = 0; i < WAVE_TABLE_SIZE; i++) {
+        double phase = TWO_PI * i / WAVE_TABLE_SIZE;
+        waveTable[i] = static_cast<float>(
+            (HARMONIC_1_AMP * std::sin(phase) +
+             HARMONIC_2_AMP * std::sin(phase * 2.0) +
+             HARMONIC_3_AMP * std::sin(phase * 3.0) +
+             HARMONIC_4_AMP * std::sin(phase * 4.0)) /
+            harmonicSum);
+    }
+
+    wavetable.build(patch.harmonics, patch.numHarmonics, sampleRate);
+}
+
+void SynthCore::setChannelCount(int channels) {
+    channelCount = std::max(1, std::min(channels, MAX_CHANNELS));
+    rebuildLimiter();
+}
+
+void SynthCore::attachWorkerPool(VoiceWorkerPool *pool) {
+    workerPool = pool;
+    parallelVoices.reset();
+    if (pool != nullptr && pool->getWorkerCount() > 0) {
+        parallelVoices = std::make_unique<ParallelVoices>(pool->getWorkerCount());
+        parallelVoices->voices = &voices;
+    }
+}
+
+void SynthCore::attachReverb(ConvolutionReverb *newReverb) {
+    reverb = newReverb;
+}
+
+void SynthCore::attachRecorder(OutputRecorder *newRecorder) {
+    recorder = newRecorder;
+}
+
+void SynthCore::attachSampler(StreamingSampler *newSampler) {
+    if (sampler != nullptr) {
+        sampler->allNotesOff();
+        sampler->setStats(nullptr);
+    }
+    sampler = newSampler;
+    if (sampler != nullptr) {
+        sampler->setSampleRate(sampleRate);
+        sampler->setStats(&stats);
+    }
+}
+
+void SynthCore::setFilter(bool enabled, float cutoff, float resonance) {
+    filterCutoff.store(cutoff, std::memory_order_relaxed);
+    filterResonance.store(std::clamp(resonance, 0.0f, VoiceFilter::MAX_RESONANCE),
+                          std::memory_order_relaxed);
+    filterRequested.store(enabled, std::memory_order_relaxed);
+}
+
+void SynthCore::setGlide(float seconds) {
+    glideTime.store(std::max(0.0f, seconds), std::memory_order_relaxed);
+}
+
+void SynthCore::setVibrato(float rateHz, float depth) {
+    vibratoRate.store(std::max(0.0f, rateHz), std::memory_order_relaxed);
+    vibratoDepth.store(depth, std::memory_order_relaxed);
+}
+
+int SynthCore::activeVoiceCount() const {
+    return voices.activeCount() + (sampler != nullptr ? sampler->activeVoiceCount() : 0);
+}
+
+int64_t SynthCore::nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+double SynthCore::midiNoteToFrequency(int midiNote) {
+    return 440.0 * std::pow(2.0, ((double)midiNote - 69.0) / 12.0);
+}
+
+int64_t SynthCore::eventFrameNow() const {
+    return frameClock.eventFrame(nowNanos(), sampleRate);
+}
+
+int64_t SynthCore::eventFrameAt(int64_t nanos) const {
+    return frameClock.eventFrame(std::min(nanos, nowNanos()), sampleRate);
+}
+
+int64_t SynthCore::getFramePosition() const {
+    return framePosition.load(std::memory_order_relaxed);
+}
+
+float SynthCore::keyPan(int midiNote) const {
+    return static_cast<float>(patch.panSpread * (midiNote - 63.5) / 63.5);
+}
+
+bool SynthCore::postNoteOn(int midiNote, int64_t frame) {
+    return postNoteOn(midiNote, frame, keyPan(midiNote));
+}
+
+bool SynthCore::postNoteOn(int midiNote, int64_t frame, float pan) {
+    return postNoteOn(midiNote, frame, pan, DEFAULT_VELOCITY);
+}
+
+bool SynthCore::postNoteOn(int midiNote, int64_t frame, float pan, int velocity) {
+    return postEvent(NoteEvent::Type::NOTE_ON, midiNote, frame,
+                     std::max(-1.0f, std::min(pan, 1.0f)),
+                     std::max(1, std::min(velocity, 127)));
+}
+
+bool SynthCore::postNoteOff(int midiNote, int64_t frame) {
+    return postEvent(NoteEvent::Type::NOTE_OFF, midiNote, frame);
+}
+
+bool SynthCore::postAllNotesOff(int64_t frame) {
+    return postEvent(NoteEvent::Type::ALL_OFF, -1, frame);
+}
+
+bool SynthCore::postEvent(NoteEvent::Type type, int midiNote, int64_t frame, float pan,
+                          int velocity) {
+    if (!eventQueue.push(
+            NoteEvent{type, midiNote, frame, pan, static_cast<uint8_t>(velocity)})) {
+        stats.countDroppedEvent();
+        return false;
+    }
+    return true;
+}
+
+bool SynthCore::postPitchBend(int midiNote, int64_t frame, float semitones) {
+    const NoteEvent event = NoteEvent::pitchBend(midiNote, frame, semitones);
+    return postEvents(&event, 1) == 1;
+}
+
+bool SynthCore::postPressure(int midiNote, int64_t frame, float pressure) {
+    const NoteEvent event =
+        NoteEvent::pressure(midiNote, frame, std::max(0.0f, std::min(pressure, 1.0f)));
+    return postEvents(&event, 1) == 1;
+}
+
+int SynthCore::postEvents(const NoteEvent *events, int count) {
+    if (count <= 0) {
+        return 0;
+    }
+    const int queued = static_cast<int>(eventQueue.push(events, static_cast<uint32_t>(count)));
+    if (queued < count) {
+        stats.countDroppedEvent(count - queued);
+    }
+    return queued;
+}
+
+void SynthCore::reset() {
+    voices.clear();
+    channelBend = 0.0f;
+    channelPressure = 0.0f;
+    hasLastNote = false;
+    limiter->reset();
+    if (sampler != nullptr) {
+        sampler->allNotesOff();
+    }
+}
+
+// Audio thread: move everything other threads queued into pendingEvents,
+// keeping it sorted by frame (stable, so same-frame events keep their order)
+void SynthCore::drainEvents() {
+    NoteEvent event;
+    while (pendingCount < EVENT_QUEUE_CAPACITY && eventQueue.pop(event)) {
+        uint32_t i = pendingCount++;
+        while (i > 0 && pendingEvents[i - 1].frame > event.frame) {
+            pendingEvents[i] = pendingEvents[i - 1];
+            i--;
+        }
+        pendingEvents[i] = event;
+    }
+}
+
+void SynthCore::applyEvent(const NoteEvent &event) {
+    if (sampler != nullptr) {
+        switch (event.type) {
+            case NoteEvent::Type::NOTE_ON:
+                if (event.midiNote >= 0 && event.midiNote < Tuning::NUM_NOTES) {
+                    sampler->noteOn(event.midiNote, event.velocity, event.pan,
+                                    tuning.frequency(event.midiNote));
+                }
+                break;
+            case NoteEvent::Type::NOTE_OFF:
+                sampler->noteOff(event.midiNote);
+                break;
+            case NoteEvent::Type::ALL_OFF:
+                sampler->allNotesOff();
+                voices.clear();
+                break;
+            case NoteEvent::Type::PITCH_BEND:
+            case NoteEvent::Type::PRESSURE:
+                break;
+        }
+        return;
+    }
+
+    switch (event.type) {
+        case NoteEvent::Type::NOTE_ON:
+            startNote(event.midiNote, event.pan);
+            break;
+        case NoteEvent::Type::NOTE_OFF:
+            releaseNote(event.midiNote);
+            break;
+        case NoteEvent::Type::ALL_OFF:
+            voices.clear();
+            break;
+        case NoteEvent::Type::PITCH_BEND:
+            applyPitchBend(event.midiNote, event.amount);
+            break;
+        case NoteEvent::Type::PRESSURE:
+            applyPressure(event.midiNote, event.amount);
+            break;
+    }
+}
+
+void SynthCore::applySequencerEvent(const SequencerEvent &event, int64_t frame) {
+    switch (event.type) {
+        case SequencerEvent::Type::NOTE_ON:
+            applyEvent(NoteEvent::noteOn(event.number, frame, event.value, event.velocity));
+            break;
+        case SequencerEvent::Type::NOTE_OFF:
+            applyEvent(NoteEvent::noteOff(event.number, frame));
+            break;
+        case SequencerEvent::Type::CONTROL:
+            // The bus glides to the new level over its smoothing time
+            if (event.number == static_cast<uint8_t>(SequencerEvent::Control::OUTPUT_GAIN)) {
+                effects.setOutputGain(event.value);
+            } else if (event.number ==
+                       static_cast<uint8_t>(SequencerEvent::Control::SEND_LEVEL)) {
+                effects.setSendLevel(event.value);
+            }
+            break;
+    }
+}
+
+void SynthCore::startNote(int midiNote, float pan) {
+    if (midiNote < 0 || midiNote >= VoicePool<MAX_POLYPHONY>::NUM_MIDI_NOTES) {
+        return;
+    }
+
+    int v = voices.find(midiNote);
+    if (v != VoicePool<MAX_POLYPHONY>::NO_VOICE) {
+        // Re-trigger: attack again from the current level
+        voices.enterSegment(v, envelopeParams.attackFrom(voices.envLevel[v]));
+        voices.noteId[v] = nextNoteId++;
+        // The filter envelope restarts too, ramped in from the next tick,
+        // and the note's own expression is cleared
+        voices.filterEnv[v] = 1.0f;
+        modulating |= voices.bend[v] != 0.0f || voices.pressure[v] != 0.0f;
+        voices.bend[v] = 0.0f;
+        voices.pressure[v] = 0.0f;
+        return;
+    }
+
+    // Evict a note if at capacity: prefer releasing notes, then oldest
+    if (voices.activeCount() >= patch.maxVoices) {
+        voices.release(voices.findVictim());
+        stats.countSteal();
+    }
+
+    v = voices.allocate(midiNote, nextNoteId++);
+    OscillatorKernel::panGains(pan, voices.panLeft[v], voices.panRight[v]);
+    voices.enterSegment(v, envelopeParams.attackFrom(0.0f));
+
+    // Start at the previous note's pitch when gliding, on the current
+    // vibrato and global bend either way; the next tick ramps from here
+    const float octave = tuning.octave(midiNote);
+    const float glideFrames = glideTime.load(std::memory_order_relaxed) * sampleRate;
+    float glide = 0.0f;
+    if (glideFrames > 0.0f && hasLastNote) {
+        glide = lastNoteOctave - octave;
+    }
+    lastNoteOctave = octave;
+    hasLastNote = true;
+    voices.glide[v] = glide;
+    voices.glideStep[v] = glide * CONTROL_FRAMES / std::max(glideFrames, 1.0f * CONTROL_FRAMES);
+    voices.bend[v] = 0.0f;
+    voices.pressure[v] = 0.0f;
+    voices.baseIncrement[v] = tuning.phaseIncrement(midiNote);
+    voices.phaseIncrement[v] = VoiceModulation::scaleIncrement(
+        voices.baseIncrement[v], glide + (vibratoNow + channelBend) / 12.0f);
+    voices.incrementStep[v] = 0;
+    voices.modGain[v] = 1.0f + static_cast<float>(patch.pressureGain) * channelPressure;
+    voices.modGainStep[v] = 0.0f;
+    // The table level for the higher of the start and the note's own pitch
+    const double frequency = std::max(voices.phaseIncrement[v], voices.baseIncrement[v]) *
+                             (static_cast<double>(sampleRate) / 4294967296.0);
+    voices.tableOffset[v] = wavetable.tableOffsetFor(frequency);
+    modulating |= glide != 0.0f;
+
+    voices.filterBase[v] = octave;
+    voices.filterEnv[v] = 1.0f;
+    resetFilter(v);
+}
+
+// Pressure from the note and the global one, 0..1
+float SynthCore::pressureOf(int v) const {
+    return std::min(voices.pressure[v] + channelPressure, 1.0f);
+}
+
+// Target cutoff of voice v, in octaves relative to the sample rate
+float SynthCore::filterOctave(int v) const {
+    return voices.filterBase[v] + filterCutoffNow +
+           static_cast<float>(patch.filterEnvAmount) * voices.filterEnv[v] +
+           static_cast<float>(patch.pressureCutoff) * pressureOf(v);
+}
+
+void SynthCore::applyPitchBend(int midiNote, float semitones) {
+    if (midiNote < 0) {
+        channelBend = semitones;
+    } else if (midiNote < VoicePool<MAX_POLYPHONY>::NUM_MIDI_NOTES) {
+        const int v = voices.find(midiNote);
+        if (v == VoicePool<MAX_POLYPHONY>::NO_VOICE) {
+            return;
+        }
+        voices.bend[v] = semitones;
+    }
+    modulating = true;
+}
+
+void SynthCore::applyPressure(int midiNote, float pressure) {
+    if (midiNote < 0) {
+        channelPressure = pressure;
+    } else if (midiNote < VoicePool<MAX_POLYPHONY>::NUM_MIDI_NOTES) {
+        const int v = voices.find(midiNote);
+        if (v == VoicePool<MAX_POLYPHONY>::NO_VOICE) {
+            return;
+        }
+        voices.pressure[v] = pressure;
+    }
+    modulating = true;
+}
+
+// Clears voice v's filter state and holds its coefficients until the next
+// control tick
+void SynthCore::resetFilter(int v) {
+    voices.filterS1[v] = 0.0f;
+    voices.filterS2[v] = 0.0f;
+    const VoiceFilter::Coefficients c =
+        VoiceFilter::coefficients(filterOctave(v), filterResonanceNow);
+    voices.filterG[v] = c.g;
+    voices.filterA1[v] = c.a1;
+    voices.filterA2[v] = c.a2;
+    voices.filterGStep[v] = 0.0f;
+    voices.filterA1Step[v] = 0.0f;
+    voices.filterA2Step[v] = 0.0f;
+}
+
+// Audio thread, every CONTROL_FRAMES while the filter is on:
+// takes the latest settings and points every voice's coefficient ramp at
+// its cutoff one tick from now
+void SynthCore::updateFilters() {
+    const bool starting = !filterActive;
+    filterActive = filterRequested.load(std::memory_order_relaxed);
+    if (!filterActive) {
+        return;
+    }
+    filterCutoffNow = filterCutoff.load(std::memory_order_relaxed);
+    filterResonanceNow = filterResonance.load(std::memory_order_relaxed);
+
+    constexpr float RAMP = 1.0f / CONTROL_FRAMES;
+    constexpr float FILTER_ENV_FLOOR = 1e-4f;
+    for (int v = 0; v < voices.activeCount(); v++) {
+        if (starting) {
+            // Voices that played unfiltered carry no usable state
+            resetFilter(v);
+            continue;
+        }
+        // Flushed to zero well before it could turn denormal
+        voices.filterEnv[v] =
+            voices.filterEnv[v] > FILTER_ENV_FLOOR ? voices.filterEnv[v] * filterEnvDecay : 0.0f;
+        const VoiceFilter::Coefficients target =
+            VoiceFilter::coefficients(filterOctave(v), filterResonanceNow);
+        voices.filterGStep[v] = (target.g - voices.filterG[v]) * RAMP;
+        voices.filterA1Step[v] = (target.a1 - voices.filterA1[v]) * RAMP;
+        voices.filterA2Step[v] = (target.a2 - voices.filterA2[v]) * RAMP;
+    }
+}
+
+// Audio thread, every CONTROL_FRAMES while anything modulates: advances
+// vibrato and glide and points every voice's increment and gain ramps at
+// their values one tick from now. Targets within a step of where a voice
+// is are taken straight away, so the ramps (and the ticks) stop once
+// nothing moves.
+void SynthCore::updateModulation() {
+    const float depth = vibratoDepth.load(std::memory_order_relaxed);
+    vibratoNow = 0.0f;
+    if (depth != 0.0f) {
+        lfoPhase += static_cast<uint32_t>(vibratoRate.load(std::memory_order_relaxed) *
+                                          CONTROL_FRAMES / sampleRate * 4294967296.0);
+        vibratoNow = depth * VoiceModulation::lfo(lfoPhase);
+    }
+
+    const float shared = (vibratoNow + channelBend) / 12.0f;
+    const float pressureGain = static_cast<float>(patch.pressureGain);
+    constexpr float RAMP = 1.0f / CONTROL_FRAMES;
+    constexpr float GAIN_EPSILON = 1e-5f;
+    bool moving = depth != 0.0f;
+    bool gained = false;
+    for (int v = 0; v < voices.activeCount(); v++) {
+        float &glide = voices.glide[v];
+        if (glide != 0.0f) {
+            glide = std::abs(glide) > std::abs(voices.glideStep[v]) ? glide - voices.glideStep[v]
+                                                                    : 0.0f;
+        }
+        const uint32_t target = VoiceModulation::scaleIncrement(
+            voices.baseIncrement[v], glide + voices.bend[v] / 12.0f + shared);
+        const int64_t difference =
+            static_cast<int64_t>(target) - static_cast<int64_t>(voices.phaseIncrement[v]);
+        if (std::abs(difference) < CONTROL_FRAMES) {
+            voices.phaseIncrement[v] = target;
+            voices.incrementStep[v] = 0;
+            // Back down from a bend or glide, the voice gets its harmonics back
+            voices.tableOffset[v] = wavetable.tableOffsetFor(
+                target * (static_cast<double>(sampleRate) / 4294967296.0));
+        } else {
+            voices.incrementStep[v] = static_cast<int32_t>(difference / CONTROL_FRAMES);
+            // Bent or slid up past its own table level, the voice would alias
+            voices.tableOffset[v] = wavetable.tableOffsetFor(
+                std::max(target, voices.phaseIncrement[v]) *
+                (static_cast<double>(sampleRate) / 4294967296.0));
+            moving = true;
+        }
+
+        const float gain = 1.0f + pressureGain * pressureOf(v);
+        if (std::abs(gain - voices.modGain[v]) < GAIN_EPSILON) {
+            voices.modGain[v] = gain;
+            voices.modGainStep[v] = 0.0f;
+        } else {
+            voices.modGainStep[v] = (gain - voices.modGain[v]) * RAMP;
+            moving = true;
+        }
+        gained |= gain != 1.0f;
+    }
+    modulating = moving;
+    modulationLanes = moving || gained;
+}
+
+bool SynthCore::controlWanted() const {
+    return modulating || filterRequested.load(std::memory_order_relaxed) ||
+           vibratoDepth.load(std::memory_order_relaxed) != 0.0f;
+}
+
+void SynthCore::controlTick() {
+    updateFilters();
+    updateModulation();
+    controlRunning = filterActive || modulating;
+    controlFramesLeft = CONTROL_FRAMES;
+}
+
+void SynthCore::releaseNote(int midiNote) {
+    if (midiNote < 0 || midiNote >= VoicePool<MAX_POLYPHONY>::NUM_MIDI_NOTES) {
+        return;
+    }
+
+    int v = voices.find(midiNote);
+    if (v != VoicePool<MAX_POLYPHONY>::NO_VOICE && !isReleasing(voices.envStage[v])) {
+        voices.enterSegment(v, envelopeParams.release());
+    }
+}
+
+void SynthCore::render(float *output, int32_t numFrames) {
+    std::fill_n(output, numFrames * channelCount, 0.0f);
+
+    const int64_t startNanos = nowNanos();
+    const int64_t blockStart = framePosition.load(std::memory_order_relaxed);
+    frameClock.publish(blockStart, startNanos, numFrames);
+
+    drainEvents();
+    if (idle.load(std::memory_order_relaxed)) {
+        if (pendingCount == 0 && !sequencer.isPlaying() &&
+            idleDetection.load(std::memory_order_relaxed)) {
+            if (recorder != nullptr) {
+                recorder->capture(output, numFrames, blockStart);
+            }
+            framePosition.store(blockStart + numFrames, std::memory_order_relaxed);
+            idleFrames.store(idleFrames.load(std::memory_order_relaxed) + numFrames,
+                             std::memory_order_relaxed);
+            stats.recordIdleCallback(nowNanos() - startNanos, numFrames, sampleRate);
+            return;
+        }
+        idle.store(false, std::memory_order_relaxed);
+        silentFrames = 0;
+    }
+    tuning.beginBlock();
+    for (uint32_t e = 0; e < pendingCount && pendingEvents[e].frame < blockStart; e++) {
+        stats.countLateEvent();
+    }
+    sequencer.beginBlock(blockStart, numFrames);
+
+    // Split the buffer at event frames so every note on/off lands on its
+    // exact sample. Events that are already late apply at frame 0; posted
+    // events go before sequencer events on the same frame.
+    int32_t offset = 0;
+    uint32_t nextEvent = 0;
+    Sequencer::Dispatch dispatch;
+    while (offset < numFrames) {
+        while (nextEvent < pendingCount &&
+               pendingEvents[nextEvent].frame <= blockStart + offset) {
+            applyEvent(pendingEvents[nextEvent++]);
+        }
+        while (sequencer.peekFrame() <= blockStart + offset && sequencer.pop(dispatch)) {
+            applySequencerEvent(dispatch.event, dispatch.frame);
+        }
+
+        int64_t next = std::min(blockStart + numFrames, sequencer.peekFrame());
+        if (nextEvent < pendingCount) {
+            next = std::min(next, pendingEvents[nextEvent].frame);
+        }
+        const int32_t end = static_cast<int32_t>(next - blockStart);
+        renderFrames(output + offset * channelCount, end - offset);
+        if (sampler != nullptr) {
+            sampler->render(output + offset * channelCount, end - offset, channelCount);
+        }
+        offset = end;
+    }
+
+    // Keep events that belong to later buffers
+    std::copy(pendingEvents + nextEvent, pendingEvents + pendingCount,
+              pendingEvents);
+    pendingCount -= nextEvent;
+
+    effects.process(output, numFrames, channelCount);
+    if (reverb != nullptr && reverb->getChannelCount() == channelCount) {
+        reverb->process(output, numFrames);
+    }
+    limiter->process(output, output, numFrames);
+    if (recorder != nullptr) {
+        recorder->capture(output, numFrames, blockStart);
+    }
+
+    framePosition.store(blockStart + numFrames, std::memory_order_relaxed);
+    trackSilence(output, numFrames);
+
+    stats.recordVoices(activeVoiceCount());
+    stats.recordCallback(nowNanos() - startNanos, numFrames, sampleRate);
+}
+
+// Audio thread: goes idle once the output has been silent, with nothing
+// left to play, for IDLE_SETTLE_SECONDS
+void SynthCore::trackSilence(const float *output, int32_t numFrames) {
+    bool quiet = idleDetection.load(std::memory_order_relaxed) && activeVoiceCount() == 0 &&
+                 pendingCount == 0 && !sequencer.isPlaying();
+    const int32_t samples = numFrames * channelCount;
+    for (int32_t i = 0; quiet && i < samples; i++) {
+        quiet = std::fabs(output[i]) < SILENCE_LEVEL;
+    }
+    if (!quiet) {
+        silentFrames = 0;
+        return;
+    }
+    silentFrames += numFrames;
+    if (silentFrames >= static_cast<int64_t>(IDLE_SETTLE_SECONDS * sampleRate)) {
+        idleFrames.store(0, std::memory_order_relaxed);
+        idle.store(true, std::memory_order_relaxed);
+    }
+}
+
+void SynthCore::suspend() {
+    frameClock.pause(framePosition.load(std::memory_order_relaxed));
+}
+
+void SynthCore::renderFrames(float *output, int32_t numFrames) {
+    if (!controlRunning && controlWanted()) {
+        controlTick();
+    }
+
+    int32_t offset = 0;
+    while (offset < numFrames && voices.activeCount() > 0) {
+        const int count = voices.activeCount();
+
+        // Render up to the next envelope stage change of any voice, so
+        // every voice stays on one affine segment for the whole chunk, and
+        // no further than the next control tick
+        int32_t chunk = numFrames - offset;
+        for (int v = 0; v < count; v++) {
+            chunk = std::min(chunk, voices.envFramesLeft[v]);
+        }
+        if (controlRunning) {
+            chunk = std::min(chunk, controlFramesLeft);
+        }
+        renderVoices(output + channelCount * offset, chunk, count,
+                     static_cast<float>(patch.voiceGain));
+
+        for (int v = 0; v < voices.activeCount();) {
+            voices.envFramesLeft[v] -= chunk;
+            if (voices.envFramesLeft[v] == 0) {
+                voices.enterSegment(v, envelopeParams.after(voices.envStage[v],
+                                                            voices.envLevel[v]));
+            }
+            if (voices.envStage[v] == EnvelopeStage::DONE) {
+                voices.release(v); // moves the last voice into slot v
+            } else {
+                ++v;
+            }
+        }
+        offset += chunk;
+
+        if (controlRunning) {
+            controlFramesLeft -= chunk;
+            if (controlFramesLeft == 0) {
+                controlTick();
+            }
+        }
+    }
+}
+
+// Adds `count` voices, all on one envelope segment, into `output`
+void SynthCore::renderVoices(float *output, int32_t numFrames, int count, float gain) {
+    const auto renderHere = [&](float *out, int32_t frames) {
+        const OscillatorKernel::Voices lanes =
+            kernelVoices(voices, count, filterActive, modulationLanes);
+        if (channelCount == 2) {
+            OscillatorKernel::renderStereo(wavetable.pairs(), lanes, gain, out, frames);
+        } else {
+            OscillatorKernel::render(wavetable.pairs(), lanes, gain, out, frames);
+        }
+    };
+    if (parallelVoices == nullptr || count < PARALLEL_MIN_VOICES) {
+        renderHere(output, numFrames);
+        return;
+    }
+
+    ParallelVoices &job = *parallelVoices;
+    for (int32_t offset = 0; offset < numFrames; offset += WORKER_BLOCK_FRAMES) {
+        const int32_t frames = std::min(WORKER_BLOCK_FRAMES, numFrames - offset);
+        // A worker that missed an earlier deadline may still be reading the
+        // job and its snapshot: render this block without touching them
+        if (!workerPool->ready()) {
+            renderHere(output + channelCount * offset, frames);
+            continue;
+        }
+        job.pairs = wavetable.pairs();
+        job.gain = gain;
+        job.channels = channelCount;
+        job.count = count;
+        job.filtered = filterActive;
+        job.modulated = modulationLanes;
+        job.numFrames = frames;
+        job.output = output + channelCount * offset;
+        job.snapshot();
+        const int64_t budget = static_cast<int64_t>(
+            job.numFrames * DEADLINE_FRACTION * 1e9 / sampleRate);
+        workerPool->run(job, job.taskCount(), VoiceWorkerPool::nowNanos() + budget);
+    }
+}
@@ -0,0 +1,383 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Platform-independent polyphonic synth core
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "EffectsBus.h"
+#include "EngineStats.h"
+#include "Envelope.h"
+#include "FrameClock.h"
+#include "MipmappedWavetable.h"
+#include "NoteEventQueue.h"
+#include "OscillatorKernel.h"
+#include "Sequencer.h"
+#include "Tuning.h"
+#include "VoiceFilter.h"
+#include "VoiceModulation.h"
+#include "VoicePool.h"
+#include "VoiceWorkerPool.h"
+#include "flowgraph/LookAheadLimiter.h"
+
+class ConvolutionReverb;
+class OutputRecorder;
+class StreamingSampler;
+
+/*
+ * Everything between "a note event was posted" and "a buffer of samples came
+ * out": the event queue, voice pool, envelopes, wavetables and oscillator
+ * kernel. It has no device, JNI or logging dependencies, so the same code is
+ * driven by the Oboe callback on Android and by the offline renderer, tests
+ * and benchmarks on a plain host.
+ *
+ * With a StreamingSampler attached, notes play the sampler's zones instead
+ * of the wavetable voices; events are still split sample-accurately.
+ *
+ * A Sequencer (stopped and empty by default) plays patterns from inside
+ * render(): its events split the buffer exactly like posted ones, and its
+ * control events set the effects bus levels.
+ *
+ * Voices can run through a resonant low-pass each (off by default; see
+ * setFilter()), whose coefficients are worked out once per CONTROL_FRAMES
+ * from the note's pitch, the cutoff and a decaying filter envelope, and
+ * ramped per sample inside the kernel. Pitch is modulated on the same
+ * tick: glide from the previous note, a shared vibrato LFO and per-note
+ * (MPE-style) or global pitch bend give each voice a target phase
+ * increment, and per-note pressure a target gain, which the kernel ramps
+ * to. Control ticks only run while something is moving, so held notes
+ * with nothing modulating cost what they did before.
+ *
+ * Note pitches come from a Tuning (12-TET until told otherwise): per-note
+ * phase increments precomputed at the current sample rate, so a note-on
+ * does no transcendental math and a new scale applies from the next block.
+ *
+ * The mixed buffer then runs through the EffectsBus (empty by default),
+ * whose chains can be changed from any thread while rendering, an attached
+ * ConvolutionReverb, and finally a look-ahead peak limiter; an attached
+ * OutputRecorder gets the result.
+ * Every voice plays at a fixed gain and the limiter alone keeps chords from
+ * clipping, at a constant output latency of getLatencyFrames() frames
+ * (2 ms).
+ *
+ * With a VoiceWorkerPool attached, chunks with at least PARALLEL_MIN_VOICES
+ * active voices are split into tasks of VOICES_PER_TASK voices and rendered
+ * across the pool's workers and the audio thread; a task a worker has not
+ * finished within DEADLINE_FRACTION of the chunk's duration is rendered
+ * inline instead, as are the chunks that follow until that worker is done
+ * with it. The output matches single-threaded rendering up to
+ * float rounding of the partial sums.
+ *
+ * Once the output has stayed below SILENCE_LEVEL for IDLE_SETTLE_SECONDS
+ * (longer than any effects delay) with no voice sounding, no event queued
+ * and the sequencer stopped, render() goes idle: it writes silence and
+ * returns without touching voices, effects, reverb or the limiter, until
+ * an event or the sequencer gives it something to play. A front end can
+ * use isIdle() and getIdleFrames() to stop its stream altogether (see
+ * suspend()).
+ *
+ * Threading: post*(), setFilter(), setGlide(), setVibrato(), eventFrameNow(),
+ * eventFrameAt(), isIdle() and setIdleDetection() may be called from any
+ * thread;
+ * render() belongs to a single audio thread; setSampleRate(),
+ * attachSampler(), attachWorkerPool(), attachReverb() and attachRecorder()
+ * must not race render().
+ */
+class SynthCore {
+public:
+  static constexpr int SAMPLE_RATE = 48000;
+  static constexpr double TWO_PI = 2.0 * M_PI;
+  static constexpr int MAX_POLYPHONY = 24;
+  static constexpr uint32_t EVENT_QUEUE_CAPACITY = 256;
+  static constexpr int MAX_CHANNELS = 2;
+  static constexpr int DEFAULT_VELOCITY = 100;
+
+  static constexpr double ATTACK_TIME = 0.008;
+  static constexpr double DECAY_TIME = 0.15;
+  static constexpr double SUSTAIN_LEVEL = 0.6;
+  static constexpr double RELEASE_TIME = 2.0;
+
+  static constexpr double HARMONIC_1_AMP = 1.0;
+  static constexpr double HARMONIC_2_AMP = 0.4;
+  static constexpr double HARMONIC_3_AMP = 0.2;
+  static constexpr double HARMONIC_4_AMP = 0.1;
+
+  // Per-voice output gain; the output limiter catches whatever chords add up to
+  static constexpr double VOICE_GAIN = 0.7;
+
+  // Filter and modulation tick
+  static constexpr int32_t CONTROL_FRAMES = VoiceFilter::CONTROL_FRAMES;
+
+  // Multi-core voice rendering
+  static constexpr int VOICES_PER_TASK = 4;
+  static constexpr int PARALLEL_MIN_VOICES = 8;
+  static constexpr int32_t WORKER_BLOCK_FRAMES = 256;
+  static constexpr double DEADLINE_FRACTION = 0.5;
+
+  // Idle detection: -100 dBFS, held past the longest effects delay (2 s)
+  static constexpr float SILENCE_LEVEL = 1.0e-5f;
+  static constexpr double IDLE_SETTLE_SECONDS = 2.5;
+
+  static constexpr int WAVE_TABLE_SIZE = OscillatorKernel::TABLE_SIZE;
+  static constexpr int WAVE_TABLE_MASK = WAVE_TABLE_SIZE - 1;
+  static float waveTable[WAVE_TABLE_SIZE];
+
+  // Everything that gives an engine its sound. The defaults are the Oboe
+  // engine's voice; other front ends pass their own.
+  struct Patch {
+    static constexpr int MAX_HARMONICS = 8;
+    double harmonics[MAX_HARMONICS] = {HARMONIC_1_AMP, HARMONIC_2_AMP,
+                                       HARMONIC_3_AMP, HARMONIC_4_AMP};
+    int numHarmonics = 4;
+    double attackTime = ATTACK_TIME;
+    double decayTime = DECAY_TIME;
+    double sustainLevel = SUSTAIN_LEVEL;
+    double releaseTime = RELEASE_TIME;
+    // At most MAX_POLYPHONY
+    int maxVoices = MAX_POLYPHONY;
+    // Pan of notes posted without one: 0 keeps every note centred, 1 spreads
+    // MIDI 0..127 from hard left to hard right
+    double panSpread = 0.5;
+    double voiceGain = VOICE_GAIN;
+    // Per-voice resonant low-pass tracking the note (see setFilter()). The
+    // cutoff opens filterEnvAmount octaves further at note-on and falls
+    // back by 1/e every filterEnvDecay seconds.
+    bool filterEnabled = false;
+    double filterCutoff = 2.0;
+    double filterResonance = 0.3;
+    double filterEnvAmount = 3.0;
+    double filterEnvDecay = 0.3;
+    // Seconds to slide from the previous note's pitch (see setGlide())
+    double glideTime = 0.0;
+    // Shared vibrato LFO; depth in semitones, 0 for none
+    double vibratoRate = 5.5;
+    double vibratoDepth = 0.0;
+    // Full pressure raises a voice's gain by this much and opens its
+    // filter by this many octaves
+    double pressureGain = 0.5;
+    double pressureCutoff = 2.0;
+  };
+
+  SynthCore() : SynthCore(Patch{}) {}
+  explicit SynthCore(const Patch &patch);
+  ~SynthCore();
+
+  // Rebuilds rate-dependent tables. Call before rendering starts.
+  void setSampleRate(int32_t rate);
+  int32_t getSampleRate() const { return sampleRate; }
+
+  // Builds the reference waveTable (default harmonics) and the patch's
+  // band-limited mipmaps, which are what the voices actually play
+  void initWaveTable();
+  const MipmappedWavetable &getWavetable() const { return wavetable; }
+
+  // 1 = mono, 2 = interleaved stereo. Must not race render().
+  void setChannelCount(int channels);
+  int getChannelCount() const { return channelCount; }
+
+  // Routes notes to `sampler` (nullptr switches back to the wavetable
+  // voices). The caller keeps ownership. Must not race render().
+  void attachSampler(StreamingSampler *sampler);
+  StreamingSampler *getSampler() const { return sampler; }
+
+  // Renders the wavetable voices across `pool` (nullptr: single-threaded).
+  // The caller keeps ownership. Must not race render().
+  void attachWorkerPool(VoiceWorkerPool *pool);
+  VoiceWorkerPool *getWorkerPool() const { return workerPool; }
+
+  // Adds `reverb` to the output after the effects bus (nullptr: none). It
+  // is skipped while its channel count differs from ours. The caller keeps
+  // ownership. Must not race render().
+  void attachReverb(ConvolutionReverb *reverb);
+
+  // Hands every rendered buffer to `recorder`, which records whenever it
+  // has been started (with this channel count). The caller keeps ownership.
+  // Must not race render().
+  void attachRecorder(OutputRecorder *recorder);
+
+  // Any thread: switches the voice filter and sets its cutoff, in octaves
+  // above each note's pitch, and resonance (0..VoiceFilter::MAX_RESONANCE).
+  // Sounding notes glide to the new settings from the next control tick.
+  void setFilter(bool enabled, float cutoff, float resonance);
+
+  // Any thread: notes struck from now on slide from the previous note's
+  // pitch over `seconds` (0 turns glide off)
+  void setGlide(float seconds);
+  // Any thread: vibrato on every voice; depth in semitones, 0 turns it off
+  void setVibrato(float rateHz, float depth);
+
+  // Any thread. Each returns false if the event queue was full.
+  bool postNoteOn(int midiNote, int64_t frame);
+  // pan: -1 hard left .. +1 hard right (e.g. from the key's screen position)
+  bool postNoteOn(int midiNote, int64_t frame, float pan);
+  // velocity: 1..127; only the sampler responds to it
+  bool postNoteOn(int midiNote, int64_t frame, float pan, int velocity);
+  bool postNoteOff(int midiNote, int64_t frame);
+  bool postAllNotesOff(int64_t frame);
+  // Queues events built by the caller (pan and velocity already in range)
+  // with one claim on the queue, for chords and other batches. Returns how
+  // many were queued; the rest are dropped and counted.
+  int postEvents(const NoteEvent *events, int count);
+  // Per-note expression for wavetable voices; midiNote -1 applies to every
+  // note, struck or not, on top of its own. A new note-on clears the
+  // note's own bend and pressure. The sampler ignores both.
+  bool postPitchBend(int midiNote, int64_t frame, float semitones);
+  // pressure: 0..1
+  bool postPressure(int midiNote, int64_t frame, float pressure);
+
+  // The pan postNoteOn(midiNote, frame) gives a note: its key position
+  // scaled by the patch's pan spread
+  float keyPan(int midiNote) const;
+
+  // Any thread: the frame an event posted at this instant should land on
+  int64_t eventFrameNow() const;
+  // Same for an event stamped `nanos` on the steady clock (nowNanos(), i.e.
+  // System.nanoTime() on Android); stamps in the future count as now
+  int64_t eventFrameAt(int64_t nanos) const;
+  int64_t getFramePosition() const;
+
+  // Audio thread: overwrites `output` with numFrames frames of
+  // getChannelCount() interleaved samples
+  void render(float *output, int32_t numFrames);
+  int activeVoiceCount() const;
+
+  // Any thread: whether render() is on its silent fast path, and the frames
+  // it has rendered there since it went idle
+  bool isIdle() const { return idle.load(std::memory_order_relaxed); }
+  int64_t getIdleFrames() const { return idleFrames.load(std::memory_order_relaxed); }
+  // Any thread: false keeps render() on the full path through silence; on
+  // by default
+  void setIdleDetection(bool enabled) {
+    idleDetection.store(enabled, std::memory_order_relaxed);
+  }
+  // Audio thread, from the last render() before the caller stops calling it
+  // for a while (a suspended stream): events posted until the next render()
+  // land on its first frame rather than where the wall clock would put them
+  void suspend();
+  // Audio thread: whether events are waiting for a render()
+  bool hasQueuedEvents() const { return pendingCount > 0 || !eventQueue.empty(); }
+
+  // Pattern playback; patterns and transport may be set from any thread
+  Sequencer &getSequencer() { return sequencer; }
+
+  // Note pitches; scales may be set from any thread
+  Tuning &getTuning() { return tuning; }
+
+  // Master and send effects applied at the end of render()
+  EffectsBus &getEffectsBus() { return effects; }
+
+  // Output limiter, the last stage of render(). Its threshold may be set
+  // from any thread; it is rebuilt (keeping the threshold) on a rate or
+  // channel count change.
+  oboe::flowgraph::LookAheadLimiter &getLimiter() { return *limiter; }
+  // Frames between an event's frame and its first output sample
+  int32_t getLatencyFrames() const { return limiter->getLatencyFrames(); }
+
+  // Health counters, updated by render(); readable from any thread
+  EngineStats &getStats() { return stats; }
+  const EngineStats &getStats() const { return stats; }
+
+  // Audio thread (or when nothing is rendering): drops every voice, the
+  // global bend and pressure and the note the next glide would start from
+  void reset();
+
+  static int64_t nowNanos();
+  static double midiNoteToFrequency(int midiNote);
+
+private:
+  // Owned by the audio thread; other threads only talk to it via eventQueue
+  VoicePool<MAX_POLYPHONY> voices;
+  uint64_t nextNoteId = 0;
+
+  NoteEventQueue<NoteEvent, EVENT_QUEUE_CAPACITY> eventQueue;
+
+  // Events popped from the queue but due in a later buffer, sorted by frame
+  NoteEvent pendingEvents[EVENT_QUEUE_CAPACITY];
+  uint32_t pendingCount = 0;
+
+  Patch patch;
+  int32_t sampleRate = SAMPLE_RATE;
+  int channelCount = 1;
+  MipmappedWavetable wavetable;
+  EnvelopeParams envelopeParams;
+  FrameClock frameClock;
+  std::atomic<int64_t> framePosition{0};
+  EngineStats stats;
+  StreamingSampler *sampler = nullptr;
+  OutputRecorder *recorder = nullptr;
+  ConvolutionReverb *reverb = nullptr;
+  Sequencer sequencer;
+  Tuning tuning;
+  EffectsBus effects;
+  std::unique_ptr<oboe::flowgraph::LookAheadLimiter> limiter;
+
+  // Voice filter settings from setFilter(), taken at each control tick
+  std::atomic<bool> filterRequested{false};
+  std::atomic<float> filterCutoff{0.0f};
+  std::atomic<float> filterResonance{0.0f};
+  // Audio thread: the settings in effect
+  bool filterActive = false;
+  float filterCutoffNow = 0.0f;
+  float filterResonanceNow = 0.0f;
+  float filterEnvDecay = 1.0f; // per tick
+
+  // Modulation settings from setGlide() and setVibrato()
+  std::atomic<float> glideTime{0.0f};
+  std::atomic<float> vibratoRate{0.0f};
+  std::atomic<float> vibratoDepth{0.0f};
+  // Audio thread: global bend and pressure, the LFO, and the pitch the
+  // next glide starts from
+  float channelBend = 0.0f;
+  float channelPressure = 0.0f;
+  uint32_t lfoPhase = 0;
+  float vibratoNow = 0.0f; // semitones
+  float lastNoteOctave = 0.0f;
+  bool hasLastNote = false;
+  // Some voice's pitch or gain is still ramping, or is about to
+  bool modulating = false;
+  // The kernel needs the modulation lanes (ramping, or a gain other than 1)
+  bool modulationLanes = false;
+
+  // Silence detection; the audio thread writes idle and idleFrames
+  std::atomic<bool> idleDetection{true};
+  std::atomic<bool> idle{false};
+  std::atomic<int64_t> idleFrames{0};
+  int64_t silentFrames = 0;
+
+  // Control ticks run while the filter is on or something modulates
+  bool controlRunning = false;
+  int32_t controlFramesLeft = CONTROL_FRAMES;
+
+  // Voice snapshot and per-worker scratch for attachWorkerPool()
+  struct ParallelVoices;
+  VoiceWorkerPool *workerPool = nullptr;
+  std::unique_ptr<ParallelVoices> parallelVoices;
+
+  bool postEvent(NoteEvent::Type type, int midiNote, int64_t frame, float pan = 0.0f,
+                 int velocity = DEFAULT_VELOCITY);
+  void drainEvents();
+  void applyEvent(const NoteEvent &event);
+  void applySequencerEvent(const SequencerEvent &event, int64_t frame);
+  void startNote(int midiNote, float pan);
+  void releaseNote(int midiNote);
+  void resetFilter(int v);
+  float filterOctave(int v) const;
+  float pressureOf(int v) const;
+  void applyPitchBend(int midiNote, float semitones);
+  void applyPressure(int midiNote, float pressure);
+  bool controlWanted() const;
+  void controlTick();
+  void updateFilters();
+  void updateModulation();
+  void renderFrames(float *output, int32_t numFrames);
+  void trackSilence(const float *output, int32_t numFrames);
+  void renderVoices(float *output, int32_t numFrames, int count, float gain);
+  void rebuildLimiter();
+};
@@ -0,0 +1,194 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Tuning tables: equal divisions, Scala scales and a movable root
+ */
+
+#include "Tuning.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "OscillatorKernel.h"
+
+namespace {
+
+double twelveTetFrequency(int note) {
+    return 440.0 * std::exp2((note - 69) / 12.0);
+}
+
+// One Scala pitch: cents if it has a '.', else a ratio n/d or n
+bool parseScalaPitch(const std::string &token, double &cents) {
+    const char *text = token.c_str();
+    char *end = nullptr;
+    if (token.find('.') != std::string::npos) {
+        cents = std::strtod(text, &end);
+        return end != text && *end == '\0' && std::isfinite(cents);
+    }
+    const long numerator = std::strtol(text, &end, 10);
+    long denominator = 1;
+    if (*end == '/') {
+        const char *rest = end + 1;
+        denominator = std::strtol(rest, &end, 10);
+        if (end == rest) {
+            return false;
+        }
+    }
+    if (end == text || *end != '\0' || numerator <= 0 || denominator <= 0) {
+        return false;
+    }
+    cents = 1200.0 * std::log2(static_cast<double>(numerator) / denominator);
+    return true;
+}
+
+} // namespace
+
+TuningScale TuningScale::equalDivisions(int divisions, double periodCents) {
+    TuningScale scale;
+    divisions = std::max(1, divisions);
+    for (int i = 1; i <= divisions; i++) {
+        scale.cents.push_back(periodCents * i / divisions);
+    }
+    return scale;
+}
+
+bool TuningScale::parseScala(const std::string &text, TuningScale &scale) {
+    std::istringstream in(text);
+    std::string line;
+    int field = 0;
+    long count = 0;
+    std::vector<double> cents;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty() && line[0] == '!') {
+            continue;
+        }
+        if (field++ == 0) {
+            // Description; may be blank
+            continue;
+        }
+        std::string token;
+        std::istringstream(line) >> token;
+        if (field == 2) {
+            char *end = nullptr;
+            count = std::strtol(token.c_str(), &end, 10);
+            if (token.empty() || *end != '\0' || count <= 0 || count > 1024) {
+                return false;
+            }
+            continue;
+        }
+        double pitch = 0.0;
+        if (token.empty()) {
+            continue;
+        }
+        if (!parseScalaPitch(token, pitch)) {
+            return false;
+        }
+        cents.push_back(pitch);
+        if (static_cast<long>(cents.size()) == count) {
+            break;
+        }
+    }
+    // The period has to go up, or notes would not rise with the note number
+    if (count == 0 || static_cast<long>(cents.size()) != count || cents.back() <= 0.0) {
+        return false;
+    }
+    scale.cents = std::move(cents);
+    return true;
+}
+
+bool TuningScale::loadScala(const std::string &path, TuningScale &scale) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return parseScala(text.str(), scale);
+}
+
+Tuning::Tuning() {
+    current = buildLocked();
+}
+
+Tuning::~Tuning() {
+    delete current;
+    delete pending.exchange(nullptr);
+    std::lock_guard<std::mutex> lock(controlLock);
+    reclaimLocked();
+}
+
+Tuning::Table *Tuning::buildLocked() const {
+    auto table = std::make_unique<Table>();
+    const int root = std::clamp(scale.rootNote, 0, NUM_NOTES - 1);
+    const double rootFrequency =
+        scale.rootFrequency > 0.0 ? scale.rootFrequency : twelveTetFrequency(root);
+    // Keep the increment in range: at most just under Nyquist
+    const double maxFrequency = 0.4999 * sampleRate;
+
+    const int degrees = static_cast<int>(scale.cents.size());
+    for (int note = 0; note < NUM_NOTES; note++) {
+        double frequency;
+        if (degrees == 0) {
+            frequency = rootFrequency * std::exp2((note - root) / 12.0);
+        } else {
+            const int steps = note - root;
+            const int period = steps >= 0 ? steps / degrees : -((degrees - 1 - steps) / degrees);
+            const int degree = steps - period * degrees;
+            const double cents =
+                period * scale.cents.back() + (degree > 0 ? scale.cents[degree - 1] : 0.0);
+            frequency = rootFrequency * std::exp2(cents / 1200.0);
+        }
+        frequency = std::min(frequency, maxFrequency);
+        table->frequency[note] = frequency;
+        table->phaseIncrement[note] = OscillatorKernel::phaseIncrementFor(frequency, sampleRate);
+        table->octave[note] = static_cast<float>(std::log2(frequency / sampleRate));
+    }
+    return table.release();
+}
+
+void Tuning::reclaimLocked() {
+    Table *table;
+    while (retired.pop(table)) {
+        delete table;
+    }
+}
+
+void Tuning::setSampleRate(int32_t rate) {
+    std::lock_guard<std::mutex> lock(controlLock);
+    reclaimLocked();
+    sampleRate = rate;
+    // No render is running: replace the table in place. A pending one was
+    // built from the same scale at the old rate.
+    delete pending.exchange(nullptr, std::memory_order_acq_rel);
+    delete current;
+    current = buildLocked();
+}
+
+void Tuning::setScale(const TuningScale &next) {
+    std::lock_guard<std::mutex> lock(controlLock);
+    reclaimLocked();
+    scale = next;
+    // A table the audio thread never took can be freed right here
+    delete pending.exchange(buildLocked(), std::memory_order_acq_rel);
+}
+
+TuningScale Tuning::getScale() {
+    std::lock_guard<std::mutex> lock(controlLock);
+    return scale;
+}
+
+void Tuning::adoptPending() {
+    if (Table *next = pending.exchange(nullptr, std::memory_order_acq_rel)) {
+        // Every publish drains `retired` first, so the push cannot fail
+        retired.push(current);
+        current = next;
+    }
+}
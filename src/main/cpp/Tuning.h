@@ -0,0 +1,108 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Tuning tables: equal divisions, Scala scales and a movable root
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "NoteEventQueue.h"
+
+// How note numbers map to pitch. Notes run linearly through the scale from
+// rootNote, one degree per note number, so an isomorphic layout that hands
+// out consecutive numbers along one axis plays the scale along that axis.
+struct TuningScale {
+  // Degrees above the root in cents, ascending; the last one is the period
+  // the scale repeats at (1200 for an octave). Empty means 12-TET.
+  std::vector<double> cents;
+  // Note number of degree 0 (the keyboard's root handle)
+  int rootNote = 60;
+  // Pitch of rootNote; 0 keeps its 12-TET pitch (A4 = 440 Hz), so moving
+  // the root keeps the new root note where it was
+  double rootFrequency = 0.0;
+
+  // `divisions` equal steps per `periodCents` (a 1200-cent octave by default)
+  static TuningScale equalDivisions(int divisions, double periodCents = 1200.0);
+
+  // Scala .scl text: lines starting with '!' are comments; the first other
+  // line is a description, the next the number of degrees, then one pitch
+  // per line, in cents if it has a '.', else a ratio ("5/4" or "2").
+  // Leaves `scale` untouched and returns false if the text is malformed.
+  static bool parseScala(const std::string &text, TuningScale &scale);
+  static bool loadScala(const std::string &path, TuningScale &scale);
+};
+
+/*
+ * Per-note pitch for the oscillators, precomputed so a note-on is two table
+ * loads: the frequency (for the wavetable level) and the phase increment,
+ * 0.32 fixed point at the device sample rate as OscillatorKernel wants it.
+ *
+ * Tables are immutable snapshots swapped like Sequencer patterns: setScale()
+ * builds one on the calling thread and publishes it with one atomic
+ * exchange; the audio thread takes it in beginBlock(), and the old one goes
+ * back through `retired` to be freed on the control side. A tuning change
+ * therefore never blocks the audio thread, and notes already sounding keep
+ * their pitch.
+ *
+ * Threading: setScale/getScale from any thread; beginBlock and the lookups
+ * from the audio thread only; setSampleRate() must not race the audio
+ * thread.
+ */
+class Tuning {
+public:
+  static constexpr int NUM_NOTES = 128;
+
+  Tuning();
+  ~Tuning();
+
+  Tuning(const Tuning &) = delete;
+  Tuning &operator=(const Tuning &) = delete;
+
+  // Rebuilds the current table for the new rate
+  void setSampleRate(int32_t rate);
+
+  void setScale(const TuningScale &scale);
+  TuningScale getScale();
+
+  // Audio thread: takes a newly published table
+  void beginBlock() {
+    if (pending.load(std::memory_order_relaxed) != nullptr) {
+      adoptPending();
+    }
+  }
+
+  // Audio thread; note must be in [0, NUM_NOTES)
+  double frequency(int note) const { return current->frequency[note]; }
+  uint32_t phaseIncrement(int note) const { return current->phaseIncrement[note]; }
+  // log2(frequency / sample rate), where the voice filter tracks the note from
+  float octave(int note) const { return current->octave[note]; }
+
+private:
+  struct Table {
+    double frequency[NUM_NOTES];
+    uint32_t phaseIncrement[NUM_NOTES];
+    float octave[NUM_NOTES];
+  };
+
+  // Control side
+  std::mutex controlLock;
+  TuningScale scale;
+  int32_t sampleRate = 48000;
+
+  std::atomic<Table *> pending{nullptr};
+  NoteEventQueue<Table *, 8> retired;
+
+  // Audio thread only; never null
+  Table *current = nullptr;
+
+  Table *buildLocked() const;
+  void reclaimLocked();
+  void adoptPending();
+};
@@ -0,0 +1,49 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Per-voice resonant low-pass: table-driven coefficients at control rate
+ */
+
+#include "VoiceFilter.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr int TABLE_STEPS = static_cast<int>(
+    (VoiceFilter::MAX_OCTAVE - VoiceFilter::MIN_OCTAVE) * VoiceFilter::STEPS_PER_OCTAVE);
+
+// One guard entry so the last step can interpolate
+std::array<float, TABLE_STEPS + 2> buildGainTable() {
+    std::array<float, TABLE_STEPS + 2> table{};
+    for (int i = 0; i < TABLE_STEPS + 2; i++) {
+        const double octave =
+            VoiceFilter::MIN_OCTAVE + static_cast<double>(i) / VoiceFilter::STEPS_PER_OCTAVE;
+        table[i] = static_cast<float>(std::tan(M_PI * std::exp2(octave)));
+    }
+    return table;
+}
+
+// tan(pi * 2^octave) every 1/STEPS_PER_OCTAVE from MIN_OCTAVE: the
+// pre-warped integrator gain that cutoffGain() interpolates
+const std::array<float, TABLE_STEPS + 2> kGain = buildGainTable();
+
+} // namespace
+
+float VoiceFilter::cutoffGain(float octave) {
+    const float position =
+        (std::clamp(octave, MIN_OCTAVE, MAX_OCTAVE) - MIN_OCTAVE) * STEPS_PER_OCTAVE;
+    const int i = std::min(static_cast<int>(position), TABLE_STEPS);
+    const float frac = position - static_cast<float>(i);
+    return kGain[i] + (kGain[i + 1] - kGain[i]) * frac;
+}
+
+VoiceFilter::Coefficients VoiceFilter::coefficients(float octave, float resonance) {
+    const float g = cutoffGain(octave);
+    const float k = 2.0f - 2.0f * std::clamp(resonance, 0.0f, MAX_RESONANCE);
+    const float a1 = 1.0f / (1.0f + g * (g + k));
+    return {g, a1, g * a1};
+}
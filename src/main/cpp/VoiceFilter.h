@@ -0,0 +1,47 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Per-voice resonant low-pass: table-driven coefficients at control rate
+ */
+
+#pragma once
+
+/*
+ * Coefficients for the oscillator kernel's per-voice filter, a topology-
+ * preserving-transform state-variable low-pass (Zavalishin). Per sample:
+ *
+ *     v1 = a1 * s1 + a2 * (x - s2)    v2 = s2 + g * v1
+ *     s1 = 2 * v1 - s1                s2 = 2 * v2 - s2    y = v2
+ *
+ * with g = tan(pi * fc / fs), k = 1 / Q, a1 = 1 / (1 + g * (g + k)) and
+ * a2 = g * a1. It stays stable for any positive g and k, so coefficients
+ * ramped linearly between two control points cannot blow up.
+ *
+ * Cutoffs are given in octaves relative to the sample rate (log2(fc / fs)),
+ * which is what the tuning table and a filter envelope produce; g comes from
+ * a table over that range, so a control tick does no transcendental math.
+ */
+class VoiceFilter {
+public:
+  // Coefficients are worked out once per CONTROL_FRAMES and ramped in between
+  static constexpr int CONTROL_FRAMES = 64;
+  // About 12 Hz at 48 kHz
+  static constexpr float MIN_OCTAVE = -12.0f;
+  // 0.42 fs; tan() grows too steep to interpolate much past this
+  static constexpr float MAX_OCTAVE = -1.25f;
+  static constexpr int STEPS_PER_OCTAVE = 64;
+  // Resonance is capped here to keep the filter from self-oscillating
+  static constexpr float MAX_RESONANCE = 0.98f;
+
+  struct Coefficients {
+    float g;
+    float a1;
+    float a2;
+  };
+
+  // tan(pi * 2^octave), octave clamped to [MIN_OCTAVE, MAX_OCTAVE]
+  static float cutoffGain(float octave);
+  // resonance: 0 (Q = 0.5) .. MAX_RESONANCE (Q = 25)
+  static Coefficients coefficients(float octave, float resonance);
+};
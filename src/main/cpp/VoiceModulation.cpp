@@ -0,0 +1,65 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Control-rate pitch math for glide, vibrato and pitch bend
+ */
+
+#include "VoiceModulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr int LFO_SIZE = 1 << VoiceModulation::LFO_TABLE_BITS;
+constexpr int LFO_FRAC_BITS = 32 - VoiceModulation::LFO_TABLE_BITS;
+
+// Both tables carry one guard entry so the last step can interpolate
+std::array<float, LFO_SIZE + 1> buildSineTable() {
+    std::array<float, LFO_SIZE + 1> table{};
+    for (int i = 0; i <= LFO_SIZE; i++) {
+        table[i] = static_cast<float>(std::sin(2.0 * M_PI * i / LFO_SIZE));
+    }
+    return table;
+}
+
+std::array<double, VoiceModulation::EXP2_TABLE_STEPS + 1> buildExp2Table() {
+    std::array<double, VoiceModulation::EXP2_TABLE_STEPS + 1> table{};
+    for (int i = 0; i <= VoiceModulation::EXP2_TABLE_STEPS; i++) {
+        table[i] = std::exp2(static_cast<double>(i) / VoiceModulation::EXP2_TABLE_STEPS);
+    }
+    return table;
+}
+
+// One LFO cycle, and 2^x across one octave, which exp2() extends to any
+// octave with ldexp
+const std::array<float, LFO_SIZE + 1> kSine = buildSineTable();
+const std::array<double, VoiceModulation::EXP2_TABLE_STEPS + 1> kExp2 = buildExp2Table();
+
+} // namespace
+
+float VoiceModulation::lfo(uint32_t phase) {
+    const uint32_t i = phase >> LFO_FRAC_BITS;
+    const float frac =
+        static_cast<float>(phase & ((1u << LFO_FRAC_BITS) - 1)) * (1.0f / (1u << LFO_FRAC_BITS));
+    return kSine[i] + (kSine[i + 1] - kSine[i]) * frac;
+}
+
+double VoiceModulation::exp2(float octaves) {
+    const float clamped = std::clamp(octaves, -MAX_OCTAVES, MAX_OCTAVES);
+    const float whole = std::floor(clamped);
+    const float position = (clamped - whole) * EXP2_TABLE_STEPS;
+    const int i = std::min(static_cast<int>(position), EXP2_TABLE_STEPS - 1);
+    const double frac = position - static_cast<float>(i);
+    return std::ldexp(kExp2[i] + (kExp2[i + 1] - kExp2[i]) * frac, static_cast<int>(whole));
+}
+
+uint32_t VoiceModulation::scaleIncrement(uint32_t increment, float octaves) {
+    if (octaves == 0.0f) {
+        return increment;
+    }
+    const double scaled = increment * exp2(octaves);
+    return scaled >= MAX_INCREMENT ? MAX_INCREMENT : static_cast<uint32_t>(scaled);
+}
@@ -0,0 +1,35 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Control-rate pitch math for glide, vibrato and pitch bend
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Table-driven helpers for SynthCore's modulation tick, which works out a
+ * target phase increment per voice every control period and lets the
+ * oscillator kernel ramp to it. Nothing here calls a transcendental
+ * function, so a tick costs a few table reads per active voice.
+ */
+class VoiceModulation {
+public:
+  static constexpr int LFO_TABLE_BITS = 8;
+  static constexpr int EXP2_TABLE_STEPS = 256;
+  // Pitch offsets are clamped to this many octaves either way
+  static constexpr float MAX_OCTAVES = 8.0f;
+  // Just under Nyquist, like the tuning tables
+  static constexpr uint32_t MAX_INCREMENT = static_cast<uint32_t>(0.4999 * 4294967296.0);
+
+  // sin(2 pi * phase / 2^32)
+  static float lfo(uint32_t phase);
+
+  // 2^octaves for |octaves| <= MAX_OCTAVES
+  static double exp2(float octaves);
+
+  // `increment` moved by `octaves`, at most MAX_INCREMENT
+  static uint32_t scaleIncrement(uint32_t increment, float octaves);
+};
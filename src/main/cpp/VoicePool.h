@@ -0,0 +1,166 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Fixed-capacity, allocation-free polyphonic voice pool
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "Envelope.h"
+
+/*
+ * Voice state is laid out as structure-of-arrays and kept dense: the active
+ * voices are always slots [0, activeCount()), so the oscillator kernel can
+ * load consecutive voices straight into SIMD lanes. Nothing here allocates;
+ * a 128-entry table maps MIDI note -> slot in O(1), and releasing a voice
+ * moves the last active voice into its slot.
+ *
+ * Owned by the audio thread.
+ */
+template <int CAPACITY>
+class VoicePool {
+  static_assert(CAPACITY > 0 && CAPACITY < 128,
+                "Voice indices are stored as int8_t");
+
+public:
+  static constexpr int NUM_MIDI_NOTES = 128;
+  static constexpr int NO_VOICE = -1;
+
+  // 32-bit fixed-point phase: a full cycle is 2^32
+  alignas(64) uint32_t phase[CAPACITY];
+  alignas(64) uint32_t phaseIncrement[CAPACITY];
+  // Entry offset of the band-limited table level this voice reads
+  alignas(64) uint32_t tableOffset[CAPACITY];
+  alignas(64) float envLevel[CAPACITY];
+  alignas(64) float envMul[CAPACITY];
+  alignas(64) float envAdd[CAPACITY];
+  alignas(64) int32_t envFramesLeft[CAPACITY];
+  // Constant-power channel gains, set at note-on
+  alignas(64) float panLeft[CAPACITY];
+  alignas(64) float panRight[CAPACITY];
+  // Low-pass state and coefficients (see VoiceFilter), ramped by the steps
+  alignas(64) float filterS1[CAPACITY];
+  alignas(64) float filterS2[CAPACITY];
+  alignas(64) float filterG[CAPACITY];
+  alignas(64) float filterA1[CAPACITY];
+  alignas(64) float filterA2[CAPACITY];
+  alignas(64) float filterGStep[CAPACITY];
+  alignas(64) float filterA1Step[CAPACITY];
+  alignas(64) float filterA2Step[CAPACITY];
+  // Cutoff in octaves relative to the sample rate before the filter
+  // envelope, and the envelope's level (1 at note-on, decaying to 0)
+  float filterBase[CAPACITY];
+  float filterEnv[CAPACITY];
+  // Pitch and gain modulation: the tuning's increment for the note, the
+  // per-sample ramps the kernel applies, and the per-note controls the
+  // ramps are worked out from at each control tick
+  uint32_t baseIncrement[CAPACITY];
+  alignas(64) int32_t incrementStep[CAPACITY];
+  alignas(64) float modGain[CAPACITY];
+  alignas(64) float modGainStep[CAPACITY];
+  // Octaves from the note's pitch, stepped to 0 by glideStep every tick
+  float glide[CAPACITY];
+  float glideStep[CAPACITY];
+  // Per-note pitch bend in semitones and pressure 0..1
+  float bend[CAPACITY];
+  float pressure[CAPACITY];
+  EnvelopeStage envStage[CAPACITY];
+  int8_t midiNote[CAPACITY];
+  uint64_t noteId[CAPACITY];
+
+  VoicePool() { clear(); }
+
+  int activeCount() const { return numActive; }
+  bool isFull() const { return numActive == CAPACITY; }
+
+  int find(int note) const { return noteToVoice[note]; }
+
+  void clear() {
+    for (int n = 0; n < NUM_MIDI_NOTES; n++) {
+      noteToVoice[n] = NO_VOICE;
+    }
+    numActive = 0;
+  }
+
+  // Takes the next free slot for `note`. The caller must make room first
+  // (see findVictim) if the pool is full.
+  int allocate(int note, uint64_t id) {
+    int v = numActive++;
+    noteToVoice[note] = static_cast<int8_t>(v);
+    midiNote[v] = static_cast<int8_t>(note);
+    noteId[v] = id;
+    phase[v] = 0;
+    envLevel[v] = 0.0f;
+    return v;
+  }
+
+  // Frees slot v by moving the last active voice into it, so a caller
+  // iterating over the slots must revisit v.
+  void release(int v) {
+    noteToVoice[midiNote[v]] = NO_VOICE;
+    int last = --numActive;
+    if (v != last) {
+      phase[v] = phase[last];
+      phaseIncrement[v] = phaseIncrement[last];
+      tableOffset[v] = tableOffset[last];
+      envLevel[v] = envLevel[last];
+      envMul[v] = envMul[last];
+      envAdd[v] = envAdd[last];
+      envFramesLeft[v] = envFramesLeft[last];
+      panLeft[v] = panLeft[last];
+      panRight[v] = panRight[last];
+      filterS1[v] = filterS1[last];
+      filterS2[v] = filterS2[last];
+      filterG[v] = filterG[last];
+      filterA1[v] = filterA1[last];
+      filterA2[v] = filterA2[last];
+      filterGStep[v] = filterGStep[last];
+      filterA1Step[v] = filterA1Step[last];
+      filterA2Step[v] = filterA2Step[last];
+      filterBase[v] = filterBase[last];
+      filterEnv[v] = filterEnv[last];
+      baseIncrement[v] = baseIncrement[last];
+      incrementStep[v] = incrementStep[last];
+      modGain[v] = modGain[last];
+      modGainStep[v] = modGainStep[last];
+      glide[v] = glide[last];
+      glideStep[v] = glideStep[last];
+      bend[v] = bend[last];
+      pressure[v] = pressure[last];
+      envStage[v] = envStage[last];
+      midiNote[v] = midiNote[last];
+      noteId[v] = noteId[last];
+      noteToVoice[midiNote[v]] = static_cast<int8_t>(v);
+    }
+  }
+
+  // Eviction policy: oldest releasing voice, otherwise oldest active voice
+  int findVictim() const {
+    int oldestReleasing = NO_VOICE;
+    int oldest = NO_VOICE;
+    for (int v = 0; v < numActive; v++) {
+      if (isReleasing(envStage[v]) &&
+          (oldestReleasing == NO_VOICE || noteId[v] < noteId[oldestReleasing])) {
+        oldestReleasing = v;
+      }
+      if (oldest == NO_VOICE || noteId[v] < noteId[oldest]) {
+        oldest = v;
+      }
+    }
+    return oldestReleasing != NO_VOICE ? oldestReleasing : oldest;
+  }
+
+  void enterSegment(int v, const EnvelopeSegment &segment) {
+    envStage[v] = segment.stage;
+    envMul[v] = segment.mul;
+    envAdd[v] = segment.add;
+    envFramesLeft[v] = segment.frames;
+  }
+
+private:
+  int8_t noteToVoice[NUM_MIDI_NOTES];
+  int numActive = 0;
+};
@@ -0,0 +1,272 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Deadline-aware worker pool for splitting voice rendering across cores
+ */
+
+#include "VoiceWorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// A parked worker rechecks this often, so a wake-up the notify raced past
+// costs at most this long (and the deadline covers the dispatch meanwhile)
+constexpr auto PARK_TIMEOUT = std::chrono::milliseconds(1);
+
+// Spin iterations between clock reads
+constexpr int SPINS_PER_CLOCK_READ = 256;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+void pinToCore(int worker) {
+#if defined(__linux__)
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores <= 1) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((cores - 1 - worker % cores + cores) % cores, &set);
+    // Best effort: some kernels refuse affinity for app threads
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)worker;
+#endif
+}
+
+} // namespace
+
+VoiceWorkerPool::VoiceWorkerPool(int numWorkers, bool pinThreads)
+    : numWorkers(std::clamp(numWorkers, 0, MAX_WORKERS)) {
+    for (auto &state : taskState) {
+        state.store(INLINE, std::memory_order_relaxed);
+    }
+    for (int w = 0; w < this->numWorkers; w++) {
+        workers[w].thread = std::thread(&VoiceWorkerPool::workerLoop, this, w, pinThreads);
+    }
+}
+
+VoiceWorkerPool::~VoiceWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(parkLock);
+        running.store(false, std::memory_order_relaxed);
+    }
+    parkSignal.notify_all();
+    for (int w = 0; w < numWorkers; w++) {
+        workers[w].thread.join();
+    }
+}
+
+int VoiceWorkerPool::defaultWorkerCount() {
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(cores - 1, 0, 3);
+}
+
+int64_t VoiceWorkerPool::nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int VoiceWorkerPool::popFront(Range &range) {
+    uint32_t bounds = range.bounds.load(std::memory_order_relaxed);
+    while ((bounds >> 16) < (bounds & 0xffff)) {
+        if (range.bounds.compare_exchange_weak(bounds, bounds + (1u << 16),
+                                               std::memory_order_acquire)) {
+            return static_cast<int>(bounds >> 16);
+        }
+    }
+    return -1;
+}
+
+int VoiceWorkerPool::popBack(Range &range) {
+    uint32_t bounds = range.bounds.load(std::memory_order_relaxed);
+    while ((bounds >> 16) < (bounds & 0xffff)) {
+        if (range.bounds.compare_exchange_weak(bounds, bounds - 1,
+                                               std::memory_order_acquire)) {
+            return static_cast<int>((bounds & 0xffff) - 1);
+        }
+    }
+    return -1;
+}
+
+void VoiceWorkerPool::runAllInline(Job &inlineJob, int count) {
+    for (int t = 0; t < count; t++) {
+        inlineJob.runInline(t);
+    }
+}
+
+bool VoiceWorkerPool::ready() {
+    for (int w = 0; w < numWorkers; w++) {
+        // Acquire: everything the worker read of the last job happened
+        // before it went inactive
+        if (workers[w].active.load(std::memory_order_acquire)) {
+            stats.inlineFallbacks.store(
+                stats.inlineFallbacks.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+void VoiceWorkerPool::run(Job &newJob, int count, int64_t deadlineNanos) {
+    stats.dispatches.store(stats.dispatches.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    if (numWorkers == 0 || count <= 1 || count > MAX_TASKS) {
+        runAllInline(newJob, count);
+        return;
+    }
+
+    // Pairs with the check in work(): either a worker sees `publishing` and
+    // stays out, or we see it active and leave its job alone
+    publishing.store(true, std::memory_order_seq_cst);
+    for (int w = 0; w < numWorkers; w++) {
+        if (workers[w].active.load(std::memory_order_seq_cst)) {
+            publishing.store(false, std::memory_order_release);
+            stats.inlineFallbacks.store(
+                stats.inlineFallbacks.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+            runAllInline(newJob, count);
+            return;
+        }
+    }
+
+    job = &newJob;
+    for (int t = 0; t < count; t++) {
+        taskState[t].store(PENDING, std::memory_order_relaxed);
+    }
+    const int participants = numWorkers + 1;
+    for (int p = 0; p < participants; p++) {
+        const uint32_t begin = static_cast<uint32_t>(count * p / participants);
+        const uint32_t end = static_cast<uint32_t>(count * (p + 1) / participants);
+        ranges[p].bounds.store(begin << 16 | end, std::memory_order_relaxed);
+    }
+    generation.fetch_add(1, std::memory_order_seq_cst);
+    publishing.store(false, std::memory_order_release);
+    if (parked.load(std::memory_order_seq_cst) > 0) {
+        // Only after the pool sat idle; a spinning worker needs no syscall
+        parkSignal.notify_all();
+    }
+
+    // Our own share, then whatever nobody has claimed yet
+    for (int p = 0; p < participants; p++) {
+        int task;
+        while ((task = p == 0 ? popFront(ranges[0]) : popBack(ranges[p])) >= 0) {
+            taskState[task].store(INLINE, std::memory_order_relaxed);
+            newJob.runInline(task);
+        }
+    }
+
+    // Every task is now claimed. Collect the workers' results, taking back
+    // any that are not done by the deadline.
+    int64_t committed = 0;
+    int64_t late = 0;
+    for (int t = 0; t < count; t++) {
+        uint8_t state = taskState[t].load(std::memory_order_acquire);
+        int spins = 0;
+        while (state == PENDING || state == RUNNING) {
+            if (++spins % SPINS_PER_CLOCK_READ == 0 && nowNanos() >= deadlineNanos) {
+                if (taskState[t].compare_exchange_strong(state, ABANDONED,
+                                                         std::memory_order_acq_rel)) {
+                    newJob.runInline(t);
+                    late++;
+                    state = ABANDONED;
+                    break;
+                }
+                continue;
+            }
+            cpuRelax();
+            state = taskState[t].load(std::memory_order_acquire);
+        }
+        if (state == DONE) {
+            newJob.commit(t, taskWorker[t]);
+            committed++;
+        }
+    }
+    if (committed > 0) {
+        stats.workerTasks.store(stats.workerTasks.load(std::memory_order_relaxed) + committed,
+                                std::memory_order_relaxed);
+    }
+    if (late > 0) {
+        stats.lateTasks.store(stats.lateTasks.load(std::memory_order_relaxed) + late,
+                              std::memory_order_relaxed);
+    }
+}
+
+void VoiceWorkerPool::work(int worker) {
+    const int participants = numWorkers + 1;
+    Job &current = *job;
+    for (int i = 0; i < participants; i++) {
+        // Own range first, then the others, starting with the next worker's
+        const int p = (worker + 1 + i) % participants;
+        int task;
+        while ((task = i == 0 ? popFront(ranges[p]) : popBack(ranges[p])) >= 0) {
+            uint8_t expected = PENDING;
+            if (!taskState[task].compare_exchange_strong(expected, RUNNING,
+                                                         std::memory_order_acq_rel)) {
+                continue; // the deadline passed before we got to it
+            }
+            current.runOnWorker(task, worker);
+            taskWorker[task] = static_cast<int8_t>(worker);
+            expected = RUNNING;
+            taskState[task].compare_exchange_strong(expected, DONE, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void VoiceWorkerPool::workerLoop(int worker, bool pin) {
+    if (pin) {
+        pinToCore(worker);
+    }
+    // Not the current value: a dispatch may already have come and gone
+    // before this thread got going
+    uint32_t seen = 0;
+    int64_t idleSince = nowNanos();
+    int spins = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        const uint32_t current = generation.load(std::memory_order_acquire);
+        if (current == seen) {
+            if (++spins % SPINS_PER_CLOCK_READ != 0) {
+                cpuRelax();
+                continue;
+            }
+            if (nowNanos() - idleSince < SPIN_NANOS) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(parkLock);
+            parked.fetch_add(1, std::memory_order_seq_cst);
+            parkSignal.wait_for(lock, PARK_TIMEOUT, [&] {
+                return generation.load(std::memory_order_seq_cst) != seen ||
+                       !running.load(std::memory_order_relaxed);
+            });
+            parked.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        seen = current;
+        workers[worker].active.store(true, std::memory_order_seq_cst);
+        if (!publishing.load(std::memory_order_seq_cst) &&
+            generation.load(std::memory_order_seq_cst) == current) {
+            work(worker);
+        }
+        workers[worker].active.store(false, std::memory_order_release);
+        idleSince = nowNanos();
+    }
+}
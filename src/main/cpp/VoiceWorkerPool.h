@@ -0,0 +1,143 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Deadline-aware worker pool for splitting voice rendering across cores
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/*
+ * Runs a job's tasks on the calling (audio) thread plus a few worker
+ * threads, without the audio thread ever blocking on a lock or waiting past
+ * a deadline.
+ *
+ * Workers are pinned to a core each (best effort) and spin on a generation
+ * counter while audio is flowing, so a dispatch wakes them in well under a
+ * microsecond; after SPIN_NANOS without work they park on a condition
+ * variable and the next dispatch pays one wake-up.
+ *
+ * Each participant starts with a contiguous share of the tasks, packed as
+ * begin|end in one atomic word. Owners take from the front, thieves from the
+ * back, so voices that cost more (or a worker that wakes late) just move
+ * tasks to whoever is free. The audio thread works its own share first,
+ * then steals everything still unclaimed.
+ *
+ * Workers never touch shared state: runOnWorker() renders into storage
+ * private to that worker and the audio thread folds finished tasks in with
+ * commit(). That is what makes the deadline safe: a task a worker claimed
+ * but has not finished by the deadline is taken back and rendered inline
+ * from the untouched shared state, and whatever the worker later produces
+ * is ignored. That worker keeps reading the job it was given until it
+ * finishes, so the caller must not rewrite the job (or anything it reads)
+ * while ready() says so; it renders without the pool instead. run() itself
+ * also renders everything inline if it finds a worker still busy.
+ *
+ * Threading: run() from one thread at a time (the audio thread); the
+ * constructor and destructor from a control thread.
+ */
+class VoiceWorkerPool {
+public:
+  static constexpr int MAX_WORKERS = 7;
+  static constexpr int MAX_TASKS = 64;
+  // Spin this long after the last dispatch before parking
+  static constexpr int64_t SPIN_NANOS = 20000000;
+
+  class Job {
+  public:
+    virtual ~Job() = default;
+    // Calling thread: run `task` on the shared state
+    virtual void runInline(int task) = 0;
+    // Worker `worker` (0-based): run `task`, writing only that worker's
+    // private storage
+    virtual void runOnWorker(int task, int worker) = 0;
+    // Calling thread: fold in a task that worker `worker` finished
+    virtual void commit(int task, int worker) = 0;
+  };
+
+  struct Stats {
+    std::atomic<int64_t> dispatches{0};
+    // Tasks rendered by a worker and committed
+    std::atomic<int64_t> workerTasks{0};
+    // Tasks taken back from a worker at the deadline
+    std::atomic<int64_t> lateTasks{0};
+    // Dispatches rendered inline because a worker was still busy (including
+    // every ready() that returned false)
+    std::atomic<int64_t> inlineFallbacks{0};
+  };
+
+  // pinThreads: pin worker i to the i-th highest-numbered core, where
+  // big cores usually sit on Android
+  explicit VoiceWorkerPool(int numWorkers, bool pinThreads = true);
+  ~VoiceWorkerPool();
+
+  VoiceWorkerPool(const VoiceWorkerPool &) = delete;
+  VoiceWorkerPool &operator=(const VoiceWorkerPool &) = delete;
+
+  int getWorkerCount() const { return numWorkers; }
+
+  // One less than the core count, at most 3
+  static int defaultWorkerCount();
+
+  // Calling thread, before preparing a job for run(): false while a worker
+  // is still running a task it was too late for and may read the last job,
+  // whose storage must then be left alone. A false counts as an inline
+  // fallback.
+  bool ready();
+
+  // Runs tasks [0, numTasks) and returns once each one has been run inline
+  // or committed. Tasks still running on a worker at deadlineNanos (steady
+  // clock, see nowNanos()) are re-run inline; so is a job of more than
+  // MAX_TASKS tasks.
+  void run(Job &job, int numTasks, int64_t deadlineNanos);
+
+  const Stats &getStats() const { return stats; }
+
+  static int64_t nowNanos();
+
+private:
+  enum TaskState : uint8_t { PENDING, RUNNING, DONE, INLINE, ABANDONED };
+
+  struct alignas(64) Range {
+    // begin << 16 | end
+    std::atomic<uint32_t> bounds{0};
+  };
+
+  struct alignas(64) Worker {
+    std::thread thread;
+    // Set while the worker may read the current job
+    std::atomic<bool> active{false};
+  };
+
+  const int numWorkers;
+  Worker workers[MAX_WORKERS];
+  // Index 0 is the calling thread, 1 + i is worker i
+  Range ranges[MAX_WORKERS + 1];
+  std::atomic<uint8_t> taskState[MAX_TASKS];
+  int8_t taskWorker[MAX_TASKS];
+
+  // The current job; written only while `publishing` and no worker is active
+  Job *job = nullptr;
+
+  std::atomic<uint32_t> generation{0};
+  std::atomic<bool> publishing{false};
+  std::atomic<bool> running{true};
+
+  std::mutex parkLock;
+  std::condition_variable parkSignal;
+  std::atomic<int> parked{0};
+
+  Stats stats;
+
+  static int popFront(Range &range);
+  static int popBack(Range &range);
+  void workerLoop(int worker, bool pin);
+  void work(int worker);
+  void runAllInline(Job &job, int numTasks);
+};
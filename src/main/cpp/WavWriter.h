@@ -0,0 +1,136 @@
+/*
+ * kwada (C) 2026
+ * Author: phedwin
+ *
+ * Minimal streaming writer for 32-bit float and 24-bit PCM WAV files
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Writes interleaved float frames to a WAVE_FORMAT_IEEE_FLOAT file, or
+ * converts them to 24-bit PCM (clipped, rounded to nearest). The header is
+ * written up front with zero sizes and patched by close(), so the writer can
+ * stream an arbitrary number of frames without buffering them. The file
+ * goes through a WRITE_BUFFER_BYTES stdio buffer, so small writes reach the
+ * disk as large ones. Assumes a little-endian host, which covers every ABI
+ * we build for.
+ *
+ * Does blocking file I/O: never call it from the audio thread.
+ */
+class WavWriter {
+public:
+  enum class Format { FLOAT32, PCM24 };
+
+  static constexpr size_t WRITE_BUFFER_BYTES = 1 << 16;
+
+  WavWriter() = default;
+  ~WavWriter() { close(); }
+
+  WavWriter(const WavWriter &) = delete;
+  WavWriter &operator=(const WavWriter &) = delete;
+
+  bool open(const char *path, int32_t sampleRate, int32_t channelCount,
+            Format sampleFormat = Format::FLOAT32) {
+    close();
+    file = std::fopen(path, "wb");
+    if (file == nullptr) {
+      return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER_BYTES);
+    format = sampleFormat;
+    channels = channelCount;
+    rate = sampleRate;
+    dataBytes = 0;
+    if (!writeHeader()) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  bool isOpen() const { return file != nullptr; }
+
+  bool write(const float *frames, int32_t numFrames) {
+    if (file == nullptr) {
+      return false;
+    }
+    const size_t samples = static_cast<size_t>(numFrames) * channels;
+    if (format == Format::PCM24) {
+      return writePcm24(frames, samples);
+    }
+    if (std::fwrite(frames, sizeof(float), samples, file) != samples) {
+      return false;
+    }
+    dataBytes += static_cast<uint32_t>(samples * sizeof(float));
+    return true;
+  }
+
+  Format getFormat() const { return format; }
+
+  // Patches the RIFF and data sizes. Safe to call more than once.
+  bool close() {
+    if (file == nullptr) {
+      return true;
+    }
+    bool ok = std::fseek(file, 0, SEEK_SET) == 0 && writeHeader();
+    ok &= std::fclose(file) == 0;
+    file = nullptr;
+    return ok;
+  }
+
+private:
+  static constexpr uint16_t FORMAT_PCM = 1;
+  static constexpr uint16_t FORMAT_IEEE_FLOAT = 3;
+  static constexpr uint32_t HEADER_BYTES = 44;
+  static constexpr size_t PCM24_CHUNK_SAMPLES = 1024;
+
+  std::FILE *file = nullptr;
+  Format format = Format::FLOAT32;
+  int32_t channels = 1;
+  int32_t rate = 0;
+  uint32_t dataBytes = 0;
+
+  bool put32(uint32_t value) { return std::fwrite(&value, 4, 1, file) == 1; }
+  bool put16(uint16_t value) { return std::fwrite(&value, 2, 1, file) == 1; }
+  bool putTag(const char *tag) { return std::fwrite(tag, 1, 4, file) == 4; }
+
+  bool writePcm24(const float *samples, size_t count) {
+    uint8_t bytes[3 * PCM24_CHUNK_SAMPLES];
+    for (size_t done = 0; done < count;) {
+      const size_t n = std::min(PCM24_CHUNK_SAMPLES, count - done);
+      for (size_t i = 0; i < n; i++) {
+        const float clipped = std::clamp(samples[done + i], -1.0f, 1.0f);
+        const int32_t value =
+            std::min(8388607, static_cast<int32_t>(std::lrint(clipped * 8388608.0f)));
+        bytes[3 * i] = static_cast<uint8_t>(value);
+        bytes[3 * i + 1] = static_cast<uint8_t>(value >> 8);
+        bytes[3 * i + 2] = static_cast<uint8_t>(value >> 16);
+      }
+      if (std::fwrite(bytes, 3, n, file) != n) {
+        return false;
+      }
+      dataBytes += static_cast<uint32_t>(3 * n);
+      done += n;
+    }
+    return true;
+  }
+
+  bool writeHeader() {
+    const uint16_t bytesPerSample = format == Format::PCM24 ? 3 : sizeof(float);
+    const uint16_t blockAlign = static_cast<uint16_t>(channels * bytesPerSample);
+    return putTag("RIFF") && put32(HEADER_BYTES - 8 + dataBytes) &&
+           putTag("WAVE") && putTag("fmt ") && put32(16) &&
+           put16(format == Format::PCM24 ? FORMAT_PCM : FORMAT_IEEE_FLOAT) &&
+           put16(static_cast<uint16_t>(channels)) &&
+           put32(static_cast<uint32_t>(rate)) &&
+           put32(static_cast<uint32_t>(rate) * blockAlign) &&
+           put16(blockAlign) && put16(static_cast<uint16_t>(8 * bytesPerSample)) &&
+           putTag("data") && put32(dataBytes);
+  }
+};